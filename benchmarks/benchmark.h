@@ -0,0 +1,177 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+// Helpers shared by the benchmarks : timing, and random stream graphs big enough to measure something.
+
+#include "../src/stream_graph.h"
+#include "../src/utils.h"
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static double Benchmark_now(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+}
+
+static void Benchmark_report(const char* name, double seconds, size_t nb_repetitions) {
+	printf("%-40s %12.3f us\n", name, seconds * 1e6 / (double)nb_repetitions);
+}
+
+typedef struct {
+	size_t instant;
+	char sign;
+	char letter;
+	size_t id;
+} BenchmarkEvent;
+
+static int BenchmarkEvent_compare(const void* a, const void* b) {
+	const BenchmarkEvent* ea = (const BenchmarkEvent*)a;
+	const BenchmarkEvent* eb = (const BenchmarkEvent*)b;
+	return (ea->instant > eb->instant) - (ea->instant < eb->instant);
+}
+
+typedef struct {
+	char* str;
+	size_t size;
+	size_t capacity;
+} BenchmarkBuffer;
+
+static void BenchmarkBuffer_append(BenchmarkBuffer* buffer, const char* format, ...) {
+	va_list args;
+	va_start(args, format);
+	int length = vsnprintf(buffer->str + buffer->size, buffer->capacity - buffer->size, format, args);
+	va_end(args);
+	if (buffer->size + (size_t)length >= buffer->capacity) {
+		while (buffer->size + (size_t)length >= buffer->capacity) {
+			buffer->capacity *= 2;
+		}
+		buffer->str = realloc(buffer->str, buffer->capacity);
+		va_start(args, format);
+		vsnprintf(buffer->str + buffer->size, buffer->capacity - buffer->size, format, args);
+		va_end(args);
+	}
+	buffer->size += (size_t)length;
+}
+
+/**
+ * Generates a StreamGraph of nb_nodes nodes present during the whole lifespan [0, lifespan[, and nb_links distinct
+ * links, each present during nb_intervals random intervals. nb_links must be at most nb_nodes * (nb_nodes - 1) / 2.
+ * The internal format is written directly, since the converter from the external one is too slow for big graphs.
+ */
+static StreamGraph Benchmark_random_stream_graph(size_t nb_nodes, size_t nb_links, size_t nb_intervals,
+												 size_t lifespan, unsigned int seed) {
+	srand(seed);
+	size_t (*links)[2] = MALLOC(nb_links * sizeof(size_t[2]));
+	size_t* nb_neighbours = calloc(nb_nodes, sizeof(size_t));
+	for (size_t i = 0; i < nb_links; i++) {
+		links[i][0] = i % nb_nodes;
+		links[i][1] = (links[i][0] + 1 + i / nb_nodes) % nb_nodes;
+		nb_neighbours[links[i][0]]++;
+		nb_neighbours[links[i][1]]++;
+	}
+
+	size_t nb_events = 2 * nb_nodes + 2 * nb_links * nb_intervals;
+	BenchmarkEvent* events = MALLOC(nb_events * sizeof(BenchmarkEvent));
+	size_t n = 0;
+	for (size_t i = 0; i < nb_nodes; i++) {
+		events[n++] = (BenchmarkEvent){0, '+', 'N', i};
+		events[n++] = (BenchmarkEvent){lifespan, '-', 'N', i};
+	}
+	// Each interval is drawn in its own slot of the lifespan, so that the intervals of a link never touch
+	size_t slot = lifespan / nb_intervals;
+	for (size_t i = 0; i < nb_links; i++) {
+		for (size_t k = 0; k < nb_intervals; k++) {
+			size_t start = k * slot + (size_t)rand() % (slot / 2);
+			size_t end = start + 1 + (size_t)rand() % (slot / 2 - 1);
+			events[n++] = (BenchmarkEvent){start, '+', 'L', i};
+			events[n++] = (BenchmarkEvent){end, '-', 'L', i};
+		}
+	}
+	// qsort is not stable, but no element appears and disappears at the same instant, so the order within one is free
+	qsort(events, nb_events, sizeof(BenchmarkEvent), BenchmarkEvent_compare);
+
+	size_t nb_slices = lifespan / RELATIVE_MOMENT_MAX + 1;
+	size_t* moments_in_slice = calloc(nb_slices, sizeof(size_t));
+	size_t nb_key_moments = 0;
+	for (size_t i = 0; i < nb_events; i++) {
+		if (i == 0 || events[i].instant != events[i - 1].instant) {
+			moments_in_slice[events[i].instant / SLICE_SIZE]++;
+			nb_key_moments++;
+		}
+	}
+
+	BenchmarkBuffer buffer = {.str = MALLOC(4096), .size = 0, .capacity = 4096};
+	BenchmarkBuffer_append(&buffer, "SGA Internal version 1.0.0\n\n\n[General]\nLifespan=(0 %zu)\nScaling=1\n\n\n", lifespan);
+	BenchmarkBuffer_append(&buffer, "[Memory]\nNumberOfNodes=%zu\nNumberOfLinks=%zu\nNumberOfKeyMoments=%zu\n\n", nb_nodes,
+						   nb_links, nb_key_moments);
+	BenchmarkBuffer_append(&buffer, "[[Nodes]]\n[[[NumberOfNeighbours]]]\n");
+	for (size_t i = 0; i < nb_nodes; i++) {
+		BenchmarkBuffer_append(&buffer, "%zu\n", nb_neighbours[i]);
+	}
+	BenchmarkBuffer_append(&buffer, "[[[NumberOfIntervals]]]\n");
+	for (size_t i = 0; i < nb_nodes; i++) {
+		BenchmarkBuffer_append(&buffer, "1\n");
+	}
+	BenchmarkBuffer_append(&buffer, "\n[[Links]]\n[[[NumberOfIntervals]]]\n");
+	for (size_t i = 0; i < nb_links; i++) {
+		BenchmarkBuffer_append(&buffer, "%zu\n", nb_intervals);
+	}
+	BenchmarkBuffer_append(&buffer, "\n[[[NumberOfSlices]]]\n");
+	for (size_t i = 0; i < nb_slices; i++) {
+		BenchmarkBuffer_append(&buffer, "%zu\n", moments_in_slice[i]);
+	}
+
+	// The links of each node, grouped by node in one pass over the links, in increasing order of id
+	size_t* offsets = calloc(nb_nodes + 1, sizeof(size_t));
+	for (size_t i = 0; i < nb_nodes; i++) {
+		offsets[i + 1] = offsets[i] + nb_neighbours[i];
+	}
+	size_t* links_of_nodes = MALLOC((2 * nb_links + 1) * sizeof(size_t));
+	for (size_t i = 0; i < nb_links; i++) {
+		links_of_nodes[offsets[links[i][0]]++] = i;
+		links_of_nodes[offsets[links[i][1]]++] = i;
+	}
+	BenchmarkBuffer_append(&buffer, "\n\n[Data]\n\n[[Neighbours]]\n[[[NodesToLinks]]]\n");
+	for (size_t node = 0; node < nb_nodes; node++) {
+		BenchmarkBuffer_append(&buffer, "(");
+		// The offsets now point to the end of the links of each node
+		for (size_t i = offsets[node] - nb_neighbours[node]; i < offsets[node]; i++) {
+			BenchmarkBuffer_append(&buffer, "%zu%s", links_of_nodes[i], i + 1 < offsets[node] ? " " : "");
+		}
+		BenchmarkBuffer_append(&buffer, ")\n");
+	}
+	free(links_of_nodes);
+	free(offsets);
+	BenchmarkBuffer_append(&buffer, "[[[LinksToNodes]]]\n");
+	for (size_t i = 0; i < nb_links; i++) {
+		BenchmarkBuffer_append(&buffer, "(%zu %zu)\n", links[i][0], links[i][1]);
+	}
+
+	BenchmarkBuffer_append(&buffer, "\n[[Events]]\n");
+	for (size_t i = 0; i < nb_events; i++) {
+		bool first = i == 0 || events[i].instant != events[i - 1].instant;
+		bool last = i == nb_events - 1 || events[i].instant != events[i + 1].instant;
+		if (first) {
+			BenchmarkBuffer_append(&buffer, "%zu=(", events[i].instant);
+		}
+		BenchmarkBuffer_append(&buffer, "(%c %c %zu)%s", events[i].sign, events[i].letter, events[i].id,
+							   last ? ")\n" : " ");
+	}
+	BenchmarkBuffer_append(&buffer, "\n[EndOfFile]\n");
+
+	StreamGraph stream_graph = StreamGraph_from_string(buffer.str);
+	free(buffer.str);
+	free(moments_in_slice);
+	free(events);
+	free(nb_neighbours);
+	free(links);
+	return stream_graph;
+}
+
+#endif // BENCHMARK_
\ No newline at end of file
@@ -0,0 +1,45 @@
+// Measures the enumeration of the maximal cliques on a graph of a million links, on a single thread and on every
+// processor. The cliques are only counted, so that the time is the one of the search.
+
+#include "../src/cliques.h"
+#include "../src/stream.h"
+#include "../src/stream/full_stream_graph.h"
+#include "../src/thread_pool.h"
+#include "benchmark.h"
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#define NB_REPETITIONS 3
+
+static void count_clique(const TemporalClique* clique, void* data) {
+	(void)clique;
+	atomic_fetch_add_explicit((atomic_size_t*)data, 1, memory_order_relaxed);
+}
+
+static void run(Stream* stream, size_t nb_workers) {
+	ThreadPool_set_global_nb_workers(nb_workers);
+	atomic_size_t nb_cliques = 0;
+	double start = Benchmark_now();
+	for (size_t i = 0; i < NB_REPETITIONS; i++) {
+		Stream_maximal_cliques(stream, count_clique, &nb_cliques);
+	}
+	char label[64];
+	snprintf(label, sizeof(label), "maximal cliques (%zu workers)", ThreadPool_nb_workers(ThreadPool_global()));
+	Benchmark_report(label, Benchmark_now() - start, NB_REPETITIONS);
+	ThreadPool_set_global_nb_workers(1);
+}
+
+int main() {
+	// Each node is linked to the 10 next ones, so the cliques have up to 11 nodes
+	StreamGraph sg = Benchmark_random_stream_graph(100000, 1000000, 2, 10000, 42);
+	Stream full = FullStreamGraph_from(&sg);
+	printf("FullStreamGraph\n");
+	// 0 workers uses every processor online
+	run(&full, 1);
+	run(&full, 0);
+	FullStreamGraph_destroy(full);
+	StreamGraph_destroy(sg);
+	return 0;
+}
\ No newline at end of file
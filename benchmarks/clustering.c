@@ -0,0 +1,54 @@
+// Measures the clustering coefficients on a graph of a million links, on a single thread and on every processor.
+// Each repetition starts from an empty cache, so that the triangles are enumerated again.
+
+#include "../src/metrics.h"
+#include "../src/stream.h"
+#include "../src/stream/full_stream_graph.h"
+#include "../src/thread_pool.h"
+#include "benchmark.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+#define NB_REPETITIONS 3
+
+static void run(const char* name, Stream* stream, size_t nb_workers, double (*metric)(Stream*)) {
+	ThreadPool_set_global_nb_workers(nb_workers);
+	volatile double sink = 0;
+	double start = Benchmark_now();
+	for (size_t i = 0; i < NB_REPETITIONS; i++) {
+		Stream fresh = *stream;
+		init_cache(&fresh);
+		sink += metric(&fresh);
+		destroy_cache(fresh);
+	}
+	(void)sink;
+	char label[64];
+	snprintf(label, sizeof(label), "%s (%zu workers)", name, ThreadPool_nb_workers(ThreadPool_global()));
+	Benchmark_report(label, Benchmark_now() - start, NB_REPETITIONS);
+	ThreadPool_set_global_nb_workers(1);
+}
+
+static double clustering_coeff_of_all_nodes(Stream* stream) {
+	MetricValues values = Stream_clustering_coeff_of_all_nodes(stream);
+	double first = values.values[0];
+	MetricValues_destroy(values);
+	return first;
+}
+
+int main() {
+	// Each node is linked to the 10 next ones, so every node is in 45 triangles
+	StreamGraph sg = Benchmark_random_stream_graph(100000, 1000000, 2, 10000, 42);
+	Stream full = FullStreamGraph_from(&sg);
+	printf("FullStreamGraph\n");
+	// 0 workers uses every processor online
+	size_t nb_workers[] = {1, 0};
+	for (size_t i = 0; i < sizeof(nb_workers) / sizeof(nb_workers[0]); i++) {
+		run("clustering coefficient", &full, nb_workers[i], Stream_clustering_coeff);
+		run("transitivity", &full, nb_workers[i], Stream_transitivity);
+		run("clustering of all nodes", &full, nb_workers[i], clustering_coeff_of_all_nodes);
+	}
+	FullStreamGraph_destroy(full);
+	StreamGraph_destroy(sg);
+	return 0;
+}
\ No newline at end of file
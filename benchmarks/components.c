@@ -0,0 +1,50 @@
+// Measures the connected components at every key moment of a graph of a million links, and at a few instants.
+// The key moments are the leaves of the segment tree, so their number sets its depth.
+
+#include "../src/components.h"
+#include "../src/stream.h"
+#include "../src/stream/full_stream_graph.h"
+#include "benchmark.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NB_REPETITIONS 3
+#define NB_INSTANTS	   10
+
+static void sum_components(ComponentsCount count, void* user_data) {
+	*(size_t*)user_data += count.nb_components;
+}
+
+int main() {
+	StreamGraph sg = Benchmark_random_stream_graph(100000, 1000000, 2, 10000, 42);
+	Stream full = FullStreamGraph_from(&sg);
+	printf("FullStreamGraph\n");
+
+	volatile size_t sink = 0;
+	double start = Benchmark_now();
+	for (size_t i = 0; i < NB_REPETITIONS; i++) {
+		size_t total = 0;
+		Stream_sweep_components(&full, sum_components, &total);
+		sink += total;
+	}
+	Benchmark_report("components at every key moment", Benchmark_now() - start, NB_REPETITIONS);
+
+	TimeId instants[NB_INSTANTS];
+	for (size_t i = 0; i < NB_INSTANTS; i++) {
+		instants[i] = i * 1000;
+	}
+	start = Benchmark_now();
+	for (size_t i = 0; i < NB_REPETITIONS; i++) {
+		NodesComponents components = Stream_components_at_instants(&full, instants, NB_INSTANTS);
+		sink += components.components[0];
+		NodesComponents_destroy(components);
+	}
+	Benchmark_report("components of the nodes at 10 instants", Benchmark_now() - start, NB_REPETITIONS);
+	(void)sink;
+
+	FullStreamGraph_destroy(full);
+	StreamGraph_destroy(sg);
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+// Measures the cost of dispatching a call to the functions of a Stream.
+// The switch reproduces how the metrics used to find the functions of a Stream, copying the whole table on every call.
+
+#include "../src/metrics.h"
+#include "../src/stream.h"
+#include "../src/stream/chunk_stream.h"
+#include "../src/stream/chunk_stream_small.h"
+#include "../src/stream/full_stream_graph.h"
+#include "../src/stream/link_stream.h"
+#include "../src/stream_functions.h"
+#include "../src/stream_graph.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <time.h>
+
+#define NB_CALLS 10000000
+
+static double now_seconds(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+}
+
+__attribute__((noinline)) static Interval lifespan_through_switch(Stream* stream) {
+	StreamFunctions stream_functions;
+	switch (stream->type) {
+		case FULL_STREAM_GRAPH: {
+			stream_functions = FullStreamGraph_stream_functions;
+			break;
+		}
+		case LINK_STREAM: {
+			stream_functions = LinkStream_stream_functions;
+			break;
+		}
+		case CHUNK_STREAM: {
+			stream_functions = ChunkStream_stream_functions;
+			break;
+		}
+		case CHUNK_STREAM_SMALL: {
+			stream_functions = ChunkStreamSmall_stream_functions;
+			break;
+		}
+		default: {
+			return Interval_from(0, 0);
+		}
+	}
+	return stream_functions.lifespan(stream->stream);
+}
+
+__attribute__((noinline)) static Interval lifespan_through_table(Stream* stream) {
+	return stream->stream_functions->lifespan(stream->stream);
+}
+
+static void report(const char* name, double seconds) {
+	printf("%-28s %8.2f ns/call\n", name, seconds * 1e9 / NB_CALLS);
+}
+
+int main() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	Stream st = FullStreamGraph_from(&sg);
+	volatile size_t sink = 0;
+
+	double start = now_seconds();
+	for (size_t i = 0; i < NB_CALLS; i++) {
+		sink += lifespan_through_switch(&st).end;
+	}
+	report("lifespan (switch + copy)", now_seconds() - start);
+
+	start = now_seconds();
+	for (size_t i = 0; i < NB_CALLS; i++) {
+		sink += lifespan_through_table(&st).end;
+	}
+	report("lifespan (table pointer)", now_seconds() - start);
+
+	// Every cardinal it needs is cached after the first call, so this is mostly dispatch
+	start = now_seconds();
+	for (size_t i = 0; i < NB_CALLS; i++) {
+		sink += (size_t)Stream_coverage(&st);
+	}
+	report("Stream_coverage (cached)", now_seconds() - start);
+
+	(void)sink;
+	FullStreamGraph_destroy(st);
+	StreamGraph_destroy(sg);
+	return 0;
+}
\ No newline at end of file
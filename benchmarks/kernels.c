@@ -0,0 +1,85 @@
+// Compares the specialised kernels of the metrics with the generic path through the iterators.
+// Each repetition starts from an empty cache, so that everything is computed again.
+
+#include "../src/metrics.h"
+#include "../src/stream.h"
+#include "../src/stream/chunk_stream.h"
+#include "../src/stream/full_stream_graph.h"
+#include "benchmark.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+#define NB_REPETITIONS 20
+
+static const MetricsFunctions no_specialisation = {0};
+
+static void run(const char* name, Stream* stream, bool specialised, double (*metric)(Stream*)) {
+	volatile double sink = 0;
+	double start = Benchmark_now();
+	for (size_t i = 0; i < NB_REPETITIONS; i++) {
+		Stream fresh = *stream;
+		if (!specialised) {
+			fresh.metrics_functions = &no_specialisation;
+		}
+		init_cache(&fresh);
+		sink += metric(&fresh);
+		destroy_cache(fresh);
+	}
+	(void)sink;
+	char label[64];
+	snprintf(label, sizeof(label), "%s (%s)", name, specialised ? "specialised" : "generic");
+	Benchmark_report(label, Benchmark_now() - start, NB_REPETITIONS);
+}
+
+static double cardinals(Stream* stream) {
+	return (double)(cardinalOfV(stream) + cardinalOfW(stream) + cardinalOfE(stream));
+}
+
+static double degree_sums(Stream* stream) {
+	MetricValues degrees = Stream_degree_of_all_nodes(stream);
+	double sum = degrees.values[0];
+	MetricValues_destroy(degrees);
+	return sum;
+}
+
+static double densities_of_links(Stream* stream) {
+	MetricValues densities = Stream_density_of_all_links(stream);
+	double sum = densities.values[0];
+	MetricValues_destroy(densities);
+	return sum;
+}
+
+static void run_all(const char* stream_name, Stream* stream) {
+	printf("%s\n", stream_name);
+	for (int specialised = 0; specialised <= 1; specialised++) {
+		run("cardinals", stream, specialised, cardinals);
+		run("degree of all nodes", stream, specialised, degree_sums);
+		run("density of all links", stream, specialised, densities_of_links);
+	}
+}
+
+int main() {
+	StreamGraph sg = Benchmark_random_stream_graph(2000, 20000, 4, 100000, 42);
+
+	Stream full = FullStreamGraph_from(&sg);
+	run_all("FullStreamGraph", &full);
+	FullStreamGraph_destroy(full);
+
+	NodeIdVector nodes = NodeIdVector_new();
+	for (size_t i = 0; i < sg.nodes.nb_nodes; i += 2) {
+		NodeIdVector_push(&nodes, i);
+	}
+	LinkIdVector links = LinkIdVector_new();
+	for (size_t i = 0; i < sg.links.nb_links; i++) {
+		LinkIdVector_push(&links, i);
+	}
+	Stream chunk = CS_from(&sg, &nodes, &links, 25000, 75000);
+	run_all("ChunkStream", &chunk);
+	CS_destroy(chunk);
+	NodeIdVector_destroy(nodes);
+	LinkIdVector_destroy(links);
+
+	StreamGraph_destroy(sg);
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+// Measures the temporal paths from every node, on a single thread and on every processor.
+// The Timeline and the graph of the links are built once per run, then each source sweeps every event.
+
+#include "../src/paths.h"
+#include "../src/stream.h"
+#include "../src/stream/full_stream_graph.h"
+#include "../src/thread_pool.h"
+#include "benchmark.h"
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#define NB_REPETITIONS 3
+
+static void count_reached(const TemporalPaths* paths, void* data) {
+	size_t nb_reached = 0;
+	for (size_t i = 0; i < paths->nb_node_ids; i++) {
+		nb_reached += paths->earliest_arrivals[i] != PATHS_UNREACHABLE;
+	}
+	atomic_fetch_add_explicit((atomic_size_t*)data, nb_reached, memory_order_relaxed);
+}
+
+static void run(Stream* stream, size_t nb_workers) {
+	ThreadPool_set_global_nb_workers(nb_workers);
+	atomic_size_t nb_reached = 0;
+	double start = Benchmark_now();
+	for (size_t i = 0; i < NB_REPETITIONS; i++) {
+		Stream_temporal_paths_from_all_nodes(stream, 0, count_reached, &nb_reached);
+	}
+	char label[64];
+	snprintf(label, sizeof(label), "paths from all nodes (%zu workers)", ThreadPool_nb_workers(ThreadPool_global()));
+	Benchmark_report(label, Benchmark_now() - start, NB_REPETITIONS);
+	ThreadPool_set_global_nb_workers(1);
+}
+
+int main() {
+	StreamGraph sg = Benchmark_random_stream_graph(500, 5000, 2, 10000, 42);
+	Stream full = FullStreamGraph_from(&sg);
+	printf("FullStreamGraph\n");
+	// 0 workers uses every processor online
+	run(&full, 1);
+	run(&full, 0);
+	FullStreamGraph_destroy(full);
+	StreamGraph_destroy(sg);
+	return 0;
+}
\ No newline at end of file
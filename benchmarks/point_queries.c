@@ -0,0 +1,107 @@
+// Measures the batched presence queries against answering each query on its own.
+// The nodes are present during the whole lifespan, so the queries are about links, each present during 2 intervals.
+
+#include "../src/point_queries.h"
+#include "../src/stream.h"
+#include "../src/stream/full_stream_graph.h"
+#include "../src/stream_functions.h"
+#include "benchmark.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NB_REPETITIONS 3
+#define NB_QUERIES	   1000000
+#define NB_INSTANTS	   100
+#define LIFESPAN	   10000
+
+int main() {
+	StreamGraph sg = Benchmark_random_stream_graph(100000, 1000000, 2, LIFESPAN, 42);
+	Stream full = FullStreamGraph_from(&sg);
+	printf("FullStreamGraph\n");
+
+	srand(7);
+	PresenceQuery* queries = MALLOC(NB_QUERIES * sizeof(PresenceQuery));
+	for (size_t i = 0; i < NB_QUERIES; i++) {
+		queries[i] = (PresenceQuery){.id = (size_t)rand() % 1000000, .instant = (size_t)rand() % LIFESPAN};
+	}
+	bool* answers = MALLOC(NB_QUERIES * sizeof(bool));
+
+	volatile size_t sink = 0;
+	double start = Benchmark_now();
+	for (size_t i = 0; i < NB_REPETITIONS; i++) {
+		Stream_are_links_present(&full, queries, NB_QUERIES, answers);
+		sink += answers[0];
+	}
+	Benchmark_report("1M link presence queries, batched", Benchmark_now() - start, NB_REPETITIONS);
+
+	start = Benchmark_now();
+	for (size_t i = 0; i < NB_REPETITIONS; i++) {
+		for (size_t q = 0; q < NB_QUERIES; q++) {
+			bool present = false;
+			TimesIterator times = full.stream_functions->times_link_present(full.stream, queries[q].id);
+			FOR_EACH_TIME(interval, times) {
+				present |= interval.start <= queries[q].instant && queries[q].instant < interval.end;
+			}
+			answers[q] = present;
+		}
+		sink += answers[0];
+	}
+	Benchmark_report("1M link presence queries, one by one", Benchmark_now() - start, NB_REPETITIONS);
+
+	TimeId instants[NB_INSTANTS];
+	for (size_t i = 0; i < NB_INSTANTS; i++) {
+		instants[i] = (NB_INSTANTS - i) * (LIFESPAN / NB_INSTANTS) - 1;
+	}
+	start = Benchmark_now();
+	for (size_t i = 0; i < NB_REPETITIONS; i++) {
+		LinksAtInstants links = Stream_links_present_at_instants(&full, instants, NB_INSTANTS);
+		sink += links.offsets[NB_INSTANTS];
+		LinksAtInstants_destroy(links);
+	}
+	Benchmark_report("links present at 100 instants, batched", Benchmark_now() - start, NB_REPETITIONS);
+
+	// The events table stores the links present at each key moment where some disappear, which doesn't fit in memory
+	// for the graph above, so it is measured on a smaller one, with and without it
+	StreamGraph small_sg = Benchmark_random_stream_graph(200, 2000, 2, LIFESPAN, 42);
+	Stream small = FullStreamGraph_from(&small_sg);
+	printf("FullStreamGraph, 2000 links\n");
+	start = Benchmark_now();
+	for (size_t i = 0; i < NB_REPETITIONS; i++) {
+		LinksAtInstants links = Stream_links_present_at_instants(&small, instants, NB_INSTANTS);
+		sink += links.offsets[NB_INSTANTS];
+		LinksAtInstants_destroy(links);
+	}
+	Benchmark_report("links present at 100 instants, scanned", Benchmark_now() - start, NB_REPETITIONS);
+
+	start = Benchmark_now();
+	init_events_table(&small_sg);
+	Benchmark_report("building the events table", Benchmark_now() - start, 1);
+	start = Benchmark_now();
+	for (size_t i = 0; i < NB_REPETITIONS; i++) {
+		LinksAtInstants links = Stream_links_present_at_instants(&small, instants, NB_INSTANTS);
+		sink += links.offsets[NB_INSTANTS];
+		LinksAtInstants_destroy(links);
+	}
+	Benchmark_report("links present at 100 instants, from the events", Benchmark_now() - start, NB_REPETITIONS);
+	start = Benchmark_now();
+	for (size_t i = 0; i < NB_REPETITIONS; i++) {
+		for (size_t t = 0; t < NB_INSTANTS; t++) {
+			LinksIterator links = small.stream_functions->links_present_at_t(small.stream, instants[t]);
+			sink += COUNT_ITERATOR(links);
+		}
+	}
+	Benchmark_report("links present at 100 instants, one by one", Benchmark_now() - start, NB_REPETITIONS);
+	(void)sink;
+
+	free(answers);
+	free(queries);
+	events_destroy(&small_sg);
+	FullStreamGraph_destroy(small);
+	StreamGraph_destroy(small_sg);
+	FullStreamGraph_destroy(full);
+	StreamGraph_destroy(sg);
+	return 0;
+}
\ No newline at end of file
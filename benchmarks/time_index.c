@@ -0,0 +1,61 @@
+// Measures the total times of ChunkStreams with every node and link over windows of time, summed over the presence
+// intervals against read from the TimeIndex. Each window uses a new Stream, so that its cardinals are not cached.
+
+#include "../src/metrics.h"
+#include "../src/stream.h"
+#include "../src/stream/chunk_stream.h"
+#include "benchmark.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+#define NB_WINDOWS 100
+#define LIFESPAN   10000
+
+// Only the cardinals are timed, not the creation of the ChunkStreams
+static size_t total_times_of_windows(StreamGraph* sg, NodeIdVector* nodes, LinkIdVector* links, double* seconds) {
+	size_t sum = 0;
+	*seconds = 0;
+	for (size_t i = 0; i < NB_WINDOWS; i++) {
+		size_t start = i * (LIFESPAN / NB_WINDOWS);
+		Stream st = CS_from(sg, nodes, links, start, start + LIFESPAN / 10);
+		double start_seconds = Benchmark_now();
+		sum += cardinalOfW(&st) + cardinalOfE(&st);
+		*seconds += Benchmark_now() - start_seconds;
+		CS_destroy(st);
+	}
+	return sum;
+}
+
+int main() {
+	StreamGraph sg = Benchmark_random_stream_graph(100000, 1000000, 2, LIFESPAN, 42);
+	NodeIdVector nodes = NodeIdVector_with_capacity(sg.nodes.nb_nodes);
+	for (size_t i = 0; i < sg.nodes.nb_nodes; i++) {
+		NodeIdVector_push(&nodes, i);
+	}
+	LinkIdVector links = LinkIdVector_with_capacity(sg.links.nb_links);
+	for (size_t i = 0; i < sg.links.nb_links; i++) {
+		LinkIdVector_push(&links, i);
+	}
+	printf("ChunkStream\n");
+
+	double seconds;
+	size_t scanned = total_times_of_windows(&sg, &nodes, &links, &seconds);
+	Benchmark_report("cardinals of a window, scanned", seconds, NB_WINDOWS);
+
+	double start = Benchmark_now();
+	init_time_index(&sg);
+	Benchmark_report("building the time index", Benchmark_now() - start, 1);
+
+	size_t indexed = total_times_of_windows(&sg, &nodes, &links, &seconds);
+	Benchmark_report("cardinals of a window, indexed", seconds, NB_WINDOWS);
+	if (indexed != scanned) {
+		printf("The indexed cardinals differ from the scanned ones\n");
+		return 1;
+	}
+
+	NodeIdVector_destroy(nodes);
+	LinkIdVector_destroy(links);
+	StreamGraph_destroy(sg);
+	return 0;
+}
\ No newline at end of file
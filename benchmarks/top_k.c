@@ -0,0 +1,84 @@
+// Measures the top-k queries against computing the metric of every element and sorting it.
+// Each repetition uses a new Stream, so that the memo table doesn't hold the presence times of a previous one.
+
+#include "../src/metrics.h"
+#include "../src/stream.h"
+#include "../src/stream/full_stream_graph.h"
+#include "benchmark.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NB_REPETITIONS 3
+#define K			   10
+
+static int compare_decreasing(const void* a, const void* b) {
+	double value_a = *(const double*)a;
+	double value_b = *(const double*)b;
+	return (value_a < value_b) - (value_a > value_b);
+}
+
+static double sort_and_take_best(MetricValues values) {
+	qsort(values.values, values.nb_elements, sizeof(double), compare_decreasing);
+	double best = values.values[0];
+	MetricValues_destroy(values);
+	return best;
+}
+
+int main() {
+	StreamGraph sg = Benchmark_random_stream_graph(100000, 1000000, 2, 10000, 42);
+	printf("FullStreamGraph\n");
+
+	volatile double sink = 0;
+	double start = Benchmark_now();
+	for (size_t i = 0; i < NB_REPETITIONS; i++) {
+		Stream full = FullStreamGraph_from(&sg);
+		MetricValues best = Stream_most_present_nodes(&full, K);
+		sink += best.values[0];
+		MetricValues_destroy(best);
+		FullStreamGraph_destroy(full);
+	}
+	Benchmark_report("10 most present nodes", Benchmark_now() - start, NB_REPETITIONS);
+
+	start = Benchmark_now();
+	for (size_t i = 0; i < NB_REPETITIONS; i++) {
+		Stream full = FullStreamGraph_from(&sg);
+		sink += sort_and_take_best(Stream_contribution_of_all_nodes(&full));
+		FullStreamGraph_destroy(full);
+	}
+	Benchmark_report("contribution of all nodes, sorted", Benchmark_now() - start, NB_REPETITIONS);
+
+	start = Benchmark_now();
+	for (size_t i = 0; i < NB_REPETITIONS; i++) {
+		Stream full = FullStreamGraph_from(&sg);
+		MetricValues best = Stream_densest_links(&full, K);
+		sink += best.values[0];
+		MetricValues_destroy(best);
+		FullStreamGraph_destroy(full);
+	}
+	Benchmark_report("10 densest links", Benchmark_now() - start, NB_REPETITIONS);
+
+	start = Benchmark_now();
+	for (size_t i = 0; i < NB_REPETITIONS; i++) {
+		Stream full = FullStreamGraph_from(&sg);
+		sink += sort_and_take_best(Stream_density_of_all_links(&full));
+		FullStreamGraph_destroy(full);
+	}
+	Benchmark_report("density of all links, sorted", Benchmark_now() - start, NB_REPETITIONS);
+
+	start = Benchmark_now();
+	for (size_t i = 0; i < NB_REPETITIONS; i++) {
+		Stream full = FullStreamGraph_from(&sg);
+		size_t nb_instants;
+		InstantMetrics* busiest = Stream_busiest_instants(&full, K, &nb_instants);
+		sink += (double)busiest[0].nb_links;
+		free(busiest);
+		FullStreamGraph_destroy(full);
+	}
+	Benchmark_report("10 busiest key moments", Benchmark_now() - start, NB_REPETITIONS);
+	(void)sink;
+
+	StreamGraph_destroy(sg);
+	return 0;
+}
\ No newline at end of file
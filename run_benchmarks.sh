@@ -0,0 +1,32 @@
+#!/bin/bash
+
+# Builds the library with the release flags and runs every benchmark in the benchmarks directory.
+# Run a single one with ./run_benchmarks.sh <name>, for benchmarks/<name>.c
+
+CC=gcc
+CFLAGS="-Wall -Wextra -O3 -Wno-unused-function -std=c2x -pthread"
+
+BENCHMARK_DIR=benchmarks
+BIN_DIR=bin
+
+mkdir -p $BIN_DIR
+make metrics FLAGS=-O3 2> /dev/null || { echo "Could not build the library"; exit 1; }
+
+if [ $# -eq 1 ]; then
+    files=$BENCHMARK_DIR/$1.c
+else
+    files=$BENCHMARK_DIR/*.c
+fi
+
+global_success=0
+for file in $files; do
+    filename=$(basename $file .c)
+    echo "Running benchmark: $filename"
+    $CC $CFLAGS -o $BIN_DIR/benchmark_$filename $file $BIN_DIR/metrics.a -lm -pthread || { global_success=1; continue; }
+    $BIN_DIR/benchmark_$filename || global_success=1
+    echo ""
+done
+
+# Leave the library built with the default flags for the tests
+make metrics 2> /dev/null
+exit $global_success
\ No newline at end of file
@@ -1,7 +1,7 @@
 #!/bin/bash
 
 CC=gcc
-CFLAGS="-Wall -Wextra -g -Wno-unused-function"
+CFLAGS="-Wall -Wextra -g -Wno-unused-function -pthread"
 
 SRC_DIR=src
 TEST_DIR=tests
@@ -37,9 +37,9 @@ if [ $# -eq 1 ]; then
     else
         make $filename
         if [ -f $BIN_DIR/$filename.a ]; then
-            $CC $CFLAGS -o $BIN_DIR/test_$filename $TEST_DIR/$filename.c $BIN_DIR/$filename.a $BIN_DIR/test.o
+            $CC $CFLAGS -o $BIN_DIR/test_$filename $TEST_DIR/$filename.c $BIN_DIR/$filename.a $BIN_DIR/test.o -lm -pthread
         else
-            $CC $CFLAGS -o $BIN_DIR/test_$filename $TEST_DIR/$filename.c $BIN_DIR/$filename.o $BIN_DIR/test.o
+            $CC $CFLAGS -o $BIN_DIR/test_$filename $TEST_DIR/$filename.c $BIN_DIR/$filename.o $BIN_DIR/test.o -lm -pthread
         fi
     fi
 
@@ -82,9 +82,9 @@ for file in $TEST_DIR/*.c; do
         make $filename
         # If the compilation produced a .a file, use it instead of the .o file
         if [ -f $BIN_DIR/$filename.a ]; then
-            $CC -Wno-unused-function -g -o $BIN_DIR/test_$filename $file $BIN_DIR/$filename.a $BIN_DIR/test.o
+            $CC -Wno-unused-function -g -o $BIN_DIR/test_$filename $file $BIN_DIR/$filename.a $BIN_DIR/test.o -lm -pthread
         else
-            $CC -Wno-unused-function -g -o $BIN_DIR/test_$filename $file $BIN_DIR/$filename.o $BIN_DIR/test.o
+            $CC -Wno-unused-function -g -o $BIN_DIR/test_$filename $file $BIN_DIR/$filename.o $BIN_DIR/test.o -lm -pthread
         fi
     fi
 
@@ -1,23 +1,44 @@
 #include "bit_array.h"
 #include "utils.h"
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 
-// Using an int because it is the biggest type that can be used with bitwise shifting operations that doesn't fuck up
-const size_t MASK_SIZE = sizeof(int);
+// The loops over whole arrays are compiled twice on x86-64, with and without AVX2, and the best one for the processor
+// is picked when the program is loaded. The searches use popcnt when the processor has it.
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+#	define BULK_LOOP __attribute__((target_clones("avx2", "default")))
+#	define POPCOUNT_LOOP __attribute__((target_clones("popcnt", "default")))
+#else
+#	define BULK_LOOP
+#	define POPCOUNT_LOOP
+#endif
 
-size_t nb_bytes(size_t nb_bits) {
-	return (nb_bits / MASK_SIZE) + 1;
+static size_t nb_words(size_t nb_bits) {
+	return (nb_bits / BIT_ARRAY_WORD_SIZE) + 1;
+}
+
+static size_t word_index(size_t index) {
+	return index / BIT_ARRAY_WORD_SIZE;
+}
+
+static uint64_t bit_mask(size_t index) {
+	return (uint64_t)1 << (index % BIT_ARRAY_WORD_SIZE);
+}
+
+// The bits of the last word which are not in the array
+static uint64_t tail_mask(size_t nb_bits) {
+	return ~((uint64_t)0) << (nb_bits % BIT_ARRAY_WORD_SIZE);
 }
 
 BitArray BitArray_with_n_bits(size_t nb_bits) {
-	BitArray bit_array = (BitArray){.nb_bits = nb_bits, .bits = MALLOC(nb_bytes(nb_bits) * MASK_SIZE)};
+	BitArray bit_array = (BitArray){.nb_bits = nb_bits, .bits = MALLOC(nb_words(nb_bits) * sizeof(uint64_t))};
 	return bit_array;
 }
 
 BitArray BitArray_n_zeros(size_t nb_bits) {
 	BitArray bit_array = BitArray_with_n_bits(nb_bits);
-	for (size_t i = 0; i < nb_bytes(nb_bits); i++) {
+	for (size_t i = 0; i < nb_words(nb_bits); i++) {
 		bit_array.bits[i] = 0;
 	}
 	return bit_array;
@@ -25,23 +46,15 @@ BitArray BitArray_n_zeros(size_t nb_bits) {
 
 BitArray BitArray_n_ones(size_t nb_bits) {
 	BitArray bit_array = BitArray_with_n_bits(nb_bits);
-	for (size_t i = 0; i < nb_bytes(nb_bits); i++) {
-		bit_array.bits[i] = ~0;
+	for (size_t i = 0; i < nb_words(nb_bits); i++) {
+		bit_array.bits[i] = ~((uint64_t)0);
 	}
+	bit_array.bits[nb_words(nb_bits) - 1] &= ~tail_mask(nb_bits);
 	return bit_array;
 }
 
-const size_t BYTE_SIZE = 8;
-size_t byte_index(size_t index) {
-	return (index / (MASK_SIZE * BYTE_SIZE));
-}
-
-size_t bit_index(size_t index) {
-	return index % (MASK_SIZE * BYTE_SIZE);
-}
-
 bool BitArray_is_one(BitArray array, size_t index) {
-	return (array.bits[byte_index(index)] & (1 << bit_index(index))) != 0;
+	return (array.bits[word_index(index)] & bit_mask(index)) != 0;
 }
 
 bool BitArray_is_zero(BitArray array, size_t index) {
@@ -49,34 +62,66 @@ bool BitArray_is_zero(BitArray array, size_t index) {
 }
 
 void BitArray_set_one(BitArray array, size_t index) {
-	array.bits[byte_index(index)] |= (1 << bit_index(index));
+	array.bits[word_index(index)] |= bit_mask(index);
 }
 
 void BitArray_set_zero(BitArray array, size_t index) {
-	array.bits[byte_index(index)] &= ~(1 << bit_index(index));
+	array.bits[word_index(index)] &= ~bit_mask(index);
 }
 
 void BitArray_and_bit(BitArray array, size_t index, int value) {
-	array.bits[byte_index(index)] &= value ? (1 << bit_index(index)) : ~(1 << bit_index(index));
+	if (!value) {
+		BitArray_set_zero(array, index);
+	}
 }
 
 void BitArray_or_bit(BitArray array, size_t index, int value) {
-	array.bits[byte_index(index)] |= value ? (1 << bit_index(index)) : ~(1 << bit_index(index));
+	if (value) {
+		BitArray_set_one(array, index);
+	}
 }
 
-BitArray BitArray_and_array(BitArray array1, BitArray array2) {
-	BitArray result = BitArray_with_n_bits(array1.nb_bits);
-	for (size_t i = 0; i < nb_bytes(array1.nb_bits); i++) {
-		result.bits[i] = array1.bits[i] & array2.bits[i];
+BULK_LOOP void BitArray_and_in_place(BitArray array1, BitArray array2) {
+	for (size_t i = 0; i < nb_words(array1.nb_bits); i++) {
+		array1.bits[i] &= array2.bits[i];
+	}
+}
+
+BULK_LOOP void BitArray_or_in_place(BitArray array1, BitArray array2) {
+	for (size_t i = 0; i < nb_words(array1.nb_bits); i++) {
+		array1.bits[i] |= array2.bits[i];
 	}
+}
+
+BULK_LOOP void BitArray_andnot_in_place(BitArray array1, BitArray array2) {
+	for (size_t i = 0; i < nb_words(array1.nb_bits); i++) {
+		array1.bits[i] &= ~array2.bits[i];
+	}
+}
+
+static BitArray BitArray_copy(BitArray array) {
+	BitArray copy = BitArray_with_n_bits(array.nb_bits);
+	for (size_t i = 0; i < nb_words(array.nb_bits); i++) {
+		copy.bits[i] = array.bits[i];
+	}
+	return copy;
+}
+
+BitArray BitArray_and_array(BitArray array1, BitArray array2) {
+	BitArray result = BitArray_copy(array1);
+	BitArray_and_in_place(result, array2);
 	return result;
 }
 
 BitArray BitArray_or_array(BitArray array1, BitArray array2) {
-	BitArray result = BitArray_with_n_bits(array1.nb_bits);
-	for (size_t i = 0; i < nb_bytes(array1.nb_bits); i++) {
-		result.bits[i] = array1.bits[i] | array2.bits[i];
-	}
+	BitArray result = BitArray_copy(array1);
+	BitArray_or_in_place(result, array2);
+	return result;
+}
+
+BitArray BitArray_andnot_array(BitArray array1, BitArray array2) {
+	BitArray result = BitArray_copy(array1);
+	BitArray_andnot_in_place(result, array2);
 	return result;
 }
 
@@ -94,26 +139,44 @@ char* BitArray_to_string(BitArray array) {
 	return str;
 }
 
-// Returns the number of leading zeros in the bit array starting from the given index
-// TODO : optimise this function with clz (count leading zeros) instruction
-size_t BitArray_leading_zeros_from(BitArray array, size_t index) {
-	/*while (index < array.nb_bits) {
-		size_t byte = byte_index(index);
-		size_t bit = bit_index(index);
-		size_t leading_zeros = __builtin_clz(array.bits[byte] << bit);
-		if (leading_zeros < BYTE_SIZE - bit) {
-			return leading_zeros;
-		}
-		index += BYTE_SIZE - bit;
+size_t BitArray_next_one(BitArray array, size_t index) {
+	if (index >= array.nb_bits) {
+		return array.nb_bits;
 	}
-	return 0;*/
-	size_t leading_zeros = 0;
-	while (index < array.nb_bits) {
-		if (BitArray_is_one(array, index)) {
-			return leading_zeros;
+	size_t word = word_index(index);
+	// Ignore the bits before the index in the first word
+	uint64_t bits = array.bits[word] & (~((uint64_t)0) << (index % BIT_ARRAY_WORD_SIZE));
+	size_t last_word = word_index(array.nb_bits - 1);
+	while (bits == 0) {
+		if (word == last_word) {
+			return array.nb_bits;
 		}
-		leading_zeros++;
-		index++;
+		word++;
+		bits = array.bits[word];
+	}
+	size_t next = (word * BIT_ARRAY_WORD_SIZE) + (size_t)__builtin_ctzll(bits);
+	return next < array.nb_bits ? next : array.nb_bits;
+}
+
+size_t BitArray_leading_zeros_from(BitArray array, size_t index) {
+	if (index >= array.nb_bits) {
+		return 0;
+	}
+	return BitArray_next_one(array, index) - index;
+}
+
+size_t BitArray_count_ones(BitArray array) {
+	return BitArray_rank(array, array.nb_bits);
+}
+
+POPCOUNT_LOOP size_t BitArray_rank(BitArray array, size_t index) {
+	size_t count = 0;
+	size_t full_words = word_index(index);
+	for (size_t i = 0; i < full_words; i++) {
+		count += (size_t)__builtin_popcountll(array.bits[i]);
+	}
+	if (index % BIT_ARRAY_WORD_SIZE != 0) {
+		count += (size_t)__builtin_popcountll(array.bits[full_words] & ~tail_mask(index));
 	}
-	return leading_zeros;
+	return count;
 }
\ No newline at end of file
@@ -8,20 +8,23 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 /**
  * @brief The structure of a variable length array of bits.
  *
  * It contains the number of bits present in the array and the array of bits.
- * The bits are stored in an array of int's.
- * I used an array of int to have less computations to do when oring or anding two arrays.
- * It is not possible to go higher than an int otherwise some functions will not work.
+ * The bits are stored in 64 bits words, bit i being the bit i % 64 of the word i / 64, so that the operations on whole
+ * arrays and the searches for the next 1 work a word at a time, with the popcount and count trailing zeros
+ * instructions. The bits of the last word after nb_bits are kept to 0 by the functions which set whole words.
  */
 typedef struct {
 	size_t nb_bits; /**< The number of bits in the array. */
-	int* bits;		/**< The array of bits. */
+	uint64_t* bits; /**< The words of the array. */
 } BitArray;
 
+#define BIT_ARRAY_WORD_SIZE 64 /**< The number of bits in a word of a BitArray. */
+
 /**
  * @name Creation and destruction functions
  * Functions to create and destroy a BitArray.
@@ -109,6 +112,28 @@ void BitArray_or_bit(BitArray array, size_t index, int value); /**< Like BitArra
  */
 BitArray BitArray_and_array(BitArray array1, BitArray array2);
 BitArray BitArray_or_array(BitArray array1, BitArray array2); /**< Like BitArray_and_array but performs a bitwise or. */
+/** Like BitArray_and_array but keeps the bits of array1 which are not in array2. */
+BitArray BitArray_andnot_array(BitArray array1, BitArray array2);
+
+/**
+ * @brief Performs a bitwise and between two BitArrays, and stores the result in the first one.
+ *
+ * The two BitArrays must have the same number of bits.
+ * @param[in, out] array1 The first BitArray, which receives the result.
+ * @param[in] array2 The second BitArray.
+ */
+void BitArray_and_in_place(BitArray array1, BitArray array2);
+void BitArray_or_in_place(BitArray array1, BitArray array2);	 /**< Like BitArray_and_in_place but with a bitwise or. */
+void BitArray_andnot_in_place(BitArray array1, BitArray array2); /**< Like BitArray_and_in_place but with and not. */
+
+/** @} */
+
+/**
+ * @name Searching and counting
+ * They work a word at a time, so they cost O(number of words) instead of O(number of bits).
+ * @{
+ */
+
 /**
  * @brief Returns the number of leading zeros in the BitArray starting from the given index.
  *
@@ -119,6 +144,37 @@ BitArray BitArray_or_array(BitArray array1, BitArray array2); /**< Like BitArray
  */
 size_t BitArray_leading_zeros_from(BitArray array, size_t index);
 
+/**
+ * @brief Returns the index of the first 1 at or after the given index, or nb_bits if there is none.
+ * @param[in] array The BitArray.
+ * @param[in] index The index to start from.
+ */
+size_t BitArray_next_one(BitArray array, size_t index);
+
+/**
+ * @brief Returns the number of 1s in the BitArray.
+ * @param[in] array The BitArray.
+ */
+size_t BitArray_count_ones(BitArray array);
+
+/**
+ * @brief Returns the number of 1s strictly before the given index.
+ * @param[in] array The BitArray.
+ * @param[in] index The index, at most nb_bits.
+ */
+size_t BitArray_rank(BitArray array, size_t index);
+
+/**
+ * @brief Loops over the indexes of the 1s of a BitArray, in increasing order.
+ *
+ * Costs O(number of words + number of 1s).
+ * @param[in] index The name of the index variable, declared by the macro.
+ * @param[in] array The BitArray.
+ */
+#define BIT_ARRAY_FOR_EACH_ONE(index, array)                                                                           \
+	for (size_t index = BitArray_next_one((array), 0); (index) < (array).nb_bits;                                      \
+		 (index) = BitArray_next_one((array), (index) + 1))
+
 /** @} */
 
 /**
@@ -0,0 +1,464 @@
+#include "cliques.h"
+#include "instrumentation.h"
+#include "interval.h"
+#include "iterators.h"
+#include "stream/chunk_stream.h"
+#include "stream_functions.h"
+#include "thread_pool.h"
+#include "utils.h"
+#include "vector.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// The searches from the nodes late in the degeneracy order have the most candidates, so the chunks are kept small
+#define STARTING_NODES_PER_CHUNK 8
+// The index of the ids which are not nodes of the Stream, and of a missing link or entry
+#define NO_NODE	 SIZE_MAX
+#define NO_LINK	 SIZE_MAX
+#define NO_ENTRY SIZE_MAX
+
+// A link, seen from one of its nodes
+typedef struct {
+	size_t node; // The index of the other node
+	LinkId link;
+} CliqueEdge;
+
+static char* CliqueEdge_to_string(const CliqueEdge* edge) {
+	char* str = MALLOC(64);
+	snprintf(str, 64, "(%zu, %zu)", edge->node, edge->link);
+	return str;
+}
+
+static bool CliqueEdge_equals(CliqueEdge a, CliqueEdge b) {
+	return a.node == b.node && a.link == b.link;
+}
+
+DefVector(CliqueEdge, NO_FREE(CliqueEdge));
+
+// The graph of the links of a Stream, with its nodes in a degeneracy order : each node has at most k neighbours later
+// in the order, with k the degeneracy of the graph, which bounds the candidates of the top level of the searches.
+typedef struct {
+	size_t nb_nodes;
+	NodeId* ids;
+	size_t max_degree;
+	size_t* offsets;			  // The neighbours of the node i are the edges from offsets[i] to offsets[i + 1]
+	CliqueEdge* edges;			  // The neighbours of each node, sorted by index
+	size_t nb_link_ids;			  // The largest link id plus one, 0 if there are no links
+	IntervalsSet* links_presence; // Indexed by link id, empty for the links absent from the Stream
+	size_t* order;				  // The indexes of the nodes, in a degeneracy order
+	size_t* rank_of_node;		  // The position of each node in order
+} CliqueGraph;
+
+static int CliqueEdge_compare(const void* a, const void* b) {
+	size_t node_a = ((const CliqueEdge*)a)->node;
+	size_t node_b = ((const CliqueEdge*)b)->node;
+	return (node_a > node_b) - (node_a < node_b);
+}
+
+// The order in which the nodes of smallest degree are removed one by one, with their degrees in buckets updated as
+// their neighbours are removed, in O(V + E) (Batagelj and Zaversnik)
+static void order_by_degeneracy(CliqueGraph* graph) {
+	size_t nb_nodes = graph->nb_nodes;
+	size_t* degrees = MALLOC((nb_nodes + 1) * sizeof(size_t));
+	size_t max_degree = 0;
+	for (size_t i = 0; i < nb_nodes; i++) {
+		degrees[i] = graph->offsets[i + 1] - graph->offsets[i];
+		max_degree = degrees[i] > max_degree ? degrees[i] : max_degree;
+	}
+	// The nodes sorted by degree, with the first position of each degree
+	size_t* bucket_starts = calloc(max_degree + 2, sizeof(size_t));
+	for (size_t i = 0; i < nb_nodes; i++) {
+		bucket_starts[degrees[i] + 1]++;
+	}
+	for (size_t d = 1; d <= max_degree + 1; d++) {
+		bucket_starts[d] += bucket_starts[d - 1];
+	}
+	size_t* sorted = graph->order;
+	size_t* positions = graph->rank_of_node;
+	for (size_t i = 0; i < nb_nodes; i++) {
+		positions[i] = bucket_starts[degrees[i]]++;
+		sorted[positions[i]] = i;
+	}
+	for (size_t d = max_degree + 1; d > 0; d--) {
+		bucket_starts[d] = bucket_starts[d - 1];
+	}
+	bucket_starts[0] = 0;
+
+	// Removing a node moves each of its neighbours of larger degree to the start of its bucket, then to the bucket
+	// below, so that the nodes before the current position are the ones removed
+	for (size_t i = 0; i < nb_nodes; i++) {
+		size_t node = sorted[i];
+		for (size_t e = graph->offsets[node]; e < graph->offsets[node + 1]; e++) {
+			size_t neighbour = graph->edges[e].node;
+			if (degrees[neighbour] > degrees[node]) {
+				size_t degree = degrees[neighbour];
+				size_t first = sorted[bucket_starts[degree]];
+				if (first != neighbour) {
+					sorted[positions[neighbour]] = first;
+					sorted[bucket_starts[degree]] = neighbour;
+					positions[first] = positions[neighbour];
+					positions[neighbour] = bucket_starts[degree];
+				}
+				bucket_starts[degree]++;
+				degrees[neighbour]--;
+			}
+		}
+	}
+	free(bucket_starts);
+	free(degrees);
+}
+
+static CliqueGraph CliqueGraph_from(Stream* stream) {
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	void* st = stream->stream;
+	CliqueGraph graph = {0};
+
+	NodeIdVector ids = NodeIdVector_new();
+	size_t nb_node_ids = 0;
+	NodesIterator nodes = stream_functions->nodes_set(st);
+	FOR_EACH_NODE(node_id, nodes) {
+		NodeIdVector_push(&ids, node_id);
+		nb_node_ids = node_id + 1 > nb_node_ids ? node_id + 1 : nb_node_ids;
+	}
+	graph.nb_nodes = ids.size;
+	graph.ids = ids.array;
+	size_t* index_of_node = MALLOC((nb_node_ids + 1) * sizeof(size_t));
+	for (size_t i = 0; i < nb_node_ids; i++) {
+		index_of_node[i] = NO_NODE;
+	}
+	for (size_t i = 0; i < graph.nb_nodes; i++) {
+		index_of_node[graph.ids[i]] = i;
+	}
+
+	LinksIterator links_set = stream_functions->links_set(st);
+	FOR_EACH_LINK(link_id, links_set) {
+		graph.nb_link_ids = link_id + 1 > graph.nb_link_ids ? link_id + 1 : graph.nb_link_ids;
+	}
+	graph.links_presence = calloc(graph.nb_link_ids + 1, sizeof(IntervalsSet));
+
+	// The neighbours of each node, the presence of a link being collected from its first node
+	CliqueEdgeVector edges = CliqueEdgeVector_new();
+	graph.offsets = MALLOC((graph.nb_nodes + 1) * sizeof(size_t));
+	for (size_t i = 0; i < graph.nb_nodes; i++) {
+		graph.offsets[i] = edges.size;
+		LinksIterator neighbours = stream_functions->neighbours_of_node(st, graph.ids[i]);
+		FOR_EACH_LINK(link_id, neighbours) {
+			Link link = stream_functions->nth_link(st, link_id);
+			NodeId other = link.nodes[0] == graph.ids[i] ? link.nodes[1] : link.nodes[0];
+			CliqueEdgeVector_push(&edges, (CliqueEdge){.node = index_of_node[other], .link = link_id});
+			if (link.nodes[0] == graph.ids[i]) {
+				graph.links_presence[link_id] =
+					TimesIterator_collect(stream_functions->times_link_present(st, link_id));
+			}
+		}
+		size_t degree = edges.size - graph.offsets[i];
+		qsort(edges.array + graph.offsets[i], degree, sizeof(CliqueEdge), CliqueEdge_compare);
+		graph.max_degree = degree > graph.max_degree ? degree : graph.max_degree;
+	}
+	graph.offsets[graph.nb_nodes] = edges.size;
+	graph.edges = edges.array;
+	free(index_of_node);
+
+	graph.order = MALLOC((graph.nb_nodes + 1) * sizeof(size_t));
+	graph.rank_of_node = MALLOC((graph.nb_nodes + 1) * sizeof(size_t));
+	order_by_degeneracy(&graph);
+	return graph;
+}
+
+static void CliqueGraph_destroy(CliqueGraph graph) {
+	for (size_t i = 0; i < graph.nb_link_ids; i++) {
+		IntervalsSet_destroy(graph.links_presence[i]);
+	}
+	free(graph.links_presence);
+	free(graph.rank_of_node);
+	free(graph.order);
+	free(graph.edges);
+	free(graph.offsets);
+	free(graph.ids);
+}
+
+// The link between two nodes, by binary search in the neighbours of the first one
+static LinkId link_between(const CliqueGraph* graph, size_t u, size_t v) {
+	size_t low = graph->offsets[u];
+	size_t high = graph->offsets[u + 1];
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		if (graph->edges[middle].node < v) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low < graph->offsets[u + 1] && graph->edges[low].node == v ? graph->edges[low].link : NO_LINK;
+}
+
+// A candidate or excluded node of a level of the search, with the times during which it is linked to all the nodes of
+// the clique, which are the intervals from first to first + nb_intervals of the search
+typedef struct {
+	size_t node;
+	bool excluded;
+	size_t first;
+	size_t nb_intervals;
+} CliqueEntry;
+
+static char* CliqueEntry_to_string(const CliqueEntry* entry) {
+	char* str = MALLOC(64);
+	snprintf(str, 64, "%zu%s", entry->node, entry->excluded ? " (excluded)" : "");
+	return str;
+}
+
+static bool CliqueEntry_equals(CliqueEntry a, CliqueEntry b) {
+	return a.node == b.node && a.excluded == b.excluded && a.first == b.first && a.nb_intervals == b.nb_intervals;
+}
+
+DefVector(CliqueEntry, NO_FREE(CliqueEntry));
+
+// The state of the search of a worker. The entries and intervals of a level are pushed on top of the ones of its
+// parent, and popped when it returns, so only the levels of the current branch are kept.
+typedef struct {
+	const CliqueGraph* graph;
+	TemporalCliqueCallback callback;
+	void* data;
+	size_t* clique; // The indexes of the nodes of the current clique, at most the largest degree plus one
+	size_t nb_clique_nodes;
+	NodeId* reported; // The ids of the nodes of the clique being reported
+	CliqueEntryVector entries;
+	IntervalVector intervals;
+	IntervalVector scratch;
+} CliqueSearch;
+
+static CliqueSearch CliqueSearch_new(const CliqueGraph* graph, TemporalCliqueCallback callback, void* data) {
+	return (CliqueSearch){
+		.graph = graph,
+		.callback = callback,
+		.data = data,
+		.clique = MALLOC((graph->max_degree + 1) * sizeof(size_t)),
+		.nb_clique_nodes = 0,
+		.reported = MALLOC((graph->max_degree + 1) * sizeof(NodeId)),
+		.entries = CliqueEntryVector_new(),
+		.intervals = IntervalVector_new(),
+		.scratch = IntervalVector_new(),
+	};
+}
+
+static void CliqueSearch_destroy(CliqueSearch search) {
+	free(search.clique);
+	free(search.reported);
+	CliqueEntryVector_destroy(search.entries);
+	IntervalVector_destroy(search.intervals);
+	IntervalVector_destroy(search.scratch);
+}
+
+static const Interval* times_of(const CliqueSearch* search, size_t entry) {
+	return search->intervals.array + search->entries.array[entry].first;
+}
+
+// Pushes the intersection of two sorted sets of disjoint intervals, in a single merge
+static void push_intersection(IntervalVector* out, const Interval* a, size_t nb_a, const Interval* b, size_t nb_b) {
+	size_t i = 0;
+	size_t j = 0;
+	while (i < nb_a && j < nb_b) {
+		Interval intersection = Interval_intersection(a[i], b[j]);
+		if (Interval_size(intersection) > 0) {
+			IntervalVector_push(out, intersection);
+		}
+		if (a[i].end < b[j].end) {
+			i++;
+		}
+		else {
+			j++;
+		}
+	}
+}
+
+// Whether each interval of a is contained in one of b, both sorted sets of disjoint intervals
+static bool is_subset(const Interval* a, size_t nb_a, const Interval* b, size_t nb_b) {
+	size_t j = 0;
+	for (size_t i = 0; i < nb_a; i++) {
+		while (j < nb_b && b[j].end < a[i].end) {
+			j++;
+		}
+		if (j == nb_b || b[j].start > a[i].start) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Whether an interval is contained in one of a sorted set of disjoint intervals, by binary search
+static bool contains_interval(const Interval* set, size_t nb_intervals, Interval interval) {
+	size_t low = 0;
+	size_t high = nb_intervals;
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		if (set[middle].end < interval.end) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low < nb_intervals && set[low].start <= interval.start;
+}
+
+// Whether the node of the entry u is linked to the node of the entry v and to the clique whenever v is linked to the
+// clique, in which case the cliques with v but not u can be extended to u
+static bool covers(const CliqueSearch* search, size_t u, size_t v) {
+	const CliqueEntry* entries = search->entries.array;
+	LinkId link = link_between(search->graph, entries[u].node, entries[v].node);
+	if (link == NO_LINK) {
+		return false;
+	}
+	IntervalsSet presence = search->graph->links_presence[link];
+	return is_subset(times_of(search, v), entries[v].nb_intervals, times_of(search, u), entries[u].nb_intervals) &&
+		   is_subset(times_of(search, v), entries[v].nb_intervals, presence.intervals, presence.nb_intervals);
+}
+
+// The entry which covers the most candidates, to branch on as few of them as possible
+static size_t choose_pivot(const CliqueSearch* search, size_t begin, size_t end) {
+	size_t pivot = NO_ENTRY;
+	size_t most_covered = 0;
+	for (size_t u = begin; u < end; u++) {
+		size_t nb_covered = 0;
+		for (size_t v = begin; v < end; v++) {
+			if (v != u && !search->entries.array[v].excluded && covers(search, u, v)) {
+				nb_covered++;
+			}
+		}
+		if (pivot == NO_ENTRY || nb_covered > most_covered) {
+			pivot = u;
+			most_covered = nb_covered;
+		}
+	}
+	return pivot;
+}
+
+static int NodeId_compare(const void* a, const void* b) {
+	NodeId node_a = *(const NodeId*)a;
+	NodeId node_b = *(const NodeId*)b;
+	return (node_a > node_b) - (node_a < node_b);
+}
+
+// The intervals of the times of the clique which no candidate or excluded node is linked to the clique during
+static void report_maximal_intervals(CliqueSearch* search, size_t begin, size_t end, size_t first, size_t nb_times) {
+	for (size_t i = 0; i < search->nb_clique_nodes; i++) {
+		search->reported[i] = search->graph->ids[search->clique[i]];
+	}
+	qsort(search->reported, search->nb_clique_nodes, sizeof(NodeId), NodeId_compare);
+	for (size_t t = 0; t < nb_times; t++) {
+		Interval interval = search->intervals.array[first + t];
+		bool is_maximal = true;
+		for (size_t e = begin; e < end && is_maximal; e++) {
+			is_maximal = !contains_interval(times_of(search, e), search->entries.array[e].nb_intervals, interval);
+		}
+		if (is_maximal) {
+			TemporalClique clique = {
+				.nodes = search->reported,
+				.nb_nodes = search->nb_clique_nodes,
+				.interval = interval,
+			};
+			search->callback(&clique, search->data);
+		}
+	}
+}
+
+// Visits the current clique, whose times are the intervals from first to first + nb_times, with the entries from begin
+// to end as its candidate and excluded nodes, then the cliques extending it to the candidates the pivot doesn't cover
+static void expand(CliqueSearch* search, size_t begin, size_t end, size_t first, size_t nb_times) {
+	if (search->nb_clique_nodes >= 2) {
+		report_maximal_intervals(search, begin, end, first, nb_times);
+	}
+	size_t pivot = choose_pivot(search, begin, end);
+	for (size_t v = begin; v < end; v++) {
+		if (search->entries.array[v].excluded || (v != pivot && covers(search, pivot, v))) {
+			continue;
+		}
+		// The times of the other nodes with v, from which the nodes never linked to both are dropped
+		size_t child_begin = search->entries.size;
+		size_t child_first = search->intervals.size;
+		size_t node = search->entries.array[v].node;
+		for (size_t w = begin; w < end; w++) {
+			LinkId link = w == v ? NO_LINK : link_between(search->graph, node, search->entries.array[w].node);
+			if (link == NO_LINK) {
+				continue;
+			}
+			search->scratch.size = 0;
+			push_intersection(&search->scratch, times_of(search, w), search->entries.array[w].nb_intervals,
+							  times_of(search, v), search->entries.array[v].nb_intervals);
+			IntervalsSet presence = search->graph->links_presence[link];
+			size_t entry_first = search->intervals.size;
+			push_intersection(&search->intervals, search->scratch.array, search->scratch.size, presence.intervals,
+							  presence.nb_intervals);
+			if (search->intervals.size > entry_first) {
+				CliqueEntryVector_push(&search->entries, (CliqueEntry){
+															 .node = search->entries.array[w].node,
+															 .excluded = search->entries.array[w].excluded,
+															 .first = entry_first,
+															 .nb_intervals = search->intervals.size - entry_first,
+														 });
+			}
+		}
+		search->clique[search->nb_clique_nodes++] = node;
+		expand(search, child_begin, search->entries.size, search->entries.array[v].first,
+			   search->entries.array[v].nb_intervals);
+		search->nb_clique_nodes--;
+		search->entries.size = child_begin;
+		search->intervals.size = child_first;
+		search->entries.array[v].excluded = true;
+	}
+}
+
+// The cliques whose first node in the degeneracy order is the node : its later neighbours are the candidates, and the
+// earlier ones are excluded, with the presence of their link as times
+static void cliques_from_node(CliqueSearch* search, size_t node) {
+	const CliqueGraph* graph = search->graph;
+	for (size_t e = graph->offsets[node]; e < graph->offsets[node + 1]; e++) {
+		IntervalsSet presence = graph->links_presence[graph->edges[e].link];
+		if (presence.nb_intervals == 0) {
+			continue;
+		}
+		CliqueEntryVector_push(&search->entries, (CliqueEntry){
+													 .node = graph->edges[e].node,
+													 .excluded = graph->rank_of_node[graph->edges[e].node] <
+																 graph->rank_of_node[node],
+													 .first = search->intervals.size,
+													 .nb_intervals = presence.nb_intervals,
+												 });
+		IntervalVector_append(&search->intervals, presence.intervals, presence.nb_intervals);
+	}
+	search->clique[0] = node;
+	search->nb_clique_nodes = 1;
+	expand(search, 0, search->entries.size, 0, 0);
+	search->nb_clique_nodes = 0;
+	search->entries.size = 0;
+	search->intervals.size = 0;
+}
+
+typedef struct {
+	const CliqueGraph* graph;
+	TemporalCliqueCallback callback;
+	void* data;
+} CliquesContext;
+
+static void cliques_from_nodes(void* context, size_t chunk_index, size_t from, size_t to) {
+	(void)chunk_index;
+	CliquesContext* cliques = (CliquesContext*)context;
+	CliqueSearch search = CliqueSearch_new(cliques->graph, cliques->callback, cliques->data);
+	for (size_t i = from; i < to; i++) {
+		cliques_from_node(&search, cliques->graph->order[i]);
+	}
+	CliqueSearch_destroy(search);
+}
+
+void Stream_maximal_cliques(Stream* stream, TemporalCliqueCallback callback, void* data) {
+	INSTRUMENT_METRIC(stream, maximal_cliques);
+	CliqueGraph graph = CliqueGraph_from(stream);
+	CliquesContext context = {.graph = &graph, .callback = callback, .data = data};
+	ThreadPool_parallel_for(ThreadPool_global(), graph.nb_nodes, STARTING_NODES_PER_CHUNK, cliques_from_nodes,
+							&context);
+	CliqueGraph_destroy(graph);
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#ifndef CLIQUES_H
+#define CLIQUES_H
+
+/**
+ * @file cliques.h
+ * @brief Maximal cliques of a Stream : the sets of nodes all linked together during a time interval, which can neither
+ * be extended to another node nor to a longer interval.
+ *
+ * As defined in the paper, a clique is a pair (X, [b, e[) of at least two nodes X and an interval [b, e[ during which
+ * every pair of nodes of X is linked. It is maximal if no node is linked to all the nodes of X during the whole
+ * interval, and if no interval containing [b, e[ has all the pairs of X linked.
+ * <br>
+ * The cliques are enumerated with a Bron–Kerbosch search on the graph of the links of the Stream. Each candidate node
+ * keeps the times during which it is linked to all the nodes of the current clique, which are intersected with the
+ * presence of its links when a node is added to the clique. A set of nodes is only visited once, and reports the
+ * intervals of its times which no candidate or excluded node covers. A node u is taken as pivot, and the nodes linked
+ * to u and to the clique whenever they are linked to the clique are not branched on : the cliques they are in without
+ * u are found from another branch, or are not maximal.
+ * <br>
+ * The top level of the search starts from each node with its neighbours later in a degeneracy order as candidates,
+ * and the ones before it as excluded, so that each clique is found from a single node. The starting nodes are handed
+ * to the workers of the thread pool, see thread_pool.h, and each of them only keeps the nodes of the current branch.
+ */
+
+#include "interval.h"
+#include "stream.h"
+#include "units.h"
+#include <stddef.h>
+
+/**
+ * @brief A maximal clique, only valid during the call to the callback it is given to.
+ */
+typedef struct {
+	const NodeId* nodes; /**< The nodes of the clique, sorted by id. */
+	size_t nb_nodes;	 /**< The number of nodes of the clique, at least 2. */
+	Interval interval;	 /**< The interval during which all the nodes are linked together. */
+} TemporalClique;
+
+/**
+ * @brief Called on each maximal clique by Stream_maximal_cliques.
+ * @param[in] clique The clique. Its nodes are freed or overwritten after the call.
+ * @param[in] data The data passed to Stream_maximal_cliques.
+ */
+typedef void (*TemporalCliqueCallback)(const TemporalClique* clique, void* data);
+
+/**
+ * @brief Enumerates the maximal cliques of a Stream, and calls the callback on each of them.
+ *
+ * The cliques are not stored : the memory used is the graph of the links, plus, per worker, the candidates of each
+ * level of the current branch of the search, so it is bounded by its depth. The callback is called from the workers
+ * of the thread pool, in any order of the cliques, so it must be safe to call from several threads at once when the
+ * pool has several workers.
+ * Costs O(E log E) to build the graph and order its nodes, then O(k² log d) per set of nodes visited, with k the
+ * number of candidate and excluded nodes of the set and d the largest degree.
+ * @param[in] stream The Stream.
+ * @param[in] callback Called on each maximal clique.
+ * @param[in] data Passed to the callback.
+ */
+void Stream_maximal_cliques(Stream* stream, TemporalCliqueCallback callback, void* data);
+
+#endif // CLIQUES_H
\ No newline at end of file
@@ -0,0 +1,384 @@
+#include "components.h"
+#include "instrumentation.h"
+#include "iterators.h"
+#include "stream_functions.h"
+#include "timeline.h"
+#include "utils.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+// A presence interval of a link, as the range of key moments from first to end, end excluded
+typedef struct {
+	size_t first;
+	size_t end;
+	NodeId nodes[2];
+} LinkRange;
+
+// The segment tree over the key moments of a Stream. The node i covers a range of key moments, which its children
+// 2i and 2i + 1 split in two halves, and holds the ranges of links which cover it but not its parent.
+typedef struct {
+	Timeline timeline;
+	size_t nb_moments;
+	TimeId* moments;
+	size_t nb_ranges;
+	LinkRange* ranges;
+	size_t nb_tree_nodes;
+	size_t* offsets; // The ranges of the tree node i are the ones of the indexes from offsets[i] to offsets[i + 1]
+	size_t* indexes;
+	size_t nb_node_ids; // The largest node id plus one, 0 if there are no nodes
+} ComponentsTree;
+
+// Counts the tree nodes covering the range, or writes it to them once the offsets are set
+static void cover_range(ComponentsTree* tree, size_t tree_node, size_t low, size_t high, size_t range, bool write) {
+	LinkRange link_range = tree->ranges[range];
+	if (link_range.end <= low || high <= link_range.first) {
+		return;
+	}
+	if (link_range.first <= low && high <= link_range.end) {
+		if (write) {
+			tree->indexes[tree->offsets[tree_node + 1]++] = range;
+		}
+		else {
+			tree->offsets[tree_node + 2]++;
+		}
+		return;
+	}
+	size_t middle = low + (high - low) / 2;
+	cover_range(tree, 2 * tree_node, low, middle, range, write);
+	cover_range(tree, 2 * tree_node + 1, middle, high, range, write);
+}
+
+static ComponentsTree ComponentsTree_from(Stream* stream) {
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	void* st = stream->stream;
+	ComponentsTree tree = {.timeline = Timeline_from(stream)};
+	const TimelineEvent* events = tree.timeline.events;
+	size_t nb_events = tree.timeline.nb_events;
+
+	NodesIterator nodes = stream_functions->nodes_set(st);
+	FOR_EACH_NODE(node_id, nodes) {
+		tree.nb_node_ids = node_id + 1 > tree.nb_node_ids ? node_id + 1 : tree.nb_node_ids;
+	}
+	size_t nb_link_ids = 0;
+	for (size_t i = 0; i < nb_events; i++) {
+		if (!TimelineEvent_is_node(events[i])) {
+			nb_link_ids = events[i].id + 1 > nb_link_ids ? events[i].id + 1 : nb_link_ids;
+			tree.nb_ranges += TimelineEvent_is_appearance(events[i]);
+		}
+	}
+
+	// The beginning of the lifespan is a key moment even if nothing is present, like in Stream_sweep_key_moments
+	tree.moments = MALLOC((nb_events + 1) * sizeof(TimeId));
+	if (nb_events == 0 || events[0].instant > tree.timeline.lifespan.start) {
+		tree.moments[tree.nb_moments++] = tree.timeline.lifespan.start;
+	}
+	for (size_t i = 0; i < nb_events; i++) {
+		if (i == 0 || events[i].instant != events[i - 1].instant) {
+			tree.moments[tree.nb_moments++] = events[i].instant;
+		}
+	}
+
+	// Each disappearance of a link closes the range opened by its last appearance
+	size_t* opened = MALLOC((nb_link_ids + 1) * sizeof(size_t));
+	tree.ranges = MALLOC((tree.nb_ranges + 1) * sizeof(LinkRange));
+	size_t nb_ranges = 0;
+	size_t moment = 0;
+	for (size_t i = 0; i < nb_events; i++) {
+		while (tree.moments[moment] != events[i].instant) {
+			moment++;
+		}
+		if (TimelineEvent_is_node(events[i])) {
+			continue;
+		}
+		if (TimelineEvent_is_appearance(events[i])) {
+			opened[events[i].id] = moment;
+		}
+		else {
+			Link link = stream_functions->nth_link(st, events[i].id);
+			tree.ranges[nb_ranges++] = (LinkRange){
+				.first = opened[events[i].id],
+				.end = moment,
+				.nodes = {link.nodes[0], link.nodes[1]},
+			};
+		}
+	}
+	tree.nb_ranges = nb_ranges;
+	free(opened);
+
+	tree.nb_tree_nodes = 4 * tree.nb_moments;
+	tree.offsets = calloc(tree.nb_tree_nodes + 2, sizeof(size_t));
+	for (size_t r = 0; r < tree.nb_ranges; r++) {
+		cover_range(&tree, 1, 0, tree.nb_moments, r, false);
+	}
+	for (size_t i = 2; i < tree.nb_tree_nodes + 2; i++) {
+		tree.offsets[i] += tree.offsets[i - 1];
+	}
+	tree.indexes = MALLOC((tree.offsets[tree.nb_tree_nodes + 1] + 1) * sizeof(size_t));
+	for (size_t r = 0; r < tree.nb_ranges; r++) {
+		cover_range(&tree, 1, 0, tree.nb_moments, r, true);
+	}
+	return tree;
+}
+
+static void ComponentsTree_destroy(ComponentsTree tree) {
+	free(tree.indexes);
+	free(tree.offsets);
+	free(tree.ranges);
+	free(tree.moments);
+	Timeline_destroy(tree.timeline);
+}
+
+// A union which merged two components, undone by detaching the root it attached
+typedef struct {
+	NodeId attached;
+	size_t previous_largest;
+} UnionRecord;
+
+// An instant of Stream_components_at_instants, with its position in the array of the caller to write its row back
+typedef struct {
+	TimeId instant;
+	size_t index;
+} SortedInstant;
+
+static int SortedInstant_compare(const void* a, const void* b) {
+	const SortedInstant* instant_a = (const SortedInstant*)a;
+	const SortedInstant* instant_b = (const SortedInstant*)b;
+	if (instant_a->instant != instant_b->instant) {
+		return instant_a->instant < instant_b->instant ? -1 : 1;
+	}
+	return (instant_a->index > instant_b->index) - (instant_a->index < instant_b->index);
+}
+
+// The state of the traversal of the tree : the union-find structure, by size and without path compression so that
+// its unions can be undone, and the nodes present at the current key moment
+typedef struct {
+	const ComponentsTree* tree;
+	NodeId* parents;
+	size_t* sizes;
+	UnionRecord* unions; // The unions done on the path from the root of the tree, at most one per node
+	size_t nb_unions;
+	size_t largest;
+	bool* present;
+	size_t nb_nodes;
+	size_t next_event;
+	ComponentsCountCallback callback;
+	void* user_data;
+	const SortedInstant* instants;
+	size_t nb_instants;
+	size_t next_instant;
+	NodeId* components;
+	NodeId* smallest_of_root;
+} ComponentsSweep;
+
+static ComponentsSweep ComponentsSweep_new(const ComponentsTree* tree) {
+	size_t nb_node_ids = tree->nb_node_ids;
+	ComponentsSweep sweep = {
+		.tree = tree,
+		.parents = MALLOC((nb_node_ids + 1) * sizeof(NodeId)),
+		.sizes = MALLOC((nb_node_ids + 1) * sizeof(size_t)),
+		.unions = MALLOC((nb_node_ids + 1) * sizeof(UnionRecord)),
+		.nb_unions = 0,
+		.largest = 1,
+		.present = calloc(nb_node_ids + 1, sizeof(bool)),
+		.nb_nodes = 0,
+		.next_event = 0,
+	};
+	for (size_t i = 0; i < nb_node_ids; i++) {
+		sweep.parents[i] = i;
+		sweep.sizes[i] = 1;
+	}
+	return sweep;
+}
+
+static void ComponentsSweep_destroy(ComponentsSweep sweep) {
+	free(sweep.parents);
+	free(sweep.sizes);
+	free(sweep.unions);
+	free(sweep.present);
+}
+
+static NodeId find_root(const ComponentsSweep* sweep, NodeId node) {
+	while (sweep->parents[node] != node) {
+		node = sweep->parents[node];
+	}
+	return node;
+}
+
+static void unite(ComponentsSweep* sweep, NodeId u, NodeId v) {
+	NodeId root_u = find_root(sweep, u);
+	NodeId root_v = find_root(sweep, v);
+	if (root_u == root_v) {
+		return;
+	}
+	if (sweep->sizes[root_u] < sweep->sizes[root_v]) {
+		NodeId swap = root_u;
+		root_u = root_v;
+		root_v = swap;
+	}
+	sweep->unions[sweep->nb_unions++] = (UnionRecord){.attached = root_v, .previous_largest = sweep->largest};
+	sweep->parents[root_v] = root_u;
+	sweep->sizes[root_u] += sweep->sizes[root_v];
+	sweep->largest = sweep->sizes[root_u] > sweep->largest ? sweep->sizes[root_u] : sweep->largest;
+}
+
+static void undo_unions_until(ComponentsSweep* sweep, size_t nb_unions) {
+	while (sweep->nb_unions > nb_unions) {
+		UnionRecord record = sweep->unions[--sweep->nb_unions];
+		NodeId root = sweep->parents[record.attached];
+		sweep->sizes[root] -= sweep->sizes[record.attached];
+		sweep->parents[record.attached] = record.attached;
+		sweep->largest = record.previous_largest;
+	}
+}
+
+// The smallest node id of the component of each node present, from the ids in increasing order
+static void write_components(ComponentsSweep* sweep, NodeId* row) {
+	size_t nb_node_ids = sweep->tree->nb_node_ids;
+	for (size_t i = 0; i < nb_node_ids; i++) {
+		if (!sweep->present[i]) {
+			row[i] = NO_COMPONENT;
+			continue;
+		}
+		NodeId root = find_root(sweep, i);
+		if (sweep->smallest_of_root[root] == NO_COMPONENT) {
+			sweep->smallest_of_root[root] = i;
+		}
+		row[i] = sweep->smallest_of_root[root];
+	}
+	for (size_t i = 0; i < nb_node_ids; i++) {
+		sweep->smallest_of_root[i] = NO_COMPONENT;
+	}
+}
+
+// The leaves are reached in chronological order, so the nodes present are updated with the events up to the key
+// moment, while the unions of the links present were done by the ancestors of the leaf
+static void visit_moment(ComponentsSweep* sweep, size_t moment) {
+	const ComponentsTree* tree = sweep->tree;
+	TimeId instant = tree->moments[moment];
+	const TimelineEvent* events = tree->timeline.events;
+	for (; sweep->next_event < tree->timeline.nb_events && events[sweep->next_event].instant <= instant;
+		 sweep->next_event++) {
+		TimelineEvent event = events[sweep->next_event];
+		if (TimelineEvent_is_node(event)) {
+			sweep->present[event.id] = TimelineEvent_is_appearance(event);
+			sweep->nb_nodes += TimelineEvent_is_appearance(event) ? 1 : -1;
+		}
+	}
+	if (sweep->callback != NULL) {
+		sweep->callback(
+			(ComponentsCount){
+				.instant = instant,
+				.nb_nodes = sweep->nb_nodes,
+				.nb_components = sweep->nb_nodes - sweep->nb_unions,
+				.largest_component = sweep->nb_nodes == 0 ? 0 : sweep->largest,
+			},
+			sweep->user_data);
+	}
+	bool is_last = moment + 1 == tree->nb_moments;
+	while (sweep->next_instant < sweep->nb_instants &&
+		   (is_last || sweep->instants[sweep->next_instant].instant < tree->moments[moment + 1])) {
+		write_components(sweep, sweep->components + sweep->instants[sweep->next_instant].index * tree->nb_node_ids);
+		sweep->next_instant++;
+	}
+}
+
+static void traverse(ComponentsSweep* sweep, size_t tree_node, size_t low, size_t high) {
+	const ComponentsTree* tree = sweep->tree;
+	size_t nb_unions = sweep->nb_unions;
+	for (size_t i = tree->offsets[tree_node]; i < tree->offsets[tree_node + 1]; i++) {
+		const LinkRange* range = &tree->ranges[tree->indexes[i]];
+		unite(sweep, range->nodes[0], range->nodes[1]);
+	}
+	if (high - low == 1) {
+		visit_moment(sweep, low);
+	}
+	else {
+		size_t middle = low + (high - low) / 2;
+		traverse(sweep, 2 * tree_node, low, middle);
+		traverse(sweep, 2 * tree_node + 1, middle, high);
+	}
+	undo_unions_until(sweep, nb_unions);
+}
+
+// Traverses the tree with the callback, the number of key moments being the number of leaves
+static void sweep_components(const ComponentsTree* tree, ComponentsCountCallback callback, void* user_data) {
+	ComponentsSweep sweep = ComponentsSweep_new(tree);
+	sweep.callback = callback;
+	sweep.user_data = user_data;
+	traverse(&sweep, 1, 0, tree->nb_moments);
+	ComponentsSweep_destroy(sweep);
+}
+
+size_t Stream_sweep_components(Stream* stream, ComponentsCountCallback callback, void* user_data) {
+	INSTRUMENT_METRIC(stream, sweep_components);
+	ComponentsTree tree = ComponentsTree_from(stream);
+	sweep_components(&tree, callback, user_data);
+	size_t nb_key_moments = tree.nb_moments;
+	ComponentsTree_destroy(tree);
+	return nb_key_moments;
+}
+
+typedef struct {
+	ComponentsCount* counts;
+	size_t nb_written;
+} ComponentsCountWriter;
+
+static void write_components_count(ComponentsCount count, void* user_data) {
+	ComponentsCountWriter* writer = (ComponentsCountWriter*)user_data;
+	writer->counts[writer->nb_written] = count;
+	writer->nb_written++;
+}
+
+ComponentsCount* Stream_components_time_series(Stream* stream, size_t* nb_key_moments) {
+	INSTRUMENT_METRIC(stream, components_time_series);
+	ComponentsTree tree = ComponentsTree_from(stream);
+	ComponentsCountWriter writer = {
+		.counts = MALLOC((tree.nb_moments + 1) * sizeof(ComponentsCount)),
+		.nb_written = 0,
+	};
+	sweep_components(&tree, write_components_count, &writer);
+	*nb_key_moments = tree.nb_moments;
+	ComponentsTree_destroy(tree);
+	return writer.counts;
+}
+
+NodesComponents Stream_components_at_instants(Stream* stream, const TimeId* instants, size_t nb_instants) {
+	INSTRUMENT_METRIC(stream, components_at_instants);
+	ComponentsTree tree = ComponentsTree_from(stream);
+	NodesComponents components = {
+		.nb_instants = nb_instants,
+		.nb_node_ids = tree.nb_node_ids,
+		.components = MALLOC((nb_instants * tree.nb_node_ids + 1) * sizeof(NodeId)),
+	};
+	// The instants are visited in chronological order along the traversal, and each row is written at the position of
+	// its instant in the array of the caller
+	SortedInstant* sorted = MALLOC((nb_instants + 1) * sizeof(SortedInstant));
+	for (size_t i = 0; i < nb_instants; i++) {
+		sorted[i] = (SortedInstant){.instant = instants[i], .index = i};
+	}
+	qsort(sorted, nb_instants, sizeof(SortedInstant), SortedInstant_compare);
+	ComponentsSweep sweep = ComponentsSweep_new(&tree);
+	sweep.instants = sorted;
+	sweep.nb_instants = nb_instants;
+	sweep.components = components.components;
+	sweep.smallest_of_root = MALLOC((tree.nb_node_ids + 1) * sizeof(NodeId));
+	for (size_t i = 0; i < tree.nb_node_ids; i++) {
+		sweep.smallest_of_root[i] = NO_COMPONENT;
+	}
+	// Nothing is present before the first key moment
+	while (sweep.next_instant < nb_instants && sorted[sweep.next_instant].instant < tree.moments[0]) {
+		write_components(&sweep, components.components + sorted[sweep.next_instant].index * tree.nb_node_ids);
+		sweep.next_instant++;
+	}
+	traverse(&sweep, 1, 0, tree.nb_moments);
+	free(sorted);
+	free(sweep.smallest_of_root);
+	ComponentsSweep_destroy(sweep);
+	ComponentsTree_destroy(tree);
+	return components;
+}
+
+void NodesComponents_destroy(NodesComponents components) {
+	free(components.components);
+}
\ No newline at end of file
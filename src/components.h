@@ -0,0 +1,97 @@
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+/**
+ * @file components.h
+ * @brief The connected components of the graph G_t of the nodes and links present at each instant t of a Stream.
+ *
+ * G_t only changes at the key moments of the Stream, so the components are computed once per key moment. Instead of
+ * building the links present at each of them and searching their graph, the components are maintained with a
+ * union-find structure, which cannot undo a union when a link disappears. The links are therefore handled offline :
+ * each presence interval of a link, as a range of key moments, is stored in the O(log K) nodes of a segment tree over
+ * the K key moments which cover it. A depth-first traversal of the tree adds the links of a node when entering it and
+ * undoes their unions when leaving it, so that at each leaf, the unions done are exactly the ones of the links present
+ * at its key moment. Without path compression, undoing a union only resets the root it attached.
+ * <br>
+ * The union-find structure counts the unions which merged two components, so the number of components is the number
+ * of nodes present minus that count, and keeps the size of the largest component along with the unions it undoes.
+ */
+
+#include "stream.h"
+#include "units.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief The component of the nodes absent at an instant.
+ */
+#define NO_COMPONENT SIZE_MAX
+
+/**
+ * @brief The connected components of a Stream at an instant.
+ */
+typedef struct {
+	TimeId instant;			  /**< The instant. For a key moment, the values hold until the next one. */
+	size_t nb_nodes;		  /**< The number of nodes present, |V_t|. */
+	size_t nb_components;	  /**< The number of connected components of G_t, including the isolated nodes. */
+	size_t largest_component; /**< The number of nodes of the largest component, 0 if no node is present. */
+} ComponentsCount;
+
+/**
+ * @brief A function called with the ComponentsCount of each key moment, in chronological order.
+ * @param[in] count The components at the key moment.
+ * @param[in] user_data The pointer given to Stream_sweep_components.
+ */
+typedef void (*ComponentsCountCallback)(ComponentsCount count, void* user_data);
+
+/**
+ * @brief Calls the callback with the components of the Stream at every key moment, that is every instant at which a
+ * node or link appears or disappears, and the beginning of its lifespan.
+ *
+ * Costs O(E log E) to build the Timeline of the Stream, then O(I log K log V) for the unions, with E the number of
+ * events, I the number of presence intervals of the links and K the number of key moments.
+ * @param[in] stream The Stream.
+ * @param[in] callback The function to call for each key moment.
+ * @param[in] user_data Passed as is to the callback.
+ * @return The number of key moments.
+ */
+size_t Stream_sweep_components(Stream* stream, ComponentsCountCallback callback, void* user_data);
+
+/**
+ * @brief Like Stream_sweep_components, but writes the results to an array.
+ * @param[in] stream The Stream.
+ * @param[out] nb_key_moments The number of key moments, and therefore the size of the array.
+ * @return The components at each key moment. Must be freed with free.
+ */
+ComponentsCount* Stream_components_time_series(Stream* stream, size_t* nb_key_moments);
+
+/**
+ * @brief The component of each node at several instants.
+ */
+typedef struct {
+	size_t nb_instants; /**< The number of instants. */
+	size_t nb_node_ids; /**< The largest node id of the Stream plus one, the size of a row. */
+	NodeId* components; /**< The row of the instant i starts at i * nb_node_ids, and gives the smallest node id of the
+							 component of each node, or NO_COMPONENT for the absent nodes. */
+} NodesComponents;
+
+/**
+ * @brief The component of each node at each of the instants, found in the same traversal as Stream_sweep_components.
+ *
+ * Costs the same as Stream_sweep_components, plus O(V log V) per instant to find the components of the nodes, and the
+ * sort of the instants.
+ * Must be freed with NodesComponents_destroy.
+ * @param[in] stream The Stream.
+ * @param[in] instants The instants, in any order. The row of each instant is at its position in the array.
+ * @param[in] nb_instants The number of instants.
+ * @return The components of the nodes at each instant.
+ */
+NodesComponents Stream_components_at_instants(Stream* stream, const TimeId* instants, size_t nb_instants);
+
+/**
+ * @brief Frees the array of a NodesComponents.
+ * @param[in] components The NodesComponents.
+ */
+void NodesComponents_destroy(NodesComponents components);
+
+#endif // COMPONENTS_H
\ No newline at end of file
@@ -23,30 +23,17 @@ size_t LinksPresentAtT_next_after_disappearence(LinksIterator* links_iter) {
 		return SIZE_MAX;
 	}
 
-	// If the current event has 0 links
-	while (stream_graph->events.link_events.events[links_iter_data->current_event].nb_info == 0) {
-		if (links_iter_data->current_event >= stream_graph->events.nb_events - 1) {
-			return SIZE_MAX;
-		}
-		links_iter_data->current_event++;
-		links_iter_data->current_link = 0;
-	}
-	// If you're the last link of the event
-	size_t return_val;
-	if (links_iter_data->current_link ==
-		stream_graph->events.link_events.events[links_iter_data->current_event].nb_info) {
+	// Go to the next event with links left, the events without any are skipped rather than ending the iteration
+	while (links_iter_data->current_link ==
+		   stream_graph->events.link_events.events[links_iter_data->current_event].nb_info) {
 		// If you're the last event
 		if (links_iter_data->current_event >= stream_graph->events.nb_events - 1) {
 			return SIZE_MAX;
 		}
-
 		links_iter_data->current_event++;
 		links_iter_data->current_link = 0;
 	}
-	if (stream_graph->events.link_events.events[links_iter_data->current_event].nb_info == 0) {
-		return SIZE_MAX;
-	}
-	return_val =
+	size_t return_val =
 		stream_graph->events.link_events.events[links_iter_data->current_event].events[links_iter_data->current_link];
 	links_iter_data->current_link++;
 	return return_val;
@@ -94,22 +81,14 @@ void LinksPresentAtTIterator_destroy(LinksIterator* links_iter) {
 	free(links_iter->iterator_data);
 }
 
-LinksIterator get_links_present_at_t(StreamGraph* stream_graph, TimeId t) {
-	size_t current_event = KeyMomentsTable_find_time_index(&stream_graph->key_moments, t);
-
-	// If the time is exactly a key moment after disappearance, we need to skip the disappearance event
-	if (t >= KeyMomentsTable_nth_key_moment(&stream_graph->key_moments,
-											stream_graph->events.link_events.disappearance_index)) {
-		current_event++;
-	}
-
+static LinksIterator links_present_from_event(StreamGraph* stream_graph, size_t current_event) {
 	LinksPresentAtTIterator* links_iter_data = MALLOC(sizeof(LinksPresentAtTIterator));
 	links_iter_data->current_event = current_event;
 	links_iter_data->current_link = 0;
 
 	Stream stream = {.type = FULL_STREAM_GRAPH, .stream = stream_graph};
 
-	if (current_event > stream_graph->events.nb_events) {
+	if (current_event >= stream_graph->events.nb_events) {
 		return (LinksIterator){.stream_graph = stream,
 							   .iterator_data = links_iter_data,
 							   .next = (size_t(*)(void*))LinksPresentAtT_next_after_disappearence,
@@ -130,6 +109,25 @@ LinksIterator get_links_present_at_t(StreamGraph* stream_graph, TimeId t) {
 	return links_iter;
 }
 
+LinksIterator get_links_present_at_t(StreamGraph* stream_graph, TimeId t) {
+	// Nothing changes between two key moments, so the links present at t are the ones of the last key moment before it
+	size_t nb_moments = KeyMomentsTable_nb_moments_until(&stream_graph->key_moments, t);
+	if (nb_moments == 0) {
+		// Nothing is present before the first key moment
+		return links_present_from_event(stream_graph, stream_graph->events.nb_events);
+	}
+	return get_links_present_at_nth_key_moment(stream_graph, nb_moments - 1);
+}
+
+LinksIterator get_links_present_at_nth_key_moment(StreamGraph* stream_graph, size_t n) {
+	// The events after the last appearance are shifted by one, since they list the deletions at their key moment
+	size_t current_event = n;
+	if (n >= stream_graph->events.link_events.disappearance_index) {
+		current_event++;
+	}
+	return links_present_from_event(stream_graph, current_event);
+}
+
 // Okay so next_after i have to put the skip loop before and in the next_before i have to put it after
 
 size_t NodesPresentAtT_next_after_disappearence(NodesIterator* nodes_iter) {
@@ -140,30 +138,17 @@ size_t NodesPresentAtT_next_after_disappearence(NodesIterator* nodes_iter) {
 	if (nodes_iter_data->current_event >= stream_graph->events.nb_events) {
 		return SIZE_MAX;
 	}
-	// If the current event has 0 nodes
-	while (stream_graph->events.node_events.events[nodes_iter_data->current_event].nb_info == 0) {
-		if (nodes_iter_data->current_event >= stream_graph->events.nb_events - 1) {
-			return SIZE_MAX;
-		}
-		nodes_iter_data->current_event++;
-		nodes_iter_data->current_node = 0;
-	}
-	// If you're the last node of the event
-	size_t return_val;
-	if (nodes_iter_data->current_node ==
-		stream_graph->events.node_events.events[nodes_iter_data->current_event].nb_info) {
+	// Go to the next event with nodes left, the events without any are skipped rather than ending the iteration
+	while (nodes_iter_data->current_node ==
+		   stream_graph->events.node_events.events[nodes_iter_data->current_event].nb_info) {
 		// If you're the last event
 		if (nodes_iter_data->current_event >= stream_graph->events.nb_events - 1) {
 			return SIZE_MAX;
 		}
-
 		nodes_iter_data->current_event++;
 		nodes_iter_data->current_node = 0;
 	}
-	if (stream_graph->events.node_events.events[nodes_iter_data->current_event].nb_info == 0) {
-		return SIZE_MAX;
-	}
-	return_val =
+	size_t return_val =
 		stream_graph->events.node_events.events[nodes_iter_data->current_event].events[nodes_iter_data->current_node];
 	nodes_iter_data->current_node++;
 	return return_val;
@@ -211,27 +196,19 @@ void NodesPresentAtTIterator_destroy(NodesIterator* nodes_iter) {
 	free(nodes_iter->iterator_data);
 }
 
-NodesIterator get_nodes_present_at_t(StreamGraph* stream_graph, TimeId t) {
-	size_t current_event = KeyMomentsTable_find_time_index(&stream_graph->key_moments, t);
-
-	// If the time is exactly a key moment after disappearance, we need to skip the disappearance event
-	if (t >= KeyMomentsTable_nth_key_moment(&stream_graph->key_moments,
-											stream_graph->events.node_events.disappearance_index)) {
-		current_event++;
-	}
+static NodesIterator nodes_present_from_event(StreamGraph* stream_graph, size_t current_event) {
+	NodesPresentAtTIterator* nodes_iter_data = MALLOC(sizeof(NodesPresentAtTIterator));
+	nodes_iter_data->current_event = current_event;
+	nodes_iter_data->current_node = 0;
 
 	Stream stream = {.type = FULL_STREAM_GRAPH, .stream = stream_graph};
-	if (current_event > stream_graph->events.nb_events) {
-		NodesPresentAtTIterator* nodes_iter_data = MALLOC(sizeof(NodesPresentAtTIterator));
+	if (current_event >= stream_graph->events.nb_events) {
 		return (NodesIterator){.stream_graph = stream,
 							   .iterator_data = nodes_iter_data,
 							   .next = (size_t(*)(void*))NodesPresentAtT_next_after_disappearence,
 							   .destroy = (void (*)(void*))NodesPresentAtTIterator_destroy};
 	}
 
-	NodesPresentAtTIterator* nodes_iter_data = MALLOC(sizeof(NodesPresentAtTIterator));
-	nodes_iter_data->current_event = current_event;
-	nodes_iter_data->current_node = 0;
 	NodesIterator nodes_iter = {
 		.stream_graph = stream,
 		.iterator_data = nodes_iter_data,
@@ -245,3 +222,20 @@ NodesIterator get_nodes_present_at_t(StreamGraph* stream_graph, TimeId t) {
 	}
 	return nodes_iter;
 }
+
+NodesIterator get_nodes_present_at_t(StreamGraph* stream_graph, TimeId t) {
+	// Same as for the links
+	size_t nb_moments = KeyMomentsTable_nb_moments_until(&stream_graph->key_moments, t);
+	if (nb_moments == 0) {
+		return nodes_present_from_event(stream_graph, stream_graph->events.nb_events);
+	}
+	return get_nodes_present_at_nth_key_moment(stream_graph, nb_moments - 1);
+}
+
+NodesIterator get_nodes_present_at_nth_key_moment(StreamGraph* stream_graph, size_t n) {
+	size_t current_event = n;
+	if (n >= stream_graph->events.node_events.disappearance_index) {
+		current_event++;
+	}
+	return nodes_present_from_event(stream_graph, current_event);
+}
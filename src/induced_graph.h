@@ -18,6 +18,14 @@
  */
 NodesIterator get_nodes_present_at_t(StreamGraph* stream_graph, TimeId t);
 
+/**
+ * @brief Returns an iterator over the nodes present from the nth key moment of the given StreamGraph to the next one.
+ * @param[in] stream_graph The StreamGraph.
+ * @param[in] n The index of the key moment.
+ * @return An iterator over the nodes present at the nth key moment.
+ */
+NodesIterator get_nodes_present_at_nth_key_moment(StreamGraph* stream_graph, size_t n);
+
 /**
  * @brief The data of the iterator over the nodes present at a given time in a StreamGraph.
  */
@@ -34,6 +42,14 @@ typedef struct {
  */
 LinksIterator get_links_present_at_t(StreamGraph* stream_graph, TimeId t);
 
+/**
+ * @brief Returns an iterator over the links present from the nth key moment of the given StreamGraph to the next one.
+ * @param[in] stream_graph The StreamGraph.
+ * @param[in] n The index of the key moment.
+ * @return An iterator over the links present at the nth key moment.
+ */
+LinksIterator get_links_present_at_nth_key_moment(StreamGraph* stream_graph, size_t n);
+
 /**
  * @brief The data of the iterator over the links present at a given time in a StreamGraph.
  */
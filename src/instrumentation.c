@@ -0,0 +1,138 @@
+#include "instrumentation.h"
+#include "utils.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+struct StreamInstrumentation {
+	atomic_size_t cache_hits;
+	atomic_size_t cache_misses;
+	atomic_size_t iterators_created;
+	atomic_size_t elements_iterated;
+	atomic_size_t metric_calls[NB_INSTRUMENTED_METRICS];
+	atomic_uint_least64_t metric_nanoseconds[NB_INSTRUMENTED_METRICS];
+};
+
+#define INSTRUMENTED_METRIC_NAME(name) #name,
+static const char* metric_names[NB_INSTRUMENTED_METRICS] = {FOR_EACH_INSTRUMENTED_METRIC(INSTRUMENTED_METRIC_NAME)};
+
+const char* InstrumentedMetric_name(InstrumentedMetric metric) {
+	if (metric >= NB_INSTRUMENTED_METRICS) {
+		return "unknown";
+	}
+	return metric_names[metric];
+}
+
+bool Instrumentation_enabled(void) {
+#ifdef SGA_INSTRUMENTATION
+	return true;
+#else
+	return false;
+#endif
+}
+
+StreamInstrumentation* StreamInstrumentation_new(void) {
+	StreamInstrumentation* instrumentation = MALLOC(sizeof(StreamInstrumentation));
+	StreamInstrumentation_reset(instrumentation);
+	return instrumentation;
+}
+
+void StreamInstrumentation_destroy(StreamInstrumentation* instrumentation) {
+	free(instrumentation);
+}
+
+StreamCounters StreamInstrumentation_snapshot(StreamInstrumentation* instrumentation) {
+	StreamCounters counters = {0};
+	if (instrumentation == NULL) {
+		return counters;
+	}
+	counters.cache_hits = atomic_load_explicit(&instrumentation->cache_hits, memory_order_relaxed);
+	counters.cache_misses = atomic_load_explicit(&instrumentation->cache_misses, memory_order_relaxed);
+	counters.iterators_created = atomic_load_explicit(&instrumentation->iterators_created, memory_order_relaxed);
+	counters.elements_iterated = atomic_load_explicit(&instrumentation->elements_iterated, memory_order_relaxed);
+	for (size_t i = 0; i < NB_INSTRUMENTED_METRICS; i++) {
+		counters.metric_calls[i] = atomic_load_explicit(&instrumentation->metric_calls[i], memory_order_relaxed);
+		counters.metric_nanoseconds[i] =
+			atomic_load_explicit(&instrumentation->metric_nanoseconds[i], memory_order_relaxed);
+	}
+	return counters;
+}
+
+void StreamInstrumentation_reset(StreamInstrumentation* instrumentation) {
+	if (instrumentation == NULL) {
+		return;
+	}
+	atomic_init(&instrumentation->cache_hits, 0);
+	atomic_init(&instrumentation->cache_misses, 0);
+	atomic_init(&instrumentation->iterators_created, 0);
+	atomic_init(&instrumentation->elements_iterated, 0);
+	for (size_t i = 0; i < NB_INSTRUMENTED_METRICS; i++) {
+		atomic_init(&instrumentation->metric_calls[i], 0);
+		atomic_init(&instrumentation->metric_nanoseconds[i], 0);
+	}
+}
+
+void StreamInstrumentation_count_cache_access(StreamInstrumentation* instrumentation, bool hit) {
+	if (instrumentation == NULL) {
+		return;
+	}
+	atomic_fetch_add_explicit(hit ? &instrumentation->cache_hits : &instrumentation->cache_misses, 1,
+							  memory_order_relaxed);
+}
+
+static _Thread_local StreamInstrumentation* current_instrumentation = NULL;
+
+StreamInstrumentation* StreamInstrumentation_current(void) {
+	return current_instrumentation;
+}
+
+void StreamInstrumentation_set_current(StreamInstrumentation* instrumentation) {
+	current_instrumentation = instrumentation;
+}
+
+void StreamInstrumentation_count_iterator(void) {
+	if (current_instrumentation != NULL) {
+		atomic_fetch_add_explicit(&current_instrumentation->iterators_created, 1, memory_order_relaxed);
+	}
+}
+
+void StreamInstrumentation_count_element(void) {
+	if (current_instrumentation != NULL) {
+		atomic_fetch_add_explicit(&current_instrumentation->elements_iterated, 1, memory_order_relaxed);
+	}
+}
+
+static uint64_t now_nanoseconds(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t)time.tv_sec * 1000000000 + (uint64_t)time.tv_nsec;
+}
+
+MetricTimer MetricTimer_start(StreamInstrumentation* instrumentation, InstrumentedMetric metric) {
+	MetricTimer timer = {
+		.instrumentation = instrumentation,
+		.previous = current_instrumentation,
+		.metric = metric,
+		.start_nanoseconds = now_nanoseconds(),
+	};
+	// Streams created without init_cache have no counters, their iterations go to the caller's Stream if any
+	if (instrumentation != NULL) {
+		current_instrumentation = instrumentation;
+	}
+	return timer;
+}
+
+void MetricTimer_stop(MetricTimer* timer) {
+	current_instrumentation = timer->previous;
+	if (timer->instrumentation == NULL) {
+		return;
+	}
+	uint64_t elapsed = now_nanoseconds() - timer->start_nanoseconds;
+	atomic_fetch_add_explicit(&timer->instrumentation->metric_calls[timer->metric], 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&timer->instrumentation->metric_nanoseconds[timer->metric], elapsed,
+							  memory_order_relaxed);
+}
\ No newline at end of file
@@ -0,0 +1,153 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+/**
+ * @file instrumentation.h
+ * @brief Opt-in counters to see what the metrics spend their time on.
+ *
+ * The counters are only compiled in when SGA_INSTRUMENTATION is defined, for example by adding -DSGA_INSTRUMENTATION
+ * to INSTRUMENTATION_FLAGS in the Makefile. Otherwise every hook expands to nothing, and the counters stay at 0.
+ * <br>
+ * Each Stream has its own counters, read with Stream_counters. The cache hits and misses are counted on the Stream
+ * whose cache is accessed. The iterators and the elements iterated are counted on the Stream of the metric the
+ * current thread is computing, including the chunks the workers of the thread pool run for it. The time of a metric
+ * includes the time of the metrics it calls.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** @cond */
+#define FOR_EACH_INSTRUMENTED_METRIC(X)                                                                                \
+	X(cardinalOfT)                                                                                                     \
+	X(cardinalOfV)                                                                                                     \
+	X(cardinalOfE)                                                                                                     \
+	X(cardinalOfW)                                                                                                     \
+	X(coverage)                                                                                                        \
+	X(node_duration)                                                                                                   \
+	X(contribution_of_node)                                                                                            \
+	X(contribution_of_link)                                                                                            \
+	X(number_of_nodes)                                                                                                 \
+	X(number_of_links)                                                                                                 \
+	X(node_contribution_at_instant)                                                                                    \
+	X(link_contribution_at_instant)                                                                                    \
+	X(link_duration)                                                                                                   \
+	X(uniformity)                                                                                                      \
+	X(uniformity_pair_nodes)                                                                                           \
+	X(compactness)                                                                                                     \
+	X(density)                                                                                                         \
+	X(density_of_link)                                                                                                 \
+	X(density_of_node)                                                                                                 \
+	X(density_at_instant)                                                                                              \
+	X(degree_of_node)                                                                                                  \
+	X(average_node_degree)                                                                                             \
+	X(degree)                                                                                                          \
+	X(average_expected_degree)                                                                                         \
+	X(clustering_coeff_of_node)                                                                                        \
+	X(clustering_coeff)                                                                                                \
+	X(transitivity)                                                                                                    \
+	X(temporal_paths_from)                                                                                             \
+	X(latest_departures_to)                                                                                            \
+	X(maximal_cliques)                                                                                                 \
+	X(contribution_of_all_nodes)                                                                                       \
+	X(contribution_of_all_links)                                                                                       \
+	X(degree_of_all_nodes)                                                                                             \
+	X(density_of_all_links)                                                                                            \
+	X(density_of_all_nodes)                                                                                            \
+	X(clustering_coeff_of_all_nodes)                                                                                   \
+	X(temporal_paths_from_all_nodes)                                                                                   \
+	X(degree_histogram)                                                                                                \
+	X(most_present_nodes)                                                                                              \
+	X(densest_links)                                                                                                   \
+	X(busiest_instants)                                                                                                \
+	X(sweep_key_moments)                                                                                               \
+	X(sweep_instants)                                                                                                  \
+	X(key_moments_time_series)                                                                                         \
+	X(instants_time_series)                                                                                            \
+	X(sweep_components)                                                                                                \
+	X(components_time_series)                                                                                          \
+	X(components_at_instants)                                                                                          \
+	X(uniformity_estimate)                                                                                             \
+	X(density_estimate)                                                                                                \
+	X(density_of_node_estimate)                                                                                        \
+	X(clustering_coeff_estimate)                                                                                       \
+	X(are_nodes_present)                                                                                               \
+	X(are_links_present)                                                                                               \
+	X(links_present_at_instants)
+#define INSTRUMENTED_METRIC_ENUM(name) METRIC_##name,
+/** @endcond */
+
+/**
+ * @brief The metrics whose calls and time are counted, named after the functions computing them.
+ */
+typedef enum {
+	FOR_EACH_INSTRUMENTED_METRIC(INSTRUMENTED_METRIC_ENUM) NB_INSTRUMENTED_METRICS,
+} InstrumentedMetric;
+
+/**
+ * @brief Returns the name of an instrumented metric.
+ * @param[in] metric The metric.
+ */
+const char* InstrumentedMetric_name(InstrumentedMetric metric);
+
+/**
+ * @brief A snapshot of the counters of a Stream.
+ */
+typedef struct {
+	size_t cache_hits;								  /**< Cardinals and memo table values found in the cache. */
+	size_t cache_misses;							  /**< Cardinals and memo table values that had to be computed. */
+	size_t iterators_created;						  /**< Iterators over nodes, links or times consumed. */
+	size_t elements_iterated;						  /**< Elements returned by these iterators. */
+	size_t metric_calls[NB_INSTRUMENTED_METRICS];	  /**< Number of calls of each metric. */
+	uint64_t metric_nanoseconds[NB_INSTRUMENTED_METRICS]; /**< Total time spent in each metric. */
+} StreamCounters;
+
+/**
+ * @brief Whether the library was compiled with the instrumentation.
+ */
+bool Instrumentation_enabled(void);
+
+/** @cond */
+// The live counters of a Stream, private to instrumentation.c. Shared by every copy of the Stream.
+typedef struct StreamInstrumentation StreamInstrumentation;
+
+StreamInstrumentation* StreamInstrumentation_new(void);
+void StreamInstrumentation_destroy(StreamInstrumentation* instrumentation);
+StreamCounters StreamInstrumentation_snapshot(StreamInstrumentation* instrumentation);
+void StreamInstrumentation_reset(StreamInstrumentation* instrumentation);
+void StreamInstrumentation_count_cache_access(StreamInstrumentation* instrumentation, bool hit);
+
+// The counters the iterations of the current thread are attributed to
+StreamInstrumentation* StreamInstrumentation_current(void);
+void StreamInstrumentation_set_current(StreamInstrumentation* instrumentation);
+void StreamInstrumentation_count_iterator(void);
+void StreamInstrumentation_count_element(void);
+
+typedef struct {
+	StreamInstrumentation* instrumentation;
+	StreamInstrumentation* previous;
+	InstrumentedMetric metric;
+	uint64_t start_nanoseconds;
+} MetricTimer;
+
+MetricTimer MetricTimer_start(StreamInstrumentation* instrumentation, InstrumentedMetric metric);
+void MetricTimer_stop(MetricTimer* timer);
+
+#ifdef SGA_INSTRUMENTATION
+#	define INSTRUMENT_CACHE_ACCESS(instrumentation, hit) StreamInstrumentation_count_cache_access(instrumentation, hit)
+#	define INSTRUMENT_ITERATOR_CREATED()				  StreamInstrumentation_count_iterator()
+#	define INSTRUMENT_ELEMENT_ITERATED()				  StreamInstrumentation_count_element()
+// Times the rest of the enclosing block, whichever way it is left, using the GNU cleanup attribute
+#	define INSTRUMENT_METRIC(stream, name)                                                                             \
+		MetricTimer metric_timer_##name __attribute__((cleanup(MetricTimer_stop))) =                                   \
+			MetricTimer_start((stream)->cache.instrumentation, METRIC_##name)
+#else
+#	define INSTRUMENT_CACHE_ACCESS(instrumentation, hit)
+#	define INSTRUMENT_ITERATOR_CREATED()
+#	define INSTRUMENT_ELEMENT_ITERATED()
+#	define INSTRUMENT_METRIC(stream, name)
+#endif
+/** @endcond */
+
+#endif // INSTRUMENTATION_H
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include "utils.h"
 #include "vector.h"
 
+#include <string.h>
+
 bool Interval_contains(Interval interval, TimeId time) {
 	return interval.start <= time && time < interval.end;
 }
@@ -27,10 +29,63 @@ Interval Interval_intersection(Interval a, Interval b) {
 	return intersection;
 }
 
+// The bounds of an interval, {start, end}, in a SIMD register : 128 bits fit in the baseline of most targets.
+typedef TimeId IntervalBounds __attribute__((vector_size(sizeof(Interval))));
+
+static inline IntervalBounds IntervalBounds_load(const Interval* interval) {
+	IntervalBounds bounds;
+	memcpy(&bounds, interval, sizeof(bounds));
+	return bounds;
+}
+
+// Clamps both bounds to [low, high], which empties the intervals outside of it
+static inline IntervalBounds IntervalBounds_clamp(IntervalBounds bounds, IntervalBounds low, IntervalBounds high) {
+	IntervalBounds below = (IntervalBounds)(bounds < low);
+	bounds = (bounds & ~below) | (low & below);
+	IntervalBounds above = (IntervalBounds)(bounds > high);
+	return (bounds & ~above) | (high & above);
+}
+
+// The sizes are summed as the sum of the ends minus the sum of the starts, with independent accumulators so that
+// several intervals are in flight. The modular arithmetic of size_t keeps it exact, as long as no interval is reversed,
+// which the sets of the library never are.
 size_t IntervalsSet_size(IntervalsSet intervals_set) {
-	size_t size = 0;
-	for (size_t i = 0; i < intervals_set.nb_intervals; i++) {
-		size += Interval_size(intervals_set.intervals[i]);
+	const Interval* intervals = intervals_set.intervals;
+	size_t nb_intervals = intervals_set.nb_intervals;
+	IntervalBounds sums_a = {0};
+	IntervalBounds sums_b = {0};
+	size_t i = 0;
+	for (; i + 2 <= nb_intervals; i += 2) {
+		sums_a += IntervalBounds_load(&intervals[i]);
+		sums_b += IntervalBounds_load(&intervals[i + 1]);
+	}
+	IntervalBounds sums = sums_a + sums_b;
+	size_t size = sums[1] - sums[0];
+	if (i < nb_intervals) {
+		size += Interval_size(intervals[i]);
+	}
+	return size;
+}
+
+size_t IntervalsSet_size_clipped(IntervalsSet intervals_set, Interval clip) {
+	if (clip.end < clip.start) {
+		return 0;
+	}
+	const Interval* intervals = intervals_set.intervals;
+	size_t nb_intervals = intervals_set.nb_intervals;
+	IntervalBounds low = {clip.start, clip.start};
+	IntervalBounds high = {clip.end, clip.end};
+	IntervalBounds sums_a = {0};
+	IntervalBounds sums_b = {0};
+	size_t i = 0;
+	for (; i + 2 <= nb_intervals; i += 2) {
+		sums_a += IntervalBounds_clamp(IntervalBounds_load(&intervals[i]), low, high);
+		sums_b += IntervalBounds_clamp(IntervalBounds_load(&intervals[i + 1]), low, high);
+	}
+	IntervalBounds sums = sums_a + sums_b;
+	size_t size = sums[1] - sums[0];
+	if (i < nb_intervals) {
+		size += Interval_size(Interval_intersection(intervals[i], clip));
 	}
 	return size;
 }
@@ -146,6 +201,39 @@ Interval IntervalsSet_last(IntervalsSet* intervals_set) {
 	return intervals_set->intervals[intervals_set->nb_intervals - 1];
 }
 
+Interval IntervalsSet_span_clipped(IntervalsSet intervals_set, Interval clip) {
+	const Interval* intervals = intervals_set.intervals;
+	// The first interval ending after the start of the clip
+	size_t low = 0;
+	size_t high = intervals_set.nb_intervals;
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		if (intervals[middle].end <= clip.start) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	size_t first = low;
+	// The first interval starting at or after the end of the clip, the last one inside is just before it
+	high = intervals_set.nb_intervals;
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		if (intervals[middle].start < clip.end) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	if (first >= low) {
+		return Interval_from(0, 0);
+	}
+	Interval span = Interval_from(intervals[first].start, intervals[low - 1].end);
+	return Interval_intersection(span, clip);
+}
+
 bool IntervalsSet_contains(IntervalsSet intervals_set, TimeId time) {
 	for (size_t i = 0; i < intervals_set.nb_intervals; i++) {
 		if (Interval_contains(intervals_set.intervals[i], time)) {
@@ -153,4 +241,47 @@ bool IntervalsSet_contains(IntervalsSet intervals_set, TimeId time) {
 		}
 	}
 	return false;
+}
+
+// Size of the intersection of two sets of intervals, without allocating it.
+// Assumes both sets are sorted and their intervals disjoint, so they can be merged in O(a + b)
+size_t IntervalsSet_intersection_size(IntervalsSet a, IntervalsSet b) {
+	size_t size = 0;
+	size_t i = 0;
+	size_t j = 0;
+	while (i < a.nb_intervals && j < b.nb_intervals) {
+		size += Interval_size(Interval_intersection(a.intervals[i], b.intervals[j]));
+		if (a.intervals[i].end < b.intervals[j].end) {
+			i++;
+		}
+		else {
+			j++;
+		}
+	}
+	return size;
+}
+
+// Same for three sets, merged at once in O(a + b + c) by always moving past the interval which ends first
+size_t IntervalsSet_intersection_size_of_three(IntervalsSet a, IntervalsSet b, IntervalsSet c) {
+	size_t size = 0;
+	size_t i = 0;
+	size_t j = 0;
+	size_t k = 0;
+	while (i < a.nb_intervals && j < b.nb_intervals && k < c.nb_intervals) {
+		Interval ab = Interval_intersection(a.intervals[i], b.intervals[j]);
+		size += Interval_size(Interval_intersection(ab, c.intervals[k]));
+		TimeId end_a = a.intervals[i].end;
+		TimeId end_b = b.intervals[j].end;
+		TimeId end_c = c.intervals[k].end;
+		if (end_a <= end_b && end_a <= end_c) {
+			i++;
+		}
+		else if (end_b <= end_c) {
+			j++;
+		}
+		else {
+			k++;
+		}
+	}
+	return size;
 }
\ No newline at end of file
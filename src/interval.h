@@ -29,11 +29,18 @@ DefVector(Interval, NO_FREE(Interval));
 int Interval_starts_before(const void* a, const void* b);
 
 size_t IntervalsSet_size(IntervalsSet intervals_set);
+// Total time of the intervals of the set inside clip
+size_t IntervalsSet_size_clipped(IntervalsSet intervals_set, Interval clip);
 IntervalsSet IntervalsSet_alloc(size_t nb_intervals);
 void IntervalsSet_merge(IntervalsSet* intervals_set);
 IntervalsSet IntervalsSet_intersection(IntervalsSet a, IntervalsSet b);
 IntervalsSet IntervalsSet_union(IntervalsSet a, IntervalsSet b);
 void IntervalsSet_destroy(IntervalsSet intervals_set);
 Interval IntervalsSet_last(IntervalsSet* intervals_set);
+// From the first to the last instant of the set inside clip, an empty interval if none is inside.
+// Assumes the set is sorted and its intervals disjoint, so they are found by binary search.
+Interval IntervalsSet_span_clipped(IntervalsSet intervals_set, Interval clip);
 bool IntervalsSet_contains(IntervalsSet intervals_set, TimeId time);
+size_t IntervalsSet_intersection_size(IntervalsSet a, IntervalsSet b);
+size_t IntervalsSet_intersection_size_of_three(IntervalsSet a, IntervalsSet b, IntervalsSet c);
 #endif // INTERVAL_H
\ No newline at end of file
@@ -3,6 +3,13 @@
 #include "units.h"
 
 size_t total_time_of(TimesIterator times) {
+	if (times.contiguous.intervals != NULL) {
+		INSTRUMENT_ITERATOR_CREATED();
+		size_t total_time = times.clipped ? IntervalsSet_size_clipped(times.contiguous, times.clip)
+										  : IntervalsSet_size(times.contiguous);
+		times.destroy(&times);
+		return total_time;
+	}
 	size_t total_time = 0;
 	FOR_EACH_TIME(interval, times) {
 		total_time += Interval_size(interval);
@@ -10,6 +17,15 @@ size_t total_time_of(TimesIterator times) {
 	return total_time;
 }
 
+IntervalsSet TimesIterator_collect(TimesIterator times) {
+	IntervalVector intervals = IntervalVector_new();
+	FOR_EACH_TIME(interval, times) {
+		IntervalVector_push(&intervals, interval);
+	}
+	IntervalsSet set = {.nb_intervals = intervals.size, .intervals = intervals.array};
+	return set;
+}
+
 typedef struct {
 	IntervalsSet intervals;
 	size_t current_interval;
@@ -62,6 +78,8 @@ TimesIterator TimesIterator_union(TimesIterator a, TimesIterator b) {
 		.iterator_data = data,
 		.next = (Interval(*)(void*))IntervalsIterator_next,
 		.destroy = (void (*)(void*))IntervalsIterator_destroy,
+		.contiguous = unioned,
+		.clipped = false,
 	};
 
 	IntervalVector_destroy(intervals);
@@ -99,6 +117,8 @@ TimesIterator TimesIterator_intersection(TimesIterator a, TimesIterator b) {
 		.iterator_data = MALLOC(sizeof(IntervalsIteratorData)),
 		.next = (Interval(*)(void*))IntervalsIterator_next,
 		.destroy = (void (*)(void*))IntervalsIterator_destroy,
+		.contiguous = intersected,
+		.clipped = false,
 	};
 
 	IntervalsIteratorData* data = (IntervalsIteratorData*)times.iterator_data;
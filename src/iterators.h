@@ -21,6 +21,7 @@
 
 #include "interval.h"
 #include "stream.h"
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -48,6 +49,10 @@ typedef struct {
 
 /**
  * @brief An iterator over a set of time intervals.
+ *
+ * When the intervals iterated are a contiguous array, like the presence of a node in a StreamGraph, the iterator can
+ * also expose it in contiguous, so that total_time_of sums it at once instead of calling next on each interval.
+ * The iterators which don't set it leave contiguous.intervals to NULL.
  */
 typedef struct {
 	Stream stream_graph;
@@ -55,18 +60,32 @@ typedef struct {
 	Interval (*next)(void*);
 	void (*destroy)(void*);
 	void (*skip_n)(void*, size_t);
+	IntervalsSet contiguous; /**< The intervals iterated, before clipping, if they are contiguous. */
+	bool clipped;			 /**< Whether the contiguous intervals are clipped to clip when iterated. */
+	Interval clip;			 /**< The interval the contiguous intervals are clipped to. */
 } TimesIterator;
 
 /** @cond */
 // TRICK : The || ({ x.destroy(&x); 0; }) executes the destroy function of the iterator when it ends
 // The destroy function is only called when the previous condition is false, and then evaluates to 0 (false)
 // This uses the GNU extension of "Statement Expressions"
-#define FOR_EACH(type_iterated, iterated, iterator, end_cond)                                                          \
-	for (type_iterated iterated = (iterator).next(&(iterator)); (end_cond) || ({                                       \
-																	(iterator).destroy(&(iterator));                   \
-																	0;                                                 \
-																});                                                    \
-		 (iterated) = (iterator).next(&(iterator)))
+#ifndef SGA_INSTRUMENTATION
+#	define FOR_EACH(type_iterated, iterated, iterator, end_cond)                                                       \
+		for (type_iterated iterated = (iterator).next(&(iterator)); (end_cond) || ({                                   \
+																		(iterator).destroy(&(iterator));               \
+																		0;                                             \
+																	});                                                \
+			 (iterated) = (iterator).next(&(iterator)))
+#else
+// Same, but also counts the iterator when it starts and each element when the end condition holds
+#	define FOR_EACH(type_iterated, iterated, iterator, end_cond)                                                       \
+		for (type_iterated iterated = (INSTRUMENT_ITERATOR_CREATED(), (iterator).next(&(iterator)));                   \
+			 ((end_cond) && (INSTRUMENT_ELEMENT_ITERATED(), 1)) || ({                                                  \
+				 (iterator).destroy(&(iterator));                                                                      \
+				 0;                                                                                                    \
+			 });                                                                                                       \
+			 (iterated) = (iterator).next(&(iterator)))
+#endif
 /** @endcond */
 
 /**
@@ -91,6 +110,16 @@ typedef struct {
  */
 size_t total_time_of(TimesIterator times);
 
+/**
+ * @brief Collects the given set of time intervals into an IntervalsSet.
+ *
+ * Useful when the same set of intervals needs to be read several times.
+ * Consumes the iterator. The result must be freed with IntervalsSet_destroy.
+ * @param times The set of time intervals.
+ * @return The intervals, in the order they were iterated.
+ */
+IntervalsSet TimesIterator_collect(TimesIterator times);
+
 /** @cond */
 #define _COUNT_ITERATOR(type, iterated, iterator, end_cond)                                                            \
 	({                                                                                                                 \
@@ -7,114 +7,583 @@
 #include "stream/chunk_stream_small.h"
 #include "stream/full_stream_graph.h"
 #include "stream/link_stream.h"
+#include "stream/substream.h"
 #include "stream_functions.h"
 #include "stream_graph.h"
+#include "thread_pool.h"
+#include "timeline.h"
 #include "units.h"
 #include <assert.h>
+#include <stdatomic.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
 
-// TODO : Confirm this
-// I hope gcc or clang does this optimisation :
-// ```
-// int a = 0;
-// int b = 0;
-// if (condition) {
-//     a = 5;
-// }
-// if (condition) {
-//     b = 5;
-// }
-// ```
-// into
-// ```
-// int a = 0;
-// int b = 0;
-// if (condition) {
-//     a = 5;
-//     b = 5;
-// }
-// ```
-// Otherwise the performance is going to be baaaaaaaaaaaaaaaaaaaaad
+// Returns the specialised implementation of the metric if the type of the Stream has one
 #define CATCH_METRICS_IMPLEM(function, stream)                                                                         \
-	switch (stream->type) {                                                                                            \
-		case FULL_STREAM_GRAPH: {                                                                                      \
-			if (FullStreamGraph_metrics_functions.function != NULL) {                                                  \
-				return FullStreamGraph_metrics_functions.function(stream->stream);                                     \
-			}                                                                                                          \
-			break;                                                                                                     \
-		}                                                                                                              \
-		case LINK_STREAM: {                                                                                            \
-			if (LinkStream_metrics_functions.function != NULL) {                                                       \
-				return LinkStream_metrics_functions.function(stream->stream);                                          \
-			}                                                                                                          \
-			break;                                                                                                     \
-		}                                                                                                              \
-		case CHUNK_STREAM: {                                                                                           \
-			if (ChunkStream_metrics_functions.function != NULL) {                                                      \
-				return ChunkStream_metrics_functions.function(stream->stream);                                         \
-			}                                                                                                          \
-			break;                                                                                                     \
-		}                                                                                                              \
-		case CHUNK_STREAM_SMALL: {                                                                                     \
-			if (ChunkStreamSmall_metrics_functions.function != NULL) {                                                 \
-				return ChunkStreamSmall_metrics_functions.function(stream->stream);                                    \
-			}                                                                                                          \
-			break;                                                                                                     \
-		}                                                                                                              \
-	}                                                                                                                  \
-	printf("COULD NOT CATCH " #function "\n");
+	if ((stream)->metrics_functions->function != NULL) {                                                               \
+		return (stream)->metrics_functions->function((stream)->stream);                                                \
+	}
 
 // TODO : rename the functions to be more explicit
 // TODO : rewrite them to be cleaner
-size_t cardinalOfT(Stream* stream) {
-	FETCH_CACHE(stream, cardinalOfT);
+// The cardinals are computed in separate functions, since a cached value claimed by FETCH_CACHE must be published by
+// UPDATE_CACHE, even when a specialised implementation returns early.
+static size_t compute_cardinalOfT(Stream* stream) {
 	CATCH_METRICS_IMPLEM(cardinalOfT, stream);
-	StreamFunctions stream_functions = STREAM_FUNCS(stream_functions, stream);
-	Interval lifespan = stream_functions.lifespan(stream->stream);
-	UPDATE_CACHE(stream, cardinalOfT, Interval_size(lifespan));
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	Interval lifespan = stream_functions->lifespan(stream->stream);
 	return Interval_size(lifespan);
 }
 
+size_t cardinalOfT(Stream* stream) {
+	INSTRUMENT_METRIC(stream, cardinalOfT);
+	FETCH_CACHE(stream, cardinalOfT);
+	size_t count = compute_cardinalOfT(stream);
+	UPDATE_CACHE(stream, cardinalOfT, count);
+	return count;
+}
+
+static size_t compute_cardinalOfV(Stream* stream) {
+	CATCH_METRICS_IMPLEM(cardinalOfV, stream);
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	NodesIterator nodes = stream_functions->nodes_set(stream->stream);
+	return COUNT_ITERATOR(nodes);
+}
+
 size_t cardinalOfV(Stream* stream) {
+	INSTRUMENT_METRIC(stream, cardinalOfV);
 	FETCH_CACHE(stream, cardinalOfV);
-	CATCH_METRICS_IMPLEM(cardinalOfV, stream);
-	StreamFunctions stream_functions = STREAM_FUNCS(stream_functions, stream);
-	NodesIterator nodes = stream_functions.nodes_set(stream->stream);
-	size_t count = COUNT_ITERATOR(nodes);
+	size_t count = compute_cardinalOfV(stream);
 	UPDATE_CACHE(stream, cardinalOfV, count);
 	return count;
 }
 
-size_t cardinalOfE(Stream* stream) {
-	// CATCH_METRICS_IMPLEM(cardinalOfE, stream);
-	FETCH_CACHE(stream, cardinalOfE);
-	StreamFunctions stream_functions = STREAM_FUNCS(stream_functions, stream);
-	LinksIterator links = stream_functions.links_set(stream->stream);
-	size_t count = 0;
+size_t size_set_unordered_pairs_itself(size_t n) {
+	return n * (n - 1) / 2;
+}
+
+// Number of nodes or links per chunk of the parallel loops. The loops whose elements cost O(V) each use smaller chunks
+// to balance the work between the workers.
+#define ELEMENTS_PER_CHUNK 256
+#define HEAVY_ELEMENTS_PER_CHUNK 8
+
+// The ids of the nodes or links of a Stream, gathered once so that the loops over them can be split in ranges between
+// the workers of the thread pool.
+typedef struct {
+	Stream* stream;
+	const StreamFunctions* stream_functions;
+	size_t nb_elements;
+	size_t* ids;
+	size_t* times; // Output of the loops filling the memo table, indexed by id
+	const size_t* nodes_times;
+	const size_t* links_times;
+	const size_t* degree_sums;
+	const size_t* triangles_times;
+	const size_t* wedges_times;
+	double t;
+	double w;
+} ParallelMetricContext;
+
+static ParallelMetricContext ParallelMetricContext_over_nodes(Stream* stream, const StreamFunctions* stream_functions) {
+	NodeIdVector ids = NodeIdVector_new();
+	NodesIterator nodes = stream_functions->nodes_set(stream->stream);
+	FOR_EACH_NODE(node_id, nodes) {
+		NodeIdVector_push(&ids, node_id);
+	}
+	return (ParallelMetricContext){
+		.stream = stream,
+		.stream_functions = stream_functions,
+		.nb_elements = ids.size,
+		.ids = ids.array,
+	};
+}
+
+static ParallelMetricContext ParallelMetricContext_over_links(Stream* stream, const StreamFunctions* stream_functions) {
+	LinkIdVector ids = LinkIdVector_new();
+	LinksIterator links = stream_functions->links_set(stream->stream);
 	FOR_EACH_LINK(link_id, links) {
-		TimesIterator times = stream_functions.times_link_present(stream->stream, link_id);
-		count += total_time_of(times);
+		LinkIdVector_push(&ids, link_id);
+	}
+	return (ParallelMetricContext){
+		.stream = stream,
+		.stream_functions = stream_functions,
+		.nb_elements = ids.size,
+		.ids = ids.array,
+	};
+}
+
+static void ParallelMetricContext_destroy(ParallelMetricContext context) {
+	free(context.ids);
+}
+
+// An array of the memo table, indexed by the ids of the context, and filled with 0
+static MemoValue MemoValue_indexed_by_ids(ParallelMetricContext* context) {
+	size_t nb_values = 0;
+	for (size_t i = 0; i < context->nb_elements; i++) {
+		if (context->ids[i] + 1 > nb_values) {
+			nb_values = context->ids[i] + 1;
+		}
+	}
+	return (MemoValue){.nb_values = nb_values, .values = calloc(nb_values + 1, sizeof(size_t))};
+}
+
+static void write_times_of_nodes(void* context, size_t chunk_index, size_t from, size_t to) {
+	(void)chunk_index;
+	ParallelMetricContext* ctx = (ParallelMetricContext*)context;
+	for (size_t i = from; i < to; i++) {
+		ctx->times[ctx->ids[i]] = total_time_of(ctx->stream_functions->times_node_present(ctx->stream->stream, ctx->ids[i]));
+	}
+}
+
+static void write_times_of_links(void* context, size_t chunk_index, size_t from, size_t to) {
+	(void)chunk_index;
+	ParallelMetricContext* ctx = (ParallelMetricContext*)context;
+	for (size_t i = from; i < to; i++) {
+		ctx->times[ctx->ids[i]] = total_time_of(ctx->stream_functions->times_link_present(ctx->stream->stream, ctx->ids[i]));
+	}
+}
+
+static MemoValue compute_times_node_present(Stream* stream) {
+	CATCH_METRICS_IMPLEM(times_node_present, stream);
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	ParallelMetricContext context = ParallelMetricContext_over_nodes(stream, stream_functions);
+	MemoValue times = MemoValue_indexed_by_ids(&context);
+	context.times = times.values;
+	ThreadPool_parallel_for(ThreadPool_global(), context.nb_elements, ELEMENTS_PER_CHUNK, write_times_of_nodes,
+							&context);
+	ParallelMetricContext_destroy(context);
+	return times;
+}
+
+static MemoValue compute_times_link_present(Stream* stream) {
+	CATCH_METRICS_IMPLEM(times_link_present, stream);
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	ParallelMetricContext context = ParallelMetricContext_over_links(stream, stream_functions);
+	MemoValue times = MemoValue_indexed_by_ids(&context);
+	context.times = times.values;
+	ThreadPool_parallel_for(ThreadPool_global(), context.nb_elements, ELEMENTS_PER_CHUNK, write_times_of_links,
+							&context);
+	ParallelMetricContext_destroy(context);
+	return times;
+}
+
+static void write_degree_sums(void* context, size_t chunk_index, size_t from, size_t to) {
+	(void)chunk_index;
+	ParallelMetricContext* ctx = (ParallelMetricContext*)context;
+	for (size_t i = from; i < to; i++) {
+		LinksIterator neighbours = ctx->stream_functions->neighbours_of_node(ctx->stream->stream, ctx->ids[i]);
+		size_t sum = 0;
+		FOR_EACH_LINK(link_id, neighbours) {
+			sum += ctx->links_times[link_id];
+		}
+		ctx->times[ctx->ids[i]] = sum;
+	}
+}
+
+// Sums the presence times of the neighbours of each node, the ones of the links are read from the memo table
+static MemoValue compute_degree_sums(Stream* stream) {
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	MemoValue links_times = Stream_memo_acquire(stream, MEMO_TIMES_LINK_PRESENT, compute_times_link_present);
+	if (stream->metrics_functions->degree_sums != NULL) {
+		MemoValue degree_sums = stream->metrics_functions->degree_sums(stream->stream, links_times);
+		Stream_memo_release(stream, MEMO_TIMES_LINK_PRESENT, links_times);
+		return degree_sums;
+	}
+	ParallelMetricContext context = ParallelMetricContext_over_nodes(stream, stream_functions);
+	MemoValue degree_sums = MemoValue_indexed_by_ids(&context);
+	context.times = degree_sums.values;
+	context.links_times = links_times.values;
+	ThreadPool_parallel_for(ThreadPool_global(), context.nb_elements, ELEMENTS_PER_CHUNK, write_degree_sums, &context);
+	ParallelMetricContext_destroy(context);
+	Stream_memo_release(stream, MEMO_TIMES_LINK_PRESENT, links_times);
+	return degree_sums;
+}
+
+static void write_nodes_intersection_of_links(void* context, size_t chunk_index, size_t from, size_t to) {
+	(void)chunk_index;
+	ParallelMetricContext* ctx = (ParallelMetricContext*)context;
+	void* st = ctx->stream->stream;
+	for (size_t i = from; i < to; i++) {
+		Link link = ctx->stream_functions->nth_link(st, ctx->ids[i]);
+		IntervalsSet times_u = TimesIterator_collect(ctx->stream_functions->times_node_present(st, link.nodes[0]));
+		IntervalsSet times_v = TimesIterator_collect(ctx->stream_functions->times_node_present(st, link.nodes[1]));
+		ctx->times[ctx->ids[i]] = IntervalsSet_intersection_size(times_u, times_v);
+		IntervalsSet_destroy(times_u);
+		IntervalsSet_destroy(times_v);
 	}
+}
+
+static MemoValue compute_nodes_intersection_of_links(Stream* stream) {
+	CATCH_METRICS_IMPLEM(nodes_intersection_of_links, stream);
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	ParallelMetricContext context = ParallelMetricContext_over_links(stream, stream_functions);
+	MemoValue intersections = MemoValue_indexed_by_ids(&context);
+	context.times = intersections.values;
+	ThreadPool_parallel_for(ThreadPool_global(), context.nb_elements, HEAVY_ELEMENTS_PER_CHUNK,
+							write_nodes_intersection_of_links, &context);
+	ParallelMetricContext_destroy(context);
+	return intersections;
+}
+
+// Sweeps the events of the Stream, the pairs of nodes present during [t, t') are C(|V_t|, 2)
+static MemoValue compute_sum_pairs_of_nodes(Stream* stream) {
+	Timeline timeline = Timeline_from(stream);
+	size_t nb_nodes = 0;
+	size_t sum = 0;
+	TimeId previous_instant = timeline.lifespan.start;
+	for (size_t i = 0; i < timeline.nb_events; i++) {
+		TimelineEvent event = timeline.events[i];
+		sum += size_set_unordered_pairs_itself(nb_nodes) * (event.instant - previous_instant);
+		previous_instant = event.instant;
+		if (TimelineEvent_is_node(event)) {
+			nb_nodes = TimelineEvent_is_appearance(event) ? nb_nodes + 1 : nb_nodes - 1;
+		}
+	}
+	Timeline_destroy(timeline);
+	MemoValue value = {.nb_values = 1, .values = MALLOC(sizeof(size_t))};
+	value.values[0] = sum;
+	return value;
+}
+
+static int compare_time_ids(const void* a, const void* b) {
+	TimeId time_a = *(const TimeId*)a;
+	TimeId time_b = *(const TimeId*)b;
+	return (time_a > time_b) - (time_a < time_b);
+}
+
+// The pairs of links of a node present together at t are C(k_t, 2), with k_t the number of its links present at t.
+// Their total time is found by sweeping the bounds of the presences of its links, in O(I log I) for I intervals,
+// instead of intersecting the presences of every pair of links.
+static size_t wedges_time_of_node(const StreamFunctions* stream_functions, void* stream, NodeId node_id) {
+	IntervalVector intervals = IntervalVector_new();
+	LinksIterator neighbours = stream_functions->neighbours_of_node(stream, node_id);
+	FOR_EACH_LINK(link_id, neighbours) {
+		TimesIterator times = stream_functions->times_link_present(stream, link_id);
+		FOR_EACH_TIME(interval, times) {
+			IntervalVector_push(&intervals, interval);
+		}
+	}
+	size_t nb_intervals = intervals.size;
+	TimeId* starts = MALLOC((nb_intervals + 1) * sizeof(TimeId));
+	TimeId* ends = MALLOC((nb_intervals + 1) * sizeof(TimeId));
+	for (size_t i = 0; i < nb_intervals; i++) {
+		starts[i] = intervals.array[i].start;
+		ends[i] = intervals.array[i].end;
+	}
+	IntervalVector_destroy(intervals);
+	qsort(starts, nb_intervals, sizeof(TimeId), compare_time_ids);
+	qsort(ends, nb_intervals, sizeof(TimeId), compare_time_ids);
+
+	// The intervals are open on the right, so the disappearances at an instant are applied before the appearances
+	size_t sum = 0;
+	size_t nb_present = 0;
+	TimeId previous_instant = 0;
+	size_t next_start = 0;
+	size_t next_end = 0;
+	while (next_end < nb_intervals) {
+		bool appearance = next_start < nb_intervals && starts[next_start] < ends[next_end];
+		TimeId instant = appearance ? starts[next_start] : ends[next_end];
+		sum += size_set_unordered_pairs_itself(nb_present) * (instant - previous_instant);
+		previous_instant = instant;
+		if (appearance) {
+			nb_present++;
+			next_start++;
+		}
+		else {
+			nb_present--;
+			next_end++;
+		}
+	}
+	free(starts);
+	free(ends);
+	return sum;
+}
+
+static void write_wedges_times(void* context, size_t chunk_index, size_t from, size_t to) {
+	(void)chunk_index;
+	ParallelMetricContext* ctx = (ParallelMetricContext*)context;
+	for (size_t i = from; i < to; i++) {
+		ctx->times[ctx->ids[i]] = wedges_time_of_node(ctx->stream_functions, ctx->stream->stream, ctx->ids[i]);
+	}
+}
+
+static MemoValue compute_wedges_times(Stream* stream) {
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	ParallelMetricContext context = ParallelMetricContext_over_nodes(stream, stream_functions);
+	MemoValue wedges = MemoValue_indexed_by_ids(&context);
+	context.times = wedges.values;
+	ThreadPool_parallel_for(ThreadPool_global(), context.nb_elements, HEAVY_ELEMENTS_PER_CHUNK, write_wedges_times,
+							&context);
+	ParallelMetricContext_destroy(context);
+	return wedges;
+}
+
+// A link of the static graph of a Stream, seen from one of its nodes
+typedef struct {
+	size_t node; // The other node of the link
+	LinkId link;
+} TriangleEdge;
+
+static int TriangleEdge_compare(const void* a, const void* b) {
+	size_t node_a = ((const TriangleEdge*)a)->node;
+	size_t node_b = ((const TriangleEdge*)b)->node;
+	return (node_a > node_b) - (node_a < node_b);
+}
+
+static NodeId other_node_of_link(Link link, NodeId node_id) {
+	return link.nodes[0] == node_id ? link.nodes[1] : link.nodes[0];
+}
+
+// The static graph of the links of a Stream, oriented to enumerate its triangles : the nodes are ranked by degree,
+// then by index, and each link only goes from its node of lower rank to the other one. Each triangle is then found
+// once, from its node of lowest rank u, by merging the sorted successors of u with the ones of its successor v.
+// Since a node only keeps O(√E) successors this way, there are O(E √E) triangles to check at most.
+typedef struct {
+	size_t nb_nodes;
+	size_t* ids;		   // The ids of the nodes of the Stream, the graph uses their indexes in this array instead
+	size_t nb_node_ids;	   // The largest node id plus one, 0 if there are no nodes
+	size_t* offsets;	   // The successors of the node of index i are the edges from offsets[i] to offsets[i + 1]
+	TriangleEdge* edges;   // The successors of each node, sorted by index
+	size_t nb_link_ids;	   // The largest link id plus one, 0 if there are no links
+	IntervalsSet* links_presence;	// Indexed by link id, empty for the links absent from the Stream
+	atomic_size_t* triangles_times; // Indexed like ids, added to by the workers
+} TriangleGraph;
+
+static bool ranks_before(const size_t* degrees, size_t a, size_t b) {
+	return degrees[a] < degrees[b] || (degrees[a] == degrees[b] && a < b);
+}
+
+static TriangleGraph TriangleGraph_from(Stream* stream) {
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	void* st = stream->stream;
+	TriangleGraph graph = {0};
+
+	NodeIdVector ids = NodeIdVector_new();
+	NodesIterator nodes = stream_functions->nodes_set(st);
+	FOR_EACH_NODE(node_id, nodes) {
+		NodeIdVector_push(&ids, node_id);
+		graph.nb_node_ids = node_id + 1 > graph.nb_node_ids ? node_id + 1 : graph.nb_node_ids;
+	}
+	graph.nb_nodes = ids.size;
+	graph.ids = ids.array;
+	size_t* index_of_node = MALLOC((graph.nb_node_ids + 1) * sizeof(size_t));
+	for (size_t i = 0; i < graph.nb_nodes; i++) {
+		index_of_node[graph.ids[i]] = i;
+	}
+
+	LinkIdVector links = LinkIdVector_new();
+	LinksIterator links_set = stream_functions->links_set(st);
+	FOR_EACH_LINK(link_id, links_set) {
+		LinkIdVector_push(&links, link_id);
+		graph.nb_link_ids = link_id + 1 > graph.nb_link_ids ? link_id + 1 : graph.nb_link_ids;
+	}
+	graph.links_presence = calloc(graph.nb_link_ids + 1, sizeof(IntervalsSet));
+	size_t* degrees = calloc(graph.nb_nodes + 1, sizeof(size_t));
+	for (size_t i = 0; i < links.size; i++) {
+		Link link = stream_functions->nth_link(st, links.array[i]);
+		degrees[index_of_node[link.nodes[0]]]++;
+		degrees[index_of_node[link.nodes[1]]]++;
+		graph.links_presence[links.array[i]] =
+			TimesIterator_collect(stream_functions->times_link_present(st, links.array[i]));
+	}
+
+	// Counting sort of the links by their node of lower rank
+	graph.offsets = calloc(graph.nb_nodes + 2, sizeof(size_t));
+	graph.edges = MALLOC((links.size + 1) * sizeof(TriangleEdge));
+	for (size_t i = 0; i < links.size; i++) {
+		Link link = stream_functions->nth_link(st, links.array[i]);
+		size_t u = index_of_node[link.nodes[0]];
+		size_t v = index_of_node[link.nodes[1]];
+		graph.offsets[(ranks_before(degrees, u, v) ? u : v) + 2]++;
+	}
+	for (size_t i = 2; i < graph.nb_nodes + 2; i++) {
+		graph.offsets[i] += graph.offsets[i - 1];
+	}
+	for (size_t i = 0; i < links.size; i++) {
+		Link link = stream_functions->nth_link(st, links.array[i]);
+		size_t u = index_of_node[link.nodes[0]];
+		size_t v = index_of_node[link.nodes[1]];
+		size_t lower = ranks_before(degrees, u, v) ? u : v;
+		graph.edges[graph.offsets[lower + 1]++] = (TriangleEdge){.node = lower == u ? v : u, .link = links.array[i]};
+	}
+	for (size_t i = 0; i < graph.nb_nodes; i++) {
+		qsort(graph.edges + graph.offsets[i], graph.offsets[i + 1] - graph.offsets[i], sizeof(TriangleEdge),
+			  TriangleEdge_compare);
+	}
+
+	graph.triangles_times = MALLOC((graph.nb_nodes + 1) * sizeof(atomic_size_t));
+	for (size_t i = 0; i < graph.nb_nodes; i++) {
+		atomic_init(&graph.triangles_times[i], 0);
+	}
+	free(degrees);
+	free(index_of_node);
+	LinkIdVector_destroy(links);
+	return graph;
+}
+
+static void TriangleGraph_destroy(TriangleGraph graph) {
+	for (size_t i = 0; i < graph.nb_link_ids; i++) {
+		IntervalsSet_destroy(graph.links_presence[i]);
+	}
+	free(graph.links_presence);
+	free(graph.triangles_times);
+	free(graph.edges);
+	free(graph.offsets);
+	free(graph.ids);
+}
+
+static void add_triangle_time(TriangleGraph* graph, size_t node, size_t time) {
+	atomic_fetch_add_explicit(&graph->triangles_times[node], time, memory_order_relaxed);
+}
+
+// The triangles found from the nodes of the range, added to the times of their three nodes
+static void count_triangles_from_nodes(void* context, size_t chunk_index, size_t from, size_t to) {
+	(void)chunk_index;
+	TriangleGraph* graph = (TriangleGraph*)context;
+	const TriangleEdge* edges = graph->edges;
+	for (size_t u = from; u < to; u++) {
+		for (size_t e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+			size_t v = edges[e].node;
+			IntervalsSet presence_uv = graph->links_presence[edges[e].link];
+			size_t i = graph->offsets[u];
+			size_t j = graph->offsets[v];
+			while (i < graph->offsets[u + 1] && j < graph->offsets[v + 1]) {
+				if (edges[i].node < edges[j].node) {
+					i++;
+				}
+				else if (edges[i].node > edges[j].node) {
+					j++;
+				}
+				else {
+					size_t time = IntervalsSet_intersection_size_of_three(
+						presence_uv, graph->links_presence[edges[i].link], graph->links_presence[edges[j].link]);
+					if (time != 0) {
+						add_triangle_time(graph, u, time);
+						add_triangle_time(graph, v, time);
+						add_triangle_time(graph, edges[i].node, time);
+					}
+					i++;
+					j++;
+				}
+			}
+		}
+	}
+}
+
+// The triangles are counted in parallel, and the integer additions don't depend on the order of the workers
+static MemoValue compute_triangles_times(Stream* stream) {
+	TriangleGraph graph = TriangleGraph_from(stream);
+	ThreadPool_parallel_for(ThreadPool_global(), graph.nb_nodes, HEAVY_ELEMENTS_PER_CHUNK, count_triangles_from_nodes,
+							&graph);
+	MemoValue triangles = {.nb_values = graph.nb_node_ids, .values = calloc(graph.nb_node_ids + 1, sizeof(size_t))};
+	for (size_t i = 0; i < graph.nb_nodes; i++) {
+		triangles.values[graph.ids[i]] = atomic_load_explicit(&graph.triangles_times[i], memory_order_relaxed);
+	}
+	TriangleGraph_destroy(graph);
+	return triangles;
+}
+
+// The triangles of a single node, without building the graph of the whole Stream : its neighbours are sorted, and the
+// links of each of them are searched for the other ones, in O(Σ over the neighbours of d(u) log(d(v)) + merges).
+static size_t triangles_time_of_node(const StreamFunctions* stream_functions, void* stream, NodeId node_id) {
+	LinkIdVector links = LinkIdVector_new();
+	LinksIterator links_of_node = stream_functions->neighbours_of_node(stream, node_id);
+	FOR_EACH_LINK(link_id, links_of_node) {
+		LinkIdVector_push(&links, link_id);
+	}
+	size_t degree = links.size;
+	TriangleEdge* neighbours = MALLOC((degree + 1) * sizeof(TriangleEdge));
+	for (size_t i = 0; i < degree; i++) {
+		Link link = stream_functions->nth_link(stream, links.array[i]);
+		neighbours[i] = (TriangleEdge){.node = other_node_of_link(link, node_id), .link = links.array[i]};
+	}
+	LinkIdVector_destroy(links);
+	qsort(neighbours, degree, sizeof(TriangleEdge), TriangleEdge_compare);
+	IntervalsSet* presences = MALLOC((degree + 1) * sizeof(IntervalsSet));
+	for (size_t i = 0; i < degree; i++) {
+		presences[i] = TimesIterator_collect(stream_functions->times_link_present(stream, neighbours[i].link));
+	}
+
+	size_t sum = 0;
+	for (size_t i = 0; i < degree; i++) {
+		LinksIterator links_of_neighbour = stream_functions->neighbours_of_node(stream, neighbours[i].node);
+		FOR_EACH_LINK(link_id, links_of_neighbour) {
+			TriangleEdge closing = {
+				.node = other_node_of_link(stream_functions->nth_link(stream, link_id), neighbours[i].node),
+				.link = link_id,
+			};
+			// Each pair of neighbours is only counted from the first one
+			TriangleEdge* found = NULL;
+			if (closing.node > neighbours[i].node) {
+				found = bsearch(&closing, neighbours, degree, sizeof(TriangleEdge), TriangleEdge_compare);
+			}
+			if (found != NULL) {
+				IntervalsSet presence = TimesIterator_collect(stream_functions->times_link_present(stream, link_id));
+				sum += IntervalsSet_intersection_size_of_three(presences[i], presences[found - neighbours], presence);
+				IntervalsSet_destroy(presence);
+			}
+		}
+	}
+	for (size_t i = 0; i < degree; i++) {
+		IntervalsSet_destroy(presences[i]);
+	}
+	free(presences);
+	free(neighbours);
+	return sum;
+}
+
+MemoValue Stream_memo_acquire_metric(Stream* stream, MemoKey key) {
+	static const MemoCompute computes[MEMO_NB_KEYS] = {
+		[MEMO_TIMES_NODE_PRESENT] = compute_times_node_present,
+		[MEMO_TIMES_LINK_PRESENT] = compute_times_link_present,
+		[MEMO_DEGREE_SUMS] = compute_degree_sums,
+		[MEMO_SUM_PAIRS_OF_NODES] = compute_sum_pairs_of_nodes,
+		[MEMO_NODES_INTERSECTION_OF_LINKS] = compute_nodes_intersection_of_links,
+		[MEMO_WEDGES_TIMES] = compute_wedges_times,
+		[MEMO_TRIANGLES_TIMES] = compute_triangles_times,
+	};
+	return Stream_memo_acquire(stream, key, computes[key]);
+}
+
+static size_t sum_of_memo_array(Stream* stream, MemoKey key, MemoCompute compute) {
+	MemoValue value = Stream_memo_acquire(stream, key, compute);
+	size_t sum = 0;
+	for (size_t i = 0; i < value.nb_values; i++) {
+		sum += value.values[i];
+	}
+	Stream_memo_release(stream, key, value);
+	return sum;
+}
+
+static size_t compute_cardinalOfE(Stream* stream) {
+	CATCH_METRICS_IMPLEM(cardinalOfE, stream);
+	return sum_of_memo_array(stream, MEMO_TIMES_LINK_PRESENT, compute_times_link_present);
+}
+
+size_t cardinalOfE(Stream* stream) {
+	INSTRUMENT_METRIC(stream, cardinalOfE);
+	FETCH_CACHE(stream, cardinalOfE);
+	size_t count = compute_cardinalOfE(stream);
 	UPDATE_CACHE(stream, cardinalOfE, count);
 	return count;
 }
 
+static size_t compute_cardinalOfW(Stream* stream) {
+	CATCH_METRICS_IMPLEM(cardinalOfW, stream);
+	return sum_of_memo_array(stream, MEMO_TIMES_NODE_PRESENT, compute_times_node_present);
+}
+
 size_t cardinalOfW(Stream* stream) {
+	INSTRUMENT_METRIC(stream, cardinalOfW);
 	FETCH_CACHE(stream, cardinalOfW);
-	CATCH_METRICS_IMPLEM(cardinalOfW, stream);
-	StreamFunctions stream_functions = STREAM_FUNCS(stream_functions, stream);
-	NodesIterator nodes = stream_functions.nodes_set(stream->stream);
-	size_t count = 0;
-	FOR_EACH_NODE(node_id, nodes) {
-		TimesIterator times = stream_functions.times_node_present(nodes.stream_graph.stream, node_id);
-		count += total_time_of(times);
-	}
+	size_t count = compute_cardinalOfW(stream);
 	UPDATE_CACHE(stream, cardinalOfW, count);
 	return count;
 }
 
 double Stream_coverage(Stream* stream) {
+	INSTRUMENT_METRIC(stream, coverage);
 	CATCH_METRICS_IMPLEM(coverage, stream);
 	size_t w = cardinalOfW(stream);
 	size_t t = cardinalOfT(stream);
@@ -124,33 +593,53 @@ double Stream_coverage(Stream* stream) {
 }
 
 double Stream_node_duration(Stream* stream) {
+	INSTRUMENT_METRIC(stream, node_duration);
 	CATCH_METRICS_IMPLEM(node_duration, stream);
-	StreamFunctions stream_functions = STREAM_FUNCS(stream_functions, stream);
+	const StreamFunctions* stream_functions = stream->stream_functions;
 	size_t w = cardinalOfW(stream);
 	size_t v = cardinalOfV(stream);
-	size_t scaling = stream_functions.scaling(stream->stream);
+	size_t scaling = stream_functions->scaling(stream->stream);
 	return (double)w / (double)(v * scaling);
 }
 
+// Reads the value of an element in an array of the memo table if it was already computed, a single element is cheaper
+// to compute directly than the whole array
+static bool fetch_memo_element(Stream* stream, MemoKey key, size_t id, size_t* element) {
+	MemoValue value;
+	if (!Stream_memo_fetch(stream, key, &value)) {
+		return false;
+	}
+	*element = id < value.nb_values ? value.values[id] : 0;
+	Stream_memo_release(stream, key, value);
+	return true;
+}
+
 double Stream_contribution_of_node(Stream* stream, NodeId node_id) {
+	INSTRUMENT_METRIC(stream, contribution_of_node);
 	// CATCH_METRICS_IMPLEM(contribution_of_node, stream);
-	StreamFunctions stream_functions = STREAM_FUNCS(stream_functions, stream);
-	TimesIterator times = stream_functions.times_node_present(stream->stream, node_id);
-	size_t t_v = total_time_of(times);
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	size_t t_v;
+	if (!fetch_memo_element(stream, MEMO_TIMES_NODE_PRESENT, node_id, &t_v)) {
+		t_v = total_time_of(stream_functions->times_node_present(stream->stream, node_id));
+	}
 	size_t t = cardinalOfT(stream);
 	return (double)t_v / (double)t;
 }
 
 double Stream_contribution_of_link(Stream* stream, LinkId link_id) {
+	INSTRUMENT_METRIC(stream, contribution_of_link);
 	// CATCH_METRICS_IMPLEM(contribution_of_link, stream);
-	StreamFunctions stream_functions = STREAM_FUNCS(stream_functions, stream);
-	TimesIterator times = stream_functions.times_link_present(stream->stream, link_id);
-	size_t t_v = total_time_of(times);
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	size_t t_v;
+	if (!fetch_memo_element(stream, MEMO_TIMES_LINK_PRESENT, link_id, &t_v)) {
+		t_v = total_time_of(stream_functions->times_link_present(stream->stream, link_id));
+	}
 	size_t t = cardinalOfT(stream);
 	return (double)t_v / (double)(t);
 }
 
 double Stream_number_of_nodes(Stream* stream) {
+	INSTRUMENT_METRIC(stream, number_of_nodes);
 	// CATCH_METRICS_IMPLEM(number_of_nodes, stream);
 	size_t w = cardinalOfW(stream);
 	size_t t = cardinalOfT(stream);
@@ -158,6 +647,7 @@ double Stream_number_of_nodes(Stream* stream) {
 }
 
 double Stream_number_of_links(Stream* stream) {
+	INSTRUMENT_METRIC(stream, number_of_links);
 	// CATCH_METRICS_IMPLEM(number_of_links, stream);
 	size_t e = cardinalOfE(stream);
 	size_t t = cardinalOfT(stream);
@@ -165,191 +655,218 @@ double Stream_number_of_links(Stream* stream) {
 }
 
 double Stream_node_contribution_at_instant(Stream* stream, TimeId time_id) {
+	INSTRUMENT_METRIC(stream, node_contribution_at_instant);
 	// CATCH_METRICS_IMPLEM(node_contribution_at_time, stream);
-	StreamFunctions stream_functions = STREAM_FUNCS(stream_functions, stream);
-	NodesIterator nodes = stream_functions.nodes_present_at_t(stream->stream, time_id);
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	NodesIterator nodes = stream_functions->nodes_present_at_t(stream->stream, time_id);
 	size_t v_t = COUNT_ITERATOR(nodes);
-	size_t scaling = stream_functions.scaling(stream->stream);
+	size_t scaling = stream_functions->scaling(stream->stream);
 	size_t v = cardinalOfV(stream);
 	return (double)v_t / (double)(v * scaling);
 }
 
-size_t size_set_unordered_pairs_itself(size_t n) {
-	return n * (n - 1) / 2;
-}
-
 double Stream_link_contribution_at_instant(Stream* stream, TimeId time_id) {
+	INSTRUMENT_METRIC(stream, link_contribution_at_instant);
 	// CATCH_METRICS_IMPLEM(link_contribution_at_time, stream);
-	StreamFunctions stream_functions = STREAM_FUNCS(stream_functions, stream);
-	LinksIterator links = stream_functions.links_present_at_t(stream->stream, time_id);
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	LinksIterator links = stream_functions->links_present_at_t(stream->stream, time_id);
 	size_t e_t = COUNT_ITERATOR(links);
-	size_t scaling = stream_functions.scaling(stream->stream);
+	size_t scaling = stream_functions->scaling(stream->stream);
 	size_t v = cardinalOfV(stream);
 	size_t vxv = size_set_unordered_pairs_itself(v);
 	return (double)e_t / (double)(vxv * scaling);
 }
 
 double Stream_link_duration(Stream* stream) {
+	INSTRUMENT_METRIC(stream, link_duration);
 	// CATCH_METRICS_IMPLEM(link_duration, stream);
-	StreamFunctions stream_functions = STREAM_FUNCS(stream_functions, stream);
+	const StreamFunctions* stream_functions = stream->stream_functions;
 	size_t e = cardinalOfE(stream);
 	size_t v = cardinalOfV(stream);
-	size_t scaling = stream_functions.scaling(stream->stream);
+	size_t scaling = stream_functions->scaling(stream->stream);
 	size_t vxv = size_set_unordered_pairs_itself(v);
 	return (double)e / (double)(vxv * scaling);
 }
 
+// Σ_{u < v} |T_u ∩ T_v| is the sum of C(|V_t|, 2) over time, and Σ_{u < v} |T_u ∪ T_v| is
+// (|V| - 1) |W| - Σ_{u < v} |T_u ∩ T_v|, so both sums come from a single sweep instead of a loop over the pairs of nodes.
 double Stream_uniformity(Stream* stream) {
+	INSTRUMENT_METRIC(stream, uniformity);
 	// CATCH_METRICS_IMPLEM(uniformity, stream);
-	StreamFunctions stream_functions = STREAM_FUNCS(stream_functions, stream);
-	size_t sum_num = 0;
-	size_t sum_den = 0;
-	NodesIterator nodes = stream_functions.nodes_set(stream->stream);
-	FOR_EACH_NODE(node_id, nodes) {
-		NodesIterator other_pair = stream_functions.nodes_set(stream->stream);
-		FOR_EACH_NODE(other_node_id, other_pair) {
-			if (node_id >= other_node_id) {
-				continue;
-			}
-			TimesIterator times_node = stream_functions.times_node_present(stream->stream, node_id);
-			TimesIterator times_other_node = stream_functions.times_node_present(stream->stream, other_node_id);
-			TimesIterator times_union = TimesIterator_union(times_node, times_other_node);
-
-			size_t t_u = total_time_of(times_union);
-			times_node = stream_functions.times_node_present(stream->stream, node_id);
-			times_other_node = stream_functions.times_node_present(stream->stream, other_node_id);
-			TimesIterator times_intersection = TimesIterator_intersection(times_node, times_other_node);
-			size_t t_i = total_time_of(times_intersection);
-
-			sum_num += t_i;
-			sum_den += t_u;
-		}
-	}
+	size_t sum_num = sum_of_memo_array(stream, MEMO_SUM_PAIRS_OF_NODES, compute_sum_pairs_of_nodes);
+	size_t v = cardinalOfV(stream);
+	size_t w = cardinalOfW(stream);
+	size_t sum_den = (v - 1) * w - sum_num;
 	return (double)sum_num / (double)sum_den;
 }
 
 double Stream_uniformity_pair_nodes(Stream* stream, NodeId node1, NodeId node2) {
+	INSTRUMENT_METRIC(stream, uniformity_pair_nodes);
 	// CATCH_METRICS_IMPLEM(uniformity_pair_nodes, stream);
-	StreamFunctions stream_functions = STREAM_FUNCS(stream_functions, stream);
-	TimesIterator times_node1 = stream_functions.times_node_present(stream->stream, node1);
-	TimesIterator times_node2 = stream_functions.times_node_present(stream->stream, node2);
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	TimesIterator times_node1 = stream_functions->times_node_present(stream->stream, node1);
+	TimesIterator times_node2 = stream_functions->times_node_present(stream->stream, node2);
 	TimesIterator times_union = TimesIterator_union(times_node1, times_node2);
 
 	size_t t_u = total_time_of(times_union);
-	times_node1 = stream_functions.times_node_present(stream->stream, node1);
-	times_node2 = stream_functions.times_node_present(stream->stream, node2);
+	times_node1 = stream_functions->times_node_present(stream->stream, node1);
+	times_node2 = stream_functions->times_node_present(stream->stream, node2);
 	TimesIterator times_intersection = TimesIterator_intersection(times_node1, times_node2);
 	size_t t_i = total_time_of(times_intersection);
 
 	return (double)t_i / (double)t_u;
 }
 
-double Stream_density(Stream* stream) {
-	CATCH_METRICS_IMPLEM(density, stream);
-	StreamFunctions stream_functions = STREAM_FUNCS(stream_functions, stream);
-	size_t sum_den = 0;
-	NodesIterator nodes = stream_functions.nodes_set(stream->stream);
+// The first non-empty interval of each node gives its first appearance, and the last one its last disappearance
+static Interval compute_nodes_span(Stream* stream, size_t* nb_nodes_present) {
+	if (stream->metrics_functions->nodes_span != NULL) {
+		return stream->metrics_functions->nodes_span(stream->stream, nb_nodes_present);
+	}
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	TimeId first = SIZE_MAX;
+	TimeId last = 0;
+	size_t count = 0;
+	NodesIterator nodes = stream_functions->nodes_set(stream->stream);
 	FOR_EACH_NODE(node_id, nodes) {
-		NodesIterator other_nodes = stream_functions.nodes_set(stream->stream);
-		FOR_EACH_NODE(other_node_id, other_nodes) {
-			if (node_id >= other_node_id) {
+		bool present = false;
+		TimesIterator times = stream_functions->times_node_present(stream->stream, node_id);
+		FOR_EACH_TIME(interval, times) {
+			if (interval.start >= interval.end) {
 				continue;
 			}
-			TimesIterator times_node = stream_functions.times_node_present(stream->stream, node_id);
-			TimesIterator times_other_node = stream_functions.times_node_present(stream->stream, other_node_id);
-			TimesIterator times_intersection = TimesIterator_intersection(times_node, times_other_node);
-			sum_den += total_time_of(times_intersection);
+			present = true;
+			first = interval.start < first ? interval.start : first;
+			last = interval.end > last ? interval.end : last;
 		}
+		count += present;
 	}
+	*nb_nodes_present = count;
+	return count == 0 ? Interval_from(0, 0) : Interval_from(first, last);
+}
 
-	size_t sum_num = 0;
-	LinksIterator links = stream_functions.links_set(stream->stream);
-	FOR_EACH_LINK(link_id, links) {
-		TimesIterator times_link = stream_functions.times_link_present(stream->stream, link_id);
-		sum_num += total_time_of(times_link);
-	}
+double Stream_compactness(Stream* stream) {
+	INSTRUMENT_METRIC(stream, compactness);
+	size_t nb_nodes_present;
+	Interval span = compute_nodes_span(stream, &nb_nodes_present);
+	size_t w = cardinalOfW(stream);
+	return (double)w / (double)(Interval_size(span) * nb_nodes_present);
+}
 
+double Stream_density(Stream* stream) {
+	INSTRUMENT_METRIC(stream, density);
+	CATCH_METRICS_IMPLEM(density, stream);
+	size_t sum_num = cardinalOfE(stream);
+	size_t sum_den = sum_of_memo_array(stream, MEMO_SUM_PAIRS_OF_NODES, compute_sum_pairs_of_nodes);
 	return (double)sum_num / (double)sum_den;
 }
 
 double Stream_density_of_link(Stream* stream, LinkId link_id) {
-	StreamFunctions stream_functions = STREAM_FUNCS(stream_functions, stream);
-	TimesIterator times_link = stream_functions.times_link_present(stream->stream, link_id);
-	size_t sum_num = total_time_of(times_link);
-	Link l = stream_functions.nth_link(stream->stream, link_id);
-	TimesIterator t_u = stream_functions.times_node_present(stream->stream, l.nodes[0]);
-	TimesIterator t_v = stream_functions.times_node_present(stream->stream, l.nodes[1]);
-	TimesIterator t_i = TimesIterator_intersection(t_u, t_v);
-	size_t sum_den = total_time_of(t_i);
+	INSTRUMENT_METRIC(stream, density_of_link);
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	size_t sum_num;
+	if (!fetch_memo_element(stream, MEMO_TIMES_LINK_PRESENT, link_id, &sum_num)) {
+		TimesIterator times_link = stream_functions->times_link_present(stream->stream, link_id);
+		sum_num = total_time_of(times_link);
+	}
+	size_t sum_den;
+	if (!fetch_memo_element(stream, MEMO_NODES_INTERSECTION_OF_LINKS, link_id, &sum_den)) {
+		Link l = stream_functions->nth_link(stream->stream, link_id);
+		TimesIterator t_u = stream_functions->times_node_present(stream->stream, l.nodes[0]);
+		TimesIterator t_v = stream_functions->times_node_present(stream->stream, l.nodes[1]);
+		TimesIterator t_i = TimesIterator_intersection(t_u, t_v);
+		sum_den = total_time_of(t_i);
+	}
 
 	return (double)sum_num / (double)sum_den;
 }
 
 double Stream_density_of_node(Stream* stream, NodeId node_id) {
+	INSTRUMENT_METRIC(stream, density_of_node);
 	// CATCH_METRICS_IMPLEM(density_of_node, stream);
-	StreamFunctions stream_functions = STREAM_FUNCS(stream_functions, stream);
-	LinksIterator neighbours = stream_functions.neighbours_of_node(stream->stream, node_id);
+	const StreamFunctions* stream_functions = stream->stream_functions;
 	size_t sum_num = 0;
 	size_t sum_den = 0;
-	FOR_EACH_LINK(link_id, neighbours) {
-		TimesIterator times_link = stream_functions.times_link_present(stream->stream, link_id);
-		sum_num += total_time_of(times_link);
+	if (!fetch_memo_element(stream, MEMO_DEGREE_SUMS, node_id, &sum_num)) {
+		LinksIterator neighbours = stream_functions->neighbours_of_node(stream->stream, node_id);
+		FOR_EACH_LINK(link_id, neighbours) {
+			TimesIterator times_link = stream_functions->times_link_present(stream->stream, link_id);
+			sum_num += total_time_of(times_link);
+		}
 	}
 
-	NodesIterator nodes = stream_functions.nodes_set(stream->stream);
+	NodesIterator nodes = stream_functions->nodes_set(stream->stream);
 	FOR_EACH_NODE(other_node_id, nodes) {
 		if (node_id == other_node_id) {
 			continue;
 		}
-		TimesIterator times_node = stream_functions.times_node_present(stream->stream, node_id);
-		TimesIterator times_other_node = stream_functions.times_node_present(stream->stream, other_node_id);
+		TimesIterator times_node = stream_functions->times_node_present(stream->stream, node_id);
+		TimesIterator times_other_node = stream_functions->times_node_present(stream->stream, other_node_id);
 		TimesIterator times_intersection = TimesIterator_intersection(times_node, times_other_node);
 		sum_den += total_time_of(times_intersection);
 	}
-	printf("sum_num = %zu, sum_den = %zu\n", sum_num, sum_den);
 	return (double)sum_num / (double)sum_den;
 }
 
 double Stream_density_at_instant(Stream* stream, TimeId time_id) {
+	INSTRUMENT_METRIC(stream, density_at_instant);
 	// CATCH_METRICS_IMPLEM(density_at_instant, stream);
-	StreamFunctions stream_functions = STREAM_FUNCS(stream_functions, stream);
-	NodesIterator nodes_at_t = stream_functions.nodes_present_at_t(stream->stream, time_id);
-	LinksIterator links_at_t = stream_functions.links_present_at_t(stream->stream, time_id);
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	NodesIterator nodes_at_t = stream_functions->nodes_present_at_t(stream->stream, time_id);
+	LinksIterator links_at_t = stream_functions->links_present_at_t(stream->stream, time_id);
 	// size_t et = COUNT_ITERATOR(links_at_t);
 	size_t et = COUNT_ITERATOR(links_at_t);
 	size_t vt = COUNT_ITERATOR(nodes_at_t);
-	printf("et = %zu, vt = %zu\n", et, vt);
 	return (double)et / (double)(size_set_unordered_pairs_itself(vt));
 }
 
 double Stream_degree_of_node(Stream* stream, NodeId node_id) {
+	INSTRUMENT_METRIC(stream, degree_of_node);
 	// CATCH_METRICS_IMPLEM(degree_of_node, stream);
-	StreamFunctions stream_functions = STREAM_FUNCS(stream_functions, stream);
-	LinksIterator neighbours = stream_functions.neighbours_of_node(stream->stream, node_id);
+	const StreamFunctions* stream_functions = stream->stream_functions;
 	size_t sum_num = 0;
-	FOR_EACH_LINK(link_id, neighbours) {
-		TimesIterator times_link = stream_functions.times_link_present(stream->stream, link_id);
-		sum_num += total_time_of(times_link);
+	if (!fetch_memo_element(stream, MEMO_DEGREE_SUMS, node_id, &sum_num)) {
+		LinksIterator neighbours = stream_functions->neighbours_of_node(stream->stream, node_id);
+		FOR_EACH_LINK(link_id, neighbours) {
+			TimesIterator times_link = stream_functions->times_link_present(stream->stream, link_id);
+			sum_num += total_time_of(times_link);
+		}
 	}
-	size_t sum_den = Interval_size(stream_functions.lifespan(stream->stream));
+	size_t sum_den = cardinalOfT(stream);
 	return (double)sum_num / (double)sum_den;
 }
 
-double Stream_average_node_degree(Stream* stream) {
-	// CATCH_METRICS_IMPLEM(average_node_degree, stream);
-	StreamFunctions stream_functions = STREAM_FUNCS(stream_functions, stream);
+static double sum_weighted_degrees(void* context, size_t from, size_t to) {
+	ParallelMetricContext* ctx = (ParallelMetricContext*)context;
 	double sum = 0;
-	double w = (double)cardinalOfW(stream);
-	NodesIterator nodes = stream_functions.nodes_set(stream->stream);
-	FOR_EACH_NODE(node_id, nodes) {
-		double degree = Stream_degree_of_node(stream, node_id);
-		size_t t_v = total_time_of(stream_functions.times_node_present(stream->stream, node_id));
-		sum += degree * ((double)t_v / w);
+	for (size_t i = from; i < to; i++) {
+		double degree = (double)ctx->degree_sums[ctx->ids[i]] / ctx->t;
+		size_t t_v = ctx->nodes_times[ctx->ids[i]];
+		sum += degree * ((double)t_v / ctx->w);
 	}
 	return sum;
 }
 
+double Stream_average_node_degree(Stream* stream) {
+	INSTRUMENT_METRIC(stream, average_node_degree);
+	// CATCH_METRICS_IMPLEM(average_node_degree, stream);
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	MemoValue nodes_times = Stream_memo_acquire(stream, MEMO_TIMES_NODE_PRESENT, compute_times_node_present);
+	MemoValue degree_sums = Stream_memo_acquire(stream, MEMO_DEGREE_SUMS, compute_degree_sums);
+	ParallelMetricContext context = ParallelMetricContext_over_nodes(stream, stream_functions);
+	context.nodes_times = nodes_times.values;
+	context.degree_sums = degree_sums.values;
+	context.t = (double)cardinalOfT(stream);
+	context.w = (double)cardinalOfW(stream);
+	double sum = ThreadPool_sum_double(ThreadPool_global(), context.nb_elements, ELEMENTS_PER_CHUNK,
+									   sum_weighted_degrees, &context);
+	ParallelMetricContext_destroy(context);
+	Stream_memo_release(stream, MEMO_DEGREE_SUMS, degree_sums);
+	Stream_memo_release(stream, MEMO_TIMES_NODE_PRESENT, nodes_times);
+	return sum;
+}
+
 double Stream_degree(Stream* stream) {
+	INSTRUMENT_METRIC(stream, degree);
 	// CATCH_METRICS_IMPLEM(degree, stream);
 	size_t number_of_links = cardinalOfE(stream);
 	size_t t = cardinalOfT(stream);
@@ -358,8 +875,814 @@ double Stream_degree(Stream* stream) {
 }
 
 double Stream_average_expected_degree(Stream* stream) {
+	INSTRUMENT_METRIC(stream, average_expected_degree);
 	// CATCH_METRICS_IMPLEM(degree, stream);
 	size_t number_of_links = cardinalOfE(stream);
 	size_t number_of_nodes = cardinalOfW(stream);
 	return (double)(2 * number_of_links) / (double)number_of_nodes;
+}
+
+// The current degree of each node, and when it last changed, so that the time spent with it is added to the
+// histogram and to the sum of the degrees of the node when it changes again
+typedef struct {
+	size_t* degrees;	  // Indexed by node id
+	TimeId* since;		  // Indexed by node id
+	bool* present;		  // Indexed by node id
+	size_t* degree_sums;  // Indexed by node id, Σ_u |T_uv| so far
+	size_t* node_times;	  // Indexed by degree
+	size_t nb_degrees;	  // The largest degree reached plus one
+	size_t capacity;	  // The size of node_times
+} DegreeSweep;
+
+static void DegreeSweep_flush(DegreeSweep* sweep, NodeId node_id, TimeId instant) {
+	if (sweep->present[node_id]) {
+		size_t duration = instant - sweep->since[node_id];
+		sweep->node_times[sweep->degrees[node_id]] += duration;
+		sweep->degree_sums[node_id] += sweep->degrees[node_id] * duration;
+	}
+	sweep->since[node_id] = instant;
+}
+
+static void DegreeSweep_increment(DegreeSweep* sweep, NodeId node_id) {
+	size_t degree = ++sweep->degrees[node_id];
+	if (degree >= sweep->capacity) {
+		size_t capacity = 2 * sweep->capacity;
+		sweep->node_times = realloc(sweep->node_times, capacity * sizeof(size_t));
+		for (size_t k = sweep->capacity; k < capacity; k++) {
+			sweep->node_times[k] = 0;
+		}
+		sweep->capacity = capacity;
+	}
+	sweep->nb_degrees = degree + 1 > sweep->nb_degrees ? degree + 1 : sweep->nb_degrees;
+}
+
+DegreeHistogram Stream_degree_histogram(Stream* stream) {
+	INSTRUMENT_METRIC(stream, degree_histogram);
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	Timeline timeline = Timeline_from(stream);
+
+	NodeIdVector ids = NodeIdVector_new();
+	size_t nb_node_ids = 0;
+	NodesIterator nodes = stream_functions->nodes_set(stream->stream);
+	FOR_EACH_NODE(node_id, nodes) {
+		NodeIdVector_push(&ids, node_id);
+		nb_node_ids = node_id + 1 > nb_node_ids ? node_id + 1 : nb_node_ids;
+	}
+	DegreeSweep sweep = {
+		.degrees = calloc(nb_node_ids + 1, sizeof(size_t)),
+		.since = calloc(nb_node_ids + 1, sizeof(TimeId)),
+		.present = calloc(nb_node_ids + 1, sizeof(bool)),
+		.degree_sums = calloc(nb_node_ids + 1, sizeof(size_t)),
+		.node_times = calloc(16, sizeof(size_t)),
+		.nb_degrees = 1,
+		.capacity = 16,
+	};
+
+	// Each event only changes the degree or the presence of the nodes it is about
+	for (size_t i = 0; i < timeline.nb_events; i++) {
+		TimelineEvent event = timeline.events[i];
+		bool appears = TimelineEvent_is_appearance(event);
+		if (TimelineEvent_is_node(event)) {
+			DegreeSweep_flush(&sweep, event.id, event.instant);
+			sweep.present[event.id] = appears;
+			continue;
+		}
+		Link link = stream_functions->nth_link(stream->stream, event.id);
+		for (size_t end = 0; end < 2; end++) {
+			DegreeSweep_flush(&sweep, link.nodes[end], event.instant);
+			if (appears) {
+				DegreeSweep_increment(&sweep, link.nodes[end]);
+			}
+			else {
+				sweep.degrees[link.nodes[end]]--;
+			}
+		}
+	}
+
+	DegreeHistogram histogram = {
+		.nb_degrees = sweep.nb_degrees,
+		.node_times = sweep.node_times,
+		.degrees = {.nb_elements = ids.size, .ids = ids.array, .values = MALLOC((ids.size + 1) * sizeof(double))},
+	};
+	double t = (double)cardinalOfT(stream);
+	for (size_t i = 0; i < ids.size; i++) {
+		histogram.degrees.values[i] = (double)sweep.degree_sums[ids.array[i]] / t;
+	}
+	free(sweep.degrees);
+	free(sweep.since);
+	free(sweep.present);
+	free(sweep.degree_sums);
+	Timeline_destroy(timeline);
+	return histogram;
+}
+
+void DegreeHistogram_destroy(DegreeHistogram histogram) {
+	free(histogram.node_times);
+	MetricValues_destroy(histogram.degrees);
+}
+
+static double clustering_coeff_from_times(size_t triangles_time, size_t wedges_time) {
+	return wedges_time == 0 ? 0.0 : (double)triangles_time / (double)wedges_time;
+}
+
+double Stream_clustering_coeff_of_node(Stream* stream, NodeId node_id) {
+	INSTRUMENT_METRIC(stream, clustering_coeff_of_node);
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	size_t triangles_time;
+	if (!fetch_memo_element(stream, MEMO_TRIANGLES_TIMES, node_id, &triangles_time)) {
+		triangles_time = triangles_time_of_node(stream_functions, stream->stream, node_id);
+	}
+	size_t wedges_time;
+	if (!fetch_memo_element(stream, MEMO_WEDGES_TIMES, node_id, &wedges_time)) {
+		wedges_time = wedges_time_of_node(stream_functions, stream->stream, node_id);
+	}
+	return clustering_coeff_from_times(triangles_time, wedges_time);
+}
+
+static double sum_weighted_clustering_coeffs(void* context, size_t from, size_t to) {
+	ParallelMetricContext* ctx = (ParallelMetricContext*)context;
+	double sum = 0;
+	for (size_t i = from; i < to; i++) {
+		size_t node_id = ctx->ids[i];
+		double coeff = clustering_coeff_from_times(ctx->triangles_times[node_id], ctx->wedges_times[node_id]);
+		sum += coeff * ((double)ctx->nodes_times[node_id] / ctx->w);
+	}
+	return sum;
+}
+
+double Stream_clustering_coeff(Stream* stream) {
+	INSTRUMENT_METRIC(stream, clustering_coeff);
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	MemoValue nodes_times = Stream_memo_acquire(stream, MEMO_TIMES_NODE_PRESENT, compute_times_node_present);
+	MemoValue triangles_times = Stream_memo_acquire(stream, MEMO_TRIANGLES_TIMES, compute_triangles_times);
+	MemoValue wedges_times = Stream_memo_acquire(stream, MEMO_WEDGES_TIMES, compute_wedges_times);
+	ParallelMetricContext context = ParallelMetricContext_over_nodes(stream, stream_functions);
+	context.nodes_times = nodes_times.values;
+	context.triangles_times = triangles_times.values;
+	context.wedges_times = wedges_times.values;
+	context.w = (double)cardinalOfW(stream);
+	double sum = ThreadPool_sum_double(ThreadPool_global(), context.nb_elements, ELEMENTS_PER_CHUNK,
+									   sum_weighted_clustering_coeffs, &context);
+	ParallelMetricContext_destroy(context);
+	Stream_memo_release(stream, MEMO_WEDGES_TIMES, wedges_times);
+	Stream_memo_release(stream, MEMO_TRIANGLES_TIMES, triangles_times);
+	Stream_memo_release(stream, MEMO_TIMES_NODE_PRESENT, nodes_times);
+	return sum;
+}
+
+double Stream_transitivity(Stream* stream) {
+	INSTRUMENT_METRIC(stream, transitivity);
+	size_t triangles_time = sum_of_memo_array(stream, MEMO_TRIANGLES_TIMES, compute_triangles_times);
+	size_t wedges_time = sum_of_memo_array(stream, MEMO_WEDGES_TIMES, compute_wedges_times);
+	return clustering_coeff_from_times(triangles_time, wedges_time);
+}
+
+void MetricValues_destroy(MetricValues metric_values) {
+	free(metric_values.ids);
+	free(metric_values.values);
+}
+
+// Everything a bulk metric needs, computed once before the elements are split between threads
+typedef struct {
+	Stream* stream;
+	const StreamFunctions* stream_functions;
+	MetricValues result;
+	size_t t;
+	MemoValue times;			  // The presence times of the nodes or links, from the memo table
+	MemoValue degree_sums;		  // From the memo table, only acquired by the metrics on nodes which need them
+	MemoValue intersections;	  // From the memo table, only acquired by the density of the links
+	MemoValue triangles_times;	  // From the memo table, only acquired by the clustering coefficients
+	MemoValue wedges_times;		  // Same
+	IntervalsSet* nodes_presence; // Only filled by the metrics which need intersections
+} BulkMetricContext;
+
+typedef void (*BulkMetricKernel)(BulkMetricContext* context, size_t from, size_t to);
+
+typedef struct {
+	BulkMetricContext* context;
+	BulkMetricKernel kernel;
+} BulkMetricTask;
+
+static void BulkMetricTask_run(void* task, size_t chunk_index, size_t from, size_t to) {
+	(void)chunk_index;
+	BulkMetricTask* bulk_task = (BulkMetricTask*)task;
+	bulk_task->kernel(bulk_task->context, from, to);
+}
+
+// Splits the elements in chunks computed by the workers of the thread pool.
+// The StreamGraph is read-only, and each element only writes its own slot of the result, so no locking is needed.
+static void run_bulk_kernel(BulkMetricContext* context, BulkMetricKernel kernel) {
+	BulkMetricTask task = {.context = context, .kernel = kernel};
+	ThreadPool_parallel_for(ThreadPool_global(), context->result.nb_elements, HEAVY_ELEMENTS_PER_CHUNK,
+							BulkMetricTask_run, &task);
+}
+
+static BulkMetricContext BulkMetricContext_over_nodes(Stream* stream, bool with_degree_sums) {
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	NodeIdVector ids = NodeIdVector_new();
+	NodesIterator nodes = stream_functions->nodes_set(stream->stream);
+	FOR_EACH_NODE(node_id, nodes) {
+		NodeIdVector_push(&ids, node_id);
+	}
+	return (BulkMetricContext){
+		.stream = stream,
+		.stream_functions = stream_functions,
+		.result = {.nb_elements = ids.size, .ids = ids.array, .values = MALLOC((ids.size + 1) * sizeof(double))},
+		.t = cardinalOfT(stream),
+		.times = Stream_memo_acquire(stream, MEMO_TIMES_NODE_PRESENT, compute_times_node_present),
+		.degree_sums = with_degree_sums ? Stream_memo_acquire(stream, MEMO_DEGREE_SUMS, compute_degree_sums)
+										: (MemoValue){0, NULL},
+		.intersections = {0, NULL},
+		.triangles_times = {0, NULL},
+		.wedges_times = {0, NULL},
+		.nodes_presence = NULL,
+	};
+}
+
+static BulkMetricContext BulkMetricContext_over_links(Stream* stream) {
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	LinkIdVector ids = LinkIdVector_new();
+	LinksIterator links = stream_functions->links_set(stream->stream);
+	FOR_EACH_LINK(link_id, links) {
+		LinkIdVector_push(&ids, link_id);
+	}
+	return (BulkMetricContext){
+		.stream = stream,
+		.stream_functions = stream_functions,
+		.result = {.nb_elements = ids.size, .ids = ids.array, .values = MALLOC((ids.size + 1) * sizeof(double))},
+		.t = cardinalOfT(stream),
+		.times = Stream_memo_acquire(stream, MEMO_TIMES_LINK_PRESENT, compute_times_link_present),
+		.degree_sums = {0, NULL},
+		.intersections = {0, NULL},
+		.triangles_times = {0, NULL},
+		.wedges_times = {0, NULL},
+		.nodes_presence = NULL,
+	};
+}
+
+// Releases what the context acquired from the memo table, and returns the result
+static MetricValues BulkMetricContext_finish(BulkMetricContext* context, MemoKey times_key) {
+	Stream_memo_release(context->stream, times_key, context->times);
+	if (context->degree_sums.values != NULL) {
+		Stream_memo_release(context->stream, MEMO_DEGREE_SUMS, context->degree_sums);
+	}
+	return context->result;
+}
+
+static void contribution_kernel(BulkMetricContext* context, size_t from, size_t to) {
+	for (size_t i = from; i < to; i++) {
+		context->result.values[i] = (double)context->times.values[context->result.ids[i]] / (double)context->t;
+	}
+}
+
+MetricValues Stream_contribution_of_all_nodes(Stream* stream) {
+	INSTRUMENT_METRIC(stream, contribution_of_all_nodes);
+	BulkMetricContext context = BulkMetricContext_over_nodes(stream, false);
+	run_bulk_kernel(&context, contribution_kernel);
+	return BulkMetricContext_finish(&context, MEMO_TIMES_NODE_PRESENT);
+}
+
+MetricValues Stream_contribution_of_all_links(Stream* stream) {
+	INSTRUMENT_METRIC(stream, contribution_of_all_links);
+	BulkMetricContext context = BulkMetricContext_over_links(stream);
+	run_bulk_kernel(&context, contribution_kernel);
+	return BulkMetricContext_finish(&context, MEMO_TIMES_LINK_PRESENT);
+}
+
+static void degree_of_nodes_kernel(BulkMetricContext* context, size_t from, size_t to) {
+	for (size_t i = from; i < to; i++) {
+		size_t sum_num = context->degree_sums.values[context->result.ids[i]];
+		context->result.values[i] = (double)sum_num / (double)context->t;
+	}
+}
+
+MetricValues Stream_degree_of_all_nodes(Stream* stream) {
+	INSTRUMENT_METRIC(stream, degree_of_all_nodes);
+	BulkMetricContext context = BulkMetricContext_over_nodes(stream, true);
+	run_bulk_kernel(&context, degree_of_nodes_kernel);
+	return BulkMetricContext_finish(&context, MEMO_TIMES_NODE_PRESENT);
+}
+
+static void density_of_links_kernel(BulkMetricContext* context, size_t from, size_t to) {
+	for (size_t i = from; i < to; i++) {
+		LinkId link_id = context->result.ids[i];
+		size_t sum_num = context->times.values[link_id];
+		size_t sum_den = context->intersections.values[link_id];
+		context->result.values[i] = (double)sum_num / (double)sum_den;
+	}
+}
+
+MetricValues Stream_density_of_all_links(Stream* stream) {
+	INSTRUMENT_METRIC(stream, density_of_all_links);
+	BulkMetricContext context = BulkMetricContext_over_links(stream);
+	context.intersections =
+		Stream_memo_acquire(stream, MEMO_NODES_INTERSECTION_OF_LINKS, compute_nodes_intersection_of_links);
+	run_bulk_kernel(&context, density_of_links_kernel);
+	Stream_memo_release(stream, MEMO_NODES_INTERSECTION_OF_LINKS, context.intersections);
+	return BulkMetricContext_finish(&context, MEMO_TIMES_LINK_PRESENT);
+}
+
+static void collect_nodes_presence_kernel(BulkMetricContext* context, size_t from, size_t to) {
+	for (size_t i = from; i < to; i++) {
+		TimesIterator times = context->stream_functions->times_node_present(context->stream->stream,
+																		   context->result.ids[i]);
+		context->nodes_presence[i] = TimesIterator_collect(times);
+	}
+}
+
+static void density_of_nodes_kernel(BulkMetricContext* context, size_t from, size_t to) {
+	for (size_t i = from; i < to; i++) {
+		size_t sum_num = context->degree_sums.values[context->result.ids[i]];
+		size_t sum_den = 0;
+		for (size_t j = 0; j < context->result.nb_elements; j++) {
+			if (i == j) {
+				continue;
+			}
+			sum_den += IntervalsSet_intersection_size(context->nodes_presence[i], context->nodes_presence[j]);
+		}
+		context->result.values[i] = (double)sum_num / (double)sum_den;
+	}
+}
+
+MetricValues Stream_density_of_all_nodes(Stream* stream) {
+	INSTRUMENT_METRIC(stream, density_of_all_nodes);
+	BulkMetricContext context = BulkMetricContext_over_nodes(stream, true);
+	context.nodes_presence = MALLOC((context.result.nb_elements + 1) * sizeof(IntervalsSet));
+	run_bulk_kernel(&context, collect_nodes_presence_kernel);
+	run_bulk_kernel(&context, density_of_nodes_kernel);
+	for (size_t i = 0; i < context.result.nb_elements; i++) {
+		IntervalsSet_destroy(context.nodes_presence[i]);
+	}
+	free(context.nodes_presence);
+	return BulkMetricContext_finish(&context, MEMO_TIMES_NODE_PRESENT);
+}
+
+static void clustering_coeff_of_nodes_kernel(BulkMetricContext* context, size_t from, size_t to) {
+	for (size_t i = from; i < to; i++) {
+		NodeId node_id = context->result.ids[i];
+		context->result.values[i] = clustering_coeff_from_times(context->triangles_times.values[node_id],
+																 context->wedges_times.values[node_id]);
+	}
+}
+
+MetricValues Stream_clustering_coeff_of_all_nodes(Stream* stream) {
+	INSTRUMENT_METRIC(stream, clustering_coeff_of_all_nodes);
+	BulkMetricContext context = BulkMetricContext_over_nodes(stream, false);
+	context.triangles_times = Stream_memo_acquire(stream, MEMO_TRIANGLES_TIMES, compute_triangles_times);
+	context.wedges_times = Stream_memo_acquire(stream, MEMO_WEDGES_TIMES, compute_wedges_times);
+	run_bulk_kernel(&context, clustering_coeff_of_nodes_kernel);
+	Stream_memo_release(stream, MEMO_WEDGES_TIMES, context.wedges_times);
+	Stream_memo_release(stream, MEMO_TRIANGLES_TIMES, context.triangles_times);
+	return BulkMetricContext_finish(&context, MEMO_TIMES_NODE_PRESENT);
+}
+
+static InstantMetrics InstantMetrics_from(TimeId instant, size_t nb_nodes, size_t nb_links) {
+	size_t nb_pairs = size_set_unordered_pairs_itself(nb_nodes);
+	return (InstantMetrics){
+		.instant = instant,
+		.nb_nodes = nb_nodes,
+		.nb_links = nb_links,
+		.density = nb_pairs == 0 ? 0.0 : (double)nb_links / (double)nb_pairs,
+	};
+}
+
+static void apply_timeline_event(TimelineEvent event, size_t* nb_nodes, size_t* nb_links) {
+	size_t* counter = TimelineEvent_is_node(event) ? nb_nodes : nb_links;
+	if (TimelineEvent_is_appearance(event)) {
+		(*counter)++;
+	}
+	else {
+		(*counter)--;
+	}
+}
+
+static size_t sweep_key_moments(Timeline* timeline, InstantMetricsCallback callback, void* user_data) {
+	size_t nb_nodes = 0;
+	size_t nb_links = 0;
+	size_t nb_key_moments = 0;
+
+	// The beginning of the lifespan is a key moment even if nothing is present
+	if (timeline->nb_events == 0 || timeline->events[0].instant > timeline->lifespan.start) {
+		callback(InstantMetrics_from(timeline->lifespan.start, 0, 0), user_data);
+		nb_key_moments++;
+	}
+
+	size_t i = 0;
+	while (i < timeline->nb_events) {
+		TimeId instant = timeline->events[i].instant;
+		while (i < timeline->nb_events && timeline->events[i].instant == instant) {
+			apply_timeline_event(timeline->events[i], &nb_nodes, &nb_links);
+			i++;
+		}
+		callback(InstantMetrics_from(instant, nb_nodes, nb_links), user_data);
+		nb_key_moments++;
+	}
+	return nb_key_moments;
+}
+
+size_t Stream_sweep_key_moments(Stream* stream, InstantMetricsCallback callback, void* user_data) {
+	INSTRUMENT_METRIC(stream, sweep_key_moments);
+	Timeline timeline = Timeline_from(stream);
+	size_t nb_key_moments = sweep_key_moments(&timeline, callback, user_data);
+	Timeline_destroy(timeline);
+	return nb_key_moments;
+}
+
+static void sweep_instants(Timeline* timeline, const TimeId* instants, size_t nb_instants,
+						   InstantMetricsCallback callback, void* user_data) {
+	size_t nb_nodes = 0;
+	size_t nb_links = 0;
+	size_t i = 0;
+	for (size_t n = 0; n < nb_instants; n++) {
+		DEBUG_ASSERT(n == 0 || instants[n - 1] <= instants[n]);
+		while (i < timeline->nb_events && timeline->events[i].instant <= instants[n]) {
+			apply_timeline_event(timeline->events[i], &nb_nodes, &nb_links);
+			i++;
+		}
+		callback(InstantMetrics_from(instants[n], nb_nodes, nb_links), user_data);
+	}
+}
+
+void Stream_sweep_instants(Stream* stream, const TimeId* instants, size_t nb_instants,
+						   InstantMetricsCallback callback, void* user_data) {
+	INSTRUMENT_METRIC(stream, sweep_instants);
+	Timeline timeline = Timeline_from(stream);
+	sweep_instants(&timeline, instants, nb_instants, callback, user_data);
+	Timeline_destroy(timeline);
+}
+
+typedef struct {
+	InstantMetrics* metrics;
+	size_t nb_written;
+} InstantMetricsWriter;
+
+static void write_instant_metrics(InstantMetrics metrics, void* user_data) {
+	InstantMetricsWriter* writer = (InstantMetricsWriter*)user_data;
+	writer->metrics[writer->nb_written] = metrics;
+	writer->nb_written++;
+}
+
+InstantMetrics* Stream_key_moments_time_series(Stream* stream, size_t* nb_key_moments) {
+	INSTRUMENT_METRIC(stream, key_moments_time_series);
+	// There can't be more key moments than events, plus the beginning of the lifespan
+	Timeline timeline = Timeline_from(stream);
+	InstantMetricsWriter writer = {
+		.metrics = MALLOC((timeline.nb_events + 1) * sizeof(InstantMetrics)),
+		.nb_written = 0,
+	};
+	*nb_key_moments = sweep_key_moments(&timeline, write_instant_metrics, &writer);
+	Timeline_destroy(timeline);
+	return writer.metrics;
+}
+
+void Stream_instants_time_series(Stream* stream, const TimeId* instants, size_t nb_instants, InstantMetrics* metrics) {
+	INSTRUMENT_METRIC(stream, instants_time_series);
+	InstantMetricsWriter writer = {.metrics = metrics, .nb_written = 0};
+	Stream_sweep_instants(stream, instants, nb_instants, write_instant_metrics, &writer);
+}
+
+// An element of a top-k query and its value
+typedef struct {
+	size_t id;
+	double value;
+} RankedElement;
+
+// Whether a ranks before b : the larger value first, then the smaller id, so that the ranking is a total order
+static bool RankedElement_before(RankedElement a, RankedElement b) {
+	return a.value > b.value || (a.value == b.value && a.id < b.id);
+}
+
+static int RankedElement_compare(const void* a, const void* b) {
+	RankedElement element_a = *(const RankedElement*)a;
+	RankedElement element_b = *(const RankedElement*)b;
+	return RankedElement_before(element_a, element_b) ? -1 : RankedElement_before(element_b, element_a) ? 1 : 0;
+}
+
+// The number of ranges of ids of a top-k query which are ranked at once, each with its own heap
+#define TOP_K_CHUNKS 64
+
+// The ids of a top-k query are read from their iterator a block at a time, so that only TOP_K_BLOCK of them are held
+#define TOP_K_BLOCK (TOP_K_CHUNKS * ELEMENTS_PER_CHUNK)
+
+// The best elements pushed so far, at most capacity of them, with the one which ranks last at the root so that it is
+// the first replaced. The elements are allocated as the heap fills, since the capacity can exceed the elements pushed.
+typedef struct {
+	size_t capacity;
+	size_t nb_allocated;
+	size_t size;
+	RankedElement* elements;
+} TopKHeap;
+
+static TopKHeap TopKHeap_with_capacity(size_t capacity) {
+	size_t nb_allocated = capacity < TOP_K_BLOCK ? capacity : TOP_K_BLOCK;
+	return (TopKHeap){
+		.capacity = capacity,
+		.nb_allocated = nb_allocated,
+		.size = 0,
+		.elements = MALLOC((nb_allocated + 1) * sizeof(RankedElement)),
+	};
+}
+
+// Whether an element whose value is at most bound can't enter the heap
+static bool TopKHeap_can_skip(const TopKHeap* heap, size_t id, double bound) {
+	if (heap->size < heap->capacity) {
+		return false;
+	}
+	return heap->capacity == 0 || !RankedElement_before((RankedElement){.id = id, .value = bound}, heap->elements[0]);
+}
+
+static void TopKHeap_push(TopKHeap* heap, RankedElement element) {
+	RankedElement* elements = heap->elements;
+	if (heap->size < heap->capacity) {
+		if (heap->size == heap->nb_allocated) {
+			heap->nb_allocated = heap->capacity / 2 < heap->nb_allocated ? heap->capacity : 2 * heap->nb_allocated;
+			heap->elements = realloc(heap->elements, (heap->nb_allocated + 1) * sizeof(RankedElement));
+			elements = heap->elements;
+		}
+		// The parents which rank before the element go down
+		size_t i = heap->size++;
+		while (i > 0 && RankedElement_before(elements[(i - 1) / 2], element)) {
+			elements[i] = elements[(i - 1) / 2];
+			i = (i - 1) / 2;
+		}
+		elements[i] = element;
+		return;
+	}
+	if (heap->capacity == 0 || !RankedElement_before(element, elements[0])) {
+		return;
+	}
+	// The element replaces the root, and the children which rank after it go up
+	size_t i = 0;
+	while (2 * i + 1 < heap->size) {
+		size_t child = 2 * i + 1;
+		if (child + 1 < heap->size && RankedElement_before(elements[child], elements[child + 1])) {
+			child++;
+		}
+		if (!RankedElement_before(element, elements[child])) {
+			break;
+		}
+		elements[i] = elements[child];
+		i = child;
+	}
+	elements[i] = element;
+}
+
+typedef struct TopKContext TopKContext;
+
+// Computes the value of an element, or returns false if it can't enter the heap
+typedef bool (*TopKRank)(TopKContext* context, size_t id, const TopKHeap* heap, double* value);
+
+struct TopKContext {
+	Stream* stream;
+	const StreamFunctions* stream_functions;
+	size_t k;
+	TopKRank rank;
+	size_t* block;			 // The ids of the block being ranked
+	TopKHeap* heaps;		 // One per chunk of the block
+	TopKHeap best;			 // The best elements of the blocks already ranked, which is only read during a block
+	MemoValue times;		 // The presence times of the elements, if the memo table already had them
+	MemoValue intersections; // Same, for the intersections of the nodes of the links
+	double t;
+};
+
+static void top_k_of_chunk(void* context, size_t chunk_index, size_t from, size_t to) {
+	TopKContext* ctx = (TopKContext*)context;
+	TopKHeap heap = TopKHeap_with_capacity(ctx->k < to - from ? ctx->k : to - from);
+	for (size_t i = from; i < to; i++) {
+		size_t id = ctx->block[i];
+		// Once the previous blocks filled the best heap, an element must beat it to enter
+		const TopKHeap* threshold = ctx->best.size == ctx->best.capacity ? &ctx->best : &heap;
+		double value;
+		if (ctx->rank(ctx, id, threshold, &value)) {
+			TopKHeap_push(&heap, (RankedElement){.id = id, .value = value});
+		}
+	}
+	ctx->heaps[chunk_index] = heap;
+}
+
+// Ranks the ids of the iterator a block at a time, the ranges of a block in parallel, then merges their heaps in order
+// and sorts the best k elements. The ranking is a total order, so the result doesn't depend on the blocks.
+static MetricValues run_top_k(TopKContext* context, size_t (*next)(void*), void* iterator) {
+	context->block = MALLOC(TOP_K_BLOCK * sizeof(size_t));
+	context->heaps = MALLOC(TOP_K_CHUNKS * sizeof(TopKHeap));
+	context->best = TopKHeap_with_capacity(context->k);
+	size_t id = next(iterator);
+	while (id != SIZE_MAX) {
+		size_t nb_ids = 0;
+		while (id != SIZE_MAX && nb_ids < TOP_K_BLOCK) {
+			context->block[nb_ids++] = id;
+			id = next(iterator);
+		}
+		ThreadPool_parallel_for(ThreadPool_global(), nb_ids, ELEMENTS_PER_CHUNK, top_k_of_chunk, context);
+		size_t nb_chunks = ThreadPool_nb_chunks(nb_ids, ELEMENTS_PER_CHUNK);
+		for (size_t chunk = 0; chunk < nb_chunks; chunk++) {
+			for (size_t i = 0; i < context->heaps[chunk].size; i++) {
+				TopKHeap_push(&context->best, context->heaps[chunk].elements[i]);
+			}
+			free(context->heaps[chunk].elements);
+		}
+	}
+	free(context->heaps);
+	free(context->block);
+	TopKHeap best = context->best;
+	qsort(best.elements, best.size, sizeof(RankedElement), RankedElement_compare);
+
+	MetricValues result = {
+		.nb_elements = best.size,
+		.ids = MALLOC((best.size + 1) * sizeof(size_t)),
+		.values = MALLOC((best.size + 1) * sizeof(double)),
+	};
+	for (size_t i = 0; i < best.size; i++) {
+		result.ids[i] = best.elements[i].id;
+		result.values[i] = best.elements[i].value;
+	}
+	free(best.elements);
+	return result;
+}
+
+static size_t memo_element(MemoValue value, size_t id) {
+	return id < value.nb_values ? value.values[id] : 0;
+}
+
+// Writes the interval from the first to the last of the intervals iterated, which contains all of them, in O(1) when
+// they are contiguous. Returns false if they aren't. Does not consume the iterator.
+static bool presence_span(TimesIterator times, Interval* span) {
+	IntervalsSet intervals = times.contiguous;
+	if (intervals.intervals == NULL) {
+		return false;
+	}
+	if (intervals.nb_intervals == 0) {
+		*span = Interval_from(0, 0);
+		return true;
+	}
+	TimeId start = intervals.intervals[0].start;
+	TimeId end = intervals.intervals[intervals.nb_intervals - 1].end;
+	if (times.clipped) {
+		start = start > times.clip.start ? start : times.clip.start;
+		end = end < times.clip.end ? end : times.clip.end;
+	}
+	*span = Interval_from(start, end > start ? end : start);
+	return true;
+}
+
+static bool rank_node_presence(TopKContext* context, size_t id, const TopKHeap* heap, double* value) {
+	size_t time;
+	if (context->times.values != NULL) {
+		time = memo_element(context->times, id);
+	}
+	else {
+		const StreamFunctions* stream_functions = context->stream_functions;
+		TimesIterator times = stream_functions->times_node_present(context->stream->stream, id);
+		Interval span;
+		if (presence_span(times, &span) && TopKHeap_can_skip(heap, id, (double)Interval_size(span) / context->t)) {
+			times.destroy(&times);
+			return false;
+		}
+		time = total_time_of(times);
+	}
+	*value = (double)time / context->t;
+	return true;
+}
+
+MetricValues Stream_most_present_nodes(Stream* stream, size_t k) {
+	INSTRUMENT_METRIC(stream, most_present_nodes);
+	TopKContext context = {
+		.stream = stream,
+		.stream_functions = stream->stream_functions,
+		.k = k,
+		.rank = rank_node_presence,
+		.times = {0, NULL},
+		.intersections = {0, NULL},
+		.t = (double)cardinalOfT(stream),
+	};
+	bool memoized = Stream_memo_fetch(stream, MEMO_TIMES_NODE_PRESENT, &context.times);
+	NodesIterator nodes = stream->stream_functions->nodes_set(stream->stream);
+	MetricValues result = run_top_k(&context, nodes.next, &nodes);
+	nodes.destroy(&nodes);
+	if (memoized) {
+		Stream_memo_release(stream, MEMO_TIMES_NODE_PRESENT, context.times);
+	}
+	return result;
+}
+
+// A lower bound of |T_u ∩ T_v| = |T_u| + |T_v| - |T_u ∪ T_v|, from the span of the union which contains it, or 0 if
+// the presences aren't contiguous. Summing the presences is cheaper than intersecting them.
+static size_t intersection_lower_bound(const StreamFunctions* stream_functions, void* st, Link link) {
+	TimesIterator times_u = stream_functions->times_node_present(st, link.nodes[0]);
+	TimesIterator times_v = stream_functions->times_node_present(st, link.nodes[1]);
+	Interval span_u;
+	Interval span_v;
+	if (!presence_span(times_u, &span_u) || !presence_span(times_v, &span_v)) {
+		times_u.destroy(&times_u);
+		times_v.destroy(&times_v);
+		return 0;
+	}
+	TimeId start = span_u.start < span_v.start ? span_u.start : span_v.start;
+	TimeId end = span_u.end > span_v.end ? span_u.end : span_v.end;
+	size_t sum = total_time_of(times_u) + total_time_of(times_v);
+	return sum > end - start ? sum - (end - start) : 0;
+}
+
+static bool rank_link_density(TopKContext* context, size_t id, const TopKHeap* heap, double* value) {
+	const StreamFunctions* stream_functions = context->stream_functions;
+	void* st = context->stream->stream;
+	size_t link_time = context->times.values != NULL ? memo_element(context->times, id)
+													 : total_time_of(stream_functions->times_link_present(st, id));
+	// A link is only present when both its nodes are, so the intersection of their presences is at least its time
+	if (TopKHeap_can_skip(heap, id, link_time == 0 ? 0.0 : 1.0)) {
+		return false;
+	}
+	size_t intersection;
+	if (context->intersections.values != NULL) {
+		intersection = memo_element(context->intersections, id);
+	}
+	else {
+		Link link = stream_functions->nth_link(st, id);
+		if (heap->size == heap->capacity) {
+			size_t lower_bound = intersection_lower_bound(stream_functions, st, link);
+			if (lower_bound > link_time && TopKHeap_can_skip(heap, id, (double)link_time / (double)lower_bound)) {
+				return false;
+			}
+		}
+		TimesIterator times_u = stream_functions->times_node_present(st, link.nodes[0]);
+		TimesIterator times_v = stream_functions->times_node_present(st, link.nodes[1]);
+		intersection = total_time_of(TimesIterator_intersection(times_u, times_v));
+	}
+	// The density of a link whose nodes are never together is undefined, like for Stream_density_of_link
+	if (intersection == 0) {
+		return false;
+	}
+	*value = (double)link_time / (double)intersection;
+	return true;
+}
+
+MetricValues Stream_densest_links(Stream* stream, size_t k) {
+	INSTRUMENT_METRIC(stream, densest_links);
+	TopKContext context = {
+		.stream = stream,
+		.stream_functions = stream->stream_functions,
+		.k = k,
+		.rank = rank_link_density,
+		.times = {0, NULL},
+		.intersections = {0, NULL},
+		.t = (double)cardinalOfT(stream),
+	};
+	bool times_memoized = Stream_memo_fetch(stream, MEMO_TIMES_LINK_PRESENT, &context.times);
+	bool intersections_memoized =
+		Stream_memo_fetch(stream, MEMO_NODES_INTERSECTION_OF_LINKS, &context.intersections);
+	LinksIterator links = stream->stream_functions->links_set(stream->stream);
+	MetricValues result = run_top_k(&context, links.next, &links);
+	links.destroy(&links);
+	if (intersections_memoized) {
+		Stream_memo_release(stream, MEMO_NODES_INTERSECTION_OF_LINKS, context.intersections);
+	}
+	if (times_memoized) {
+		Stream_memo_release(stream, MEMO_TIMES_LINK_PRESENT, context.times);
+	}
+	return result;
+}
+
+static void push_key_moment(InstantMetrics metrics, void* user_data) {
+	TopKHeap_push((TopKHeap*)user_data, (RankedElement){.id = metrics.instant, .value = (double)metrics.nb_links});
+}
+
+static int compare_by_instant(const void* a, const void* b) {
+	TimeId instant_a = ((const RankedElement*)a)->id;
+	TimeId instant_b = ((const RankedElement*)b)->id;
+	return (instant_a > instant_b) - (instant_a < instant_b);
+}
+
+static int compare_by_links(const void* a, const void* b) {
+	const InstantMetrics* metrics_a = (const InstantMetrics*)a;
+	const InstantMetrics* metrics_b = (const InstantMetrics*)b;
+	if (metrics_a->nb_links != metrics_b->nb_links) {
+		return metrics_a->nb_links > metrics_b->nb_links ? -1 : 1;
+	}
+	return (metrics_a->instant > metrics_b->instant) - (metrics_a->instant < metrics_b->instant);
+}
+
+InstantMetrics* Stream_busiest_instants(Stream* stream, size_t k, size_t* nb_instants) {
+	INSTRUMENT_METRIC(stream, busiest_instants);
+	Timeline timeline = Timeline_from(stream);
+	TopKHeap heap = TopKHeap_with_capacity(k < timeline.nb_events + 1 ? k : timeline.nb_events + 1);
+	sweep_key_moments(&timeline, push_key_moment, &heap);
+
+	// The second sweep needs the instants in chronological order
+	qsort(heap.elements, heap.size, sizeof(RankedElement), compare_by_instant);
+	TimeId* instants = MALLOC((heap.size + 1) * sizeof(TimeId));
+	for (size_t i = 0; i < heap.size; i++) {
+		instants[i] = heap.elements[i].id;
+	}
+	InstantMetricsWriter writer = {
+		.metrics = MALLOC((heap.size + 1) * sizeof(InstantMetrics)),
+		.nb_written = 0,
+	};
+	sweep_instants(&timeline, instants, heap.size, write_instant_metrics, &writer);
+	qsort(writer.metrics, writer.nb_written, sizeof(InstantMetrics), compare_by_links);
+
+	*nb_instants = writer.nb_written;
+	free(instants);
+	free(heap.elements);
+	Timeline_destroy(timeline);
+	return writer.metrics;
 }
\ No newline at end of file
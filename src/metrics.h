@@ -25,19 +25,53 @@
  * If set to NULL, the default implementation will be used.
  */
 // TODO : rename these
-typedef struct {
+typedef struct MetricsFunctions {
 	size_t (*cardinalOfW)(void*);
 	size_t (*cardinalOfT)(void*);
 	size_t (*cardinalOfV)(void*);
 	double (*coverage)(void*);
 	double (*node_duration)(void*);
 	double (*density)(void*);
+
+	// Core loops, usually generated from metrics_kernels.h. The arrays are the ones of the memo table, see MemoKey.
+	size_t (*cardinalOfE)(void*);
+	MemoValue (*times_node_present)(void*);
+	MemoValue (*times_link_present)(void*);
+	MemoValue (*degree_sums)(void*, MemoValue links_times);
+	MemoValue (*nodes_intersection_of_links)(void*);
+	// From the first appearance to the last disappearance of the nodes, and the number of nodes present at least once
+	Interval (*nodes_span)(void*, size_t* nb_nodes_present);
 } MetricsFunctions;
 
+/**
+ * @brief Like Stream_memo_acquire, with the function of the metrics computing the value of the key.
+ *
+ * Allows a type of Stream made of other Streams to reuse the values memoized in them.
+ * The value must be released with Stream_memo_release.
+ * @param[in] stream The Stream.
+ * @param[in] key The value to get.
+ */
+MemoValue Stream_memo_acquire_metric(Stream* stream, MemoKey key);
+
 /**
  *@name Section 3 : Stream graphs and link streams
  *@{
  */
+
+/**
+ * @brief The cardinals of the sets of the Stream, cached in the Stream after the first call.
+ *
+ * They can be called concurrently on the same Stream, the value is only computed by the first caller.
+ * @param[in] stream The Stream.
+ */
+size_t cardinalOfT(Stream* stream);
+/** @copydoc cardinalOfT */
+size_t cardinalOfV(Stream* stream);
+/** @copydoc cardinalOfT */
+size_t cardinalOfE(Stream* stream);
+/** @copydoc cardinalOfT */
+size_t cardinalOfW(Stream* stream);
+
 /**
  * @param[in] stream The Stream.
  */
@@ -99,7 +133,16 @@ double Stream_link_duration(Stream* stream);
  */
 double Stream_uniformity(Stream* stream);
 
-// TODO : compactness
+/**
+ * @brief The size of the Stream divided by the one of the smallest Stream with intervals containing it, that is
+ * |W| / (|T'| |V'|), with T' the interval from the first appearance of a node to the last disappearance of a node,
+ * and V' the nodes present at least once.
+ *
+ * Only needs the first and last presence of each node, so it costs O(V + number of intervals) at most, and O(V) for
+ * the types of Stream with metrics kernels.
+ * @param[in] stream The Stream.
+ */
+double Stream_compactness(Stream* stream);
 /** @} */
 
 /**
@@ -132,6 +175,71 @@ double Stream_density_of_node(Stream* stream, NodeId node_id);
 double Stream_density_at_instant(Stream* stream, TimeId time_id);
 /** @} */
 
+/**
+ *@name Time series
+ * The number of nodes, the number of links and the density at many instants, computed in a single sweep over the
+ * appearances and disappearances of the nodes and links of the Stream (see timeline.h), instead of rebuilding the
+ * sets of nodes and links present at each instant.
+ * The results can either be given to a callback as they are computed, or written to an array.
+ *@{
+ */
+
+/**
+ * @brief The size and density of a Stream at an instant.
+ */
+typedef struct {
+	TimeId instant;	 /**< The instant. For a key moment, the values hold until the next one. */
+	size_t nb_nodes; /**< The number of nodes present, |V_t|. */
+	size_t nb_links; /**< The number of links present, |E_t|. */
+	double density;	 /**< |E_t| divided by the number of pairs of nodes present, 0 if there are less than 2 nodes. */
+} InstantMetrics;
+
+/**
+ * @brief A function called with the InstantMetrics of each instant of a sweep, in chronological order.
+ * @param[in] metrics The metrics at the instant.
+ * @param[in] user_data The pointer given to the sweep function.
+ */
+typedef void (*InstantMetricsCallback)(InstantMetrics metrics, void* user_data);
+
+/**
+ * @brief Calls the callback for every key moment of the Stream, that is every instant at which a node or link appears
+ * or disappears, and the beginning of its lifespan.
+ * @param[in] stream The Stream.
+ * @param[in] callback The function to call for each key moment.
+ * @param[in] user_data Passed as is to the callback.
+ * @return The number of key moments.
+ */
+size_t Stream_sweep_key_moments(Stream* stream, InstantMetricsCallback callback, void* user_data);
+
+/**
+ * @brief Calls the callback for every given instant.
+ * @param[in] stream The Stream.
+ * @param[in] instants The instants, sorted in increasing order.
+ * @param[in] nb_instants The number of instants.
+ * @param[in] callback The function to call for each instant.
+ * @param[in] user_data Passed as is to the callback.
+ */
+void Stream_sweep_instants(Stream* stream, const TimeId* instants, size_t nb_instants,
+						   InstantMetricsCallback callback, void* user_data);
+
+/**
+ * @brief Like Stream_sweep_key_moments, but writes the results to an array.
+ * @param[in] stream The Stream.
+ * @param[out] nb_key_moments The number of key moments, and therefore the size of the array.
+ * @return The metrics at each key moment. Must be freed with free.
+ */
+InstantMetrics* Stream_key_moments_time_series(Stream* stream, size_t* nb_key_moments);
+
+/**
+ * @brief Like Stream_sweep_instants, but writes the results to an array.
+ * @param[in] stream The Stream.
+ * @param[in] instants The instants, sorted in increasing order.
+ * @param[in] nb_instants The number of instants.
+ * @param[out] metrics The metrics at each instant, must be able to hold nb_instants elements.
+ */
+void Stream_instants_time_series(Stream* stream, const TimeId* instants, size_t nb_instants, InstantMetrics* metrics);
+/** @} */
+
 /**
  *@name Section 8 : Neighbourhood and degree
  *@{
@@ -149,4 +257,191 @@ double Stream_degree_of_node(Stream* stream, NodeId node_id);
 double Stream_average_node_degree(Stream* stream);
 /** @} */
 
+/**
+ *@name Section 9 : Clustering
+ * The clustering coefficient of a node v is the time during which pairs of its neighbours are linked while both are
+ * linked to v, over the time during which pairs of its neighbours are both linked to v :
+ * cc(v) = Σ_{uw} |T_vu ∩ T_vw ∩ T_uw| / Σ_{uw} |T_vu ∩ T_vw|, and 0 if the denominator is 0.
+ * <br>
+ * The numerators of all the nodes are computed at once by enumerating the triangles of the graph of the links of the
+ * Stream, with its nodes ordered by degree so that each triangle is only found once, and intersecting the presences of
+ * their three links. The denominators are found by sweeping the presences of the links of each node.
+ * Both are kept in the memo table and computed in parallel with the thread pool, see thread_pool.h.
+ *@{
+ */
+
+/**
+ * @brief The clustering coefficient of a node.
+ *
+ * Uses the values of the memo table if they are there, otherwise only goes through the neighbours of the node and
+ * their links.
+ * @param[in] stream The Stream.
+ * @param[in] node_id The id of the node to get the clustering coefficient of.
+ */
+double Stream_clustering_coeff_of_node(Stream* stream, NodeId node_id);
+
+/**
+ * @brief The average of the clustering coefficients of the nodes, weighted by their presence times,
+ * that is Σ_v (|T_v| / |W|) cc(v), like the average degree of the nodes.
+ * @param[in] stream The Stream.
+ */
+double Stream_clustering_coeff(Stream* stream);
+
+/**
+ * @brief The ratio of the time triangles are closed over the time pairs of links of a node are present,
+ * Σ_v Σ_{uw} |T_vu ∩ T_vw ∩ T_uw| / Σ_v Σ_{uw} |T_vu ∩ T_vw|.
+ *
+ * Unlike Stream_clustering_coeff, the nodes with many neighbours weigh more.
+ * @param[in] stream The Stream.
+ */
+double Stream_transitivity(Stream* stream);
+/** @} */
+
+/**
+ *@name Bulk metrics
+ * Per-element metrics computed for every node or every link of the Stream at once.
+ * They give the same values as calling the per-element function on each id, but dispatch, the allocation of the
+ * results and the cardinals they depend on are only done once.
+ * The elements are split in chunks computed in parallel by the workers of the thread pool, see thread_pool.h.
+ *@{
+ */
+
+/**
+ * @brief The values of a metric for every node or every link of a Stream.
+ *
+ * The elements are in the same order as the nodes_set or links_set of the Stream, values[i] is the value for ids[i].
+ * Must be freed with MetricValues_destroy.
+ */
+typedef struct {
+	size_t nb_elements; /**< The number of nodes or links. */
+	size_t* ids;		/**< The ids of the nodes or links. */
+	double* values;		/**< The value of the metric for each node or link. */
+} MetricValues;
+
+/**
+ * @brief Frees the memory of a MetricValues.
+ * @param[in] metric_values The MetricValues to free.
+ */
+void MetricValues_destroy(MetricValues metric_values);
+
+/**
+ * @brief Stream_contribution_of_node for every node of the Stream.
+ * @param[in] stream The Stream.
+ */
+MetricValues Stream_contribution_of_all_nodes(Stream* stream);
+
+/**
+ * @brief Stream_contribution_of_link for every link of the Stream.
+ * @param[in] stream The Stream.
+ */
+MetricValues Stream_contribution_of_all_links(Stream* stream);
+
+/**
+ * @brief Stream_degree_of_node for every node of the Stream.
+ * @param[in] stream The Stream.
+ */
+MetricValues Stream_degree_of_all_nodes(Stream* stream);
+
+/**
+ * @brief Stream_density_of_link for every link of the Stream.
+ * @param[in] stream The Stream.
+ */
+MetricValues Stream_density_of_all_links(Stream* stream);
+
+/**
+ * @brief Stream_density_of_node for every node of the Stream.
+ *
+ * The presence of every node is only read once from the Stream, and the pairwise intersections are computed by
+ * merging the sorted intervals instead of going through iterators.
+ * @param[in] stream The Stream.
+ */
+MetricValues Stream_density_of_all_nodes(Stream* stream);
+
+/**
+ * @brief Stream_clustering_coeff_of_node for every node of the Stream.
+ * @param[in] stream The Stream.
+ */
+MetricValues Stream_clustering_coeff_of_all_nodes(Stream* stream);
+
+/**
+ * @brief The distribution of the degrees of the nodes over time, and the degree of each node.
+ *
+ * Must be freed with DegreeHistogram_destroy.
+ */
+typedef struct {
+	size_t nb_degrees;	  /**< The largest degree reached by a node plus one, the size of node_times. */
+	size_t* node_times;	  /**< The total time the nodes spent present with k neighbours is node_times[k], so that
+							   they add up to |W|. */
+	MetricValues degrees; /**< The degree of each node, like Stream_degree_of_all_nodes. */
+} DegreeHistogram;
+
+/**
+ * @brief The time-weighted distribution of the degrees of the nodes, and their degrees, in a single sweep over the
+ * appearances and disappearances of the nodes and links of the Stream (see timeline.h).
+ *
+ * Each event only updates the current degree of the nodes it is about, after adding the time spent with the previous
+ * one to the histogram, so the sweep costs O(E) after the Timeline is built in O(E log E), with E the number of events.
+ * @param[in] stream The Stream.
+ * @return The histogram of the degrees.
+ */
+DegreeHistogram Stream_degree_histogram(Stream* stream);
+
+/**
+ * @brief Frees the memory of a DegreeHistogram.
+ * @param[in] histogram The DegreeHistogram to free.
+ */
+void DegreeHistogram_destroy(DegreeHistogram histogram);
+/** @} */
+
+/**
+ *@name Top-k metrics
+ * The k nodes, links or instants with the largest value of a metric, without computing and sorting it for all of them.
+ * Each range of ids keeps its best k elements in a bounded heap, and skips the elements which an upper bound cheaper
+ * than the metric shows can't enter the heap once it is full. The ranges are computed in parallel by the workers of
+ * the thread pool, see thread_pool.h, and their heaps are merged in the order of the ranges.
+ * The results are sorted by decreasing value, and the ties by increasing id, so they don't depend on the number of
+ * workers. They hold less than k elements if the Stream has less than k of them.
+ *@{
+ */
+
+/**
+ * @brief The k nodes with the largest Stream_contribution_of_node, that is the most present ones.
+ *
+ * When the presence of a node is an array of intervals, the time between its first appearance and its last
+ * disappearance bounds its presence time, which skips the nodes present too briefly without summing their intervals.
+ * Must be freed with MetricValues_destroy.
+ * @param[in] stream The Stream.
+ * @param[in] k The number of nodes.
+ */
+MetricValues Stream_most_present_nodes(Stream* stream, size_t k);
+
+/**
+ * @brief The k links with the largest Stream_density_of_link.
+ *
+ * A link is only present when both its nodes are, so its density is at most 1, and 0 if it is never present. When the
+ * presences of its nodes are arrays of intervals, |T_u ∩ T_v| is at least |T_u| + |T_v| minus the time from their
+ * first appearance to their last disappearance, which bounds the density closer. The links which can't reach the k-th
+ * density this way are skipped without intersecting the presences of their nodes.
+ * The density of a link whose nodes are never present together is undefined, so these links are not ranked, and fewer
+ * than k links are returned when too few others are left.
+ * Must be freed with MetricValues_destroy.
+ * @param[in] stream The Stream.
+ * @param[in] k The number of links.
+ */
+MetricValues Stream_densest_links(Stream* stream, size_t k);
+
+/**
+ * @brief The k key moments with the most links present, see Stream_sweep_key_moments.
+ *
+ * The key moments are kept in a heap during a single sweep, then the metrics of the k best are read in a second
+ * sweep over the same events.
+ * @param[in] stream The Stream.
+ * @param[in] k The number of key moments.
+ * @param[out] nb_instants The number of key moments returned, at most k.
+ * @return The metrics at the key moments, by decreasing number of links, then increasing instant. Must be freed with
+ * free.
+ */
+InstantMetrics* Stream_busiest_instants(Stream* stream, size_t k, size_t* nb_instants);
+/** @} */
+
 #endif // METRICS_H
\ No newline at end of file
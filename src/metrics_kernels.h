@@ -0,0 +1,219 @@
+#ifndef METRICS_KERNELS_H
+#define METRICS_KERNELS_H
+
+/**
+ * @file metrics_kernels.h
+ * @brief Generates specialised versions of the core loops of the metrics for a type of Stream.
+ *
+ * The generic metrics reach the nodes, links and presence times through the iterators of the StreamFunctions, with an
+ * indirect call per element, which the compiler can neither inline nor vectorise. A type of Stream backed by a
+ * StreamGraph can instead describe how to walk its ids with a few macros, and DEFINE_METRICS_KERNELS generates loops
+ * over the raw TemporalNodesSet and LinksSet arrays of the StreamGraph. METRICS_KERNELS_FUNCTIONS puts them in its
+ * MetricsFunctions. The types of Stream which don't do this keep the generic path.
+ * <br>
+ * The description of a type of Stream is given as macros taking a pointer s to it :
+ * - STREAM_GRAPH(s) : its underlying StreamGraph.
+ * - SNAPSHOT(s) : the interval its presence times are clipped to.
+ * - CLIPPED : whether the presence times must be clipped to the snapshot. It is a constant, so the clipping is compiled
+ *   out when the presence times are already inside it.
+ * - FOR_EACH_NODE_ID(s, id) and FOR_EACH_LINK_ID(s, id) : the header of a loop over the ids present, declaring id.
+ * - NODE_PRESENCE(s, id) : the presence of a node, before clipping. The presence of a link is always the one in the
+ *   StreamGraph.
+ * - NODE_STORE(s) : the PresenceStore of the nodes, NULL if the presence of the nodes is not the one in the
+ *   StreamGraph. The presence times are read from the PresenceStores, whose arrays are contiguous.
+ * - ALL_IDS : whether the loops go over every node and link of the StreamGraph, and the times are not clipped. The total
+ *   times are then a single scan of the PresenceStores.
+ * - TIME_INDEX(s) : the TimeIndex of the StreamGraph if the Stream has all its nodes and links, with their presence
+ *   in the StreamGraph, and it was built with init_time_index. NULL otherwise. The total times inside the snapshot
+ *   are then read from it in O(log K) for K key moments.
+ */
+
+#include "interval.h"
+#include "stream.h"
+#include "stream_graph.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+// Total time of a set of intervals, clipped to the snapshot if needed. clipped is a constant, so only one is kept.
+static inline size_t kernel_presence_time(IntervalsSet presence, Interval snapshot, bool clipped) {
+	return clipped ? IntervalsSet_size_clipped(presence, snapshot) : IntervalsSet_size(presence);
+}
+
+// Total time of the intersection of two sorted sets of intervals, clipped to the snapshot if needed
+static inline size_t kernel_intersection_time(IntervalsSet a, IntervalsSet b, Interval snapshot, bool clipped) {
+	size_t sum = 0;
+	size_t i = 0;
+	size_t j = 0;
+	while (i < a.nb_intervals && j < b.nb_intervals) {
+		TimeId start = a.intervals[i].start > b.intervals[j].start ? a.intervals[i].start : b.intervals[j].start;
+		TimeId end = a.intervals[i].end < b.intervals[j].end ? a.intervals[i].end : b.intervals[j].end;
+		if (clipped) {
+			start = start < snapshot.start ? snapshot.start : start;
+			end = end > snapshot.end ? snapshot.end : end;
+		}
+		if (start < end) {
+			sum += end - start;
+		}
+		if (a.intervals[i].end < b.intervals[j].end) {
+			i++;
+		}
+		else {
+			j++;
+		}
+	}
+	return sum;
+}
+
+// Total time of an id in a PresenceStore, clipped to the snapshot if needed
+static inline size_t kernel_store_time(const PresenceStore* store, size_t id, Interval snapshot, bool clipped) {
+	return clipped ? PresenceStore_time_of_clipped(store, id, snapshot) : PresenceStore_time_of(store, id);
+}
+
+// From the first appearance to the last disappearance of a set of intervals, clipped to the snapshot if needed
+static inline Interval kernel_presence_span(IntervalsSet presence, Interval snapshot, bool clipped) {
+	if (clipped) {
+		return IntervalsSet_span_clipped(presence, snapshot);
+	}
+	if (presence.nb_intervals == 0) {
+		return Interval_from(0, 0);
+	}
+	return Interval_from(presence.intervals[0].start, IntervalsSet_last(&presence).end);
+}
+
+// An array indexed by the ids of the StreamGraph, filled with 0 for the ids absent from the Stream
+static inline MemoValue kernel_array_of_ids(size_t nb_ids) {
+	return (MemoValue){.nb_values = nb_ids, .values = calloc(nb_ids + 1, sizeof(size_t))};
+}
+
+/**
+ * @brief Defines the kernels prefix_kernel_* of a type of Stream, see the description of the file for the arguments.
+ */
+#define DEFINE_METRICS_KERNELS(prefix, Type, STREAM_GRAPH, SNAPSHOT, CLIPPED, FOR_EACH_NODE_ID, FOR_EACH_LINK_ID,      \
+							   NODE_PRESENCE, NODE_STORE, ALL_IDS, TIME_INDEX)                                         \
+	static size_t prefix##_kernel_cardinalOfV(Type* s) {                                                               \
+		size_t count = 0;                                                                                              \
+		FOR_EACH_NODE_ID(s, id) {                                                                                      \
+			(void)id;                                                                                                  \
+			count++;                                                                                                   \
+		}                                                                                                              \
+		return count;                                                                                                  \
+	}                                                                                                                  \
+                                                                                                                       \
+	static size_t prefix##_kernel_cardinalOfW(Type* s) {                                                               \
+		const TimeIndex* time_index = TIME_INDEX(s);                                                                   \
+		if (time_index != NULL) {                                                                                      \
+			return TimeIndex_node_time(time_index, SNAPSHOT(s));                                                       \
+		}                                                                                                              \
+		const PresenceStore* store = NODE_STORE(s);                                                                    \
+		if ((ALL_IDS) && store != NULL) {                                                                              \
+			return PresenceStore_total_time(store);                                                                    \
+		}                                                                                                              \
+		Interval snapshot = SNAPSHOT(s);                                                                               \
+		size_t sum = 0;                                                                                                \
+		FOR_EACH_NODE_ID(s, id) {                                                                                      \
+			sum += store != NULL ? kernel_store_time(store, id, snapshot, CLIPPED)                                     \
+								 : kernel_presence_time(NODE_PRESENCE(s, id), snapshot, CLIPPED);                      \
+		}                                                                                                              \
+		return sum;                                                                                                    \
+	}                                                                                                                  \
+                                                                                                                       \
+	static size_t prefix##_kernel_cardinalOfE(Type* s) {                                                               \
+		const TimeIndex* time_index = TIME_INDEX(s);                                                                   \
+		if (time_index != NULL) {                                                                                      \
+			return TimeIndex_link_time(time_index, SNAPSHOT(s));                                                       \
+		}                                                                                                              \
+		const PresenceStore* store = &STREAM_GRAPH(s)->link_presences;                                                 \
+		if (ALL_IDS) {                                                                                                 \
+			return PresenceStore_total_time(store);                                                                    \
+		}                                                                                                              \
+		Interval snapshot = SNAPSHOT(s);                                                                               \
+		size_t sum = 0;                                                                                                \
+		FOR_EACH_LINK_ID(s, id) {                                                                                      \
+			sum += kernel_store_time(store, id, snapshot, CLIPPED);                                                    \
+		}                                                                                                              \
+		return sum;                                                                                                    \
+	}                                                                                                                  \
+                                                                                                                       \
+	static MemoValue prefix##_kernel_times_node_present(Type* s) {                                                     \
+		const PresenceStore* store = NODE_STORE(s);                                                                    \
+		Interval snapshot = SNAPSHOT(s);                                                                               \
+		MemoValue times = kernel_array_of_ids(STREAM_GRAPH(s)->nodes.nb_nodes);                                        \
+		FOR_EACH_NODE_ID(s, id) {                                                                                      \
+			times.values[id] = store != NULL ? kernel_store_time(store, id, snapshot, CLIPPED)                         \
+											 : kernel_presence_time(NODE_PRESENCE(s, id), snapshot, CLIPPED);          \
+		}                                                                                                              \
+		return times;                                                                                                  \
+	}                                                                                                                  \
+                                                                                                                       \
+	static MemoValue prefix##_kernel_times_link_present(Type* s) {                                                     \
+		StreamGraph* stream_graph = STREAM_GRAPH(s);                                                                   \
+		Interval snapshot = SNAPSHOT(s);                                                                               \
+		MemoValue times = kernel_array_of_ids(stream_graph->links.nb_links);                                           \
+		FOR_EACH_LINK_ID(s, id) {                                                                                      \
+			times.values[id] = kernel_store_time(&stream_graph->link_presences, id, snapshot, CLIPPED);                \
+		}                                                                                                              \
+		return times;                                                                                                  \
+	}                                                                                                                  \
+                                                                                                                       \
+	/* The links absent from the Stream have a time of 0, so the neighbours don't need to be filtered */               \
+	static MemoValue prefix##_kernel_degree_sums(Type* s, MemoValue links_times) {                                     \
+		StreamGraph* stream_graph = STREAM_GRAPH(s);                                                                   \
+		MemoValue degree_sums = kernel_array_of_ids(stream_graph->nodes.nb_nodes);                                     \
+		FOR_EACH_NODE_ID(s, id) {                                                                                      \
+			TemporalNode* node = &stream_graph->nodes.nodes[id];                                                       \
+			size_t sum = 0;                                                                                            \
+			for (size_t i = 0; i < node->nb_neighbours; i++) {                                                         \
+				LinkId link_id = node->neighbours[i];                                                                  \
+				sum += link_id < links_times.nb_values ? links_times.values[link_id] : 0;                              \
+			}                                                                                                          \
+			degree_sums.values[id] = sum;                                                                              \
+		}                                                                                                              \
+		return degree_sums;                                                                                            \
+	}                                                                                                                  \
+                                                                                                                       \
+	static MemoValue prefix##_kernel_nodes_intersection_of_links(Type* s) {                                            \
+		StreamGraph* stream_graph = STREAM_GRAPH(s);                                                                   \
+		Interval snapshot = SNAPSHOT(s);                                                                               \
+		MemoValue intersections = kernel_array_of_ids(stream_graph->links.nb_links);                                   \
+		FOR_EACH_LINK_ID(s, id) {                                                                                      \
+			Link* link = &stream_graph->links.links[id];                                                               \
+			intersections.values[id] = kernel_intersection_time(NODE_PRESENCE(s, link->nodes[0]),                      \
+																NODE_PRESENCE(s, link->nodes[1]), snapshot, CLIPPED);  \
+		}                                                                                                              \
+		return intersections;                                                                                          \
+	}                                                                                                                  \
+                                                                                                                       \
+	static Interval prefix##_kernel_nodes_span(Type* s, size_t* nb_nodes_present) {                                   \
+		Interval snapshot = SNAPSHOT(s);                                                                               \
+		TimeId first = SIZE_MAX;                                                                                       \
+		TimeId last = 0;                                                                                               \
+		size_t count = 0;                                                                                              \
+		FOR_EACH_NODE_ID(s, id) {                                                                                      \
+			Interval span = kernel_presence_span(NODE_PRESENCE(s, id), snapshot, CLIPPED);                             \
+			if (span.start >= span.end) {                                                                              \
+				continue;                                                                                              \
+			}                                                                                                          \
+			count++;                                                                                                   \
+			first = span.start < first ? span.start : first;                                                           \
+			last = span.end > last ? span.end : last;                                                                  \
+		}                                                                                                              \
+		*nb_nodes_present = count;                                                                                     \
+		return count == 0 ? Interval_from(0, 0) : Interval_from(first, last);                                          \
+	}
+
+/**
+ * @brief The designated initialisers of the MetricsFunctions of a type of Stream for the kernels defined with
+ * DEFINE_METRICS_KERNELS.
+ */
+#define METRICS_KERNELS_FUNCTIONS(prefix)                                                                              \
+	.cardinalOfV = (size_t(*)(void*))prefix##_kernel_cardinalOfV,                                                      \
+	.cardinalOfW = (size_t(*)(void*))prefix##_kernel_cardinalOfW,                                                      \
+	.cardinalOfE = (size_t(*)(void*))prefix##_kernel_cardinalOfE,                                                      \
+	.times_node_present = (MemoValue(*)(void*))prefix##_kernel_times_node_present,                                     \
+	.times_link_present = (MemoValue(*)(void*))prefix##_kernel_times_link_present,                                     \
+	.degree_sums = (MemoValue(*)(void*, MemoValue))prefix##_kernel_degree_sums,                                        \
+	.nodes_intersection_of_links = (MemoValue(*)(void*))prefix##_kernel_nodes_intersection_of_links,                   \
+	.nodes_span = (Interval(*)(void*, size_t*))prefix##_kernel_nodes_span
+
+#endif // METRICS_KERNELS_H
\ No newline at end of file
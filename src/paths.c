@@ -0,0 +1,740 @@
+#include "paths.h"
+#include "instrumentation.h"
+#include "interval.h"
+#include "iterators.h"
+#include "stream/chunk_stream.h"
+#include "stream_functions.h"
+#include "thread_pool.h"
+#include "timeline.h"
+#include "utils.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+// The labels of the nodes no path waits on
+#define NO_HOPS		 SIZE_MAX
+#define NO_DEPARTURE SIZE_MAX
+// The node is connected to the source by links present now, so the paths waiting on it can leave the source now
+#define LEAVING_NOW	 (SIZE_MAX - 1)
+// The index of the ids which are not nodes of the Stream, and the end of the lists of nodes
+#define NO_NODE		 SIZE_MAX
+
+// A link, seen from one of its nodes
+typedef struct {
+	size_t node; // The index of the other node
+	LinkId link;
+} PathsEdge;
+
+// The graph of the links of a Stream and its Timeline, shared by the sweeps of all the sources. The nodes are
+// identified by their indexes in ids, so that the labels of a sweep fit in arrays of the number of nodes.
+typedef struct {
+	size_t nb_nodes;
+	NodeId* ids;
+	size_t nb_node_ids;			  // The largest node id plus one, 0 if there are no nodes
+	size_t* index_of_node;		  // Indexed by node id, NO_NODE for the ids which are not nodes of the Stream
+	size_t* offsets;			  // The links of the node of index i are the edges from offsets[i] to offsets[i + 1]
+	PathsEdge* edges;			  // The links of each node, from both of their ends
+	IntervalsSet* nodes_presence; // Indexed like ids
+	size_t nb_link_ids;			  // The largest link id plus one, 0 if there are no links
+	IntervalsSet* links_presence; // Indexed by link id, empty for the links absent from the Stream
+	size_t* links_nodes;		  // The indexes of the two nodes of the link of id l are at 2l and 2l + 1
+	Timeline timeline;
+} PathsGraph;
+
+static PathsGraph PathsGraph_from(Stream* stream) {
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	void* st = stream->stream;
+	PathsGraph graph = {.timeline = Timeline_from(stream)};
+
+	NodeIdVector ids = NodeIdVector_new();
+	NodesIterator nodes = stream_functions->nodes_set(st);
+	FOR_EACH_NODE(node_id, nodes) {
+		NodeIdVector_push(&ids, node_id);
+		graph.nb_node_ids = node_id + 1 > graph.nb_node_ids ? node_id + 1 : graph.nb_node_ids;
+	}
+	graph.nb_nodes = ids.size;
+	graph.ids = ids.array;
+	graph.index_of_node = MALLOC((graph.nb_node_ids + 1) * sizeof(size_t));
+	for (size_t i = 0; i < graph.nb_node_ids; i++) {
+		graph.index_of_node[i] = NO_NODE;
+	}
+	graph.nodes_presence = MALLOC((graph.nb_nodes + 1) * sizeof(IntervalsSet));
+	for (size_t i = 0; i < graph.nb_nodes; i++) {
+		graph.index_of_node[graph.ids[i]] = i;
+		graph.nodes_presence[i] = TimesIterator_collect(stream_functions->times_node_present(st, graph.ids[i]));
+	}
+
+	LinkIdVector links = LinkIdVector_new();
+	LinksIterator links_set = stream_functions->links_set(st);
+	FOR_EACH_LINK(link_id, links_set) {
+		LinkIdVector_push(&links, link_id);
+		graph.nb_link_ids = link_id + 1 > graph.nb_link_ids ? link_id + 1 : graph.nb_link_ids;
+	}
+	graph.links_presence = calloc(graph.nb_link_ids + 1, sizeof(IntervalsSet));
+	graph.links_nodes = MALLOC((2 * graph.nb_link_ids + 1) * sizeof(size_t));
+	graph.offsets = calloc(graph.nb_nodes + 2, sizeof(size_t));
+	for (size_t i = 0; i < links.size; i++) {
+		LinkId link_id = links.array[i];
+		Link link = stream_functions->nth_link(st, link_id);
+		size_t u = graph.index_of_node[link.nodes[0]];
+		size_t v = graph.index_of_node[link.nodes[1]];
+		graph.links_nodes[2 * link_id] = u;
+		graph.links_nodes[2 * link_id + 1] = v;
+		graph.offsets[u + 2]++;
+		graph.offsets[v + 2]++;
+		graph.links_presence[link_id] = TimesIterator_collect(stream_functions->times_link_present(st, link_id));
+	}
+
+	// Counting sort of the links by each of their nodes
+	for (size_t i = 2; i < graph.nb_nodes + 2; i++) {
+		graph.offsets[i] += graph.offsets[i - 1];
+	}
+	graph.edges = MALLOC((2 * links.size + 1) * sizeof(PathsEdge));
+	for (size_t i = 0; i < links.size; i++) {
+		LinkId link_id = links.array[i];
+		size_t u = graph.links_nodes[2 * link_id];
+		size_t v = graph.links_nodes[2 * link_id + 1];
+		graph.edges[graph.offsets[u + 1]++] = (PathsEdge){.node = v, .link = link_id};
+		graph.edges[graph.offsets[v + 1]++] = (PathsEdge){.node = u, .link = link_id};
+	}
+	LinkIdVector_destroy(links);
+	return graph;
+}
+
+static void PathsGraph_destroy(PathsGraph graph) {
+	for (size_t i = 0; i < graph.nb_nodes; i++) {
+		IntervalsSet_destroy(graph.nodes_presence[i]);
+	}
+	for (size_t i = 0; i < graph.nb_link_ids; i++) {
+		IntervalsSet_destroy(graph.links_presence[i]);
+	}
+	free(graph.nodes_presence);
+	free(graph.links_presence);
+	free(graph.links_nodes);
+	free(graph.edges);
+	free(graph.offsets);
+	free(graph.index_of_node);
+	free(graph.ids);
+	Timeline_destroy(graph.timeline);
+}
+
+// Whether the presence intervals, sorted and disjoint, contain the instant, by binary search
+static bool is_present_at(IntervalsSet presence, TimeId instant) {
+	size_t low = 0;
+	size_t high = presence.nb_intervals;
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		if (presence.intervals[middle].end <= instant) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low < presence.nb_intervals && presence.intervals[low].start <= instant;
+}
+
+// The number of events of the Timeline happening at or before the instant
+static size_t nb_events_until(const Timeline* timeline, TimeId instant) {
+	size_t low = 0;
+	size_t high = timeline->nb_events;
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		if (timeline->events[middle].instant <= instant) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+// Whether leaving the source at a is better than at b
+static bool departs_later(TimeId a, TimeId b) {
+	if (a == NO_DEPARTURE || b == LEAVING_NOW) {
+		return false;
+	}
+	if (b == NO_DEPARTURE || a == LEAVING_NOW) {
+		return true;
+	}
+	return a > b;
+}
+
+// The searches splitting the nodes leaving now into the pieces which stay connected after links disappeared. A search
+// starts from each node at an end of these links, they run in turns and merge when they meet. A search which ends
+// without meeting another one found a whole piece, and once a single search is left, the pieces are known without
+// going through the largest one, which is usually the only one when the links disappearing are not bridges.
+typedef struct {
+	size_t* piece_of_node;	 // The search which found each node, for the nodes with the current stamp
+	size_t* next_frontier;	 // The nodes left to visit by each search, as linked lists through the nodes
+	size_t* next_found;		 // The nodes found by each search, as linked lists through the nodes
+	size_t* frontier_heads;	 // The first and last nodes of the lists of each search
+	size_t* frontier_tails;
+	size_t* found_heads;
+	size_t* found_tails;
+	size_t* parents;		 // The searches which met are merged with a union-find
+	size_t* running;		 // The searches which are still running
+	size_t* running_index;	 // The index of each running search in running
+	size_t nb_running;
+} PiecesSearch;
+
+// The labels of the nodes during the sweep of one source, in O(V) memory.
+// Sweeping backwards from a target, a node is labelled with 0 hops while the target can be reached from it.
+typedef struct {
+	const PathsGraph* graph;
+	size_t origin;				// The index of the source, or of the target when sweeping backwards
+	size_t* hops;				// The fewest links of the paths from (α, source) waiting on each node
+	TimeId* departures;			// The latest departure from the source of the paths waiting on each node
+	size_t* connected;			// The nodes leaving now, and some which were and have not been removed yet
+	size_t nb_connected;
+	bool* listed;				// Whether each node is in connected
+	size_t* touched;			// The nodes leaving now at an end of a link disappearing at the current instant
+	size_t nb_touched;
+	bool* is_touched;
+	size_t* stamps;				// The last search which went through each node
+	size_t stamp;
+	PiecesSearch pieces;
+	size_t* queue;				// The nodes whose labels improved at the current instant, not relaxed yet
+	size_t queue_start;
+	size_t queue_size;
+	bool* queued;
+	TemporalPaths* paths;		// The output when sweeping forward
+	LatestDepartures* latest;	// The output when sweeping backwards
+} PathsSweep;
+
+static PiecesSearch PiecesSearch_new(size_t nb_nodes) {
+	return (PiecesSearch){
+		.piece_of_node = MALLOC((nb_nodes + 1) * sizeof(size_t)),
+		.next_frontier = MALLOC((nb_nodes + 1) * sizeof(size_t)),
+		.next_found = MALLOC((nb_nodes + 1) * sizeof(size_t)),
+		.frontier_heads = MALLOC((nb_nodes + 1) * sizeof(size_t)),
+		.frontier_tails = MALLOC((nb_nodes + 1) * sizeof(size_t)),
+		.found_heads = MALLOC((nb_nodes + 1) * sizeof(size_t)),
+		.found_tails = MALLOC((nb_nodes + 1) * sizeof(size_t)),
+		.parents = MALLOC((nb_nodes + 1) * sizeof(size_t)),
+		.running = MALLOC((nb_nodes + 1) * sizeof(size_t)),
+		.running_index = MALLOC((nb_nodes + 1) * sizeof(size_t)),
+	};
+}
+
+static void PiecesSearch_destroy(PiecesSearch pieces) {
+	free(pieces.piece_of_node);
+	free(pieces.next_frontier);
+	free(pieces.next_found);
+	free(pieces.frontier_heads);
+	free(pieces.frontier_tails);
+	free(pieces.found_heads);
+	free(pieces.found_tails);
+	free(pieces.parents);
+	free(pieces.running);
+	free(pieces.running_index);
+}
+
+static PathsSweep PathsSweep_new(const PathsGraph* graph) {
+	size_t nb_nodes = graph->nb_nodes;
+	return (PathsSweep){
+		.graph = graph,
+		.hops = MALLOC((nb_nodes + 1) * sizeof(size_t)),
+		.departures = MALLOC((nb_nodes + 1) * sizeof(TimeId)),
+		.connected = MALLOC((nb_nodes + 1) * sizeof(size_t)),
+		.listed = MALLOC((nb_nodes + 1) * sizeof(bool)),
+		.touched = MALLOC((nb_nodes + 1) * sizeof(size_t)),
+		.is_touched = MALLOC((nb_nodes + 1) * sizeof(bool)),
+		.stamps = MALLOC((nb_nodes + 1) * sizeof(size_t)),
+		.pieces = PiecesSearch_new(nb_nodes),
+		.queue = MALLOC((nb_nodes + 1) * sizeof(size_t)),
+		.queued = MALLOC((nb_nodes + 1) * sizeof(bool)),
+	};
+}
+
+static void PathsSweep_reset(PathsSweep* sweep, size_t origin) {
+	for (size_t i = 0; i < sweep->graph->nb_nodes; i++) {
+		sweep->hops[i] = NO_HOPS;
+		sweep->departures[i] = NO_DEPARTURE;
+		sweep->listed[i] = false;
+		sweep->is_touched[i] = false;
+		sweep->stamps[i] = 0;
+		sweep->queued[i] = false;
+	}
+	sweep->origin = origin;
+	sweep->nb_connected = 0;
+	sweep->nb_touched = 0;
+	sweep->stamp = 0;
+	sweep->queue_start = 0;
+	sweep->queue_size = 0;
+}
+
+static void PathsSweep_destroy(PathsSweep sweep) {
+	free(sweep.hops);
+	free(sweep.departures);
+	free(sweep.connected);
+	free(sweep.listed);
+	free(sweep.touched);
+	free(sweep.is_touched);
+	free(sweep.stamps);
+	PiecesSearch_destroy(sweep.pieces);
+	free(sweep.queue);
+	free(sweep.queued);
+}
+
+// A node is only queued once at a time, so the queue never holds more than all the nodes
+static void PathsSweep_push(PathsSweep* sweep, size_t node) {
+	if (!sweep->queued[node]) {
+		sweep->queued[node] = true;
+		sweep->queue[(sweep->queue_start + sweep->queue_size) % sweep->graph->nb_nodes] = node;
+		sweep->queue_size++;
+	}
+}
+
+static size_t PathsSweep_pop(PathsSweep* sweep) {
+	size_t node = sweep->queue[sweep->queue_start];
+	sweep->queue_start = (sweep->queue_start + 1) % sweep->graph->nb_nodes;
+	sweep->queue_size--;
+	sweep->queued[node] = false;
+	return node;
+}
+
+// A path with that many links waits on the node from the instant
+static void reach_with_hops(PathsSweep* sweep, size_t node, size_t hops, TimeId instant) {
+	NodeId node_id = sweep->graph->ids[node];
+	sweep->hops[node] = hops;
+	if (sweep->latest != NULL) {
+		if (sweep->latest->latest_departures[node_id] == PATHS_UNREACHABLE) {
+			sweep->latest->latest_departures[node_id] = instant;
+		}
+	}
+	else {
+		if (sweep->paths->earliest_arrivals[node_id] == PATHS_UNREACHABLE) {
+			sweep->paths->earliest_arrivals[node_id] = instant;
+		}
+		if (hops < sweep->paths->shortest_lengths[node_id]) {
+			sweep->paths->shortest_lengths[node_id] = hops;
+		}
+	}
+	PathsSweep_push(sweep, node);
+}
+
+// A path which left the source at departure waits on the node from the instant
+static void reach_with_departure(PathsSweep* sweep, size_t node, TimeId departure, TimeId instant) {
+	NodeId node_id = sweep->graph->ids[node];
+	sweep->departures[node] = departure;
+	size_t duration = departure == LEAVING_NOW ? 0 : instant - departure;
+	if (duration < sweep->paths->fastest_durations[node_id]) {
+		sweep->paths->fastest_durations[node_id] = duration;
+	}
+	if (departure == LEAVING_NOW && !sweep->listed[node]) {
+		sweep->listed[node] = true;
+		sweep->connected[sweep->nb_connected++] = node;
+	}
+	PathsSweep_push(sweep, node);
+}
+
+static void relax(PathsSweep* sweep, size_t from, size_t to, TimeId instant) {
+	if (sweep->latest != NULL) {
+		if (sweep->hops[from] != NO_HOPS && sweep->hops[to] == NO_HOPS) {
+			reach_with_hops(sweep, to, 0, instant);
+		}
+		return;
+	}
+	if (sweep->hops[from] != NO_HOPS && sweep->hops[from] + 1 < sweep->hops[to]) {
+		reach_with_hops(sweep, to, sweep->hops[from] + 1, instant);
+	}
+	if (departs_later(sweep->departures[from], sweep->departures[to])) {
+		reach_with_departure(sweep, to, sweep->departures[from], instant);
+	}
+}
+
+// Relaxes the links present at present_at of the queued nodes, until no label improves. The improvements are recorded
+// at the instant, which differs from present_at when sweeping backwards.
+static void propagate(PathsSweep* sweep, TimeId present_at, TimeId instant) {
+	const PathsGraph* graph = sweep->graph;
+	while (sweep->queue_size > 0) {
+		size_t node = PathsSweep_pop(sweep);
+		for (size_t e = graph->offsets[node]; e < graph->offsets[node + 1]; e++) {
+			if (is_present_at(graph->links_presence[graph->edges[e].link], present_at)) {
+				relax(sweep, node, graph->edges[e].node, instant);
+			}
+		}
+	}
+}
+
+// A node leaving now at an end of a link which disappears, from which a search starts if the nodes leaving now must be
+// split after the disappearances of the instant
+static void touch(PathsSweep* sweep, size_t node) {
+	if (!sweep->is_touched[node]) {
+		sweep->is_touched[node] = true;
+		sweep->touched[sweep->nb_touched++] = node;
+	}
+}
+
+static size_t PiecesSearch_find(PiecesSearch* pieces, size_t piece) {
+	while (pieces->parents[piece] != piece) {
+		pieces->parents[piece] = pieces->parents[pieces->parents[piece]];
+		piece = pieces->parents[piece];
+	}
+	return piece;
+}
+
+static bool is_in_piece(PathsSweep* sweep, size_t node, size_t piece) {
+	return sweep->stamps[node] == sweep->stamp &&
+		   PiecesSearch_find(&sweep->pieces, sweep->pieces.piece_of_node[node]) == piece;
+}
+
+// The nodes leaving now outside of the piece, NO_NODE for none, are cut off from the source, so they can only be
+// reached by leaving it before the instant, so up to it
+static void cut_off_from_source(PathsSweep* sweep, size_t piece, TimeId instant) {
+	size_t nb_kept = 0;
+	for (size_t i = 0; i < sweep->nb_connected; i++) {
+		size_t node = sweep->connected[i];
+		if (sweep->departures[node] == LEAVING_NOW && (piece == NO_NODE || !is_in_piece(sweep, node, piece))) {
+			sweep->departures[node] = instant;
+		}
+		if (sweep->departures[node] == LEAVING_NOW) {
+			sweep->connected[nb_kept++] = node;
+		}
+		else {
+			sweep->listed[node] = false;
+		}
+	}
+	sweep->nb_connected = nb_kept;
+}
+
+static void append_to_list(size_t* next, size_t* heads, size_t* tails, size_t list, size_t node) {
+	next[node] = NO_NODE;
+	if (heads[list] == NO_NODE) {
+		heads[list] = node;
+	}
+	else {
+		next[tails[list]] = node;
+	}
+	tails[list] = node;
+}
+
+static void concatenate_lists(size_t* next, size_t* heads, size_t* tails, size_t list, size_t other) {
+	if (heads[other] == NO_NODE) {
+		return;
+	}
+	if (heads[list] == NO_NODE) {
+		heads[list] = heads[other];
+	}
+	else {
+		next[tails[list]] = heads[other];
+	}
+	tails[list] = tails[other];
+}
+
+static void add_to_piece(PathsSweep* sweep, size_t piece, size_t node) {
+	PiecesSearch* pieces = &sweep->pieces;
+	sweep->stamps[node] = sweep->stamp;
+	pieces->piece_of_node[node] = piece;
+	append_to_list(pieces->next_frontier, pieces->frontier_heads, pieces->frontier_tails, piece, node);
+	append_to_list(pieces->next_found, pieces->found_heads, pieces->found_tails, piece, node);
+}
+
+static void start_search(PathsSweep* sweep, size_t piece, size_t node) {
+	PiecesSearch* pieces = &sweep->pieces;
+	pieces->parents[piece] = piece;
+	pieces->frontier_heads[piece] = NO_NODE;
+	pieces->found_heads[piece] = NO_NODE;
+	pieces->running_index[piece] = pieces->nb_running;
+	pieces->running[pieces->nb_running++] = piece;
+	add_to_piece(sweep, piece, node);
+}
+
+static void stop_search(PiecesSearch* pieces, size_t piece) {
+	size_t index = pieces->running_index[piece];
+	size_t last = pieces->running[--pieces->nb_running];
+	pieces->running[index] = last;
+	pieces->running_index[last] = index;
+}
+
+static void merge_searches(PiecesSearch* pieces, size_t piece, size_t other) {
+	pieces->parents[other] = piece;
+	concatenate_lists(pieces->next_frontier, pieces->frontier_heads, pieces->frontier_tails, piece, other);
+	concatenate_lists(pieces->next_found, pieces->found_heads, pieces->found_tails, piece, other);
+	stop_search(pieces, other);
+}
+
+static size_t pop_frontier(PiecesSearch* pieces, size_t piece) {
+	size_t node = pieces->frontier_heads[piece];
+	if (node != NO_NODE) {
+		pieces->frontier_heads[piece] = pieces->next_frontier[node];
+	}
+	return node;
+}
+
+// Returns whether the piece was the one of the source, in which case all the other pieces are cut off at once
+static bool cut_piece(PathsSweep* sweep, size_t piece, TimeId instant) {
+	if (is_in_piece(sweep, sweep->origin, piece)) {
+		cut_off_from_source(sweep, piece, instant);
+		return true;
+	}
+	PiecesSearch* pieces = &sweep->pieces;
+	for (size_t node = pieces->found_heads[piece]; node != NO_NODE; node = pieces->next_found[node]) {
+		if (sweep->departures[node] == LEAVING_NOW) {
+			sweep->departures[node] = instant;
+		}
+	}
+	return false;
+}
+
+// Runs the searches from the seeds leaving now until a single one is left, and returns whether they all met. Without
+// cut, returns as soon as a search ends without meeting the others, otherwise cuts off the pieces found this way.
+static bool search_pieces(PathsSweep* sweep, const size_t* seeds, size_t nb_seeds, TimeId instant, bool cut) {
+	const PathsGraph* graph = sweep->graph;
+	PiecesSearch* pieces = &sweep->pieces;
+	sweep->stamp++;
+	pieces->nb_running = 0;
+	for (size_t i = 0; i < nb_seeds; i++) {
+		if (sweep->departures[seeds[i]] == LEAVING_NOW && sweep->stamps[seeds[i]] != sweep->stamp) {
+			start_search(sweep, pieces->nb_running, seeds[i]);
+		}
+	}
+	bool all_met = true;
+	size_t turn = 0;
+	while (pieces->nb_running > 1) {
+		turn %= pieces->nb_running;
+		size_t piece = pieces->running[turn];
+		size_t node = pop_frontier(pieces, piece);
+		if (node == NO_NODE) {
+			if (!cut || cut_piece(sweep, piece, instant)) {
+				return false;
+			}
+			stop_search(pieces, piece);
+			all_met = false;
+			continue;
+		}
+		for (size_t e = graph->offsets[node]; e < graph->offsets[node + 1]; e++) {
+			size_t neighbour = graph->edges[e].node;
+			if (!is_present_at(graph->links_presence[graph->edges[e].link], instant)) {
+				continue;
+			}
+			if (sweep->stamps[neighbour] != sweep->stamp) {
+				add_to_piece(sweep, piece, neighbour);
+			}
+			else {
+				size_t other = PiecesSearch_find(pieces, pieces->piece_of_node[neighbour]);
+				if (other != piece) {
+					merge_searches(pieces, piece, other);
+				}
+			}
+		}
+		turn++;
+	}
+	return all_met;
+}
+
+// Links between nodes leaving now disappeared at the instant, and some of them were the only ones connecting pieces of
+// these nodes. Every piece cut off from the source has one of the touched nodes, and so does the piece of the source,
+// so searching from all of them at once finds the pieces cut off.
+static void split_connected(PathsSweep* sweep, TimeId instant) {
+	if (sweep->departures[sweep->origin] != LEAVING_NOW) {
+		cut_off_from_source(sweep, NO_NODE, instant);
+	}
+	else {
+		search_pieces(sweep, sweep->touched, sweep->nb_touched, instant, true);
+	}
+}
+
+static void untouch_all(PathsSweep* sweep) {
+	for (size_t i = 0; i < sweep->nb_touched; i++) {
+		sweep->is_touched[sweep->touched[i]] = false;
+	}
+	sweep->nb_touched = 0;
+}
+
+// Applies the events after the start one instant at a time : first the disappearances, which drop the paths waiting
+// on the nodes leaving, then the appearances, whose links are relaxed, and the improvements are propagated.
+static void sweep_forward(PathsSweep* sweep, TimeId start) {
+	const PathsGraph* graph = sweep->graph;
+	size_t source = sweep->origin;
+	if (is_present_at(graph->nodes_presence[source], start)) {
+		reach_with_hops(sweep, source, 0, start);
+		reach_with_departure(sweep, source, LEAVING_NOW, start);
+		propagate(sweep, start, start);
+	}
+
+	// The events at the start are already accounted for by the presences at it
+	const TimelineEvent* events = graph->timeline.events;
+	size_t nb_events = graph->timeline.nb_events;
+	size_t i = nb_events_until(&graph->timeline, start);
+	while (i < nb_events) {
+		TimeId instant = events[i].instant;
+		bool split = false;
+		for (; i < nb_events && events[i].instant == instant && !TimelineEvent_is_appearance(events[i]); i++) {
+			if (TimelineEvent_is_node(events[i])) {
+				size_t node = graph->index_of_node[events[i].id];
+				split |= sweep->departures[node] == LEAVING_NOW;
+				sweep->hops[node] = NO_HOPS;
+				sweep->departures[node] = NO_DEPARTURE;
+			}
+			else {
+				const size_t* nodes = &graph->links_nodes[2 * events[i].id];
+				if (sweep->departures[nodes[0]] == LEAVING_NOW && sweep->departures[nodes[1]] == LEAVING_NOW) {
+					touch(sweep, nodes[0]);
+					touch(sweep, nodes[1]);
+					// If the ends of every link disappearing are still connected, so are all the nodes leaving now.
+					// Most links are not bridges, so the searches from their two ends meet quickly.
+					split = split || !search_pieces(sweep, nodes, 2, instant, false);
+				}
+			}
+		}
+		if (split) {
+			split_connected(sweep, instant);
+		}
+		untouch_all(sweep);
+		for (; i < nb_events && events[i].instant == instant; i++) {
+			if (TimelineEvent_is_node(events[i])) {
+				// The source can be left again once it is back
+				if (graph->index_of_node[events[i].id] == source) {
+					reach_with_departure(sweep, source, LEAVING_NOW, instant);
+				}
+			}
+			else {
+				const size_t* nodes = &graph->links_nodes[2 * events[i].id];
+				relax(sweep, nodes[0], nodes[1], instant);
+				relax(sweep, nodes[1], nodes[0], instant);
+			}
+		}
+		propagate(sweep, instant, instant);
+	}
+}
+
+// Goes back in time from the deadline, one instant at a time. Just before an instant, the nodes appearing at it are
+// absent, so they cannot wait anymore, and the links disappearing at it are present, so they are relaxed. A node
+// reached there can leave up to the instant.
+static void sweep_backward(PathsSweep* sweep, TimeId deadline) {
+	const PathsGraph* graph = sweep->graph;
+	size_t target = sweep->origin;
+	if (is_present_at(graph->nodes_presence[target], deadline)) {
+		reach_with_hops(sweep, target, 0, deadline);
+		propagate(sweep, deadline, deadline);
+	}
+
+	const TimelineEvent* events = graph->timeline.events;
+	size_t i = nb_events_until(&graph->timeline, deadline);
+	while (i > 0) {
+		TimeId instant = events[i - 1].instant;
+		size_t end = i;
+		for (; i > 0 && events[i - 1].instant == instant; i--) {
+			if (events[i - 1].kind == NODE_APPEARANCE) {
+				sweep->hops[graph->index_of_node[events[i - 1].id]] = NO_HOPS;
+			}
+		}
+		for (size_t j = i; j < end; j++) {
+			if (events[j].kind == LINK_DISAPPEARANCE) {
+				const size_t* nodes = &graph->links_nodes[2 * events[j].id];
+				relax(sweep, nodes[0], nodes[1], instant);
+				relax(sweep, nodes[1], nodes[0], instant);
+			}
+		}
+		// Nothing is present before the first instant, which is also the only one which can be 0
+		if (instant > 0) {
+			propagate(sweep, instant - 1, instant);
+		}
+	}
+}
+
+static size_t* unreachable_array(size_t nb_node_ids) {
+	size_t* array = MALLOC((nb_node_ids + 1) * sizeof(size_t));
+	for (size_t i = 0; i < nb_node_ids; i++) {
+		array[i] = PATHS_UNREACHABLE;
+	}
+	return array;
+}
+
+static TemporalPaths TemporalPaths_unreachable(const PathsGraph* graph, NodeId source, TimeId start) {
+	return (TemporalPaths){
+		.source = source,
+		.start = start,
+		.nb_node_ids = graph->nb_node_ids,
+		.earliest_arrivals = unreachable_array(graph->nb_node_ids),
+		.shortest_lengths = unreachable_array(graph->nb_node_ids),
+		.fastest_durations = unreachable_array(graph->nb_node_ids),
+	};
+}
+
+static bool is_node_of(const PathsGraph* graph, NodeId node_id) {
+	return node_id < graph->nb_node_ids && graph->index_of_node[node_id] != NO_NODE;
+}
+
+static TemporalPaths paths_from(PathsSweep* sweep, NodeId source, TimeId start) {
+	TemporalPaths paths = TemporalPaths_unreachable(sweep->graph, source, start);
+	if (is_node_of(sweep->graph, source)) {
+		PathsSweep_reset(sweep, sweep->graph->index_of_node[source]);
+		sweep->paths = &paths;
+		sweep->latest = NULL;
+		sweep_forward(sweep, start);
+	}
+	return paths;
+}
+
+TemporalPaths Stream_temporal_paths_from(Stream* stream, NodeId source, TimeId start) {
+	INSTRUMENT_METRIC(stream, temporal_paths_from);
+	PathsGraph graph = PathsGraph_from(stream);
+	PathsSweep sweep = PathsSweep_new(&graph);
+	TemporalPaths paths = paths_from(&sweep, source, start);
+	PathsSweep_destroy(sweep);
+	PathsGraph_destroy(graph);
+	return paths;
+}
+
+void TemporalPaths_destroy(TemporalPaths paths) {
+	free(paths.earliest_arrivals);
+	free(paths.shortest_lengths);
+	free(paths.fastest_durations);
+}
+
+LatestDepartures Stream_latest_departures_to(Stream* stream, NodeId target, TimeId deadline) {
+	INSTRUMENT_METRIC(stream, latest_departures_to);
+	PathsGraph graph = PathsGraph_from(stream);
+	LatestDepartures departures = {
+		.target = target,
+		.deadline = deadline,
+		.nb_node_ids = graph.nb_node_ids,
+		.latest_departures = unreachable_array(graph.nb_node_ids),
+	};
+	if (is_node_of(&graph, target)) {
+		PathsSweep sweep = PathsSweep_new(&graph);
+		PathsSweep_reset(&sweep, graph.index_of_node[target]);
+		sweep.latest = &departures;
+		sweep_backward(&sweep, deadline);
+		PathsSweep_destroy(sweep);
+	}
+	PathsGraph_destroy(graph);
+	return departures;
+}
+
+void LatestDepartures_destroy(LatestDepartures departures) {
+	free(departures.latest_departures);
+}
+
+typedef struct {
+	const PathsGraph* graph;
+	TimeId start;
+	TemporalPathsCallback callback;
+	void* data;
+} AllSourcesContext;
+
+// Each worker reuses the labels of its sweep for the sources of its range, and frees their paths after the callback
+static void sweep_sources(void* context, size_t chunk_index, size_t from, size_t to) {
+	(void)chunk_index;
+	AllSourcesContext* all_sources = (AllSourcesContext*)context;
+	PathsSweep sweep = PathsSweep_new(all_sources->graph);
+	for (size_t i = from; i < to; i++) {
+		TemporalPaths paths = paths_from(&sweep, all_sources->graph->ids[i], all_sources->start);
+		all_sources->callback(&paths, all_sources->data);
+		TemporalPaths_destroy(paths);
+	}
+	PathsSweep_destroy(sweep);
+}
+
+void Stream_temporal_paths_from_all_nodes(Stream* stream, TimeId start, TemporalPathsCallback callback, void* data) {
+	INSTRUMENT_METRIC(stream, temporal_paths_from_all_nodes);
+	PathsGraph graph = PathsGraph_from(stream);
+	AllSourcesContext context = {.graph = &graph, .start = start, .callback = callback, .data = data};
+	// A sweep goes through every event, so the sources are handed to the workers one by one
+	ThreadPool_parallel_for(ThreadPool_global(), graph.nb_nodes, 1, sweep_sources, &context);
+	PathsGraph_destroy(graph);
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+#ifndef PATHS_H
+#define PATHS_H
+
+/**
+ * @file paths.h
+ * @brief Time-respecting paths in a Stream : earliest arrivals, latest departures, shortest and fastest paths.
+ *
+ * As defined in the paper, a path from (α, u) to (ω, v) is a sequence of links (t_0, u_0, v_0), ..., (t_k, u_k, v_k)
+ * with u_0 = u, v_k = v, v_i = u_{i+1} and α <= t_0 <= ... <= t_k <= ω, each link present at the instant it is
+ * traversed, and each node present while the path waits on it, from α for u and until ω for v. Traversing a link
+ * takes no time, so several links can be traversed at the same instant. The length of a path is its number of links,
+ * and its duration is t_k - t_0.
+ * <br>
+ * The paths are found by sweeping the Timeline of the Stream once per source, see timeline.h. Between two events, the
+ * nodes and links present do not change, so the nodes reachable are the ones connected to a reached node by the links
+ * present, and a node stays reached as long as it is present. Each node keeps the fewest links and the latest
+ * departure from the source among the paths currently waiting on it, which only change at the events. Only the nodes
+ * whose labels improve at an event are relaxed, by checking which of their links are present with a binary search in
+ * their presence intervals.
+ * <br>
+ * The graph of the links and the Timeline are built once and shared between the sources, so a sweep only uses O(V)
+ * memory on top of them, and the bulk version runs the sweeps of the different sources in parallel with the thread
+ * pool, see thread_pool.h.
+ * <br>
+ * The intervals being open on the right, a path can leave a node up to the end of the presence of a link, but not at
+ * it. The latest departures and the durations ending there are therefore bounds which are approached but not reached.
+ */
+
+#include "stream.h"
+#include "units.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief The value of the times, lengths and durations of the nodes no path reaches.
+ */
+#define PATHS_UNREACHABLE SIZE_MAX
+
+/**
+ * @brief The paths from a source node, starting at or after an instant.
+ *
+ * The arrays are indexed by node id, and hold PATHS_UNREACHABLE for the nodes no path reaches, including the ids which
+ * are not nodes of the Stream.
+ */
+typedef struct {
+	NodeId source;				/**< The node the paths start from. */
+	TimeId start;				/**< The instant α the paths start from. */
+	size_t nb_node_ids;			/**< The largest node id of the Stream plus one, the size of the arrays. */
+	TimeId* earliest_arrivals;	/**< The first instant each node is reached by a path from (α, source). */
+	size_t* shortest_lengths;	/**< The fewest links of a path from (α, source) to each node. */
+	size_t* fastest_durations;	/**< The smallest duration of a path from the source to each node, leaving it at or
+									 after α. Unlike the paths above, it may leave the source after it was absent. */
+} TemporalPaths;
+
+/**
+ * @brief The latest instants at which each node can be left to reach a target node before a deadline.
+ *
+ * The array is indexed by node id, and holds PATHS_UNREACHABLE for the nodes which cannot reach the target.
+ */
+typedef struct {
+	NodeId target;				/**< The node the paths go to. */
+	TimeId deadline;			/**< The instant ω the paths must arrive by. */
+	size_t nb_node_ids;			/**< The largest node id of the Stream plus one, the size of the array. */
+	TimeId* latest_departures;	/**< The latest instant a path from each node reaches (ω, target). */
+} LatestDepartures;
+
+/**
+ * @brief Called on the paths of each source by Stream_temporal_paths_from_all_nodes.
+ * @param[in] paths The paths from a source. They are freed after the call.
+ * @param[in] data The data passed to Stream_temporal_paths_from_all_nodes.
+ */
+typedef void (*TemporalPathsCallback)(const TemporalPaths* paths, void* data);
+
+/**
+ * @brief The earliest arrivals, shortest and fastest paths from a node, found in one sweep of the events of the Stream
+ * from the instant start.
+ *
+ * Costs O(E log E) to build the Timeline and the graph of the links, then O(E + Σ relaxations · log I) for the sweep,
+ * with E the number of events and I the number of presence intervals of a link. The fastest paths also check that the
+ * ends of a link between two nodes connected to the source are still connected when it disappears, with two searches
+ * which stop as soon as they meet, and only split the connected nodes into pieces when they are not.
+ * Must be freed with TemporalPaths_destroy.
+ * @param[in] stream The Stream.
+ * @param[in] source The node the paths start from.
+ * @param[in] start The instant the paths start from.
+ * @return The paths from the source.
+ */
+TemporalPaths Stream_temporal_paths_from(Stream* stream, NodeId source, TimeId start);
+
+/**
+ * @brief Frees the arrays of a TemporalPaths.
+ * @param[in] paths The TemporalPaths.
+ */
+void TemporalPaths_destroy(TemporalPaths paths);
+
+/**
+ * @brief The latest departures of every node to a target, found in one sweep of the events of the Stream backwards
+ * from the instant deadline.
+ *
+ * Same costs as Stream_temporal_paths_from. Must be freed with LatestDepartures_destroy.
+ * @param[in] stream The Stream.
+ * @param[in] target The node the paths go to.
+ * @param[in] deadline The instant the paths must arrive by.
+ * @return The latest departures to the target.
+ */
+LatestDepartures Stream_latest_departures_to(Stream* stream, NodeId target, TimeId deadline);
+
+/**
+ * @brief Frees the array of a LatestDepartures.
+ * @param[in] departures The LatestDepartures.
+ */
+void LatestDepartures_destroy(LatestDepartures departures);
+
+/**
+ * @brief Runs Stream_temporal_paths_from from every node of the Stream, in parallel with the thread pool.
+ *
+ * The Timeline and the graph of the links are only built once. Each worker only keeps the paths of the source it is
+ * sweeping, so the memory used is O(V) per worker, and the callback is called from the workers, in any order of the
+ * sources. It must therefore be safe to call from several threads at once.
+ * @param[in] stream The Stream.
+ * @param[in] start The instant the paths start from.
+ * @param[in] callback Called on the paths from each node.
+ * @param[in] data Passed to the callback.
+ */
+void Stream_temporal_paths_from_all_nodes(Stream* stream, TimeId start, TemporalPathsCallback callback, void* data);
+
+#endif // PATHS_H
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include "point_queries.h"
+#include "bit_array.h"
+#include "induced_graph.h"
+#include "instrumentation.h"
+#include "stream/full_stream_graph.h"
+#include "stream/link_stream.h"
+#include "stream_functions.h"
+#include "utils.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// A query, and its position in the array given, so that the answers can be written back in that order once the queries
+// are sorted
+typedef struct {
+	size_t id;
+	TimeId instant;
+	size_t index;
+} SortedQuery;
+
+static int SortedQuery_compare(const void* a, const void* b) {
+	const SortedQuery* query_a = (const SortedQuery*)a;
+	const SortedQuery* query_b = (const SortedQuery*)b;
+	if (query_a->id != query_b->id) {
+		return query_a->id < query_b->id ? -1 : 1;
+	}
+	if (query_a->instant != query_b->instant) {
+		return query_a->instant < query_b->instant ? -1 : 1;
+	}
+	return (query_a->index > query_b->index) - (query_a->index < query_b->index);
+}
+
+// The queries are sorted by element, then by instant, so that the intervals of each element are read once, forward,
+// along with its queries
+static void answer_presence_queries(Stream* stream, bool of_nodes, const PresenceQuery* queries, size_t nb_queries,
+									bool* answers) {
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	SortedQuery* sorted = MALLOC((nb_queries + 1) * sizeof(SortedQuery));
+	for (size_t i = 0; i < nb_queries; i++) {
+		sorted[i] = (SortedQuery){.id = queries[i].id, .instant = queries[i].instant, .index = i};
+	}
+	qsort(sorted, nb_queries, sizeof(SortedQuery), SortedQuery_compare);
+
+	size_t i = 0;
+	while (i < nb_queries) {
+		size_t id = sorted[i].id;
+		TimesIterator times = of_nodes ? stream_functions->times_node_present(stream->stream, id)
+									   : stream_functions->times_link_present(stream->stream, id);
+		Interval interval = times.next(&times);
+		for (; i < nb_queries && sorted[i].id == id; i++) {
+			// The intervals are sorted, and open on the right
+			while (interval.start != SIZE_MAX && interval.end <= sorted[i].instant) {
+				interval = times.next(&times);
+			}
+			answers[sorted[i].index] = interval.start != SIZE_MAX && interval.start <= sorted[i].instant;
+		}
+		times.destroy(&times);
+	}
+	free(sorted);
+}
+
+void Stream_are_nodes_present(Stream* stream, const PresenceQuery* queries, size_t nb_queries, bool* answers) {
+	INSTRUMENT_METRIC(stream, are_nodes_present);
+	answer_presence_queries(stream, true, queries, nb_queries, answers);
+}
+
+void Stream_are_links_present(Stream* stream, const PresenceQuery* queries, size_t nb_queries, bool* answers) {
+	INSTRUMENT_METRIC(stream, are_links_present);
+	answer_presence_queries(stream, false, queries, nb_queries, answers);
+}
+
+// The position of the first of the sorted instants which is at least instant, or nb_instants if there are none
+static size_t first_instant_from(const SortedQuery* sorted, size_t nb_instants, TimeId instant) {
+	size_t low = 0;
+	size_t high = nb_instants;
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		if (sorted[middle].instant < instant) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+// Goes through the intervals of every link, and the sorted instants each of them contains. The first pass only counts
+// the links present at the instant of the query i in ends[i + 1], so that the second one can write them from the
+// position ends[i] on, which it moves forward.
+static void place_links_present(Stream* stream, const SortedQuery* sorted, size_t nb_instants, size_t* ends,
+								LinkId* links) {
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	LinksIterator links_set = stream_functions->links_set(stream->stream);
+	FOR_EACH_LINK(link_id, links_set) {
+		TimesIterator times = stream_functions->times_link_present(stream->stream, link_id);
+		FOR_EACH_TIME(interval, times) {
+			size_t from = first_instant_from(sorted, nb_instants, interval.start);
+			for (size_t i = from; i < nb_instants && sorted[i].instant < interval.end; i++) {
+				if (links == NULL) {
+					ends[sorted[i].index + 1]++;
+				}
+				else {
+					links[ends[sorted[i].index]++] = link_id;
+				}
+			}
+		}
+	}
+}
+
+// The StreamGraph whose EventsTable gives the links present in the Stream, or NULL if it has none or it isn't built
+static StreamGraph* events_table_of(Stream* stream) {
+	StreamGraph* stream_graph = NULL;
+	if (stream->type == FULL_STREAM_GRAPH) {
+		stream_graph = ((FullStreamGraph*)stream->stream)->underlying_stream_graph;
+	}
+	else if (stream->type == LINK_STREAM) {
+		stream_graph = ((LinkStream*)stream->stream)->underlying_stream_graph;
+	}
+	if (stream_graph == NULL || stream_graph->events.link_events.events == NULL ||
+		stream_graph->events.nb_events == 0) {
+		return NULL;
+	}
+	return stream_graph;
+}
+
+// Same as place_links_present, but walks forward over the key moments along the sorted instants, and only reads the
+// links present from the EventsTable once per key moment reached. The links are the same from a key moment to the
+// next one, so the other instants in between copy the row of the first one.
+static void place_links_from_events(StreamGraph* stream_graph, const SortedQuery* sorted, size_t nb_instants,
+									size_t* ends, LinkId* links) {
+	const KeyMomentsTable* key_moments = &stream_graph->key_moments;
+	size_t slice = 0;
+	size_t position = 0;	// The next key moment in the slice
+	size_t nb_reached = 0;	// The number of key moments at or before the instant
+	size_t row_moment = 0;	// The nb_reached of the last row read, 0 if there is none yet
+	size_t row_start = 0;
+	size_t row_size = 0;
+	// The links read are marked in it, to write them in the order of their ids, which is the one of the links_set
+	BitArray read_links = links == NULL ? (BitArray){0} : BitArray_n_zeros(stream_graph->links.nb_links);
+	for (size_t i = 0; i < nb_instants; i++) {
+		while (slice < key_moments->nb_slices) {
+			if (position == key_moments->slices[slice].nb_moments) {
+				slice++;
+				position = 0;
+			}
+			else if (slice * SLICE_SIZE + key_moments->slices[slice].moments[position] <= sorted[i].instant) {
+				position++;
+				nb_reached++;
+			}
+			else {
+				break;
+			}
+		}
+		// Nothing is present before the first key moment
+		if (nb_reached == 0) {
+			continue;
+		}
+		size_t index = sorted[i].index;
+		if (nb_reached != row_moment) {
+			row_moment = nb_reached;
+			LinksIterator links_present = get_links_present_at_nth_key_moment(stream_graph, nb_reached - 1);
+			if (links == NULL) {
+				row_size = COUNT_ITERATOR(links_present);
+			}
+			else {
+				FOR_EACH_LINK(link_id, links_present) {
+					BitArray_set_one(read_links, link_id);
+				}
+				row_start = ends[index];
+				row_size = 0;
+				for (size_t link_id = BitArray_next_one(read_links, 0); link_id < read_links.nb_bits;
+					 link_id = BitArray_next_one(read_links, link_id + 1)) {
+					BitArray_set_zero(read_links, link_id);
+					links[row_start + row_size++] = link_id;
+				}
+			}
+		}
+		else if (links != NULL) {
+			memcpy(links + ends[index], links + row_start, row_size * sizeof(LinkId));
+		}
+		if (links == NULL) {
+			ends[index + 1] += row_size;
+		}
+		else {
+			ends[index] += row_size;
+		}
+	}
+	BitArray_destroy(read_links);
+}
+
+LinksAtInstants Stream_links_present_at_instants(Stream* stream, const TimeId* instants, size_t nb_instants) {
+	INSTRUMENT_METRIC(stream, links_present_at_instants);
+	SortedQuery* sorted = MALLOC((nb_instants + 1) * sizeof(SortedQuery));
+	for (size_t i = 0; i < nb_instants; i++) {
+		sorted[i] = (SortedQuery){.id = 0, .instant = instants[i], .index = i};
+	}
+	qsort(sorted, nb_instants, sizeof(SortedQuery), SortedQuery_compare);
+
+	LinksAtInstants result = {
+		.nb_instants = nb_instants,
+		.offsets = calloc(nb_instants + 1, sizeof(size_t)),
+		.links = NULL,
+	};
+	StreamGraph* stream_graph = events_table_of(stream);
+	if (stream_graph != NULL) {
+		place_links_from_events(stream_graph, sorted, nb_instants, result.offsets, NULL);
+	}
+	else {
+		place_links_present(stream, sorted, nb_instants, result.offsets, NULL);
+	}
+	for (size_t i = 0; i < nb_instants; i++) {
+		result.offsets[i + 1] += result.offsets[i];
+	}
+	result.links = MALLOC((result.offsets[nb_instants] + 1) * sizeof(LinkId));
+	size_t* ends = MALLOC((nb_instants + 1) * sizeof(size_t));
+	for (size_t i = 0; i <= nb_instants; i++) {
+		ends[i] = result.offsets[i];
+	}
+	if (stream_graph != NULL) {
+		place_links_from_events(stream_graph, sorted, nb_instants, ends, result.links);
+	}
+	else {
+		place_links_present(stream, sorted, nb_instants, ends, result.links);
+	}
+
+	free(ends);
+	free(sorted);
+	return result;
+}
+
+void LinksAtInstants_destroy(LinksAtInstants links_at_instants) {
+	free(links_at_instants.offsets);
+	free(links_at_instants.links);
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#ifndef POINT_QUERIES_H
+#define POINT_QUERIES_H
+
+/**
+ * @file point_queries.h
+ * @brief Whether nodes or links are present at instants, and which links are, for many queries at once.
+ *
+ * Answering each query on its own creates an iterator over the presence of its node or link, and reads it from the
+ * start, or rebuilds the set of links present at its instant. Instead, the queries about nodes or links are sorted by
+ * element, then by instant, so that the presence of each element queried is read once, forward, along with all its
+ * queries : the cost is O(Q log Q) for Q queries, plus the intervals of the elements queried. The sets of links present
+ * at many instants are read from the EventsTable of the StreamGraph when it is built (see init_events_table), walking
+ * its key moments forward along the sorted instants, so that the links present are only read once per key moment
+ * reached. Otherwise, they are found in a single pass over the presences of the links, with the instants sorted so that
+ * the ones an interval contains are found by a binary search, in O(I log Q + R) for I intervals and R links returned.
+ * Either way, the answers are written in the order of the queries given.
+ * <br>
+ * Since the presences are read through the StreamFunctions, the queries work on any type of Stream.
+ */
+
+#include "stream.h"
+#include "units.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Whether a node or a link is present at an instant.
+ */
+typedef struct {
+	size_t id;		/**< The id of the node or link. */
+	TimeId instant; /**< The instant. */
+} PresenceQuery;
+
+/**
+ * @brief Answers whether the node of each query is present at its instant.
+ * @param[in] stream The Stream.
+ * @param[in] queries The queries, in any order, about nodes of the Stream.
+ * @param[in] nb_queries The number of queries.
+ * @param[out] answers The answer of the query i is written to answers[i].
+ */
+void Stream_are_nodes_present(Stream* stream, const PresenceQuery* queries, size_t nb_queries, bool* answers);
+
+/**
+ * @brief Answers whether the link of each query is present at its instant.
+ * @param[in] stream The Stream.
+ * @param[in] queries The queries, in any order, about links of the Stream.
+ * @param[in] nb_queries The number of queries.
+ * @param[out] answers The answer of the query i is written to answers[i].
+ */
+void Stream_are_links_present(Stream* stream, const PresenceQuery* queries, size_t nb_queries, bool* answers);
+
+/**
+ * @brief The links present at several instants.
+ *
+ * Must be freed with LinksAtInstants_destroy.
+ */
+typedef struct {
+	size_t nb_instants; /**< The number of instants. */
+	size_t* offsets;	/**< The links present at the instant i are links[offsets[i]] to links[offsets[i + 1] - 1]. */
+	LinkId* links;		/**< The links present at every instant, one instant after the other, in the order of the
+							 links_set of the Stream within an instant. */
+} LinksAtInstants;
+
+/**
+ * @brief The links present at each of the instants.
+ *
+ * When the Stream is a FullStreamGraph or a LinkStream whose StreamGraph has its EventsTable built, the links present
+ * at each key moment reached are read from it, and the instants between the same two key moments share them.
+ * Otherwise, the presences of all the links are scanned. Either way, they are read twice, once to count the links
+ * present at each instant and once to write them, so that no more memory than the result is used.
+ * @param[in] stream The Stream.
+ * @param[in] instants The instants, in any order.
+ * @param[in] nb_instants The number of instants.
+ * @return The links present at each instant, in the order of the instants given.
+ */
+LinksAtInstants Stream_links_present_at_instants(Stream* stream, const TimeId* instants, size_t nb_instants);
+
+/**
+ * @brief Frees the arrays of a LinksAtInstants.
+ * @param[in] links_at_instants The LinksAtInstants.
+ */
+void LinksAtInstants_destroy(LinksAtInstants links_at_instants);
+
+#endif // POINT_QUERIES_H
\ No newline at end of file
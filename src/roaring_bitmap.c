@@ -0,0 +1,688 @@
+#include "roaring_bitmap.h"
+#include "utils.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WORD_SIZE		 64
+#define BITMAP_BYTES	 (ROARING_BITMAP_WORDS * sizeof(uint64_t))
+#define INITIAL_CAPACITY 4
+
+static size_t key_of(size_t value) {
+	return value >> ROARING_BLOCK_BITS;
+}
+
+static uint16_t low_of(size_t value) {
+	return (uint16_t)(value & (ROARING_BLOCK_SIZE - 1));
+}
+
+static size_t value_of(size_t key, uint32_t low) {
+	return (key << ROARING_BLOCK_BITS) | low;
+}
+
+/*
+ * Containers
+ */
+
+static RoaringContainer container_array(size_t key, uint32_t capacity) {
+	return (RoaringContainer){
+		.key = key,
+		.kind = ROARING_ARRAY,
+		.cardinality = 0,
+		.size = 0,
+		.capacity = capacity,
+		.values = MALLOC((capacity > 0 ? capacity : 1) * sizeof(uint16_t)),
+	};
+}
+
+static RoaringContainer container_runs(size_t key, uint32_t capacity) {
+	return (RoaringContainer){
+		.key = key,
+		.kind = ROARING_RUN,
+		.cardinality = 0,
+		.size = 0,
+		.capacity = capacity,
+		.runs = MALLOC(capacity * sizeof(RoaringRun)),
+	};
+}
+
+static RoaringContainer container_bitmap(size_t key) {
+	return (RoaringContainer){
+		.key = key,
+		.kind = ROARING_BITMAP,
+		.cardinality = 0,
+		.size = 0,
+		.capacity = 0,
+		.words = calloc(ROARING_BITMAP_WORDS, sizeof(uint64_t)),
+	};
+}
+
+// The three pointers of the union share the same memory, so any of them can be freed
+static void container_destroy(RoaringContainer container) {
+	free(container.values);
+}
+
+static size_t container_bytes(const RoaringContainer* container) {
+	switch (container->kind) {
+		case ROARING_ARRAY:
+			return container->capacity * sizeof(uint16_t);
+		case ROARING_BITMAP:
+			return BITMAP_BYTES;
+		case ROARING_RUN:
+			return container->capacity * sizeof(RoaringRun);
+	}
+	return 0;
+}
+
+static RoaringContainer container_copy(const RoaringContainer* container) {
+	RoaringContainer copy = *container;
+	size_t bytes = container->kind == ROARING_BITMAP ? BITMAP_BYTES
+													 : container->size * (container->kind == ROARING_ARRAY
+																			  ? sizeof(uint16_t)
+																			  : sizeof(RoaringRun));
+	copy.capacity = container->kind == ROARING_BITMAP ? 0 : container->size;
+	copy.values = MALLOC(bytes);
+	memcpy(copy.values, container->values, bytes);
+	return copy;
+}
+
+// The most compact kind of container for a block, runs only being chosen when they are strictly smaller
+static RoaringContainerKind best_kind(uint32_t cardinality, uint32_t nb_runs) {
+	size_t run_bytes = nb_runs * sizeof(RoaringRun);
+	size_t other_bytes =
+		cardinality <= ROARING_ARRAY_MAX_CARDINALITY ? cardinality * sizeof(uint16_t) : BITMAP_BYTES;
+	if (run_bytes < other_bytes) {
+		return ROARING_RUN;
+	}
+	return cardinality <= ROARING_ARRAY_MAX_CARDINALITY ? ROARING_ARRAY : ROARING_BITMAP;
+}
+
+// Index of the first value of an array container greater or equal to low
+static uint32_t array_lower_bound(const RoaringContainer* container, uint32_t low) {
+	uint32_t left = 0;
+	uint32_t right = container->size;
+	while (left < right) {
+		uint32_t middle = left + (right - left) / 2;
+		if (container->values[middle] < low) {
+			left = middle + 1;
+		}
+		else {
+			right = middle;
+		}
+	}
+	return left;
+}
+
+// Index of the first run of a run container ending at or after low
+static uint32_t runs_lower_bound(const RoaringContainer* container, uint32_t low) {
+	uint32_t left = 0;
+	uint32_t right = container->size;
+	while (left < right) {
+		uint32_t middle = left + (right - left) / 2;
+		if (container->runs[middle].last < low) {
+			left = middle + 1;
+		}
+		else {
+			right = middle;
+		}
+	}
+	return left;
+}
+
+// First set bit of a bitmap at or after low, ROARING_BLOCK_SIZE if there is none
+static uint32_t words_next(const uint64_t* words, uint32_t low) {
+	if (low >= ROARING_BLOCK_SIZE) {
+		return ROARING_BLOCK_SIZE;
+	}
+	size_t word_index = low / WORD_SIZE;
+	uint64_t word = words[word_index] & (~(uint64_t)0 << (low % WORD_SIZE));
+	while (word == 0) {
+		word_index++;
+		if (word_index == ROARING_BITMAP_WORDS) {
+			return ROARING_BLOCK_SIZE;
+		}
+		word = words[word_index];
+	}
+	return (uint32_t)(word_index * WORD_SIZE + __builtin_ctzll(word));
+}
+
+// First value of a container at or after low, ROARING_BLOCK_SIZE if there is none
+static uint32_t container_next(const RoaringContainer* container, uint32_t low) {
+	switch (container->kind) {
+		case ROARING_ARRAY: {
+			uint32_t index = array_lower_bound(container, low);
+			return index < container->size ? container->values[index] : ROARING_BLOCK_SIZE;
+		}
+		case ROARING_BITMAP:
+			return words_next(container->words, low);
+		case ROARING_RUN: {
+			uint32_t index = runs_lower_bound(container, low);
+			if (index == container->size) {
+				return ROARING_BLOCK_SIZE;
+			}
+			return container->runs[index].start > low ? container->runs[index].start : low;
+		}
+	}
+	return ROARING_BLOCK_SIZE;
+}
+
+static bool container_contains(const RoaringContainer* container, uint16_t low) {
+	return container_next(container, low) == low;
+}
+
+static void words_set_range(uint64_t* words, uint32_t start, uint32_t last) {
+	size_t first_word = start / WORD_SIZE;
+	size_t last_word = last / WORD_SIZE;
+	uint64_t first_mask = ~(uint64_t)0 << (start % WORD_SIZE);
+	uint64_t last_mask = ~(uint64_t)0 >> (WORD_SIZE - 1 - (last % WORD_SIZE));
+	if (first_word == last_word) {
+		words[first_word] |= first_mask & last_mask;
+		return;
+	}
+	words[first_word] |= first_mask;
+	for (size_t i = first_word + 1; i < last_word; i++) {
+		words[i] = ~(uint64_t)0;
+	}
+	words[last_word] |= last_mask;
+}
+
+// Writes the values of a container as a bitmap of ROARING_BITMAP_WORDS words
+static void container_to_words(const RoaringContainer* container, uint64_t* words) {
+	if (container->kind == ROARING_BITMAP) {
+		memcpy(words, container->words, BITMAP_BYTES);
+		return;
+	}
+	memset(words, 0, BITMAP_BYTES);
+	if (container->kind == ROARING_ARRAY) {
+		for (uint32_t i = 0; i < container->size; i++) {
+			words[container->values[i] / WORD_SIZE] |= (uint64_t)1 << (container->values[i] % WORD_SIZE);
+		}
+	}
+	else {
+		for (uint32_t i = 0; i < container->size; i++) {
+			words_set_range(words, container->runs[i].start, container->runs[i].last);
+		}
+	}
+}
+
+// A bit starts a run if it is set and the one before it is not
+static uint32_t words_nb_runs(const uint64_t* words) {
+	uint32_t nb_runs = 0;
+	uint64_t carry = 0;
+	for (size_t i = 0; i < ROARING_BITMAP_WORDS; i++) {
+		nb_runs += __builtin_popcountll(words[i] & ~((words[i] << 1) | carry));
+		carry = words[i] >> (WORD_SIZE - 1);
+	}
+	return nb_runs;
+}
+
+static uint32_t words_cardinality(const uint64_t* words) {
+	uint32_t cardinality = 0;
+	for (size_t i = 0; i < ROARING_BITMAP_WORDS; i++) {
+		cardinality += __builtin_popcountll(words[i]);
+	}
+	return cardinality;
+}
+
+// Appends a value to a run container being built in increasing order, growing the last run if it is consecutive
+static void runs_append(RoaringContainer* container, uint16_t low) {
+	if (container->size > 0 && container->runs[container->size - 1].last + 1 == low) {
+		container->runs[container->size - 1].last = low;
+	}
+	else {
+		container->runs[container->size++] = (RoaringRun){.start = low, .last = low};
+	}
+	container->cardinality++;
+}
+
+// Builds the container of the given kind from a bitmap. The capacity of array and run containers is exact.
+static RoaringContainer container_from_words(size_t key, const uint64_t* words, RoaringContainerKind kind,
+											 uint32_t cardinality, uint32_t nb_runs) {
+	RoaringContainer container;
+	switch (kind) {
+		case ROARING_BITMAP:
+			container = container_bitmap(key);
+			memcpy(container.words, words, BITMAP_BYTES);
+			container.cardinality = cardinality;
+			return container;
+		case ROARING_ARRAY:
+			container = container_array(key, cardinality);
+			break;
+		case ROARING_RUN:
+			container = container_runs(key, nb_runs);
+			break;
+	}
+	for (size_t i = 0; i < ROARING_BITMAP_WORDS; i++) {
+		uint64_t word = words[i];
+		while (word != 0) {
+			uint16_t low = (uint16_t)(i * WORD_SIZE + __builtin_ctzll(word));
+			word &= word - 1;
+			if (kind == ROARING_ARRAY) {
+				container.values[container.size++] = low;
+				container.cardinality++;
+			}
+			else {
+				runs_append(&container, low);
+			}
+		}
+	}
+	return container;
+}
+
+// Like container_from_words, but picks the most compact kind. runs_allowed is false to get an array or a bitmap.
+static RoaringContainer container_from_words_compact(size_t key, const uint64_t* words, bool runs_allowed) {
+	uint32_t cardinality = words_cardinality(words);
+	uint32_t nb_runs = words_nb_runs(words);
+	RoaringContainerKind kind = best_kind(cardinality, nb_runs);
+	if (kind == ROARING_RUN && !runs_allowed) {
+		kind = cardinality <= ROARING_ARRAY_MAX_CARDINALITY ? ROARING_ARRAY : ROARING_BITMAP;
+	}
+	return container_from_words(key, words, kind, cardinality, nb_runs);
+}
+
+static void container_convert(RoaringContainer* container, bool runs_allowed) {
+	uint64_t words[ROARING_BITMAP_WORDS];
+	container_to_words(container, words);
+	RoaringContainer converted = container_from_words_compact(container->key, words, runs_allowed);
+	container_destroy(*container);
+	*container = converted;
+}
+
+static void container_array_to_bitmap(RoaringContainer* container) {
+	RoaringContainer bitmap = container_bitmap(container->key);
+	container_to_words(container, bitmap.words);
+	bitmap.cardinality = container->cardinality;
+	container_destroy(*container);
+	*container = bitmap;
+}
+
+// Returns whether the value was added
+static bool container_add(RoaringContainer* container, uint16_t low) {
+	switch (container->kind) {
+		case ROARING_ARRAY: {
+			uint32_t index = array_lower_bound(container, low);
+			if (index < container->size && container->values[index] == low) {
+				return false;
+			}
+			if (container->size == ROARING_ARRAY_MAX_CARDINALITY) {
+				container_array_to_bitmap(container);
+				return container_add(container, low);
+			}
+			if (container->size == container->capacity) {
+				container->capacity = container->capacity * 2 > ROARING_ARRAY_MAX_CARDINALITY
+										  ? ROARING_ARRAY_MAX_CARDINALITY
+										  : container->capacity * 2;
+				container->values = realloc(container->values, container->capacity * sizeof(uint16_t));
+			}
+			memmove(&container->values[index + 1], &container->values[index],
+					(container->size - index) * sizeof(uint16_t));
+			container->values[index] = low;
+			container->size++;
+			container->cardinality++;
+			return true;
+		}
+		case ROARING_BITMAP: {
+			uint64_t mask = (uint64_t)1 << (low % WORD_SIZE);
+			if ((container->words[low / WORD_SIZE] & mask) != 0) {
+				return false;
+			}
+			container->words[low / WORD_SIZE] |= mask;
+			container->cardinality++;
+			return true;
+		}
+		case ROARING_RUN:
+			// Runs are only built by RoaringBitmap_optimize and RoaringBitmap_from_values, adding to them goes back
+			// to an array or a bitmap
+			if (container_contains(container, low)) {
+				return false;
+			}
+			container_convert(container, false);
+			return container_add(container, low);
+	}
+	return false;
+}
+
+/*
+ * Bitmaps
+ */
+
+RoaringBitmap RoaringBitmap_empty(void) {
+	return (RoaringBitmap){.nb_containers = 0, .capacity = 0, .containers = NULL};
+}
+
+void RoaringBitmap_destroy(RoaringBitmap bitmap) {
+	for (size_t i = 0; i < bitmap.nb_containers; i++) {
+		container_destroy(bitmap.containers[i]);
+	}
+	free(bitmap.containers);
+}
+
+// Appends a container, which must have a greater key than the last one
+static void push_container(RoaringBitmap* bitmap, RoaringContainer container) {
+	if (bitmap->nb_containers == bitmap->capacity) {
+		bitmap->capacity = bitmap->capacity == 0 ? INITIAL_CAPACITY : bitmap->capacity * 2;
+		bitmap->containers = realloc(bitmap->containers, bitmap->capacity * sizeof(RoaringContainer));
+	}
+	bitmap->containers[bitmap->nb_containers++] = container;
+}
+
+// Index of the first container whose key is greater or equal to the given one
+static size_t containers_lower_bound(const RoaringBitmap* bitmap, size_t key) {
+	size_t left = 0;
+	size_t right = bitmap->nb_containers;
+	while (left < right) {
+		size_t middle = left + (right - left) / 2;
+		if (bitmap->containers[middle].key < key) {
+			left = middle + 1;
+		}
+		else {
+			right = middle;
+		}
+	}
+	return left;
+}
+
+static int compare_values(const void* a, const void* b) {
+	size_t value_a = *(const size_t*)a;
+	size_t value_b = *(const size_t*)b;
+	return (value_a > value_b) - (value_a < value_b);
+}
+
+RoaringBitmap RoaringBitmap_from_values(const size_t* values, size_t nb_values) {
+	RoaringBitmap bitmap = RoaringBitmap_empty();
+	if (nb_values == 0) {
+		return bitmap;
+	}
+	size_t* sorted = MALLOC(nb_values * sizeof(size_t));
+	memcpy(sorted, values, nb_values * sizeof(size_t));
+	qsort(sorted, nb_values, sizeof(size_t), compare_values);
+
+	size_t block_start = 0;
+	while (block_start < nb_values) {
+		size_t key = key_of(sorted[block_start]);
+		size_t block_end = block_start;
+		uint32_t cardinality = 0;
+		uint32_t nb_runs = 0;
+		// Count the distinct values and the runs of the block
+		for (; block_end < nb_values && key_of(sorted[block_end]) == key; block_end++) {
+			if (block_end > block_start && sorted[block_end] == sorted[block_end - 1]) {
+				continue;
+			}
+			if (cardinality == 0 || sorted[block_end] != sorted[block_end - 1] + 1) {
+				nb_runs++;
+			}
+			cardinality++;
+		}
+
+		RoaringContainerKind kind = best_kind(cardinality, nb_runs);
+		RoaringContainer container = kind == ROARING_ARRAY	 ? container_array(key, cardinality)
+									 : kind == ROARING_RUN ? container_runs(key, nb_runs)
+														   : container_bitmap(key);
+		for (size_t i = block_start; i < block_end; i++) {
+			if (i > block_start && sorted[i] == sorted[i - 1]) {
+				continue;
+			}
+			uint16_t low = low_of(sorted[i]);
+			switch (kind) {
+				case ROARING_ARRAY:
+					container.values[container.size++] = low;
+					container.cardinality++;
+					break;
+				case ROARING_BITMAP:
+					container.words[low / WORD_SIZE] |= (uint64_t)1 << (low % WORD_SIZE);
+					container.cardinality++;
+					break;
+				case ROARING_RUN:
+					runs_append(&container, low);
+					break;
+			}
+		}
+		push_container(&bitmap, container);
+		block_start = block_end;
+	}
+	free(sorted);
+	return bitmap;
+}
+
+void RoaringBitmap_add(RoaringBitmap* bitmap, size_t value) {
+	size_t key = key_of(value);
+	size_t index = containers_lower_bound(bitmap, key);
+	if (index == bitmap->nb_containers || bitmap->containers[index].key != key) {
+		push_container(bitmap, container_array(key, INITIAL_CAPACITY));
+		RoaringContainer new_container = bitmap->containers[bitmap->nb_containers - 1];
+		memmove(&bitmap->containers[index + 1], &bitmap->containers[index],
+				(bitmap->nb_containers - 1 - index) * sizeof(RoaringContainer));
+		bitmap->containers[index] = new_container;
+	}
+	container_add(&bitmap->containers[index], low_of(value));
+}
+
+bool RoaringBitmap_contains(const RoaringBitmap* bitmap, size_t value) {
+	size_t key = key_of(value);
+	size_t index = containers_lower_bound(bitmap, key);
+	if (index == bitmap->nb_containers || bitmap->containers[index].key != key) {
+		return false;
+	}
+	return container_contains(&bitmap->containers[index], low_of(value));
+}
+
+size_t RoaringBitmap_next(const RoaringBitmap* bitmap, size_t value) {
+	size_t key = key_of(value);
+	size_t index = containers_lower_bound(bitmap, key);
+	if (index < bitmap->nb_containers && bitmap->containers[index].key == key) {
+		uint32_t low = container_next(&bitmap->containers[index], low_of(value));
+		if (low < ROARING_BLOCK_SIZE) {
+			return value_of(key, low);
+		}
+		index++;
+	}
+	if (index == bitmap->nb_containers) {
+		return SIZE_MAX;
+	}
+	// The containers are never empty
+	return value_of(bitmap->containers[index].key, container_next(&bitmap->containers[index], 0));
+}
+
+size_t RoaringBitmap_cardinality(const RoaringBitmap* bitmap) {
+	size_t cardinality = 0;
+	for (size_t i = 0; i < bitmap->nb_containers; i++) {
+		cardinality += bitmap->containers[i].cardinality;
+	}
+	return cardinality;
+}
+
+size_t RoaringBitmap_memory_usage(const RoaringBitmap* bitmap) {
+	size_t bytes = sizeof(RoaringBitmap) + bitmap->capacity * sizeof(RoaringContainer);
+	for (size_t i = 0; i < bitmap->nb_containers; i++) {
+		bytes += container_bytes(&bitmap->containers[i]);
+	}
+	return bytes;
+}
+
+void RoaringBitmap_optimize(RoaringBitmap* bitmap) {
+	for (size_t i = 0; i < bitmap->nb_containers; i++) {
+		container_convert(&bitmap->containers[i], true);
+	}
+	if (bitmap->nb_containers < bitmap->capacity) {
+		bitmap->capacity = bitmap->nb_containers;
+		bitmap->containers = realloc(bitmap->containers, bitmap->capacity * sizeof(RoaringContainer));
+	}
+}
+
+/*
+ * Set operations
+ */
+
+typedef enum {
+	AND,
+	OR,
+	ANDNOT,
+} SetOperation;
+
+// Merges two array containers. Returns an empty container if the result is empty or does not fit in an array.
+static RoaringContainer arrays_merge(const RoaringContainer* container1, const RoaringContainer* container2,
+									 SetOperation operation) {
+	RoaringContainer result = container_array(container1->key, container1->size + container2->size);
+	uint32_t i = 0;
+	uint32_t j = 0;
+	while (i < container1->size || j < container2->size) {
+		uint32_t value1 = i < container1->size ? container1->values[i] : ROARING_BLOCK_SIZE;
+		uint32_t value2 = j < container2->size ? container2->values[j] : ROARING_BLOCK_SIZE;
+		bool keep = operation == OR || (operation == AND ? value1 == value2 : value1 < value2);
+		if (keep) {
+			result.values[result.size++] = (uint16_t)(value1 < value2 ? value1 : value2);
+		}
+		i += value1 <= value2;
+		j += value2 <= value1;
+		if (operation != OR && i == container1->size) {
+			break;
+		}
+	}
+	result.cardinality = result.size;
+	return result;
+}
+
+// Keeps the values of an array container which are (or are not) in another container
+static RoaringContainer array_filter(const RoaringContainer* array, const RoaringContainer* other, bool keep_present) {
+	RoaringContainer result = container_array(array->key, array->size);
+	for (uint32_t i = 0; i < array->size; i++) {
+		if (container_contains(other, array->values[i]) == keep_present) {
+			result.values[result.size++] = array->values[i];
+		}
+	}
+	result.cardinality = result.size;
+	return result;
+}
+
+static RoaringContainer containers_operation(const RoaringContainer* container1, const RoaringContainer* container2,
+											 SetOperation operation) {
+	bool array1 = container1->kind == ROARING_ARRAY;
+	bool array2 = container2->kind == ROARING_ARRAY;
+	if (array1 && array2 &&
+		(operation != OR || container1->size + container2->size <= ROARING_ARRAY_MAX_CARDINALITY)) {
+		return arrays_merge(container1, container2, operation);
+	}
+	if (operation == AND && (array1 || array2)) {
+		return array1 ? array_filter(container1, container2, true) : array_filter(container2, container1, true);
+	}
+	if (operation == ANDNOT && array1) {
+		return array_filter(container1, container2, false);
+	}
+
+	uint64_t words1[ROARING_BITMAP_WORDS];
+	uint64_t words2[ROARING_BITMAP_WORDS];
+	container_to_words(container1, words1);
+	container_to_words(container2, words2);
+	for (size_t i = 0; i < ROARING_BITMAP_WORDS; i++) {
+		switch (operation) {
+			case AND:
+				words1[i] &= words2[i];
+				break;
+			case OR:
+				words1[i] |= words2[i];
+				break;
+			case ANDNOT:
+				words1[i] &= ~words2[i];
+				break;
+		}
+	}
+	return container_from_words_compact(container1->key, words1, false);
+}
+
+static void push_or_destroy(RoaringBitmap* bitmap, RoaringContainer container) {
+	if (container.cardinality == 0) {
+		container_destroy(container);
+	}
+	else {
+		push_container(bitmap, container);
+	}
+}
+
+static RoaringBitmap bitmaps_operation(const RoaringBitmap* bitmap1, const RoaringBitmap* bitmap2,
+									   SetOperation operation) {
+	RoaringBitmap result = RoaringBitmap_empty();
+	size_t i = 0;
+	size_t j = 0;
+	while (i < bitmap1->nb_containers || j < bitmap2->nb_containers) {
+		const RoaringContainer* container1 = i < bitmap1->nb_containers ? &bitmap1->containers[i] : NULL;
+		const RoaringContainer* container2 = j < bitmap2->nb_containers ? &bitmap2->containers[j] : NULL;
+		if (container1 != NULL && container2 != NULL && container1->key == container2->key) {
+			push_or_destroy(&result, containers_operation(container1, container2, operation));
+			i++;
+			j++;
+		}
+		else if (container2 == NULL || (container1 != NULL && container1->key < container2->key)) {
+			if (operation != AND) {
+				push_container(&result, container_copy(container1));
+			}
+			i++;
+		}
+		else {
+			if (operation == OR) {
+				push_container(&result, container_copy(container2));
+			}
+			j++;
+		}
+	}
+	return result;
+}
+
+RoaringBitmap RoaringBitmap_and(const RoaringBitmap* bitmap1, const RoaringBitmap* bitmap2) {
+	return bitmaps_operation(bitmap1, bitmap2, AND);
+}
+
+RoaringBitmap RoaringBitmap_or(const RoaringBitmap* bitmap1, const RoaringBitmap* bitmap2) {
+	return bitmaps_operation(bitmap1, bitmap2, OR);
+}
+
+RoaringBitmap RoaringBitmap_andnot(const RoaringBitmap* bitmap1, const RoaringBitmap* bitmap2) {
+	return bitmaps_operation(bitmap1, bitmap2, ANDNOT);
+}
+
+/*
+ * Iteration
+ */
+
+RoaringIterator RoaringIterator_from(const RoaringBitmap* bitmap) {
+	return (RoaringIterator){.bitmap = bitmap, .container = 0, .index = 0, .low = 0};
+}
+
+size_t RoaringIterator_next(RoaringIterator* iterator) {
+	const RoaringBitmap* bitmap = iterator->bitmap;
+	while (iterator->container < bitmap->nb_containers) {
+		const RoaringContainer* container = &bitmap->containers[iterator->container];
+		switch (container->kind) {
+			case ROARING_ARRAY:
+				if (iterator->index < container->size) {
+					return value_of(container->key, container->values[iterator->index++]);
+				}
+				break;
+			case ROARING_BITMAP: {
+				uint32_t low = words_next(container->words, iterator->low);
+				if (low < ROARING_BLOCK_SIZE) {
+					iterator->low = low + 1;
+					return value_of(container->key, low);
+				}
+				break;
+			}
+			case ROARING_RUN:
+				while (iterator->index < container->size) {
+					RoaringRun run = container->runs[iterator->index];
+					if (iterator->low < run.start) {
+						iterator->low = run.start;
+					}
+					if (iterator->low <= run.last) {
+						return value_of(container->key, iterator->low++);
+					}
+					iterator->index++;
+				}
+				break;
+		}
+		iterator->container++;
+		iterator->index = 0;
+		iterator->low = 0;
+	}
+	return SIZE_MAX;
+}
\ No newline at end of file
@@ -0,0 +1,216 @@
+#ifndef ROARING_BITMAP_H
+#define ROARING_BITMAP_H
+
+/**
+ * @file roaring_bitmap.h
+ * @brief A compressed set of integers, whose memory scales with its content instead of with its largest value.
+ *
+ * Like Roaring bitmaps, the integers are split in blocks of 2^16 values sharing the same upper bits, and only the
+ * blocks containing at least one value are stored. Each block is kept in the most compact of three containers :
+ * - a sorted array of the lower 16 bits of its values, when it has at most ROARING_ARRAY_MAX_CARDINALITY values.
+ * - a bitmap of 2^16 bits, when it has more.
+ * - a sorted array of runs of consecutive values, when it is smaller than the two others. Runs are only chosen by
+ *   RoaringBitmap_optimize and RoaringBitmap_from_values, since adding values one at a time rarely creates them.
+ * <br>
+ * A set of a few thousand ids out of millions thus costs a few kilobytes, instead of a bit per possible id for a
+ * BitArray. The set operations work block by block, and skip the blocks absent from one of the operands.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define ROARING_BLOCK_BITS			  16						/**< The number of lower bits stored in a block. */
+#define ROARING_BLOCK_SIZE			  (1 << ROARING_BLOCK_BITS)	/**< The number of values of a block. */
+#define ROARING_BITMAP_WORDS		  (ROARING_BLOCK_SIZE / 64)	/**< The number of words of a bitmap block. */
+#define ROARING_ARRAY_MAX_CARDINALITY 4096						/**< Above this, an array is bigger than a bitmap. */
+
+/**
+ * @brief The kind of container of a block.
+ */
+typedef enum {
+	ROARING_ARRAY,
+	ROARING_BITMAP,
+	ROARING_RUN,
+} RoaringContainerKind;
+
+/**
+ * @brief A run of consecutive values of a block, from start to last included.
+ */
+typedef struct {
+	uint16_t start;	/**< The first value of the run. */
+	uint16_t last;	/**< The last value of the run. */
+} RoaringRun;
+
+/**
+ * @brief The values of a block, stored in one of the three kinds of containers.
+ */
+typedef struct {
+	size_t key;				   /**< The upper bits shared by the values of the block. */
+	RoaringContainerKind kind; /**< The kind of container. */
+	uint32_t cardinality;	   /**< The number of values in the block. */
+	uint32_t size;			   /**< The number of values of an array, or of runs of a run container. */
+	uint32_t capacity;		   /**< The number of values or runs allocated. */
+	union {
+		uint16_t* values; /**< The sorted values of an array container. */
+		uint64_t* words;  /**< The ROARING_BITMAP_WORDS words of a bitmap container. */
+		RoaringRun* runs; /**< The sorted runs of a run container. */
+	};
+} RoaringContainer;
+
+/**
+ * @brief A compressed set of integers.
+ */
+typedef struct {
+	size_t nb_containers;		  /**< The number of non-empty blocks. */
+	size_t capacity;			  /**< The number of containers allocated. */
+	RoaringContainer* containers; /**< The containers, sorted by key. */
+} RoaringBitmap;
+
+/**
+ * @name Creation and destruction functions
+ * @{
+ */
+
+/**
+ * @brief Creates an empty RoaringBitmap. It does not allocate any memory until a value is added.
+ *
+ * Any RoaringBitmap should be freed with RoaringBitmap_destroy.
+ */
+RoaringBitmap RoaringBitmap_empty(void);
+
+/**
+ * @brief Creates a RoaringBitmap containing the given values.
+ *
+ * The values may be unsorted and contain duplicates. The blocks are built directly in their most compact container,
+ * which is much faster than adding the values one by one.
+ * @param[in] values The values.
+ * @param[in] nb_values The number of values.
+ * @return The RoaringBitmap containing the values.
+ */
+RoaringBitmap RoaringBitmap_from_values(const size_t* values, size_t nb_values);
+
+/**
+ * @brief Frees the memory of a RoaringBitmap.
+ * @param[in] bitmap The RoaringBitmap.
+ */
+void RoaringBitmap_destroy(RoaringBitmap bitmap);
+
+/** @} */
+
+/**
+ * @name Values
+ * @{
+ */
+
+/**
+ * @brief Adds a value to a RoaringBitmap, if it was not already in it.
+ * @param[in, out] bitmap The RoaringBitmap.
+ * @param[in] value The value.
+ */
+void RoaringBitmap_add(RoaringBitmap* bitmap, size_t value);
+
+/**
+ * @brief Returns whether a value is in a RoaringBitmap.
+ *
+ * Costs a binary search over the blocks, and one in the block if it is an array or run container.
+ * @param[in] bitmap The RoaringBitmap.
+ * @param[in] value The value.
+ */
+bool RoaringBitmap_contains(const RoaringBitmap* bitmap, size_t value);
+
+/**
+ * @brief Returns the smallest value of a RoaringBitmap at or after the given one, or SIZE_MAX if there is none.
+ * @param[in] bitmap The RoaringBitmap.
+ * @param[in] value The value to start from.
+ */
+size_t RoaringBitmap_next(const RoaringBitmap* bitmap, size_t value);
+
+/**
+ * @brief Returns the number of values in a RoaringBitmap.
+ * @param[in] bitmap The RoaringBitmap.
+ */
+size_t RoaringBitmap_cardinality(const RoaringBitmap* bitmap);
+
+/**
+ * @brief Returns the number of bytes used by a RoaringBitmap, including its containers.
+ * @param[in] bitmap The RoaringBitmap.
+ */
+size_t RoaringBitmap_memory_usage(const RoaringBitmap* bitmap);
+
+/**
+ * @brief Converts every block to its most compact container, and frees the unused memory of the containers.
+ * @param[in, out] bitmap The RoaringBitmap.
+ */
+void RoaringBitmap_optimize(RoaringBitmap* bitmap);
+
+/** @} */
+
+/**
+ * @name Set operations
+ * They create a new RoaringBitmap, which must be freed with RoaringBitmap_destroy.
+ * @{
+ */
+
+/**
+ * @brief Returns the intersection of two RoaringBitmaps.
+ *
+ * Only the blocks present in both are compared. Two array containers are merged directly, the other pairs are
+ * compared word by word.
+ * @param[in] bitmap1 The first RoaringBitmap.
+ * @param[in] bitmap2 The second RoaringBitmap.
+ */
+RoaringBitmap RoaringBitmap_and(const RoaringBitmap* bitmap1, const RoaringBitmap* bitmap2);
+/** Like RoaringBitmap_and, but returns the union. */
+RoaringBitmap RoaringBitmap_or(const RoaringBitmap* bitmap1, const RoaringBitmap* bitmap2);
+/** Like RoaringBitmap_and, but returns the values of bitmap1 which are not in bitmap2. */
+RoaringBitmap RoaringBitmap_andnot(const RoaringBitmap* bitmap1, const RoaringBitmap* bitmap2);
+
+/** @} */
+
+/**
+ * @name Iteration
+ * @{
+ */
+
+/**
+ * @brief An iterator over the values of a RoaringBitmap, in increasing order.
+ *
+ * Unlike RoaringBitmap_next, which searches the blocks again at each call, it remembers its position, so a whole
+ * iteration costs O(number of values + number of bitmap words).
+ */
+typedef struct {
+	const RoaringBitmap* bitmap; /**< The RoaringBitmap iterated over. */
+	size_t container;			 /**< The index of the current container. */
+	size_t index;				 /**< The index of the next value of an array, or of the current run. */
+	uint32_t low;				 /**< The lower bits of the next value to look at in a bitmap or run container. */
+} RoaringIterator;
+
+/**
+ * @brief Returns an iterator at the first value of a RoaringBitmap.
+ * @param[in] bitmap The RoaringBitmap. It must not be modified during the iteration.
+ */
+RoaringIterator RoaringIterator_from(const RoaringBitmap* bitmap);
+
+/**
+ * @brief Returns the next value of the iteration, or SIZE_MAX once every value has been returned.
+ * @param[in, out] iterator The iterator.
+ */
+size_t RoaringIterator_next(RoaringIterator* iterator);
+
+/**
+ * @brief Loops over the values of a RoaringBitmap, in increasing order.
+ *
+ * The outer loop only declares the iterator, and runs once.
+ * @param[in] value The name of the value variable, declared by the macro.
+ * @param[in] roaring A pointer to the RoaringBitmap.
+ */
+#define ROARING_BITMAP_FOR_EACH(value, roaring)                                                                        \
+	for (RoaringIterator value##_iterator = RoaringIterator_from(roaring); value##_iterator.bitmap != NULL;            \
+		 value##_iterator.bitmap = NULL)                                                                               \
+		for (size_t value = RoaringIterator_next(&value##_iterator); (value) != SIZE_MAX;                              \
+			 (value) = RoaringIterator_next(&value##_iterator))
+
+/** @} */
+
+#endif // ROARING_BITMAP_H
\ No newline at end of file
@@ -0,0 +1,269 @@
+#include "sampling.h"
+#include "instrumentation.h"
+#include "iterators.h"
+#include "metrics.h"
+#include "stream_functions.h"
+#include "utils.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+// The number of samples drawn before the confidence interval is trusted to stop on the relative error
+#define MIN_SAMPLES 30
+
+// The number of samples between two checks of the duration and the relative error, which are costlier than a sample
+#define SAMPLES_PER_CHECK 64
+
+// The sums of the terms of the samples drawn, and the state of their random generator
+typedef struct {
+	SamplingBudget budget;
+	uint64_t state;
+	double start_seconds;
+	double z; // The quantile of the normal law for the confidence
+	size_t nb_samples;
+	double sum_a;
+	double sum_b;
+	double sum_aa;
+	double sum_ab;
+	double sum_bb;
+} Sampler;
+
+static double now_seconds(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+}
+
+// Solves P(|X| > z) = erfc(z / √2) = 1 - confidence for a standard normal X by bisection, erfc being decreasing
+static double normal_quantile(double confidence) {
+	double low = 0.0;
+	double high = 40.0;
+	for (size_t i = 0; i < 100; i++) {
+		double middle = (low + high) / 2;
+		if (erfc(middle / sqrt(2.0)) > 1.0 - confidence) {
+			low = middle;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return (low + high) / 2;
+}
+
+static Sampler Sampler_from(SamplingBudget budget) {
+	if (budget.max_samples == 0 && budget.max_seconds <= 0 && budget.relative_error <= 0) {
+		budget.max_samples = DEFAULT_NB_SAMPLES;
+	}
+	double confidence = budget.confidence > 0 ? budget.confidence : 0.95;
+	return (Sampler){
+		.budget = budget,
+		.state = budget.seed,
+		.start_seconds = now_seconds(),
+		.z = normal_quantile(confidence),
+	};
+}
+
+// SplitMix64, which gives good random numbers from any seed, including 0
+static uint64_t Sampler_next(Sampler* sampler) {
+	uint64_t x = (sampler->state += 0x9E3779B97F4A7C15);
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EB;
+	return x ^ (x >> 31);
+}
+
+// A random number in [0, n[, with a bias of at most n / 2^64 from the modulo
+static size_t Sampler_below(Sampler* sampler, size_t n) {
+	return (size_t)(Sampler_next(sampler) % n);
+}
+
+static void Sampler_add(Sampler* sampler, double a, double b) {
+	sampler->nb_samples++;
+	sampler->sum_a += a;
+	sampler->sum_b += b;
+	sampler->sum_aa += a * a;
+	sampler->sum_ab += a * b;
+	sampler->sum_bb += b * b;
+}
+
+// The ratio of the sums, and the half width of its confidence interval from the variance of the delta method
+static MetricEstimate Sampler_estimate(const Sampler* sampler) {
+	double n = (double)sampler->nb_samples;
+	// Without any denominator the ratio is undefined, as in the exact metrics
+	double ratio = sampler->sum_b == 0 ? NAN : sampler->sum_a / sampler->sum_b;
+	MetricEstimate estimate = {.value = ratio, .lower = ratio, .upper = ratio, .nb_samples = sampler->nb_samples};
+	if (sampler->nb_samples < 2 || sampler->sum_b == 0) {
+		return estimate;
+	}
+	// Σ (a_i - R b_i)², expanded to be computed from the sums
+	double residuals = sampler->sum_aa - 2 * ratio * sampler->sum_ab + ratio * ratio * sampler->sum_bb;
+	double mean_b = sampler->sum_b / n;
+	double variance = fmax(residuals, 0.0) / ((n - 1) * n * mean_b * mean_b);
+	double half_width = sampler->z * sqrt(variance);
+	estimate.lower = fmax(ratio - half_width, 0.0);
+	estimate.upper = ratio + half_width;
+	return estimate;
+}
+
+static bool Sampler_done(const Sampler* sampler) {
+	SamplingBudget budget = sampler->budget;
+	if (budget.max_samples != 0 && sampler->nb_samples >= budget.max_samples) {
+		return true;
+	}
+	if (sampler->nb_samples % SAMPLES_PER_CHECK != 0) {
+		return false;
+	}
+	if (budget.max_seconds > 0 && now_seconds() - sampler->start_seconds >= budget.max_seconds) {
+		return true;
+	}
+	if (budget.relative_error > 0 && sampler->nb_samples >= MIN_SAMPLES) {
+		// The relative error of an undefined ratio never shrinks, so the sampling stops instead of looping forever
+		MetricEstimate estimate = Sampler_estimate(sampler);
+		if (!isfinite(estimate.value)) {
+			return true;
+		}
+		if (estimate.upper - estimate.value <= budget.relative_error * estimate.value) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// The node ids of the Stream, to draw them in O(1)
+static NodeId* collect_nodes(const StreamFunctions* stream_functions, void* st, size_t* nb_nodes) {
+	NodesIterator nodes = stream_functions->nodes_set(st);
+	size_t count = COUNT_ITERATOR(nodes);
+	NodeId* ids = MALLOC((count + 1) * sizeof(NodeId));
+	size_t i = 0;
+	nodes = stream_functions->nodes_set(st);
+	FOR_EACH_NODE(node_id, nodes) {
+		ids[i++] = node_id;
+	}
+	*nb_nodes = count;
+	return ids;
+}
+
+// Draws two distinct nodes, uniformly among the pairs
+static void draw_pair(Sampler* sampler, const NodeId* ids, size_t nb_nodes, NodeId* u, NodeId* v) {
+	size_t i = Sampler_below(sampler, nb_nodes);
+	size_t j = Sampler_below(sampler, nb_nodes - 1);
+	j += j >= i;
+	*u = ids[i];
+	*v = ids[j];
+}
+
+static size_t time_of_node(const StreamFunctions* stream_functions, void* st, NodeId node_id) {
+	return total_time_of(stream_functions->times_node_present(st, node_id));
+}
+
+static size_t time_of_intersection(const StreamFunctions* stream_functions, void* st, NodeId u, NodeId v) {
+	TimesIterator times_u = stream_functions->times_node_present(st, u);
+	TimesIterator times_v = stream_functions->times_node_present(st, v);
+	return total_time_of(TimesIterator_intersection(times_u, times_v));
+}
+
+// The time of the link between u and v, searched among the neighbours of u, 0 if there is none
+static size_t time_of_link_between(const StreamFunctions* stream_functions, void* st, NodeId u, NodeId v) {
+	size_t time = 0;
+	LinksIterator neighbours = stream_functions->neighbours_of_node(st, u);
+	FOR_EACH_LINK(link_id, neighbours) {
+		Link link = stream_functions->nth_link(st, link_id);
+		if (link.nodes[0] == v || link.nodes[1] == v) {
+			time = total_time_of(stream_functions->times_link_present(st, link_id));
+		}
+	}
+	return time;
+}
+
+MetricEstimate Stream_uniformity_estimate(Stream* stream, SamplingBudget budget) {
+	INSTRUMENT_METRIC(stream, uniformity_estimate);
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	void* st = stream->stream;
+	Sampler sampler = Sampler_from(budget);
+	size_t nb_nodes;
+	NodeId* ids = collect_nodes(stream_functions, st, &nb_nodes);
+	while (nb_nodes >= 2 && !Sampler_done(&sampler)) {
+		NodeId u, v;
+		draw_pair(&sampler, ids, nb_nodes, &u, &v);
+		size_t intersection = time_of_intersection(stream_functions, st, u, v);
+		// |T_u ∪ T_v| = |T_u| + |T_v| - |T_u ∩ T_v|, cheaper than iterating the union
+		size_t union_time =
+			time_of_node(stream_functions, st, u) + time_of_node(stream_functions, st, v) - intersection;
+		Sampler_add(&sampler, (double)intersection, (double)union_time);
+	}
+	free(ids);
+	return Sampler_estimate(&sampler);
+}
+
+MetricEstimate Stream_density_estimate(Stream* stream, SamplingBudget budget) {
+	INSTRUMENT_METRIC(stream, density_estimate);
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	void* st = stream->stream;
+	Sampler sampler = Sampler_from(budget);
+	size_t nb_nodes;
+	NodeId* ids = collect_nodes(stream_functions, st, &nb_nodes);
+	while (nb_nodes >= 2 && !Sampler_done(&sampler)) {
+		NodeId u, v;
+		draw_pair(&sampler, ids, nb_nodes, &u, &v);
+		size_t intersection = time_of_intersection(stream_functions, st, u, v);
+		// A link is only present when both its nodes are, so its neighbours are not searched for disjoint nodes
+		size_t link_time = intersection == 0 ? 0 : time_of_link_between(stream_functions, st, u, v);
+		Sampler_add(&sampler, (double)link_time, (double)intersection);
+	}
+	free(ids);
+	return Sampler_estimate(&sampler);
+}
+
+MetricEstimate Stream_density_of_node_estimate(Stream* stream, NodeId node_id, SamplingBudget budget) {
+	INSTRUMENT_METRIC(stream, density_of_node_estimate);
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	void* st = stream->stream;
+	Sampler sampler = Sampler_from(budget);
+	size_t nb_nodes;
+	NodeId* ids = collect_nodes(stream_functions, st, &nb_nodes);
+	size_t links_time = 0;
+	LinksIterator neighbours = stream_functions->neighbours_of_node(st, node_id);
+	FOR_EACH_LINK(link_id, neighbours) {
+		links_time += total_time_of(stream_functions->times_link_present(st, link_id));
+	}
+	// The node itself is not one of the other nodes, but it may not be in the Stream
+	size_t nb_other_nodes = nb_nodes;
+	for (size_t i = 0; i < nb_nodes; i++) {
+		if (ids[i] == node_id) {
+			nb_other_nodes--;
+			break;
+		}
+	}
+	// The exact numerator is spread evenly over the other nodes, so the variance of the ratio is the one of the
+	// denominator alone
+	double links_time_per_node = nb_other_nodes == 0 ? 0.0 : (double)links_time / (double)nb_other_nodes;
+	while (nb_other_nodes >= 1 && !Sampler_done(&sampler)) {
+		NodeId other_node_id = ids[Sampler_below(&sampler, nb_nodes)];
+		if (other_node_id == node_id) {
+			continue;
+		}
+		size_t intersection = time_of_intersection(stream_functions, st, node_id, other_node_id);
+		Sampler_add(&sampler, links_time_per_node, (double)intersection);
+	}
+	free(ids);
+	return Sampler_estimate(&sampler);
+}
+
+MetricEstimate Stream_clustering_coeff_estimate(Stream* stream, SamplingBudget budget) {
+	INSTRUMENT_METRIC(stream, clustering_coeff_estimate);
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	void* st = stream->stream;
+	Sampler sampler = Sampler_from(budget);
+	size_t nb_nodes;
+	NodeId* ids = collect_nodes(stream_functions, st, &nb_nodes);
+	while (nb_nodes >= 1 && !Sampler_done(&sampler)) {
+		NodeId node_id = ids[Sampler_below(&sampler, nb_nodes)];
+		double node_time = (double)time_of_node(stream_functions, st, node_id);
+		double coeff = node_time == 0 ? 0.0 : Stream_clustering_coeff_of_node(stream, node_id);
+		Sampler_add(&sampler, node_time * coeff, node_time);
+	}
+	free(ids);
+	return Sampler_estimate(&sampler);
+}
\ No newline at end of file
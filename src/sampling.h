@@ -0,0 +1,93 @@
+#ifndef SAMPLING_H
+#define SAMPLING_H
+
+/**
+ * @file sampling.h
+ * @brief Estimates of metrics from uniform samples, with a confidence interval, for Streams too big to compute them.
+ *
+ * The metrics estimated are ratios of two sums over a set of elements, like the time pairs of nodes are both present
+ * over the time one of them is. Elements are drawn uniformly with replacement, and the ratio of the sums of the two
+ * terms over the samples estimates the ratio of the sums over all the elements. By the central limit theorem and the
+ * delta method, the error of this ratio R is close to a normal law of variance Σ(a_i - R b_i)² / (n (n - 1) b̄²) for
+ * n samples with terms a_i and b_i of mean b̄, from which the confidence interval is found.
+ * <br>
+ * The samples are drawn until the budget is spent : a number of samples, a duration, or a relative error reached by
+ * the confidence interval, whichever comes first. Each sample only reads the presences of a few nodes and links
+ * through the StreamFunctions, so the estimates work on any type of Stream.
+ * <br>
+ * The interval is only an approximation for few samples, or when the terms are very skewed, like the link times of
+ * a very sparse Stream, in which case most samples are 0.
+ */
+
+#include "stream.h"
+#include "units.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief When to stop drawing samples. The fields left to 0 are not limits.
+ *
+ * If no limit is set, DEFAULT_NB_SAMPLES samples are drawn.
+ */
+typedef struct {
+	size_t max_samples;	   /**< The number of samples after which the sampling stops. */
+	double max_seconds;	   /**< The duration after which the sampling stops. */
+	double relative_error; /**< The half width of the confidence interval over the estimate under which the sampling
+								stops, checked every few samples. */
+	double confidence;	   /**< The probability of the confidence interval to hold the exact value, 0.95 if 0. */
+	uint64_t seed;		   /**< The seed of the random samples, so that the estimates can be reproduced. */
+} SamplingBudget;
+
+/**
+ * @brief The number of samples drawn when the budget has no limit.
+ */
+#define DEFAULT_NB_SAMPLES 10000
+
+/**
+ * @brief An estimate of a metric and its confidence interval.
+ */
+typedef struct {
+	double value;	   /**< The estimate of the metric. */
+	double lower;	   /**< The lower bound of the confidence interval, at least 0 since the metrics are positive. */
+	double upper;	   /**< The upper bound of the confidence interval. */
+	size_t nb_samples; /**< The number of samples drawn. */
+} MetricEstimate;
+
+/**
+ * @brief Estimates Stream_uniformity from pairs of nodes, as Σ |T_u ∩ T_v| / Σ |T_u ∪ T_v| over the pairs drawn.
+ * @param[in] stream The Stream.
+ * @param[in] budget When to stop sampling.
+ */
+MetricEstimate Stream_uniformity_estimate(Stream* stream, SamplingBudget budget);
+
+/**
+ * @brief Estimates Stream_density from pairs of nodes, as Σ |T_uv| / Σ |T_u ∩ T_v| over the pairs drawn.
+ *
+ * The link between two nodes is searched in the neighbours of one of them.
+ * @param[in] stream The Stream.
+ * @param[in] budget When to stop sampling.
+ */
+MetricEstimate Stream_density_estimate(Stream* stream, SamplingBudget budget);
+
+/**
+ * @brief Estimates Stream_density_of_node from the other nodes u, whose time Σ |T_u ∩ T_v| shared with the node v is
+ * sampled.
+ *
+ * The time Σ |T_uv| of the links of the node is computed exactly from its neighbours, so only the denominator varies.
+ * @param[in] stream The Stream.
+ * @param[in] node_id The id of the node.
+ * @param[in] budget When to stop sampling.
+ */
+MetricEstimate Stream_density_of_node_estimate(Stream* stream, NodeId node_id, SamplingBudget budget);
+
+/**
+ * @brief Estimates Stream_clustering_coeff from nodes, as Σ |T_v| cc(v) / Σ |T_v| over the nodes v drawn.
+ *
+ * The clustering coefficient of a node drawn is computed exactly with Stream_clustering_coeff_of_node, which only goes
+ * through its neighbours and their links.
+ * @param[in] stream The Stream.
+ * @param[in] budget When to stop sampling.
+ */
+MetricEstimate Stream_clustering_coeff_estimate(Stream* stream, SamplingBudget budget);
+
+#endif // SAMPLING_H
\ No newline at end of file
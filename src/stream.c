@@ -1,11 +1,244 @@
 #include "stream.h"
+#include "utils.h"
 
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdlib.h>
+
+typedef struct {
+	CacheState state;
+	MemoValue value;
+	size_t nb_users;  // Number of acquisitions not released yet, the value can't be evicted while it is not 0
+	size_t last_used; // Value of the clock of the table the last time the value was acquired
+} MemoEntry;
+
+struct MemoTable {
+	pthread_mutex_t lock;
+	pthread_cond_t computed;
+	MemoEntry entries[MEMO_NB_KEYS];
+	size_t budget;
+	size_t usage;
+	size_t clock;
+};
 
 void init_cache(Stream* stream) {
-	stream->cache.cardinalOfW.present = false;
-	stream->cache.cardinalOfT.present = false;
-	stream->cache.cardinalOfE.present = false;
-	stream->cache.cardinalOfV.present = false;
+	atomic_init(&stream->cache.cardinalOfW.state, CACHE_EMPTY);
+	atomic_init(&stream->cache.cardinalOfT.state, CACHE_EMPTY);
+	atomic_init(&stream->cache.cardinalOfE.state, CACHE_EMPTY);
+	atomic_init(&stream->cache.cardinalOfV.state, CACHE_EMPTY);
+
+	MemoTable* memo = MALLOC(sizeof(MemoTable));
+	pthread_mutex_init(&memo->lock, NULL);
+	pthread_cond_init(&memo->computed, NULL);
+	for (size_t i = 0; i < MEMO_NB_KEYS; i++) {
+		memo->entries[i] = (MemoEntry){.state = CACHE_EMPTY, .value = {0, NULL}, .nb_users = 0, .last_used = 0};
+	}
+	memo->budget = MEMO_DEFAULT_BUDGET;
+	memo->usage = 0;
+	memo->clock = 0;
+	stream->cache.memo = memo;
+
+#ifdef SGA_INSTRUMENTATION
+	stream->cache.instrumentation = StreamInstrumentation_new();
+#else
+	stream->cache.instrumentation = NULL;
+#endif
+}
+
+void destroy_cache(Stream stream) {
+	StreamInstrumentation_destroy(stream.cache.instrumentation);
+	MemoTable* memo = stream.cache.memo;
+	if (memo == NULL) {
+		return;
+	}
+	for (size_t i = 0; i < MEMO_NB_KEYS; i++) {
+		free(memo->entries[i].value.values);
+	}
+	pthread_mutex_destroy(&memo->lock);
+	pthread_cond_destroy(&memo->computed);
+	free(memo);
+}
+
+static size_t MemoValue_memory(MemoValue value) {
+	return value.nb_values * sizeof(size_t);
+}
+
+void Stream_invalidate_cache(Stream* stream) {
+	atomic_store(&stream->cache.cardinalOfW.state, CACHE_EMPTY);
+	atomic_store(&stream->cache.cardinalOfT.state, CACHE_EMPTY);
+	atomic_store(&stream->cache.cardinalOfE.state, CACHE_EMPTY);
+	atomic_store(&stream->cache.cardinalOfV.state, CACHE_EMPTY);
+
+	MemoTable* memo = stream->cache.memo;
+	if (memo == NULL) {
+		return;
+	}
+	pthread_mutex_lock(&memo->lock);
+	for (size_t i = 0; i < MEMO_NB_KEYS; i++) {
+		MemoEntry* entry = &memo->entries[i];
+		if (entry->state != CACHE_READY) {
+			continue;
+		}
+		// The values in use no longer match their entry, so Stream_memo_release frees them
+		if (entry->nb_users == 0) {
+			free(entry->value.values);
+		}
+		memo->usage -= MemoValue_memory(entry->value);
+		*entry = (MemoEntry){.state = CACHE_EMPTY, .value = {0, NULL}, .nb_users = 0, .last_used = 0};
+	}
+	pthread_mutex_unlock(&memo->lock);
+}
+
+// Evicts the least recently used values which are not in use until the table can hold needed more bytes.
+// Must be called with the lock held.
+static void MemoTable_make_room(MemoTable* memo, size_t needed) {
+	while (memo->usage + needed > memo->budget) {
+		MemoEntry* least_recently_used = NULL;
+		for (size_t i = 0; i < MEMO_NB_KEYS; i++) {
+			MemoEntry* entry = &memo->entries[i];
+			if (entry->state == CACHE_READY && entry->nb_users == 0 &&
+				(least_recently_used == NULL || entry->last_used < least_recently_used->last_used)) {
+				least_recently_used = entry;
+			}
+		}
+		if (least_recently_used == NULL) {
+			return;
+		}
+		memo->usage -= MemoValue_memory(least_recently_used->value);
+		free(least_recently_used->value.values);
+		*least_recently_used = (MemoEntry){.state = CACHE_EMPTY, .value = {0, NULL}, .nb_users = 0, .last_used = 0};
+	}
+}
+
+MemoValue Stream_memo_acquire(Stream* stream, MemoKey key, MemoCompute compute) {
+	MemoTable* memo = stream->cache.memo;
+	if (memo == NULL) {
+		return compute(stream);
+	}
+	pthread_mutex_lock(&memo->lock);
+	MemoEntry* entry = &memo->entries[key];
+	while (entry->state == CACHE_COMPUTING) {
+		pthread_cond_wait(&memo->computed, &memo->lock);
+	}
+	INSTRUMENT_CACHE_ACCESS(stream->cache.instrumentation, entry->state == CACHE_READY);
+	if (entry->state == CACHE_READY) {
+		entry->nb_users++;
+		entry->last_used = ++memo->clock;
+		MemoValue value = entry->value;
+		pthread_mutex_unlock(&memo->lock);
+		return value;
+	}
+
+	// The value is computed without holding the lock, so that the other values stay available in the meantime
+	entry->state = CACHE_COMPUTING;
+	pthread_mutex_unlock(&memo->lock);
+	MemoValue value = compute(stream);
+	pthread_mutex_lock(&memo->lock);
+
+	size_t memory = MemoValue_memory(value);
+	MemoTable_make_room(memo, memory);
+	if (memo->usage + memory <= memo->budget) {
+		*entry = (MemoEntry){.state = CACHE_READY, .value = value, .nb_users = 1, .last_used = ++memo->clock};
+		memo->usage += memory;
+	}
+	else {
+		// Doesn't fit in the budget, the caller keeps it until it releases it
+		entry->state = CACHE_EMPTY;
+	}
+	pthread_cond_broadcast(&memo->computed);
+	pthread_mutex_unlock(&memo->lock);
+	return value;
+}
+
+bool Stream_memo_fetch(Stream* stream, MemoKey key, MemoValue* value) {
+	MemoTable* memo = stream->cache.memo;
+	if (memo == NULL) {
+		return false;
+	}
+	pthread_mutex_lock(&memo->lock);
+	MemoEntry* entry = &memo->entries[key];
+	bool found = entry->state == CACHE_READY;
+	INSTRUMENT_CACHE_ACCESS(stream->cache.instrumentation, found);
+	if (found) {
+		entry->nb_users++;
+		entry->last_used = ++memo->clock;
+		*value = entry->value;
+	}
+	pthread_mutex_unlock(&memo->lock);
+	return found;
+}
+
+void Stream_memo_release(Stream* stream, MemoKey key, MemoValue value) {
+	MemoTable* memo = stream->cache.memo;
+	if (memo == NULL) {
+		free(value.values);
+		return;
+	}
+	pthread_mutex_lock(&memo->lock);
+	MemoEntry* entry = &memo->entries[key];
+	if (entry->state == CACHE_READY && entry->value.values == value.values && entry->nb_users > 0) {
+		entry->nb_users--;
+	}
+	else {
+		free(value.values);
+	}
+	pthread_mutex_unlock(&memo->lock);
+}
+
+void Stream_set_memo_budget(Stream* stream, size_t budget) {
+	MemoTable* memo = stream->cache.memo;
+	if (memo == NULL) {
+		return;
+	}
+	pthread_mutex_lock(&memo->lock);
+	memo->budget = budget;
+	MemoTable_make_room(memo, 0);
+	pthread_mutex_unlock(&memo->lock);
+}
+
+size_t Stream_memo_usage(Stream* stream) {
+	MemoTable* memo = stream->cache.memo;
+	if (memo == NULL) {
+		return 0;
+	}
+	pthread_mutex_lock(&memo->lock);
+	size_t usage = memo->usage;
+	pthread_mutex_unlock(&memo->lock);
+	return usage;
+}
+
+StreamCounters Stream_counters(Stream* stream) {
+	return StreamInstrumentation_snapshot(stream->cache.instrumentation);
+}
+
+void Stream_reset_counters(Stream* stream) {
+	StreamInstrumentation_reset(stream->cache.instrumentation);
+}
+
+bool OptionalSizeT_fetch_or_claim(OptionalSizeT* optional, size_t* data) {
+	while (true) {
+		int state = atomic_load_explicit(&optional->state, memory_order_acquire);
+		if (state == CACHE_READY) {
+			*data = optional->data;
+			return true;
+		}
+		if (state == CACHE_EMPTY) {
+			int expected = CACHE_EMPTY;
+			if (atomic_compare_exchange_weak_explicit(&optional->state, &expected, CACHE_COMPUTING,
+													  memory_order_acquire, memory_order_relaxed)) {
+				return false;
+			}
+			continue;
+		}
+		// Another thread is computing the value, computing it again would only waste time
+		sched_yield();
+	}
+}
+
+void OptionalSizeT_publish(OptionalSizeT* optional, size_t data) {
+	optional->data = data;
+	atomic_store_explicit(&optional->state, CACHE_READY, memory_order_release);
 }
\ No newline at end of file
@@ -1,43 +1,235 @@
 #ifndef STREAM_H
 #define STREAM_H
 
+#include "instrumentation.h"
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stddef.h>
 
+/**
+ * @brief The state of a cached value.
+ */
+typedef enum {
+	CACHE_EMPTY,	 /**< Nobody computed the value yet. */
+	CACHE_COMPUTING, /**< A thread claimed the value and is computing it. */
+	CACHE_READY,	 /**< The value is published and can be read. */
+} CacheState;
+
+/**
+ * @brief A cached value, safe to share between threads.
+ *
+ * The first thread to need the value claims it by moving the state from CACHE_EMPTY to CACHE_COMPUTING, computes it,
+ * then publishes it by storing the data before moving the state to CACHE_READY with release ordering. The other
+ * threads either read it once ready, or wait for the one computing it, so that the value is only computed once.
+ */
 typedef struct {
-	bool present;
+	atomic_int state;
 	size_t data;
 } OptionalSizeT;
 
+/**
+ * @brief A table of derived values, computed lazily and shared by the metrics computed on the same Stream.
+ * Its content is private to stream.c.
+ */
+typedef struct MemoTable MemoTable;
+
 typedef struct {
 	OptionalSizeT cardinalOfW;
 	OptionalSizeT cardinalOfT;
 	OptionalSizeT cardinalOfE;
 	OptionalSizeT cardinalOfV;
+	MemoTable* memo; /**< Shared by every copy of the Stream. NULL if the Stream was not initialised with init_cache. */
+	StreamInstrumentation* instrumentation; /**< Shared by every copy of the Stream. NULL unless compiled with
+											   SGA_INSTRUMENTATION. */
 } InformationCache;
 
+/**
+ * @brief The functions to access a type of Stream, defined in stream_functions.h.
+ */
+typedef struct StreamFunctions StreamFunctions;
+
+/**
+ * @brief The specialised metrics of a type of Stream, defined in metrics.h.
+ */
+typedef struct MetricsFunctions MetricsFunctions;
+
 typedef struct {
 	enum {
 		FULL_STREAM_GRAPH,
 		LINK_STREAM,
 		CHUNK_STREAM,
 		CHUNK_STREAM_SMALL,
+		SUB_STREAM,
+		WINDOW_STREAM,
 	} type;
 	void* stream;
+	const StreamFunctions* stream_functions;   /**< The functions of its type, through which the metrics access it. */
+	const MetricsFunctions* metrics_functions; /**< The specialised metrics of its type. */
 	InformationCache cache;
 } Stream;
 
+/**
+ * @brief Initialises the cache of a Stream. Must be freed with destroy_cache, which the destroy functions of the
+ * Streams do.
+ * @param[in] stream The Stream.
+ */
 void init_cache(Stream* stream);
 
+/**
+ * @brief Frees the memo table of a Stream, and every value it holds.
+ * @param[in] stream The Stream.
+ */
+void destroy_cache(Stream stream);
+
+/**
+ * @brief Empties the cache of a Stream whose content changed, so that the cardinals and the values of the memo table
+ * are computed again when needed.
+ *
+ * The values of the memo table still in use are freed when they are released. Must not be called while metrics are
+ * being computed on the Stream.
+ * @param[in] stream The Stream.
+ */
+void Stream_invalidate_cache(Stream* stream);
+
+/**
+ * @brief Reads a cached value, or claims it for the calling thread if it is not computed yet.
+ *
+ * If another thread is computing the value, waits until it is published.
+ * @param[in] optional The cached value.
+ * @param[out] data Set to the value if it was ready.
+ * @return true if the value was ready, false if the calling thread claimed it and must publish it with
+ * OptionalSizeT_publish.
+ */
+bool OptionalSizeT_fetch_or_claim(OptionalSizeT* optional, size_t* data);
+
+/**
+ * @brief Publishes a value claimed with OptionalSizeT_fetch_or_claim, for the calling threads and the waiting ones.
+ * @param[in] optional The cached value.
+ * @param[in] data The value.
+ */
+void OptionalSizeT_publish(OptionalSizeT* optional, size_t data);
+
+/**
+ * @name Memo table
+ * Derived values that several metrics need, computed the first time one of them asks for it and kept until the Stream
+ * is destroyed, or until they are evicted to stay under the memory budget of the table. Evicting a value only frees
+ * memory, it is computed again if needed.
+ * @{
+ */
+
+/**
+ * @brief The values a memo table can hold. The arrays are indexed by node or link id, and hold 0 for the ids absent
+ * from the Stream.
+ */
+typedef enum {
+	MEMO_TIMES_NODE_PRESENT,			/**< Array : total presence time of each node. */
+	MEMO_TIMES_LINK_PRESENT,			/**< Array : total presence time of each link. */
+	MEMO_DEGREE_SUMS,					/**< Array : for each node, the sum of the presence times of its links. */
+	MEMO_SUM_PAIRS_OF_NODES,			/**< Scalar : Σ_t C(|V_t|, 2), the total time pairs of nodes coexist. */
+	MEMO_NODES_INTERSECTION_OF_LINKS,	/**< Array : for each link, the time both of its nodes are present. */
+	MEMO_WEDGES_TIMES,					/**< Array : for each node, the time its pairs of links are both present. */
+	MEMO_TRIANGLES_TIMES,				/**< Array : for each node, the time the links of its triangles are present. */
+	MEMO_NB_KEYS,
+} MemoKey;
+
+/**
+ * @brief A value of a memo table. Scalars are arrays of one value.
+ */
+typedef struct {
+	size_t nb_values;
+	size_t* values;
+} MemoValue;
+
+/**
+ * @brief Computes a value of the memo table of a Stream. The array must be allocated with malloc.
+ */
+typedef MemoValue (*MemoCompute)(Stream* stream);
+
+/**
+ * @brief The memory budget of a memo table when it is created, in bytes.
+ */
+#define MEMO_DEFAULT_BUDGET ((size_t)64 * 1024 * 1024)
+
+/**
+ * @brief Returns a value of the memo table of a Stream, computing it if needed.
+ *
+ * If several threads ask for the same value, it is only computed once. The value stays valid until it is released
+ * with Stream_memo_release, it can't be evicted before.
+ * @param[in] stream The Stream.
+ * @param[in] key The value to get.
+ * @param[in] compute The function to compute the value if it is not in the table.
+ * @return The value, which must not be modified.
+ */
+MemoValue Stream_memo_acquire(Stream* stream, MemoKey key, MemoCompute compute);
+
+/**
+ * @brief Like Stream_memo_acquire, but only returns the value if it is already in the table.
+ * @param[in] stream The Stream.
+ * @param[in] key The value to get.
+ * @param[out] value Set to the value if it is in the table.
+ * @return Whether the value was in the table. If so, it must be released with Stream_memo_release.
+ */
+bool Stream_memo_fetch(Stream* stream, MemoKey key, MemoValue* value);
+
+/**
+ * @brief Releases a value returned by Stream_memo_acquire or Stream_memo_fetch.
+ *
+ * If the value could not be kept in the table, because of the memory budget, it is freed.
+ * @param[in] stream The Stream.
+ * @param[in] key The key of the value.
+ * @param[in] value The value.
+ */
+void Stream_memo_release(Stream* stream, MemoKey key, MemoValue value);
+
+/**
+ * @brief Sets the memory budget of the memo table of a Stream, in bytes.
+ *
+ * The least recently used values are evicted until the table fits in the budget, except the ones in use.
+ * A budget of 0 disables the memo table.
+ * @param[in] stream The Stream.
+ * @param[in] budget The budget, in bytes.
+ */
+void Stream_set_memo_budget(Stream* stream, size_t budget);
+
+/**
+ * @brief Returns the memory used by the values of the memo table of a Stream, in bytes.
+ * @param[in] stream The Stream.
+ */
+size_t Stream_memo_usage(Stream* stream);
+/** @} */
+
+/**
+ * @name Instrumentation
+ * Counters of the work done on a Stream, see instrumentation.h. They are all 0 unless the library is compiled with
+ * SGA_INSTRUMENTATION.
+ * @{
+ */
+
+/**
+ * @brief Returns the counters of a Stream since it was created or since the last call to Stream_reset_counters.
+ * @param[in] stream The Stream.
+ */
+StreamCounters Stream_counters(Stream* stream);
+
+/**
+ * @brief Sets all the counters of a Stream back to 0.
+ * @param[in] stream The Stream.
+ */
+void Stream_reset_counters(Stream* stream);
+/** @} */
+
+// Once a cardinal is claimed, it must be published, so the functions using these macros should not return between
+// them, the computation can be moved to a separate function instead.
 #define FETCH_CACHE(stream, field)                                                                                     \
-	if ((stream)->cache.field.present) {                                                                               \
-		printf("Cache hit for %s\n", #field);                                                                          \
-		return (stream)->cache.field.data;                                                                             \
-	}                                                                                                                  \
-	printf("Cache miss for %s\n", #field);
-
-#define UPDATE_CACHE(stream, field, value)                                                                             \
-	(stream)->cache.field.present = true;                                                                              \
-	(stream)->cache.field.data = value;
+	{                                                                                                                  \
+		size_t cached_##field;                                                                                         \
+		bool hit_##field = OptionalSizeT_fetch_or_claim(&(stream)->cache.field, &cached_##field);                      \
+		INSTRUMENT_CACHE_ACCESS((stream)->cache.instrumentation, hit_##field);                                         \
+		if (hit_##field) {                                                                                             \
+			return cached_##field;                                                                                     \
+		}                                                                                                              \
+	}
+
+#define UPDATE_CACHE(stream, field, value) OptionalSizeT_publish(&(stream)->cache.field, value);
 
 #endif // STREAM_H
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "chunk_stream.h"
 #include "full_stream_graph.h"
+#include "../metrics_kernels.h"
 
 #include <stddef.h>
 #include <stdlib.h>
@@ -9,20 +10,23 @@ ChunkStream ChunkStream_from(StreamGraph* stream_graph, NodeIdVector* nodes, Lin
 	ChunkStream chunk_stream = (ChunkStream){
 		.underlying_stream_graph = stream_graph,
 		.snapshot = Interval_from(time_start, time_end),
-		.nodes_present = BitArray_n_zeros(stream_graph->nodes.nb_nodes),
-		.links_present = BitArray_n_zeros(stream_graph->links.nb_links),
+		.nodes_present = RoaringBitmap_from_values(nodes->array, nodes->size),
 	};
-	for (size_t i = 0; i < nodes->size; i++) {
-		BitArray_set_one(chunk_stream.nodes_present, nodes->array[i]);
-	}
+	// If the two nodes are not present in the chunk stream, then the link is not present
+	size_t nb_links_present = 0;
+	LinkId* links_present = MALLOC((links->size + 1) * sizeof(LinkId));
 	for (size_t i = 0; i < links->size; i++) {
-		// If the two nodes are not present in the chunk stream, then the link is not present
 		Link link = stream_graph->links.links[links->array[i]];
-		if (BitArray_is_one(chunk_stream.nodes_present, link.nodes[0]) &&
-			BitArray_is_one(chunk_stream.nodes_present, link.nodes[1])) {
-			BitArray_set_one(chunk_stream.links_present, links->array[i]);
+		if (RoaringBitmap_contains(&chunk_stream.nodes_present, link.nodes[0]) &&
+			RoaringBitmap_contains(&chunk_stream.nodes_present, link.nodes[1])) {
+			links_present[nb_links_present++] = links->array[i];
 		}
 	}
+	chunk_stream.links_present = RoaringBitmap_from_values(links_present, nb_links_present);
+	size_t nb_nodes_present = RoaringBitmap_cardinality(&chunk_stream.nodes_present);
+	chunk_stream.has_every_id = nb_nodes_present == stream_graph->nodes.nb_nodes &&
+								nb_links_present == stream_graph->links.nb_links;
+	free(links_present);
 	return chunk_stream;
 }
 
@@ -30,34 +34,31 @@ Stream CS_from(StreamGraph* stream_graph, NodeIdVector* nodes, LinkIdVector* lin
 			   size_t time_end) {
 	ChunkStream* chunk_stream = MALLOC(sizeof(ChunkStream));
 	*chunk_stream = ChunkStream_from(stream_graph, nodes, links, time_start, time_end);
-	Stream stream = {.type = CHUNK_STREAM, .stream = chunk_stream};
+	Stream stream = {
+		.type = CHUNK_STREAM,
+		.stream = chunk_stream,
+		.stream_functions = &ChunkStream_stream_functions,
+		.metrics_functions = &ChunkStream_metrics_functions,
+	};
 	init_cache(&stream);
 	return stream;
 }
 
 void CS_destroy(Stream stream) {
+	destroy_cache(stream);
 	ChunkStream* chunk_stream = (ChunkStream*)stream.stream;
-	BitArray_destroy(chunk_stream->nodes_present);
-	BitArray_destroy(chunk_stream->links_present);
+	RoaringBitmap_destroy(chunk_stream->nodes_present);
+	RoaringBitmap_destroy(chunk_stream->links_present);
 	free(chunk_stream);
 }
 
 typedef struct {
-	NodeId current_node;
+	RoaringIterator nodes;
 } NodesSetIteratorData;
 
 size_t CS_NodesSet_next(NodesIterator* iter) {
 	NodesSetIteratorData* nodes_iter_data = (NodesSetIteratorData*)iter->iterator_data;
-	ChunkStream* chunk_stream = (ChunkStream*)iter->stream_graph.stream;
-	if (nodes_iter_data->current_node >= chunk_stream->underlying_stream_graph->nodes.nb_nodes) {
-		return SIZE_MAX;
-	}
-	size_t return_val = BitArray_leading_zeros_from(chunk_stream->nodes_present, nodes_iter_data->current_node);
-	nodes_iter_data->current_node += return_val + 1;
-	if (nodes_iter_data->current_node > chunk_stream->underlying_stream_graph->nodes.nb_nodes) {
-		return SIZE_MAX;
-	}
-	return nodes_iter_data->current_node - 1;
+	return RoaringIterator_next(&nodes_iter_data->nodes);
 }
 
 void CS_NodesSetIterator_destroy(NodesIterator* iterator) {
@@ -66,7 +67,7 @@ void CS_NodesSetIterator_destroy(NodesIterator* iterator) {
 
 NodesIterator ChunkStream_nodes_set(ChunkStream* chunk_stream) {
 	NodesSetIteratorData* iterator_data = MALLOC(sizeof(NodesSetIteratorData));
-	iterator_data->current_node = 0;
+	iterator_data->nodes = RoaringIterator_from(&chunk_stream->nodes_present);
 	Stream stream = {.type = CHUNK_STREAM, .stream = chunk_stream};
 	NodesIterator nodes_iterator = {
 		.stream_graph = stream,
@@ -78,21 +79,12 @@ NodesIterator ChunkStream_nodes_set(ChunkStream* chunk_stream) {
 }
 
 typedef struct {
-	LinkId current_link;
+	RoaringIterator links;
 } CS_LinksSetIteratorData;
 
 size_t CS_LinksSet_next(LinksIterator* iter) {
 	CS_LinksSetIteratorData* links_iter_data = (CS_LinksSetIteratorData*)iter->iterator_data;
-	ChunkStream* chunk_stream = (ChunkStream*)iter->stream_graph.stream;
-	if (links_iter_data->current_link >= chunk_stream->underlying_stream_graph->links.nb_links) {
-		return SIZE_MAX;
-	}
-	size_t return_val = BitArray_leading_zeros_from(chunk_stream->links_present, links_iter_data->current_link);
-	links_iter_data->current_link += return_val + 1;
-	if (links_iter_data->current_link > chunk_stream->underlying_stream_graph->links.nb_links) {
-		return SIZE_MAX;
-	}
-	return links_iter_data->current_link - 1;
+	return RoaringIterator_next(&links_iter_data->links);
 }
 
 void CS_LinksSetIterator_destroy(LinksIterator* iterator) {
@@ -101,7 +93,7 @@ void CS_LinksSetIterator_destroy(LinksIterator* iterator) {
 
 LinksIterator ChunkStream_links_set(ChunkStream* chunk_stream) {
 	CS_LinksSetIteratorData* iterator_data = MALLOC(sizeof(CS_LinksSetIteratorData));
-	iterator_data->current_link = 0;
+	iterator_data->links = RoaringIterator_from(&chunk_stream->links_present);
 	Stream stream = {.type = CHUNK_STREAM, .stream = chunk_stream};
 	LinksIterator links_iterator = {
 		.stream_graph = stream,
@@ -143,7 +135,7 @@ size_t ChunkStream_NeighboursOfNode_next(LinksIterator* iter) {
 	size_t return_val =
 		chunk_stream->underlying_stream_graph->nodes.nodes[node].neighbours[neighbours_iter_data->current_neighbour];
 	neighbours_iter_data->current_neighbour++;
-	if (BitArray_is_zero(chunk_stream->links_present, return_val)) {
+	if (!RoaringBitmap_contains(&chunk_stream->links_present, return_val)) {
 		return ChunkStream_NeighboursOfNode_next(iter);
 	}
 	return return_val;
@@ -208,7 +200,7 @@ TimesIterator ChunkStream_times_node_present(ChunkStream* chunk_stream, NodeId n
 	CS_TimesIdPresentAtIteratorData* iterator_data = MALLOC(sizeof(CS_TimesIdPresentAtIteratorData));
 	size_t nb_skips = 0;
 	while (nb_skips < chunk_stream->underlying_stream_graph->nodes.nodes[node].presence.nb_intervals &&
-		   chunk_stream->underlying_stream_graph->nodes.nodes[node].presence.intervals[nb_skips].end <
+		   chunk_stream->underlying_stream_graph->nodes.nodes[node].presence.intervals[nb_skips].end <=
 			   chunk_stream->snapshot.start) {
 		nb_skips++;
 	}
@@ -222,6 +214,9 @@ TimesIterator ChunkStream_times_node_present(ChunkStream* chunk_stream, NodeId n
 		.iterator_data = iterator_data,
 		.next = (Interval(*)(void*))CS_TimesNodePresentAt_next,
 		.destroy = (void (*)(void*))CS_TimesNodePresentAtIterator_destroy,
+		.contiguous = chunk_stream->underlying_stream_graph->nodes.nodes[node].presence,
+		.clipped = true,
+		.clip = chunk_stream->snapshot,
 	};
 	return times_iterator;
 }
@@ -245,7 +240,7 @@ TimesIterator ChunkStream_times_link_present(ChunkStream* chunk_stream, LinkId l
 	CS_TimesIdPresentAtIteratorData* iterator_data = MALLOC(sizeof(CS_TimesIdPresentAtIteratorData));
 	size_t nb_skips = 0;
 	while (nb_skips < chunk_stream->underlying_stream_graph->links.links[link].presence.nb_intervals &&
-		   chunk_stream->underlying_stream_graph->links.links[link].presence.intervals[nb_skips].end <
+		   chunk_stream->underlying_stream_graph->links.links[link].presence.intervals[nb_skips].end <=
 			   chunk_stream->snapshot.start) {
 		nb_skips++;
 	}
@@ -259,6 +254,9 @@ TimesIterator ChunkStream_times_link_present(ChunkStream* chunk_stream, LinkId l
 		.iterator_data = iterator_data,
 		.next = (Interval(*)(void*))CS_TimesLinkPresentAt_next,
 		.destroy = (void (*)(void*))CS_TimesNodePresentAtIterator_destroy,
+		.contiguous = chunk_stream->underlying_stream_graph->links.links[link].presence,
+		.clipped = true,
+		.clip = chunk_stream->snapshot,
 	};
 	return times_iterator;
 }
@@ -278,7 +276,7 @@ NodeId ChunkStreamNPAT_next(NodesIterator* iter) {
 	ChunkStream* chunk_stream = (ChunkStream*)iter->stream_graph.stream;
 	NodeId node = iterator_data->nodes_iterator_fsg.next(&iterator_data->nodes_iterator_fsg);
 	// if the node is not present in the chunk stream, call the next function again
-	while (node != SIZE_MAX && BitArray_is_zero(chunk_stream->nodes_present, node)) {
+	while (node != SIZE_MAX && !RoaringBitmap_contains(&chunk_stream->nodes_present, node)) {
 		node = iterator_data->nodes_iterator_fsg.next(&iterator_data->nodes_iterator_fsg);
 	}
 	return node;
@@ -296,8 +294,8 @@ NodesIterator ChunkStream_nodes_present_at_t(ChunkStream* chunk_stream, TimeId i
 	ChunkStreamNPATIterData* iterator_data = MALLOC(sizeof(ChunkStreamNPATIterData));
 	/*FullStreamGraph* full_stream_graph = MALLOC(sizeof(FullStreamGraph));
 	 *full_stream_graph = FullStreamGraph_from(chunk_stream->underlying_stream_graph);*/
-	Stream fsg = FullStreamGraph_from(chunk_stream->underlying_stream_graph);
-	FullStreamGraph* full_stream_graph = (FullStreamGraph*)fsg.stream;
+	FullStreamGraph* full_stream_graph = MALLOC(sizeof(FullStreamGraph));
+	full_stream_graph->underlying_stream_graph = chunk_stream->underlying_stream_graph;
 	iterator_data->nodes_iterator_fsg = FullStreamGraph_stream_functions.nodes_present_at_t(full_stream_graph, instant);
 	iterator_data->underlying_stream_graph = full_stream_graph;
 
@@ -322,7 +320,7 @@ LinkId ChunkStreamLPAT_next(LinksIterator* iter) {
 	ChunkStream* chunk_stream = (ChunkStream*)iter->stream_graph.stream;
 	LinkId link = iterator_data->links_iterator_fsg.next(&iterator_data->links_iterator_fsg);
 	// if the link is not present in the chunk stream, call the next function again
-	while (link != SIZE_MAX && BitArray_is_zero(chunk_stream->links_present, link)) {
+	while (link != SIZE_MAX && !RoaringBitmap_contains(&chunk_stream->links_present, link)) {
 		link = iterator_data->links_iterator_fsg.next(&iterator_data->links_iterator_fsg);
 	}
 	return link;
@@ -337,8 +335,8 @@ void ChunkStreamLPAT_destroy(LinksIterator* iterator) {
 
 LinksIterator ChunkStream_links_present_at_t(ChunkStream* chunk_stream, TimeId instant) {
 	ChunkStreamLPATIterData* iterator_data = MALLOC(sizeof(ChunkStreamLPATIterData));
-	Stream fsg = FullStreamGraph_from(chunk_stream->underlying_stream_graph);
-	FullStreamGraph* full_stream_graph = (FullStreamGraph*)fsg.stream;
+	FullStreamGraph* full_stream_graph = MALLOC(sizeof(FullStreamGraph));
+	full_stream_graph->underlying_stream_graph = chunk_stream->underlying_stream_graph;
 	iterator_data->links_iterator_fsg = FullStreamGraph_stream_functions.links_present_at_t(full_stream_graph, instant);
 	iterator_data->underlying_stream_graph = full_stream_graph;
 	Stream stream = {.type = CHUNK_STREAM, .stream = chunk_stream};
@@ -364,10 +362,21 @@ const StreamFunctions ChunkStream_stream_functions = {
 	.neighbours_of_node = (LinksIterator(*)(void*, NodeId))ChunkStream_neighbours_of_node,
 };
 
+#define CS_STREAM_GRAPH(cs)			((cs)->underlying_stream_graph)
+#define CS_SNAPSHOT(cs)				((cs)->snapshot)
+#define CS_FOR_EACH_NODE_ID(cs, id)	ROARING_BITMAP_FOR_EACH(id, &(cs)->nodes_present)
+#define CS_FOR_EACH_LINK_ID(cs, id)	ROARING_BITMAP_FOR_EACH(id, &(cs)->links_present)
+#define CS_NODE_PRESENCE(cs, id)	((cs)->underlying_stream_graph->nodes.nodes[id].presence)
+#define CS_NODE_STORE(cs)			(&((cs)->underlying_stream_graph->node_presences))
+#define CS_TIME_INDEX(cs)                                                                                              \
+	((cs)->has_every_id ? (const TimeIndex*)(cs)->underlying_stream_graph->time_index : NULL)
+
+DEFINE_METRICS_KERNELS(ChunkStream, ChunkStream, CS_STREAM_GRAPH, CS_SNAPSHOT, true, CS_FOR_EACH_NODE_ID,
+					   CS_FOR_EACH_LINK_ID, CS_NODE_PRESENCE, CS_NODE_STORE, false, CS_TIME_INDEX)
+
 const MetricsFunctions ChunkStream_metrics_functions = {
-	.cardinalOfW = NULL,
+	METRICS_KERNELS_FUNCTIONS(ChunkStream),
 	.cardinalOfT = NULL,
-	.cardinalOfV = NULL,
 	.coverage = NULL,
 	.node_duration = NULL,
 };
\ No newline at end of file
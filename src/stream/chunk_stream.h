@@ -2,15 +2,18 @@
 #define CHUNK_STREAM_H
 
 #include "../metrics.h"
+#include "../roaring_bitmap.h"
 #include "../stream_functions.h"
 #include "../stream_graph.h"
+#include <stdbool.h>
 #include <stddef.h>
 
 typedef struct {
 	StreamGraph* underlying_stream_graph;
 	Interval snapshot;
-	BitArray nodes_present;
-	BitArray links_present;
+	RoaringBitmap nodes_present;
+	RoaringBitmap links_present;
+	bool has_every_id; // Whether every node and link of the StreamGraph is in the chunk, so only the time is selected
 } ChunkStream;
 
 /*DEFAULT_TO_STRING(NodeId, "%zu");
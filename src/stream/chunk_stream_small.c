@@ -2,13 +2,70 @@
 
 #include "../interval.h"
 #include "../iterators.h"
+#include "../metrics_kernels.h"
 #include "../stream_graph.h"
 #include "chunk_stream.h"
 #include "full_stream_graph.h"
 #include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int compare_ids(const void* a, const void* b) {
+	size_t id_a = *(const size_t*)a;
+	size_t id_b = *(const size_t*)b;
+	return (id_a > id_b) - (id_a < id_b);
+}
+
+static bool ids_sorted(const size_t* ids, size_t nb_ids) {
+	for (size_t i = 1; i < nb_ids; i++) {
+		if (ids[i - 1] > ids[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Index of the first id of a sorted array greater or equal to the given one, searched from the index from.
+// Doubles the step until it goes past the id, then searches the last step by dichotomy, so it costs O(log(distance))
+// instead of O(log(nb_ids)) when the id is close to from, as in a merge of two sorted lists.
+static size_t gallop(const size_t* ids, size_t nb_ids, size_t from, size_t id) {
+	size_t step = 1;
+	size_t low = from;
+	size_t high = from;
+	while (high < nb_ids && ids[high] < id) {
+		low = high + 1;
+		high = from + step;
+		step *= 2;
+	}
+	if (high > nb_ids) {
+		high = nb_ids;
+	}
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		if (ids[middle] < id) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+static bool sorted_ids_contain(const size_t* ids, size_t nb_ids, size_t id) {
+	size_t index = gallop(ids, nb_ids, 0, id);
+	return index < nb_ids && ids[index] == id;
+}
 
 Stream CSS_from(StreamGraph* stream_graph, NodeId* nodes, LinkId* links, Interval snapshot, size_t nb_nodes,
 				size_t nb_links) {
+	// The lookups are binary searches, which need the ids sorted
+	if (!ids_sorted(nodes, nb_nodes)) {
+		qsort(nodes, nb_nodes, sizeof(NodeId), compare_ids);
+	}
+	if (!ids_sorted(links, nb_links)) {
+		qsort(links, nb_links, sizeof(LinkId), compare_ids);
+	}
 	ChunkStreamSmall* chunk_stream = MALLOC(sizeof(ChunkStreamSmall));
 	*chunk_stream = (ChunkStreamSmall){
 		.nb_nodes = nb_nodes,
@@ -18,36 +75,71 @@ Stream CSS_from(StreamGraph* stream_graph, NodeId* nodes, LinkId* links, Interva
 		.underlying_stream_graph = stream_graph,
 		.snapshot = snapshot,
 	};
-	return (Stream){
+	Stream stream = {
 		.type = CHUNK_STREAM_SMALL,
 		.stream = chunk_stream,
+		.stream_functions = &ChunkStreamSmall_stream_functions,
+		.metrics_functions = &ChunkStreamSmall_metrics_functions,
 	};
+	init_cache(&stream);
+	return stream;
+}
+
+bool ChunkStream_prefers_small(StreamGraph* stream_graph, size_t nb_nodes, size_t nb_links) {
+	size_t nb_ids = stream_graph->nodes.nb_nodes + stream_graph->links.nb_links;
+	return (nb_nodes + nb_links) * CHUNK_STREAM_SMALL_MAX_SELECTIVITY <= nb_ids;
+}
+
+Stream ChunkStream_auto_from(StreamGraph* stream_graph, NodeIdVector* nodes, LinkIdVector* links, Interval snapshot) {
+	if (!ChunkStream_prefers_small(stream_graph, nodes->size, links->size)) {
+		return CS_from(stream_graph, nodes, links, snapshot.start, snapshot.end);
+	}
+	NodeId* nodes_present = MALLOC((nodes->size + 1) * sizeof(NodeId));
+	memcpy(nodes_present, nodes->array, nodes->size * sizeof(NodeId));
+	qsort(nodes_present, nodes->size, sizeof(NodeId), compare_ids);
+	// Removes the duplicates
+	size_t nb_nodes = 0;
+	for (size_t i = 0; i < nodes->size; i++) {
+		if (nb_nodes == 0 || nodes_present[nb_nodes - 1] != nodes_present[i]) {
+			nodes_present[nb_nodes++] = nodes_present[i];
+		}
+	}
+	// Like ChunkStream_from, keeps only the links whose two nodes are present
+	LinkId* links_present = MALLOC((links->size + 1) * sizeof(LinkId));
+	size_t nb_links = 0;
+	for (size_t i = 0; i < links->size; i++) {
+		Link link = stream_graph->links.links[links->array[i]];
+		if (sorted_ids_contain(nodes_present, nb_nodes, link.nodes[0]) &&
+			sorted_ids_contain(nodes_present, nb_nodes, link.nodes[1])) {
+			links_present[nb_links++] = links->array[i];
+		}
+	}
+	return CSS_from(stream_graph, nodes_present, links_present, snapshot, nb_nodes, nb_links);
+}
+
+void ChunkStream_auto_destroy(Stream stream) {
+	if (stream.type == CHUNK_STREAM_SMALL) {
+		ChunkStreamSmall_destroy(stream);
+	}
+	else {
+		CS_destroy(stream);
+	}
 }
 
 void ChunkStreamSmall_destroy(Stream stream) {
+	destroy_cache(stream);
 	ChunkStreamSmall* chunk_stream = (ChunkStreamSmall*)stream.stream;
 	free(chunk_stream->nodes_present);
 	free(chunk_stream->links_present);
 	free(chunk_stream);
 }
 
-// OPTIMISE : use dichotomic search since the nodes are sorted
 bool is_node_present(NodeId node, ChunkStreamSmall* chunk_stream) {
-	for (size_t i = 0; i < chunk_stream->nb_nodes; i++) {
-		if (chunk_stream->nodes_present[i] == node) {
-			return true;
-		}
-	}
-	return false;
+	return sorted_ids_contain(chunk_stream->nodes_present, chunk_stream->nb_nodes, node);
 }
 
 bool is_link_present(LinkId link, ChunkStreamSmall* chunk_stream) {
-	for (size_t i = 0; i < chunk_stream->nb_links; i++) {
-		if (chunk_stream->links_present[i] == link) {
-			return true;
-		}
-	}
-	return false;
+	return sorted_ids_contain(chunk_stream->links_present, chunk_stream->nb_links, link);
 }
 
 typedef struct {
@@ -127,26 +219,24 @@ typedef struct {
 NodeId ChunkStreamSmallNodesPresentAtTIterator_next(NodesIterator* it) {
 	ChunkStreamSmallNPATIterData* iterator_data = it->iterator_data;
 	FullStreamGraph* fsg = iterator_data->underlying_stream_graph;
-	NodeId node_id = iterator_data->nodes_iterator_fsg.next(&iterator_data->nodes_iterator_fsg);
-	if (node_id == SIZE_MAX) {
-		return SIZE_MAX;
-	}
 	ChunkStreamSmall* chunk_stream = (ChunkStreamSmall*)it->stream_graph.stream;
-	if (is_node_present(node_id, chunk_stream)) {
-		return node_id;
+	NodeId node_id = iterator_data->nodes_iterator_fsg.next(&iterator_data->nodes_iterator_fsg);
+	while (node_id != SIZE_MAX && !is_node_present(node_id, chunk_stream)) {
+		node_id = iterator_data->nodes_iterator_fsg.next(&iterator_data->nodes_iterator_fsg);
 	}
-	return iterator_data->nodes_iterator_fsg.next(&iterator_data->nodes_iterator_fsg);
+	return node_id;
 }
 
 void ChunkStreamSmallNodesPresentAtTIterator_destroy(NodesIterator* it) {
 	ChunkStreamSmallNPATIterData* iterator_data = it->iterator_data;
 	iterator_data->nodes_iterator_fsg.destroy(&iterator_data->nodes_iterator_fsg);
+	free(iterator_data->underlying_stream_graph);
 	free(iterator_data);
 }
 
 NodesIterator ChunkStreamSmall_nodes_present_at_t(ChunkStreamSmall* chunk_stream, TimeId instant) {
-	Stream st = FullStreamGraph_from(chunk_stream->underlying_stream_graph);
-	FullStreamGraph* fsg = (FullStreamGraph*)st.stream;
+	FullStreamGraph* fsg = MALLOC(sizeof(FullStreamGraph));
+	fsg->underlying_stream_graph = chunk_stream->underlying_stream_graph;
 	NodesIterator nodes_iterator_fsg = FullStreamGraph_stream_functions.nodes_present_at_t(fsg, instant);
 	ChunkStreamSmallNPATIterData* iterator_data = MALLOC(sizeof(ChunkStreamSmallNPATIterData));
 	iterator_data->nodes_iterator_fsg = nodes_iterator_fsg;
@@ -167,27 +257,24 @@ typedef struct {
 LinkId ChunkStreamSmallLinksPresentAtTIterator_next(LinksIterator* it) {
 	ChunkStreamSmallLPATIterData* iterator_data = it->iterator_data;
 	FullStreamGraph* fsg = iterator_data->underlying_stream_graph;
-	LinkId link_id = iterator_data->links_iterator_fsg.next(&iterator_data->links_iterator_fsg);
-	if (link_id == SIZE_MAX) {
-		return SIZE_MAX;
-	}
 	ChunkStreamSmall* chunk_stream = (ChunkStreamSmall*)it->stream_graph.stream;
-	if (is_link_present(link_id, chunk_stream)) {
-		return link_id;
+	LinkId link_id = iterator_data->links_iterator_fsg.next(&iterator_data->links_iterator_fsg);
+	while (link_id != SIZE_MAX && !is_link_present(link_id, chunk_stream)) {
+		link_id = iterator_data->links_iterator_fsg.next(&iterator_data->links_iterator_fsg);
 	}
-
-	return iterator_data->links_iterator_fsg.next(&iterator_data->links_iterator_fsg);
+	return link_id;
 }
 
 void ChunkStreamSmallLinksPresentAtTIterator_destroy(LinksIterator* it) {
 	ChunkStreamSmallLPATIterData* iterator_data = it->iterator_data;
 	iterator_data->links_iterator_fsg.destroy(&iterator_data->links_iterator_fsg);
+	free(iterator_data->underlying_stream_graph);
 	free(iterator_data);
 }
 
 LinksIterator ChunkStreamSmall_links_present_at_t(ChunkStreamSmall* chunk_stream, TimeId instant) {
-	Stream st = FullStreamGraph_from(chunk_stream->underlying_stream_graph);
-	FullStreamGraph* fsg = (FullStreamGraph*)st.stream;
+	FullStreamGraph* fsg = MALLOC(sizeof(FullStreamGraph));
+	fsg->underlying_stream_graph = chunk_stream->underlying_stream_graph;
 	LinksIterator links_iterator_fsg = FullStreamGraph_stream_functions.links_present_at_t(fsg, instant);
 	ChunkStreamSmallLPATIterData* iterator_data = MALLOC(sizeof(ChunkStreamSmallLPATIterData));
 	iterator_data->links_iterator_fsg = links_iterator_fsg;
@@ -203,27 +290,36 @@ LinksIterator ChunkStreamSmall_links_present_at_t(ChunkStreamSmall* chunk_stream
 typedef struct {
 	NodeId node_to_get_neighbours;
 	NodeId current_neighbour;
+	bool sorted_neighbours; // Whether the neighbours are sorted, to merge them with the links of the chunk
+	size_t current_link;	// The index in the links of the chunk where the merge is
 } CSS_NeighboursOfNodeIteratorData;
 
 size_t ChunkStreamSmall_NeighboursOfNode_next(LinksIterator* iter) {
 	CSS_NeighboursOfNodeIteratorData* neighbours_iter_data = (CSS_NeighboursOfNodeIteratorData*)iter->iterator_data;
 	ChunkStreamSmall* chunk_stream = (ChunkStreamSmall*)iter->stream_graph.stream;
-	StreamGraph* stream_graph = chunk_stream->underlying_stream_graph;
-	NodeId node = neighbours_iter_data->node_to_get_neighbours;
-	// Print all the neighbours of the node
-	if (neighbours_iter_data->current_neighbour >= stream_graph->nodes.nodes[node].nb_neighbours) {
-		return SIZE_MAX;
-	}
-	size_t return_val =
-		chunk_stream->underlying_stream_graph->nodes.nodes[node].neighbours[neighbours_iter_data->current_neighbour];
-	neighbours_iter_data->current_neighbour++;
-	/*if (BitArray_is_zero(chunk_stream->links_present, return_val)) {
-		return ChunkStreamSmall_NeighboursOfNode_next(iter);
-	}*/
-	if (!is_link_present(return_val, chunk_stream)) {
-		return ChunkStreamSmall_NeighboursOfNode_next(iter);
+	NodeId node_id = neighbours_iter_data->node_to_get_neighbours;
+	TemporalNode* node = &chunk_stream->underlying_stream_graph->nodes.nodes[node_id];
+	while (neighbours_iter_data->current_neighbour < node->nb_neighbours) {
+		LinkId neighbour = node->neighbours[neighbours_iter_data->current_neighbour];
+		neighbours_iter_data->current_neighbour++;
+		if (!neighbours_iter_data->sorted_neighbours) {
+			if (is_link_present(neighbour, chunk_stream)) {
+				return neighbour;
+			}
+			continue;
+		}
+		// Both lists are sorted, so the search for the next neighbour starts where the previous one stopped
+		neighbours_iter_data->current_link =
+			gallop(chunk_stream->links_present, chunk_stream->nb_links, neighbours_iter_data->current_link, neighbour);
+		if (neighbours_iter_data->current_link == chunk_stream->nb_links) {
+			neighbours_iter_data->current_neighbour = node->nb_neighbours;
+			return SIZE_MAX;
+		}
+		if (chunk_stream->links_present[neighbours_iter_data->current_link] == neighbour) {
+			return neighbour;
+		}
 	}
-	return return_val;
+	return SIZE_MAX;
 }
 
 void ChunkStreamSmall_NeighboursOfNodeIterator_destroy(LinksIterator* iterator) {
@@ -232,9 +328,12 @@ void ChunkStreamSmall_NeighboursOfNodeIterator_destroy(LinksIterator* iterator)
 
 LinksIterator ChunkStreamSmall_neighbours_of_node(ChunkStreamSmall* chunk_stream, NodeId node) {
 	CSS_NeighboursOfNodeIteratorData* iterator_data = MALLOC(sizeof(CSS_NeighboursOfNodeIteratorData));
+	TemporalNode* temporal_node = &chunk_stream->underlying_stream_graph->nodes.nodes[node];
 	*iterator_data = (CSS_NeighboursOfNodeIteratorData){
 		.node_to_get_neighbours = node,
 		.current_neighbour = 0,
+		.sorted_neighbours = ids_sorted(temporal_node->neighbours, temporal_node->nb_neighbours),
+		.current_link = 0,
 	};
 	Stream stream = {.type = CHUNK_STREAM_SMALL, .stream = chunk_stream};
 	LinksIterator neighbours_iterator = {
@@ -273,7 +372,7 @@ TimesIterator ChunkStreamSmall_times_node_present(ChunkStreamSmall* chunk_stream
 	CSS_TimesIdPresentAtIteratorData* iterator_data = MALLOC(sizeof(CSS_TimesIdPresentAtIteratorData));
 	size_t nb_skips = 0;
 	while (nb_skips < chunk_stream->underlying_stream_graph->nodes.nodes[node].presence.nb_intervals &&
-		   chunk_stream->underlying_stream_graph->nodes.nodes[node].presence.intervals[nb_skips].end <
+		   chunk_stream->underlying_stream_graph->nodes.nodes[node].presence.intervals[nb_skips].end <=
 			   chunk_stream->snapshot.start) {
 		nb_skips++;
 	}
@@ -287,6 +386,9 @@ TimesIterator ChunkStreamSmall_times_node_present(ChunkStreamSmall* chunk_stream
 		.iterator_data = iterator_data,
 		.next = (Interval(*)(void*))CSS_TimesNodePresentAt_next,
 		.destroy = (void (*)(void*))CSS_TimesNodePresentAtIterator_destroy,
+		.contiguous = chunk_stream->underlying_stream_graph->nodes.nodes[node].presence,
+		.clipped = true,
+		.clip = chunk_stream->snapshot,
 	};
 	return times_iterator;
 }
@@ -310,7 +412,7 @@ TimesIterator ChunkStreamSmall_times_link_present(ChunkStreamSmall* chunk_stream
 	CSS_TimesIdPresentAtIteratorData* iterator_data = MALLOC(sizeof(CSS_TimesIdPresentAtIteratorData));
 	size_t nb_skips = 0;
 	while (nb_skips < chunk_stream->underlying_stream_graph->links.links[link].presence.nb_intervals &&
-		   chunk_stream->underlying_stream_graph->links.links[link].presence.intervals[nb_skips].end <
+		   chunk_stream->underlying_stream_graph->links.links[link].presence.intervals[nb_skips].end <=
 			   chunk_stream->snapshot.start) {
 		nb_skips++;
 	}
@@ -324,6 +426,9 @@ TimesIterator ChunkStreamSmall_times_link_present(ChunkStreamSmall* chunk_stream
 		.iterator_data = iterator_data,
 		.next = (Interval(*)(void*))CSS_TimesLinkPresentAt_next,
 		.destroy = (void (*)(void*))CSS_TimesNodePresentAtIterator_destroy,
+		.contiguous = chunk_stream->underlying_stream_graph->links.links[link].presence,
+		.clipped = true,
+		.clip = chunk_stream->snapshot,
 	};
 	return times_iterator;
 }
@@ -344,10 +449,25 @@ const StreamFunctions ChunkStreamSmall_stream_functions = {
 	.neighbours_of_node = (LinksIterator(*)(void*, NodeId))ChunkStreamSmall_neighbours_of_node,
 };
 
+#define CSS_STREAM_GRAPH(css) ((css)->underlying_stream_graph)
+#define CSS_SNAPSHOT(css)	  ((css)->snapshot)
+#define CSS_FOR_EACH_NODE_ID(css, id)                                                                                  \
+	for (size_t css_index = 0, id = 0; css_index < (css)->nb_nodes && ((id) = (css)->nodes_present[css_index], true); \
+		 css_index++)
+#define CSS_FOR_EACH_LINK_ID(css, id)                                                                                  \
+	for (size_t css_index = 0, id = 0; css_index < (css)->nb_links && ((id) = (css)->links_present[css_index], true); \
+		 css_index++)
+#define CSS_NODE_PRESENCE(css, id) ((css)->underlying_stream_graph->nodes.nodes[id].presence)
+#define CSS_NODE_STORE(css)		   (&((css)->underlying_stream_graph->node_presences))
+// A small chunk never has all the StreamGraph
+#define CSS_TIME_INDEX(css)		   ((void)(css), (const TimeIndex*)NULL)
+
+DEFINE_METRICS_KERNELS(ChunkStreamSmall, ChunkStreamSmall, CSS_STREAM_GRAPH, CSS_SNAPSHOT, true, CSS_FOR_EACH_NODE_ID,
+					   CSS_FOR_EACH_LINK_ID, CSS_NODE_PRESENCE, CSS_NODE_STORE, false, CSS_TIME_INDEX)
+
 const MetricsFunctions ChunkStreamSmall_metrics_functions = {
-	.cardinalOfW = NULL,
+	METRICS_KERNELS_FUNCTIONS(ChunkStreamSmall),
 	.cardinalOfT = NULL,
-	.cardinalOfV = NULL,
 	.coverage = NULL,
 	.node_duration = NULL,
 };
\ No newline at end of file
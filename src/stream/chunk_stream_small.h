@@ -9,6 +9,8 @@
 #include "../metrics.h"
 #include "../stream_functions.h"
 #include "../stream_graph.h"
+#include "chunk_stream.h"
+#include <stdbool.h>
 #include <stddef.h>
 
 typedef struct {
@@ -24,8 +26,57 @@ extern const StreamFunctions ChunkStreamSmall_stream_functions;
 extern const MetricsFunctions ChunkStreamSmall_metrics_functions;
 
 // TODO : change the signature of this function to not have to take 6 arguments
+/**
+ * @brief Creates a ChunkStreamSmall, which takes ownership of the arrays of nodes and links.
+ *
+ * The arrays are sorted if they are not already, since the lookups of a node or link are binary searches.
+ */
 Stream CSS_from(StreamGraph* stream_graph, NodeId* nodes, LinkId* links, Interval snapshot, size_t nb_nodes,
 				size_t nb_links);
 void ChunkStreamSmall_destroy(Stream stream);
 
+/**
+ * @name Automatic choice of the representation
+ * A ChunkStream stores its nodes and links in compressed bitmaps, whose lookups stay cheap whatever the size of the
+ * selection. A ChunkStreamSmall stores them in plain sorted arrays, which are smaller and faster to loop over for a
+ * handful of ids, but whose lookups are binary searches. The choice is made on the selectivity of the chunk, the
+ * fraction of the nodes and links of the StreamGraph it keeps.
+ * @{
+ */
+
+/**
+ * @brief A chunk keeping at most 1 / CHUNK_STREAM_SMALL_MAX_SELECTIVITY of the nodes and links of the StreamGraph is
+ * stored as a ChunkStreamSmall.
+ */
+#define CHUNK_STREAM_SMALL_MAX_SELECTIVITY 64
+
+/**
+ * @brief Returns whether a chunk with the given number of nodes and links should be a ChunkStreamSmall.
+ * @param[in] stream_graph The StreamGraph the chunk is extracted from.
+ * @param[in] nb_nodes The number of nodes of the chunk.
+ * @param[in] nb_links The number of links of the chunk.
+ */
+bool ChunkStream_prefers_small(StreamGraph* stream_graph, size_t nb_nodes, size_t nb_links);
+
+/**
+ * @brief Creates a ChunkStream or a ChunkStreamSmall, depending on the selectivity of the chunk.
+ *
+ * Like CS_from, it does not take ownership of the vectors, and only keeps the links whose two nodes are in the chunk.
+ * Must be destroyed with ChunkStream_auto_destroy.
+ * @param[in] stream_graph The StreamGraph the chunk is extracted from.
+ * @param[in] nodes The nodes of the chunk.
+ * @param[in] links The links of the chunk.
+ * @param[in] snapshot The time interval of the chunk.
+ * @return The chunk, of type CHUNK_STREAM or CHUNK_STREAM_SMALL.
+ */
+Stream ChunkStream_auto_from(StreamGraph* stream_graph, NodeIdVector* nodes, LinkIdVector* links, Interval snapshot);
+
+/**
+ * @brief Destroys a chunk created by ChunkStream_auto_from, whatever its representation.
+ * @param[in] stream The chunk.
+ */
+void ChunkStream_auto_destroy(Stream stream);
+
+/** @} */
+
 #endif // CHUNK_STREAM_SMALL_H
\ No newline at end of file
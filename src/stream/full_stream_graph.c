@@ -1,6 +1,7 @@
 #include "full_stream_graph.h"
 #include "../induced_graph.h"
 #include "../metrics.h"
+#include "../metrics_kernels.h"
 #include "../stream_graph.h"
 #include "../stream_graph/nodes_set.h"
 #include "../units.h"
@@ -13,12 +14,18 @@
 Stream FullStreamGraph_from(StreamGraph* stream_graph) {
 	FullStreamGraph* full_stream_graph = MALLOC(sizeof(FullStreamGraph));
 	full_stream_graph->underlying_stream_graph = stream_graph;
-	Stream stream = {.type = FULL_STREAM_GRAPH, .stream = full_stream_graph};
+	Stream stream = {
+		.type = FULL_STREAM_GRAPH,
+		.stream = full_stream_graph,
+		.stream_functions = &FullStreamGraph_stream_functions,
+		.metrics_functions = &FullStreamGraph_metrics_functions,
+	};
 	init_cache(&stream);
 	return stream;
 }
 
 void FullStreamGraph_destroy(Stream stream) {
+	destroy_cache(stream);
 	free(stream.stream);
 }
 
@@ -137,6 +144,8 @@ TimesIterator FullStreamGraph_times_node_present(FullStreamGraph* full_stream_gr
 		.iterator_data = iterator_data,
 		.next = (Interval(*)(void*))FSG_TimesNodePresent_next,
 		.destroy = (void (*)(void*))FSG_TimesNodePresentIterator_destroy,
+		.contiguous = iterator_data->node->presence,
+		.clipped = false,
 	};
 	return times_iterator;
 }
@@ -172,6 +181,8 @@ TimesIterator FullStreamGraph_times_link_present(FullStreamGraph* full_stream_gr
 		.iterator_data = iterator_data,
 		.next = (Interval(*)(void*))TimesLinkPresent_next,
 		.destroy = (void (*)(void*))TimesLinkPresentIterator_destroy,
+		.contiguous = full_stream_graph->underlying_stream_graph->links.links[link_id].presence,
+		.clipped = false,
 	};
 	return times_iterator;
 }
@@ -230,14 +241,23 @@ const StreamFunctions FullStreamGraph_stream_functions = {
 	.neighbours_of_node = (LinksIterator(*)(void*, NodeId))FullStreamGraph_neighbours_of_node,
 };
 
-size_t FullStreamGraph_cardinalOfV(FullStreamGraph* full_stream_graph) {
-	return full_stream_graph->underlying_stream_graph->nodes.nb_nodes;
-}
+#define FSG_STREAM_GRAPH(fsg) ((fsg)->underlying_stream_graph)
+#define FSG_SNAPSHOT(fsg)	  FullStreamGraph_lifespan(fsg)
+#define FSG_FOR_EACH_NODE_ID(fsg, id)                                                                                  \
+	for (NodeId id = 0; id < (fsg)->underlying_stream_graph->nodes.nb_nodes; id++)
+#define FSG_FOR_EACH_LINK_ID(fsg, id)                                                                                  \
+	for (LinkId id = 0; id < (fsg)->underlying_stream_graph->links.nb_links; id++)
+#define FSG_NODE_PRESENCE(fsg, id) ((fsg)->underlying_stream_graph->nodes.nodes[id].presence)
+#define FSG_NODE_STORE(fsg)		   (&((fsg)->underlying_stream_graph->node_presences))
+#define FSG_TIME_INDEX(fsg)		   ((const TimeIndex*)(fsg)->underlying_stream_graph->time_index)
+
+// Everything in the StreamGraph is present, and already inside its lifespan
+DEFINE_METRICS_KERNELS(FullStreamGraph, FullStreamGraph, FSG_STREAM_GRAPH, FSG_SNAPSHOT, false, FSG_FOR_EACH_NODE_ID,
+					   FSG_FOR_EACH_LINK_ID, FSG_NODE_PRESENCE, FSG_NODE_STORE, true, FSG_TIME_INDEX)
 
 const MetricsFunctions FullStreamGraph_metrics_functions = {
-	.cardinalOfW = NULL,
+	METRICS_KERNELS_FUNCTIONS(FullStreamGraph),
 	.cardinalOfT = NULL,
-	.cardinalOfV = (size_t(*)(void*))FullStreamGraph_cardinalOfV,
 	.coverage = NULL,
 	.node_duration = NULL,
 };
\ No newline at end of file
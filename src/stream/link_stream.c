@@ -1,6 +1,7 @@
 #include "link_stream.h"
 #include "../interval.h"
 #include "../metrics.h"
+#include "../metrics_kernels.h"
 #include "../stream_graph.h"
 #include "../utils.h"
 #include "full_stream_graph.h"
@@ -85,10 +86,9 @@ NodesIterator LinkStream_nodes_set(LinkStream* link_stream) {
 	return n;
 }
 
+// TRICK : same as LinkStream_times_link_present
 LinksIterator LinkStream_links_set(LinkStream* link_stream) {
-	Stream full_stream_graph = FullStreamGraph_from(link_stream->underlying_stream_graph);
-	FullStreamGraph* fsg = (FullStreamGraph*)full_stream_graph.stream;
-	return FullStreamGraph_stream_functions.links_set(fsg);
+	return FullStreamGraph_stream_functions.links_set((FullStreamGraph*)link_stream);
 }
 
 Interval LinkStream_lifespan(LinkStream* link_stream) {
@@ -100,16 +100,13 @@ size_t LinkStream_scaling(LinkStream* link_stream) {
 	return link_stream->underlying_stream_graph->scaling;
 }
 
+// TRICK : same as LinkStream_times_link_present
 NodesIterator LinkStream_nodes_present_at_t(LinkStream* link_stream, TimeId instant) {
-	Stream full_stream_graph = FullStreamGraph_from(link_stream->underlying_stream_graph);
-	FullStreamGraph* fsg = (FullStreamGraph*)full_stream_graph.stream;
-	return FullStreamGraph_stream_functions.nodes_set(fsg);
+	return FullStreamGraph_stream_functions.nodes_set((FullStreamGraph*)link_stream);
 }
 
 LinksIterator LinkStream_links_present_at_t(LinkStream* link_stream, TimeId instant) {
-	Stream full_stream_graph = FullStreamGraph_from(link_stream->underlying_stream_graph);
-	FullStreamGraph* fsg = (FullStreamGraph*)full_stream_graph.stream;
-	return FullStreamGraph_stream_functions.links_present_at_t(fsg, instant);
+	return FullStreamGraph_stream_functions.links_present_at_t((FullStreamGraph*)link_stream, instant);
 }
 
 // time of nodes iterator
@@ -145,27 +142,33 @@ TimesIterator LinkStream_times_node_present(LinkStream* link_stream, NodeId node
 }
 
 // time of links iterator
+// TRICK : a LinkStream has the same layout as a FullStreamGraph, and it outlives the iterator, unlike a temporary one
 TimesIterator LinkStream_times_link_present(LinkStream* link_stream, LinkId link_id) {
-	return FullStreamGraph_stream_functions.times_link_present(link_stream->underlying_stream_graph, link_id);
+	return FullStreamGraph_stream_functions.times_link_present((FullStreamGraph*)link_stream, link_id);
 }
 
 Stream LS_from(StreamGraph* stream_graph) {
 	LinkStream* link_stream = MALLOC(sizeof(LinkStream));
 	link_stream->underlying_stream_graph = stream_graph;
-	Stream stream = {.type = LINK_STREAM, .stream = link_stream};
+	Stream stream = {
+		.type = LINK_STREAM,
+		.stream = link_stream,
+		.stream_functions = &LinkStream_stream_functions,
+		.metrics_functions = &LinkStream_metrics_functions,
+	};
 	init_cache(&stream);
 	return stream;
 }
 
 void LS_destroy(Stream stream) {
+	destroy_cache(stream);
 	free(stream.stream);
 }
 
 // TRICK
 Link LinkStream_nth_link(LinkStream* link_stream, LinkId link_id) {
-	Stream st = FullStreamGraph_from(link_stream->underlying_stream_graph);
-	FullStreamGraph* fsg = (FullStreamGraph*)st.stream;
-	Link link = FullStreamGraph_nth_link(fsg, link_id);
+	FullStreamGraph fsg = {.underlying_stream_graph = link_stream->underlying_stream_graph};
+	Link link = FullStreamGraph_nth_link(&fsg, link_id);
 	return link;
 }
 
@@ -183,7 +186,6 @@ const StreamFunctions LinkStream_stream_functions = {
 };
 
 double LS_coverage(LinkStream* link_stream) {
-	printf("called LS_coverage\n");
 	return 1.0;
 }
 
@@ -195,11 +197,27 @@ double density(Stream* st) {
 	return m / (double)(n * (n - 1));
 }
 
+#define LS_STREAM_GRAPH(ls) ((ls)->underlying_stream_graph)
+#define LS_SNAPSHOT(ls)		LinkStream_lifespan(ls)
+#define LS_FOR_EACH_NODE_ID(ls, id)                                                                                    \
+	for (NodeId id = 0; id < (ls)->underlying_stream_graph->nodes.nb_nodes; id++)
+#define LS_FOR_EACH_LINK_ID(ls, id)                                                                                    \
+	for (LinkId id = 0; id < (ls)->underlying_stream_graph->links.nb_links; id++)
+// The nodes are present during the whole lifespan
+#define LS_NODE_PRESENCE(ls, id)                                                                                       \
+	((void)(id), (IntervalsSet){.nb_intervals = 1, .intervals = (Interval[]){LS_SNAPSHOT(ls)}})
+// Neither are their intervals in the PresenceStore
+#define LS_NODE_STORE(ls) ((void)(ls), (const PresenceStore*)NULL)
+// Nor in the TimeIndex
+#define LS_TIME_INDEX(ls) ((void)(ls), (const TimeIndex*)NULL)
+
+DEFINE_METRICS_KERNELS(LinkStream, LinkStream, LS_STREAM_GRAPH, LS_SNAPSHOT, false, LS_FOR_EACH_NODE_ID,
+					   LS_FOR_EACH_LINK_ID, LS_NODE_PRESENCE, LS_NODE_STORE, true, LS_TIME_INDEX)
+
 const MetricsFunctions LinkStream_metrics_functions = {
+	METRICS_KERNELS_FUNCTIONS(LinkStream),
 	.coverage = (double (*)(void*))LS_coverage,
 	.cardinalOfT = NULL,
-	.cardinalOfV = NULL,
-	.cardinalOfW = NULL,
 	.node_duration = NULL,
 	.density = (double (*)(void*))density,
 };
\ No newline at end of file
@@ -1 +1,401 @@
-#include "substream.h"
\ No newline at end of file
+#include "substream.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static int compare_pieces(const void* a, const void* b) {
+	size_t start_a = ((const SubStreamPiece*)a)->window.start;
+	size_t start_b = ((const SubStreamPiece*)b)->window.start;
+	return (start_a > start_b) - (start_a < start_b);
+}
+
+static ChunkStream* SubStream_chunk(SubStream* sub_stream, size_t index) {
+	return (ChunkStream*)sub_stream->chunks[index].stream;
+}
+
+Stream SubStream_from(StreamGraph* stream_graph, size_t nb_pieces, const SubStreamPiece* pieces) {
+	SubStreamPiece* sorted_pieces = MALLOC((nb_pieces + 1) * sizeof(SubStreamPiece));
+	for (size_t i = 0; i < nb_pieces; i++) {
+		sorted_pieces[i] = pieces[i];
+	}
+	qsort(sorted_pieces, nb_pieces, sizeof(SubStreamPiece), compare_pieces);
+	for (size_t i = 1; i < nb_pieces; i++) {
+		if (sorted_pieces[i].window.start < sorted_pieces[i - 1].window.end) {
+			fprintf(stderr, "Could not create the SubStream, the windows [%zu, %zu[ and [%zu, %zu[ overlap\n",
+					sorted_pieces[i - 1].window.start, sorted_pieces[i - 1].window.end, sorted_pieces[i].window.start,
+					sorted_pieces[i].window.end);
+			exit(1);
+		}
+	}
+
+	SubStream* sub_stream = MALLOC(sizeof(SubStream));
+	*sub_stream = (SubStream){
+		.underlying_stream_graph = stream_graph,
+		.nb_chunks = nb_pieces,
+		.chunks = MALLOC((nb_pieces + 1) * sizeof(Stream)),
+		.nodes_present = RoaringBitmap_empty(),
+		.links_present = RoaringBitmap_empty(),
+	};
+	for (size_t i = 0; i < nb_pieces; i++) {
+		sub_stream->chunks[i] = CS_from(stream_graph, sorted_pieces[i].nodes, sorted_pieces[i].links,
+										sorted_pieces[i].window.start, sorted_pieces[i].window.end);
+		ChunkStream* chunk = SubStream_chunk(sub_stream, i);
+		RoaringBitmap nodes_present = RoaringBitmap_or(&sub_stream->nodes_present, &chunk->nodes_present);
+		RoaringBitmap links_present = RoaringBitmap_or(&sub_stream->links_present, &chunk->links_present);
+		RoaringBitmap_destroy(sub_stream->nodes_present);
+		RoaringBitmap_destroy(sub_stream->links_present);
+		sub_stream->nodes_present = nodes_present;
+		sub_stream->links_present = links_present;
+	}
+	free(sorted_pieces);
+
+	Stream stream = {
+		.type = SUB_STREAM,
+		.stream = sub_stream,
+		.stream_functions = &SubStream_stream_functions,
+		.metrics_functions = &SubStream_metrics_functions,
+	};
+	init_cache(&stream);
+	return stream;
+}
+
+void SubStream_destroy(Stream stream) {
+	destroy_cache(stream);
+	SubStream* sub_stream = (SubStream*)stream.stream;
+	for (size_t i = 0; i < sub_stream->nb_chunks; i++) {
+		CS_destroy(sub_stream->chunks[i]);
+	}
+	free(sub_stream->chunks);
+	RoaringBitmap_destroy(sub_stream->nodes_present);
+	RoaringBitmap_destroy(sub_stream->links_present);
+	free(sub_stream);
+}
+
+typedef struct {
+	RoaringIterator ids;
+} SS_SetIteratorData;
+
+size_t SS_Set_next(NodesIterator* iter) {
+	SS_SetIteratorData* iterator_data = (SS_SetIteratorData*)iter->iterator_data;
+	return RoaringIterator_next(&iterator_data->ids);
+}
+
+void SS_SetIterator_destroy(NodesIterator* iterator) {
+	free(iterator->iterator_data);
+}
+
+NodesIterator SubStream_nodes_set(SubStream* sub_stream) {
+	SS_SetIteratorData* iterator_data = MALLOC(sizeof(SS_SetIteratorData));
+	iterator_data->ids = RoaringIterator_from(&sub_stream->nodes_present);
+	Stream stream = {.type = SUB_STREAM, .stream = sub_stream};
+	NodesIterator nodes_iterator = {
+		.stream_graph = stream,
+		.iterator_data = iterator_data,
+		.next = (size_t(*)(void*))SS_Set_next,
+		.destroy = (void (*)(void*))SS_SetIterator_destroy,
+	};
+	return nodes_iterator;
+}
+
+LinksIterator SubStream_links_set(SubStream* sub_stream) {
+	SS_SetIteratorData* iterator_data = MALLOC(sizeof(SS_SetIteratorData));
+	iterator_data->ids = RoaringIterator_from(&sub_stream->links_present);
+	Stream stream = {.type = SUB_STREAM, .stream = sub_stream};
+	LinksIterator links_iterator = {
+		.stream_graph = stream,
+		.iterator_data = iterator_data,
+		.next = (size_t(*)(void*))SS_Set_next,
+		.destroy = (void (*)(void*))SS_SetIterator_destroy,
+	};
+	return links_iterator;
+}
+
+// From the start of the first window to the end of the last one, the gaps between the windows included
+Interval SubStream_lifespan(SubStream* sub_stream) {
+	if (sub_stream->nb_chunks == 0) {
+		return Interval_from(0, 0);
+	}
+	return Interval_from(SubStream_chunk(sub_stream, 0)->snapshot.start,
+						 SubStream_chunk(sub_stream, sub_stream->nb_chunks - 1)->snapshot.end);
+}
+
+size_t SubStream_scaling(SubStream* sub_stream) {
+	return sub_stream->underlying_stream_graph->scaling;
+}
+
+// Binary search of the chunk whose window contains the instant, SIZE_MAX if it falls in a gap
+static size_t SubStream_chunk_at(SubStream* sub_stream, TimeId instant) {
+	size_t low = 0;
+	size_t high = sub_stream->nb_chunks;
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		Interval window = SubStream_chunk(sub_stream, middle)->snapshot;
+		if (instant < window.start) {
+			high = middle;
+		}
+		else if (instant >= window.end) {
+			low = middle + 1;
+		}
+		else {
+			return middle;
+		}
+	}
+	return SIZE_MAX;
+}
+
+size_t SS_Empty_next(NodesIterator* iter) {
+	(void)iter;
+	return SIZE_MAX;
+}
+
+void SS_Empty_destroy(NodesIterator* iterator) {
+	(void)iterator;
+}
+
+// The windows are disjoint, so the nodes present at an instant are the ones of the only chunk containing it
+NodesIterator SubStream_nodes_present_at_t(SubStream* sub_stream, TimeId instant) {
+	size_t chunk = SubStream_chunk_at(sub_stream, instant);
+	if (chunk != SIZE_MAX) {
+		Stream chunk_stream = sub_stream->chunks[chunk];
+		return chunk_stream.stream_functions->nodes_present_at_t(chunk_stream.stream, instant);
+	}
+	Stream stream = {.type = SUB_STREAM, .stream = sub_stream};
+	NodesIterator nodes_iterator = {
+		.stream_graph = stream,
+		.iterator_data = NULL,
+		.next = (size_t(*)(void*))SS_Empty_next,
+		.destroy = (void (*)(void*))SS_Empty_destroy,
+	};
+	return nodes_iterator;
+}
+
+LinksIterator SubStream_links_present_at_t(SubStream* sub_stream, TimeId instant) {
+	size_t chunk = SubStream_chunk_at(sub_stream, instant);
+	if (chunk != SIZE_MAX) {
+		Stream chunk_stream = sub_stream->chunks[chunk];
+		return chunk_stream.stream_functions->links_present_at_t(chunk_stream.stream, instant);
+	}
+	Stream stream = {.type = SUB_STREAM, .stream = sub_stream};
+	LinksIterator links_iterator = {
+		.stream_graph = stream,
+		.iterator_data = NULL,
+		.next = (size_t(*)(void*))SS_Empty_next,
+		.destroy = (void (*)(void*))SS_Empty_destroy,
+	};
+	return links_iterator;
+}
+
+// Chains the times iterators of the chunks containing the node or link, in the order of their windows
+typedef struct {
+	size_t id;
+	bool is_link;
+	size_t next_chunk;
+	bool has_current;
+	TimesIterator current;
+} SS_TimesIdPresentIteratorData;
+
+Interval SS_TimesIdPresent_next(TimesIterator* iter) {
+	SS_TimesIdPresentIteratorData* iterator_data = (SS_TimesIdPresentIteratorData*)iter->iterator_data;
+	SubStream* sub_stream = (SubStream*)iter->stream_graph.stream;
+	while (true) {
+		if (iterator_data->has_current) {
+			Interval interval = iterator_data->current.next(&iterator_data->current);
+			if (interval.start != SIZE_MAX) {
+				return interval;
+			}
+			iterator_data->current.destroy(&iterator_data->current);
+			iterator_data->has_current = false;
+		}
+		// Skip the chunks the node or link is absent from
+		while (iterator_data->next_chunk < sub_stream->nb_chunks) {
+			ChunkStream* chunk = SubStream_chunk(sub_stream, iterator_data->next_chunk);
+			const RoaringBitmap* ids = iterator_data->is_link ? &chunk->links_present : &chunk->nodes_present;
+			if (RoaringBitmap_contains(ids, iterator_data->id)) {
+				break;
+			}
+			iterator_data->next_chunk++;
+		}
+		if (iterator_data->next_chunk >= sub_stream->nb_chunks) {
+			return Interval_from(SIZE_MAX, SIZE_MAX);
+		}
+		Stream chunk_stream = sub_stream->chunks[iterator_data->next_chunk];
+		iterator_data->current =
+			iterator_data->is_link
+				? chunk_stream.stream_functions->times_link_present(chunk_stream.stream, iterator_data->id)
+				: chunk_stream.stream_functions->times_node_present(chunk_stream.stream, iterator_data->id);
+		iterator_data->has_current = true;
+		iterator_data->next_chunk++;
+	}
+}
+
+void SS_TimesIdPresent_destroy(TimesIterator* iterator) {
+	SS_TimesIdPresentIteratorData* iterator_data = (SS_TimesIdPresentIteratorData*)iterator->iterator_data;
+	if (iterator_data->has_current) {
+		iterator_data->current.destroy(&iterator_data->current);
+	}
+	free(iterator_data);
+}
+
+static TimesIterator SubStream_times_id_present(SubStream* sub_stream, size_t id, bool is_link) {
+	SS_TimesIdPresentIteratorData* iterator_data = MALLOC(sizeof(SS_TimesIdPresentIteratorData));
+	*iterator_data = (SS_TimesIdPresentIteratorData){
+		.id = id,
+		.is_link = is_link,
+		.next_chunk = 0,
+		.has_current = false,
+	};
+	Stream stream = {.type = SUB_STREAM, .stream = sub_stream};
+	TimesIterator times_iterator = {
+		.stream_graph = stream,
+		.iterator_data = iterator_data,
+		.next = (Interval(*)(void*))SS_TimesIdPresent_next,
+		.destroy = (void (*)(void*))SS_TimesIdPresent_destroy,
+	};
+	return times_iterator;
+}
+
+TimesIterator SubStream_times_node_present(SubStream* sub_stream, NodeId node) {
+	return SubStream_times_id_present(sub_stream, node, false);
+}
+
+TimesIterator SubStream_times_link_present(SubStream* sub_stream, LinkId link) {
+	return SubStream_times_id_present(sub_stream, link, true);
+}
+
+Link SubStream_nth_link(SubStream* sub_stream, size_t link_id) {
+	return sub_stream->underlying_stream_graph->links.links[link_id];
+}
+
+typedef struct {
+	NodeId node_to_get_neighbours;
+	size_t current_neighbour;
+} SS_NeighboursOfNodeIteratorData;
+
+size_t SubStream_NeighboursOfNode_next(LinksIterator* iter) {
+	SS_NeighboursOfNodeIteratorData* iterator_data = (SS_NeighboursOfNodeIteratorData*)iter->iterator_data;
+	SubStream* sub_stream = (SubStream*)iter->stream_graph.stream;
+	TemporalNode* node = &sub_stream->underlying_stream_graph->nodes.nodes[iterator_data->node_to_get_neighbours];
+	while (iterator_data->current_neighbour < node->nb_neighbours) {
+		size_t link = node->neighbours[iterator_data->current_neighbour];
+		iterator_data->current_neighbour++;
+		if (RoaringBitmap_contains(&sub_stream->links_present, link)) {
+			return link;
+		}
+	}
+	return SIZE_MAX;
+}
+
+void SubStream_NeighboursOfNodeIterator_destroy(LinksIterator* iterator) {
+	free(iterator->iterator_data);
+}
+
+LinksIterator SubStream_neighbours_of_node(SubStream* sub_stream, NodeId node) {
+	SS_NeighboursOfNodeIteratorData* iterator_data = MALLOC(sizeof(SS_NeighboursOfNodeIteratorData));
+	*iterator_data = (SS_NeighboursOfNodeIteratorData){
+		.node_to_get_neighbours = node,
+		.current_neighbour = 0,
+	};
+	Stream stream = {.type = SUB_STREAM, .stream = sub_stream};
+	LinksIterator neighbours_iterator = {
+		.stream_graph = stream,
+		.iterator_data = iterator_data,
+		.next = (size_t(*)(void*))SubStream_NeighboursOfNode_next,
+		.destroy = (void (*)(void*))SubStream_NeighboursOfNodeIterator_destroy,
+	};
+	return neighbours_iterator;
+}
+
+const StreamFunctions SubStream_stream_functions = {
+	.nodes_set = (NodesIterator(*)(void*))SubStream_nodes_set,
+	.links_set = (LinksIterator(*)(void*))SubStream_links_set,
+	.lifespan = (Interval(*)(void*))SubStream_lifespan,
+	.scaling = (size_t(*)(void*))SubStream_scaling,
+	.nodes_present_at_t = (NodesIterator(*)(void*, TimeId))SubStream_nodes_present_at_t,
+	.links_present_at_t = (LinksIterator(*)(void*, TimeId))SubStream_links_present_at_t,
+	.times_node_present = (TimesIterator(*)(void*, NodeId))SubStream_times_node_present,
+	.times_link_present = (TimesIterator(*)(void*, LinkId))SubStream_times_link_present,
+	.nth_link = (Link(*)(void*, size_t))SubStream_nth_link,
+	.neighbours_of_node = (LinksIterator(*)(void*, NodeId))SubStream_neighbours_of_node,
+};
+
+// The metrics below are sums over the disjoint windows, computed from the values cached in each chunk, so that they
+// are only computed once per chunk even when the chunk is also used on its own or in other SubStreams.
+
+size_t SubStream_cardinalOfT(SubStream* sub_stream) {
+	size_t sum = 0;
+	for (size_t i = 0; i < sub_stream->nb_chunks; i++) {
+		sum += cardinalOfT(&sub_stream->chunks[i]);
+	}
+	return sum;
+}
+
+size_t SubStream_cardinalOfV(SubStream* sub_stream) {
+	return RoaringBitmap_cardinality(&sub_stream->nodes_present);
+}
+
+size_t SubStream_cardinalOfW(SubStream* sub_stream) {
+	size_t sum = 0;
+	for (size_t i = 0; i < sub_stream->nb_chunks; i++) {
+		sum += cardinalOfW(&sub_stream->chunks[i]);
+	}
+	return sum;
+}
+
+size_t SubStream_cardinalOfE(SubStream* sub_stream) {
+	size_t sum = 0;
+	for (size_t i = 0; i < sub_stream->nb_chunks; i++) {
+		sum += cardinalOfE(&sub_stream->chunks[i]);
+	}
+	return sum;
+}
+
+// Sums element-wise the arrays of the memo tables of the chunks
+static MemoValue sum_of_chunks_arrays(SubStream* sub_stream, MemoKey key) {
+	MemoValue* chunks_values = MALLOC((sub_stream->nb_chunks + 1) * sizeof(MemoValue));
+	size_t nb_values = 0;
+	for (size_t i = 0; i < sub_stream->nb_chunks; i++) {
+		chunks_values[i] = Stream_memo_acquire_metric(&sub_stream->chunks[i], key);
+		if (chunks_values[i].nb_values > nb_values) {
+			nb_values = chunks_values[i].nb_values;
+		}
+	}
+	MemoValue sum = {.nb_values = nb_values, .values = calloc(nb_values + 1, sizeof(size_t))};
+	for (size_t i = 0; i < sub_stream->nb_chunks; i++) {
+		for (size_t j = 0; j < chunks_values[i].nb_values; j++) {
+			sum.values[j] += chunks_values[i].values[j];
+		}
+		Stream_memo_release(&sub_stream->chunks[i], key, chunks_values[i]);
+	}
+	free(chunks_values);
+	return sum;
+}
+
+MemoValue SubStream_times_node_present_array(SubStream* sub_stream) {
+	return sum_of_chunks_arrays(sub_stream, MEMO_TIMES_NODE_PRESENT);
+}
+
+MemoValue SubStream_times_link_present_array(SubStream* sub_stream) {
+	return sum_of_chunks_arrays(sub_stream, MEMO_TIMES_LINK_PRESENT);
+}
+
+// The links times of the whole SubStream are not needed, the ones of each chunk are in its own memo table
+MemoValue SubStream_degree_sums(SubStream* sub_stream, MemoValue links_times) {
+	(void)links_times;
+	return sum_of_chunks_arrays(sub_stream, MEMO_DEGREE_SUMS);
+}
+
+const MetricsFunctions SubStream_metrics_functions = {
+	.cardinalOfW = (size_t(*)(void*))SubStream_cardinalOfW,
+	.cardinalOfT = (size_t(*)(void*))SubStream_cardinalOfT,
+	.cardinalOfV = (size_t(*)(void*))SubStream_cardinalOfV,
+	.coverage = NULL,
+	.node_duration = NULL,
+	.density = NULL,
+	.cardinalOfE = (size_t(*)(void*))SubStream_cardinalOfE,
+	.times_node_present = (MemoValue(*)(void*))SubStream_times_node_present_array,
+	.times_link_present = (MemoValue(*)(void*))SubStream_times_link_present_array,
+	.degree_sums = (MemoValue(*)(void*, MemoValue))SubStream_degree_sums,
+	// A chunk only computes the intersections of its own links, while the nodes of a link of the SubStream can also
+	// meet in the pieces that do not select it
+	.nodes_intersection_of_links = NULL,
+};
\ No newline at end of file
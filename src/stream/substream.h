@@ -1,7 +1,21 @@
 #ifndef SUB_STREAM_H
 #define SUB_STREAM_H
 
+/**
+ * @file substream.h
+ * @brief A Stream made of several chunks of a StreamGraph over disjoint time windows.
+ *
+ * Each chunk is a ChunkStream, a set of nodes and links restricted to a time window, and the SubStream is their union.
+ * It allows to study a pattern recurring over several periods, like every morning of a week, without copying the
+ * presences of the StreamGraph.
+ * <br>
+ * Since the windows are disjoint, the presence of a node or link is the concatenation of its presences in the chunks.
+ * The metrics summing presence times over the Stream are therefore the sums of the ones of the chunks, and reuse the
+ * values cached and memoized in each chunk.
+ */
+
 #include "../metrics.h"
+#include "../roaring_bitmap.h"
 #include "../stream_functions.h"
 #include "../stream_graph.h"
 #include "chunk_stream.h"
@@ -10,9 +24,20 @@
 typedef struct {
 	StreamGraph* underlying_stream_graph;
 	size_t nb_chunks;
-	ChunkStream* chunks;
+	Stream* chunks;				 /**< The ChunkStreams, sorted by the start of their window. */
+	RoaringBitmap nodes_present; /**< The union of the nodes of the chunks. */
+	RoaringBitmap links_present; /**< The union of the links of the chunks. */
 } SubStream;
 
+/**
+ * @brief A piece of a SubStream : the nodes and links present during a time window.
+ */
+typedef struct {
+	NodeIdVector* nodes;
+	LinkIdVector* links;
+	Interval window;
+} SubStreamPiece;
+
 typedef struct {
 	size_t id;
 	IntervalsSet presence;
@@ -23,4 +48,26 @@ typedef struct {
 	ClusterNode* nodes;
 } Cluster;
 
+/**
+ * @brief Creates a SubStream from pieces of a StreamGraph.
+ *
+ * Each piece becomes a ChunkStream, so like for CS_from, a link is only kept in a piece if both its nodes are.
+ * The pieces may be given in any order, but their windows must not overlap.
+ * Must be freed with SubStream_destroy.
+ * @param[in] stream_graph The StreamGraph.
+ * @param[in] nb_pieces The number of pieces.
+ * @param[in] pieces The pieces. The vectors are not modified and can be freed after the call.
+ * @return The SubStream.
+ */
+Stream SubStream_from(StreamGraph* stream_graph, size_t nb_pieces, const SubStreamPiece* pieces);
+
+/**
+ * @brief Frees a SubStream and its chunks.
+ * @param[in] stream The SubStream.
+ */
+void SubStream_destroy(Stream stream);
+
+extern const StreamFunctions SubStream_stream_functions;
+extern const MetricsFunctions SubStream_metrics_functions;
+
 #endif // SUB_STREAM_H
\ No newline at end of file
@@ -0,0 +1,324 @@
+#include "window_stream.h"
+#include "../induced_graph.h"
+#include "full_stream_graph.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Adds the presences between the instant of the cursor and the given one to its integrals
+static void TimelineCursor_integrate(TimelineCursor* cursor, TimeId instant) {
+	if (instant <= cursor->instant) {
+		return;
+	}
+	size_t duration = instant - cursor->instant;
+	cursor->nodes_integral += cursor->nb_nodes * duration;
+	cursor->links_integral += cursor->nb_links * duration;
+	cursor->pairs_integral += cursor->nb_nodes * (cursor->nb_nodes - 1) / 2 * duration;
+	cursor->instant = instant;
+}
+
+// Applies the events up to the instant. The end of the window stops before the events at the instant, since the
+// intervals starting there don't overlap the window, and the start applies them, since the intervals ending there
+// don't overlap it either. Each interval is thus counted in the overlaps from when the end passes its start, until the
+// start reaches its end.
+static void WindowStream_advance(WindowStream* window_stream, TimelineCursor* cursor, TimeId instant, bool is_end) {
+	const Timeline* timeline = &window_stream->timeline;
+	while (cursor->next_event < timeline->nb_events) {
+		TimelineEvent event = timeline->events[cursor->next_event];
+		if (is_end ? event.instant >= instant : event.instant > instant) {
+			break;
+		}
+		TimelineCursor_integrate(cursor, event.instant);
+		switch (event.kind) {
+			case NODE_APPEARANCE:
+				cursor->nb_nodes++;
+				if (is_end && window_stream->nodes_overlaps[event.id]++ == 0) {
+					window_stream->nb_nodes_present++;
+				}
+				break;
+			case NODE_DISAPPEARANCE:
+				cursor->nb_nodes--;
+				if (!is_end && --window_stream->nodes_overlaps[event.id] == 0) {
+					window_stream->nb_nodes_present--;
+				}
+				break;
+			case LINK_APPEARANCE:
+				cursor->nb_links++;
+				if (is_end) {
+					window_stream->links_overlaps[event.id]++;
+				}
+				break;
+			case LINK_DISAPPEARANCE:
+				cursor->nb_links--;
+				if (!is_end) {
+					window_stream->links_overlaps[event.id]--;
+				}
+				break;
+		}
+		cursor->next_event++;
+	}
+	TimelineCursor_integrate(cursor, instant);
+}
+
+Stream WindowStream_from(StreamGraph* stream_graph, Interval window) {
+	Stream full_stream_graph = FullStreamGraph_from(stream_graph);
+	WindowStream* window_stream = MALLOC(sizeof(WindowStream));
+	*window_stream = (WindowStream){
+		.underlying_stream_graph = stream_graph,
+		.timeline = Timeline_from(&full_stream_graph),
+		.start = {0},
+		.end = {0},
+		.nodes_overlaps = calloc(stream_graph->nodes.nb_nodes + 1, sizeof(size_t)),
+		.links_overlaps = calloc(stream_graph->links.nb_links + 1, sizeof(size_t)),
+		.nb_nodes_present = 0,
+		.clip = {.underlying_stream_graph = stream_graph, .snapshot = Interval_from(0, 0)},
+	};
+	FullStreamGraph_destroy(full_stream_graph);
+
+	Stream stream = {
+		.type = WINDOW_STREAM,
+		.stream = window_stream,
+		.stream_functions = &WindowStream_stream_functions,
+		.metrics_functions = &WindowStream_metrics_functions,
+	};
+	init_cache(&stream);
+	WindowStream_move_to(&stream, window);
+	return stream;
+}
+
+void WindowStream_destroy(Stream stream) {
+	destroy_cache(stream);
+	WindowStream* window_stream = (WindowStream*)stream.stream;
+	Timeline_destroy(window_stream->timeline);
+	free(window_stream->nodes_overlaps);
+	free(window_stream->links_overlaps);
+	free(window_stream);
+}
+
+void WindowStream_move_to(Stream* stream, Interval window) {
+	WindowStream* window_stream = (WindowStream*)stream->stream;
+	Interval current = window_stream->clip.snapshot;
+	if (window.start > window.end || window.start < current.start || window.end < current.end) {
+		fprintf(stderr, "Could not move the window [%zu, %zu[ to [%zu, %zu[, it can only move forward\n",
+				current.start, current.end, window.start, window.end);
+		exit(1);
+	}
+	// The end first, so that the start never passes the end of an interval the end didn't see start
+	WindowStream_advance(window_stream, &window_stream->end, window.end, true);
+	WindowStream_advance(window_stream, &window_stream->start, window.start, false);
+	window_stream->clip.snapshot = window;
+	Stream_invalidate_cache(stream);
+}
+
+void WindowStream_slide(Stream* stream, size_t step) {
+	Interval window = WindowStream_window(stream);
+	WindowStream_move_to(stream, Interval_from(window.start + step, window.end + step));
+}
+
+Interval WindowStream_window(Stream* stream) {
+	return ((WindowStream*)stream->stream)->clip.snapshot;
+}
+
+typedef struct {
+	size_t next_id;
+} WS_SetIteratorData;
+
+// The next id whose overlap count is not 0
+static size_t WS_next_overlapping(WS_SetIteratorData* iterator_data, const size_t* overlaps, size_t nb_ids) {
+	while (iterator_data->next_id < nb_ids) {
+		size_t id = iterator_data->next_id++;
+		if (overlaps[id] > 0) {
+			return id;
+		}
+	}
+	return SIZE_MAX;
+}
+
+size_t WS_NodesSet_next(NodesIterator* iter) {
+	WindowStream* window_stream = (WindowStream*)iter->stream_graph.stream;
+	return WS_next_overlapping((WS_SetIteratorData*)iter->iterator_data, window_stream->nodes_overlaps,
+							   window_stream->underlying_stream_graph->nodes.nb_nodes);
+}
+
+size_t WS_LinksSet_next(LinksIterator* iter) {
+	WindowStream* window_stream = (WindowStream*)iter->stream_graph.stream;
+	return WS_next_overlapping((WS_SetIteratorData*)iter->iterator_data, window_stream->links_overlaps,
+							   window_stream->underlying_stream_graph->links.nb_links);
+}
+
+void WS_SetIterator_destroy(NodesIterator* iterator) {
+	free(iterator->iterator_data);
+}
+
+NodesIterator WindowStream_nodes_set(WindowStream* window_stream) {
+	WS_SetIteratorData* iterator_data = MALLOC(sizeof(WS_SetIteratorData));
+	iterator_data->next_id = 0;
+	Stream stream = {.type = WINDOW_STREAM, .stream = window_stream};
+	NodesIterator nodes_iterator = {
+		.stream_graph = stream,
+		.iterator_data = iterator_data,
+		.next = (size_t(*)(void*))WS_NodesSet_next,
+		.destroy = (void (*)(void*))WS_SetIterator_destroy,
+	};
+	return nodes_iterator;
+}
+
+LinksIterator WindowStream_links_set(WindowStream* window_stream) {
+	WS_SetIteratorData* iterator_data = MALLOC(sizeof(WS_SetIteratorData));
+	iterator_data->next_id = 0;
+	Stream stream = {.type = WINDOW_STREAM, .stream = window_stream};
+	LinksIterator links_iterator = {
+		.stream_graph = stream,
+		.iterator_data = iterator_data,
+		.next = (size_t(*)(void*))WS_LinksSet_next,
+		.destroy = (void (*)(void*))WS_SetIterator_destroy,
+	};
+	return links_iterator;
+}
+
+Interval WindowStream_lifespan(WindowStream* window_stream) {
+	return window_stream->clip.snapshot;
+}
+
+size_t WindowStream_scaling(WindowStream* window_stream) {
+	return window_stream->underlying_stream_graph->scaling;
+}
+
+size_t WS_Empty_next(NodesIterator* iter) {
+	(void)iter;
+	return SIZE_MAX;
+}
+
+void WS_Empty_destroy(NodesIterator* iterator) {
+	(void)iterator;
+}
+
+// Every node present at an instant of the window overlaps it, so the nodes present are the ones of the StreamGraph,
+// read from its EventsTable at the last key moment before the instant
+NodesIterator WindowStream_nodes_present_at_t(WindowStream* window_stream, TimeId instant) {
+	if (Interval_contains(window_stream->clip.snapshot, instant)) {
+		return get_nodes_present_at_t(window_stream->underlying_stream_graph, instant);
+	}
+	Stream stream = {.type = WINDOW_STREAM, .stream = window_stream};
+	NodesIterator nodes_iterator = {
+		.stream_graph = stream,
+		.iterator_data = NULL,
+		.next = (size_t(*)(void*))WS_Empty_next,
+		.destroy = (void (*)(void*))WS_Empty_destroy,
+	};
+	return nodes_iterator;
+}
+
+LinksIterator WindowStream_links_present_at_t(WindowStream* window_stream, TimeId instant) {
+	if (Interval_contains(window_stream->clip.snapshot, instant)) {
+		return get_links_present_at_t(window_stream->underlying_stream_graph, instant);
+	}
+	Stream stream = {.type = WINDOW_STREAM, .stream = window_stream};
+	LinksIterator links_iterator = {
+		.stream_graph = stream,
+		.iterator_data = NULL,
+		.next = (size_t(*)(void*))WS_Empty_next,
+		.destroy = (void (*)(void*))WS_Empty_destroy,
+	};
+	return links_iterator;
+}
+
+TimesIterator WindowStream_times_node_present(WindowStream* window_stream, NodeId node) {
+	return ChunkStream_stream_functions.times_node_present(&window_stream->clip, node);
+}
+
+TimesIterator WindowStream_times_link_present(WindowStream* window_stream, LinkId link) {
+	return ChunkStream_stream_functions.times_link_present(&window_stream->clip, link);
+}
+
+Link WindowStream_nth_link(WindowStream* window_stream, size_t link_id) {
+	return window_stream->underlying_stream_graph->links.links[link_id];
+}
+
+typedef struct {
+	NodeId node_to_get_neighbours;
+	size_t current_neighbour;
+} WS_NeighboursOfNodeIteratorData;
+
+size_t WindowStream_NeighboursOfNode_next(LinksIterator* iter) {
+	WS_NeighboursOfNodeIteratorData* iterator_data = (WS_NeighboursOfNodeIteratorData*)iter->iterator_data;
+	WindowStream* window_stream = (WindowStream*)iter->stream_graph.stream;
+	TemporalNode* node = &window_stream->underlying_stream_graph->nodes.nodes[iterator_data->node_to_get_neighbours];
+	while (iterator_data->current_neighbour < node->nb_neighbours) {
+		size_t link = node->neighbours[iterator_data->current_neighbour];
+		iterator_data->current_neighbour++;
+		if (window_stream->links_overlaps[link] > 0) {
+			return link;
+		}
+	}
+	return SIZE_MAX;
+}
+
+void WindowStream_NeighboursOfNodeIterator_destroy(LinksIterator* iterator) {
+	free(iterator->iterator_data);
+}
+
+LinksIterator WindowStream_neighbours_of_node(WindowStream* window_stream, NodeId node) {
+	WS_NeighboursOfNodeIteratorData* iterator_data = MALLOC(sizeof(WS_NeighboursOfNodeIteratorData));
+	*iterator_data = (WS_NeighboursOfNodeIteratorData){
+		.node_to_get_neighbours = node,
+		.current_neighbour = 0,
+	};
+	Stream stream = {.type = WINDOW_STREAM, .stream = window_stream};
+	LinksIterator neighbours_iterator = {
+		.stream_graph = stream,
+		.iterator_data = iterator_data,
+		.next = (size_t(*)(void*))WindowStream_NeighboursOfNode_next,
+		.destroy = (void (*)(void*))WindowStream_NeighboursOfNodeIterator_destroy,
+	};
+	return neighbours_iterator;
+}
+
+const StreamFunctions WindowStream_stream_functions = {
+	.nodes_set = (NodesIterator(*)(void*))WindowStream_nodes_set,
+	.links_set = (LinksIterator(*)(void*))WindowStream_links_set,
+	.lifespan = (Interval(*)(void*))WindowStream_lifespan,
+	.scaling = (size_t(*)(void*))WindowStream_scaling,
+	.nodes_present_at_t = (NodesIterator(*)(void*, TimeId))WindowStream_nodes_present_at_t,
+	.links_present_at_t = (LinksIterator(*)(void*, TimeId))WindowStream_links_present_at_t,
+	.times_node_present = (TimesIterator(*)(void*, NodeId))WindowStream_times_node_present,
+	.times_link_present = (TimesIterator(*)(void*, LinkId))WindowStream_times_link_present,
+	.nth_link = (Link(*)(void*, size_t))WindowStream_nth_link,
+	.neighbours_of_node = (LinksIterator(*)(void*, NodeId))WindowStream_neighbours_of_node,
+};
+
+size_t WindowStream_cardinalOfW(WindowStream* window_stream) {
+	return window_stream->end.nodes_integral - window_stream->start.nodes_integral;
+}
+
+size_t WindowStream_cardinalOfT(WindowStream* window_stream) {
+	return Interval_size(window_stream->clip.snapshot);
+}
+
+size_t WindowStream_cardinalOfV(WindowStream* window_stream) {
+	return window_stream->nb_nodes_present;
+}
+
+size_t WindowStream_cardinalOfE(WindowStream* window_stream) {
+	return window_stream->end.links_integral - window_stream->start.links_integral;
+}
+
+// The denominator is Σ_t C(|V_t|, 2) over the window, like for the other Streams
+double WindowStream_density(WindowStream* window_stream) {
+	size_t pairs = window_stream->end.pairs_integral - window_stream->start.pairs_integral;
+	return (double)WindowStream_cardinalOfE(window_stream) / (double)pairs;
+}
+
+const MetricsFunctions WindowStream_metrics_functions = {
+	.cardinalOfW = (size_t(*)(void*))WindowStream_cardinalOfW,
+	.cardinalOfT = (size_t(*)(void*))WindowStream_cardinalOfT,
+	.cardinalOfV = (size_t(*)(void*))WindowStream_cardinalOfV,
+	.coverage = NULL,
+	.node_duration = NULL,
+	.density = (double (*)(void*))WindowStream_density,
+	.cardinalOfE = (size_t(*)(void*))WindowStream_cardinalOfE,
+	.times_node_present = NULL,
+	.times_link_present = NULL,
+	.degree_sums = NULL,
+	.nodes_intersection_of_links = NULL,
+};
\ No newline at end of file
@@ -0,0 +1,93 @@
+#ifndef WINDOW_STREAM_H
+#define WINDOW_STREAM_H
+
+/**
+ * @file window_stream.h
+ * @brief A Stream of the nodes and links of a StreamGraph during a time window which slides forward.
+ *
+ * Monitoring a metric over a sliding window with a new ChunkStream per window costs a pass over every node and link
+ * at each step. Instead, a WindowStream keeps two cursors in the Timeline of the StreamGraph, at the start and at the
+ * end of the window. Moving the window forward only applies the events the cursors cross, which update :
+ * - the integrals over time of the number of nodes, of links and of pairs of nodes present, from which |W|, |E| and
+ *   the denominator of the density are the differences between the two cursors.
+ * - the number of presence intervals of each node and link overlapping the window, from which |V| is maintained.
+ * <br>
+ * The nodes and links of the Stream are the ones present at some point of the window. Its cardinals and density are
+ * therefore read in O(1), and a move costs O(events crossed). The other metrics go through the generic path, and the
+ * values of the memo table are invalidated at each move.
+ */
+
+#include "../metrics.h"
+#include "../stream_functions.h"
+#include "../stream_graph.h"
+#include "../timeline.h"
+#include "chunk_stream.h"
+#include <stddef.h>
+
+/**
+ * @brief A position in the Timeline, with the integrals of the presences up to it.
+ */
+typedef struct {
+	size_t next_event;	   /**< The index of the first event not applied yet. */
+	TimeId instant;		   /**< The position of the cursor. */
+	size_t nb_nodes;	   /**< The number of nodes present just before the instant. */
+	size_t nb_links;	   /**< The number of links present just before the instant. */
+	size_t nodes_integral; /**< The integral of the number of nodes present, from the first event to the instant. */
+	size_t links_integral; /**< Same for the number of links present. */
+	size_t pairs_integral; /**< Same for the number of pairs of nodes present. */
+} TimelineCursor;
+
+typedef struct {
+	StreamGraph* underlying_stream_graph;
+	Timeline timeline;
+	TimelineCursor start;	 /**< At the start of the window. */
+	TimelineCursor end;		 /**< At the end of the window. */
+	size_t* nodes_overlaps;	 /**< For each node, the number of its presence intervals overlapping the window. */
+	size_t* links_overlaps;	 /**< For each link, the number of its presence intervals overlapping the window. */
+	size_t nb_nodes_present; /**< The number of nodes with at least one interval overlapping the window. */
+	ChunkStream clip;		 /**< The window as a ChunkStream without nodes, through which the presences are clipped. */
+} WindowStream;
+
+/**
+ * @brief Creates a WindowStream on a StreamGraph.
+ *
+ * Builds the Timeline of the StreamGraph, in O(E log E) for E events, then moves the window to its first position.
+ * Must be freed with WindowStream_destroy.
+ * @param[in] stream_graph The StreamGraph.
+ * @param[in] window The first window.
+ * @return The WindowStream.
+ */
+Stream WindowStream_from(StreamGraph* stream_graph, Interval window);
+
+/**
+ * @brief Frees a WindowStream.
+ * @param[in] stream The WindowStream.
+ */
+void WindowStream_destroy(Stream stream);
+
+/**
+ * @brief Moves the window of a WindowStream forward, and invalidates the cache of the Stream.
+ *
+ * Costs O(number of events between the old and the new window bounds).
+ * @param[in, out] stream The WindowStream.
+ * @param[in] window The new window. Neither its start nor its end may be before the ones of the current window.
+ */
+void WindowStream_move_to(Stream* stream, Interval window);
+
+/**
+ * @brief Slides the window of a WindowStream forward, keeping its length.
+ * @param[in, out] stream The WindowStream.
+ * @param[in] step The duration to slide the window by.
+ */
+void WindowStream_slide(Stream* stream, size_t step);
+
+/**
+ * @brief Returns the current window of a WindowStream.
+ * @param[in] stream The WindowStream.
+ */
+Interval WindowStream_window(Stream* stream);
+
+extern const StreamFunctions WindowStream_stream_functions;
+extern const MetricsFunctions WindowStream_metrics_functions;
+
+#endif // WINDOW_STREAM_H
\ No newline at end of file
@@ -4,7 +4,7 @@
 #include "iterators.h"
 #include "stream_graph/links_set.h"
 
-typedef struct {
+typedef struct StreamFunctions {
 	NodesIterator (*nodes_set)(void*);
 	LinksIterator (*links_set)(void*);
 	Interval (*lifespan)(void*);
@@ -21,27 +21,8 @@ typedef struct {
 
 } StreamFunctions;
 
-#define STREAM_FUNCS(variable, stream_var)                                                                             \
-	({                                                                                                                 \
-		switch ((stream_var)->type) {                                                                                  \
-			case FULL_STREAM_GRAPH: {                                                                                  \
-				(variable) = FullStreamGraph_stream_functions;                                                         \
-				break;                                                                                                 \
-			}                                                                                                          \
-			case LINK_STREAM: {                                                                                        \
-				(variable) = LinkStream_stream_functions;                                                              \
-				break;                                                                                                 \
-			}                                                                                                          \
-			case CHUNK_STREAM: {                                                                                       \
-				(variable) = ChunkStream_stream_functions;                                                             \
-				break;                                                                                                 \
-			}                                                                                                          \
-			case CHUNK_STREAM_SMALL: {                                                                                 \
-				(variable) = ChunkStreamSmall_stream_functions;                                                        \
-				break;                                                                                                 \
-			}                                                                                                          \
-		}                                                                                                              \
-		(variable);                                                                                                    \
-	})
+// Copies the functions of the type of a Stream into the variable.
+// Reading them through stream->stream_functions avoids the copy.
+#define STREAM_FUNCS(variable, stream_var) ((variable) = *(stream_var)->stream_functions)
 
 #endif // STREAM_FUNCTIONS_H
\ No newline at end of file
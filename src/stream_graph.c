@@ -1,3 +1,4 @@
+#include <ctype.h>
 #include <memory.h>
 #include <stdbool.h>
 #include <stddef.h>
@@ -89,6 +90,37 @@ char* get_to_header(const char* str, const char* header) {
 		}                                                                                                              \
 	}
 
+// Reads the number at the start of str, after spaces, and moves str after it. Returns the number of values read.
+// sscanf goes through the whole rest of the string on each call, which makes the parsing of big files quadratic.
+static int scan_size_t(const char** str, size_t* value) {
+	const char* current = *str;
+	while (isspace((unsigned char)*current)) {
+		current++;
+	}
+	if (!isdigit((unsigned char)*current)) {
+		return 0;
+	}
+	size_t number = 0;
+	while (isdigit((unsigned char)*current)) {
+		number = number * 10 + (size_t)(*current - '0');
+		current++;
+	}
+	*value = number;
+	*str = current;
+	return 1;
+}
+
+// Same for a tuple of an event, (sign letter id)
+static int scan_event_tuple(const char* str, char* sign, char* letter, size_t* id) {
+	if (str[0] != '(' || str[1] == '\0' || str[2] != ' ' || str[3] == '\0') {
+		return 0;
+	}
+	*sign = str[1];
+	*letter = str[3];
+	str += 4;
+	return 2 + scan_size_t(&str, id);
+}
+
 // TODO : Make the code better and less unreadable copy pasted code
 StreamGraph StreamGraph_from_string(const char* str) {
 
@@ -142,7 +174,7 @@ StreamGraph StreamGraph_from_string(const char* str) {
 	for (size_t node = 0; node < nb_nodes; node++) {
 		// Parse the node
 		size_t nb_neighbours;
-		nb_scanned = sscanf(str, "%zu\n", &nb_neighbours);
+		nb_scanned = scan_size_t(&str, &nb_neighbours);
 		EXPECTED_NB_SCANNED(1);
 		GO_TO_NEXT_LINE(str);
 		// Allocate the neighbours
@@ -154,7 +186,7 @@ StreamGraph StreamGraph_from_string(const char* str) {
 	for (size_t node = 0; node < nb_nodes; node++) {
 		// Parse the node
 		size_t nb_intervals;
-		nb_scanned = sscanf(str, "%zu\n", &nb_intervals);
+		nb_scanned = scan_size_t(&str, &nb_intervals);
 		EXPECTED_NB_SCANNED(1);
 		GO_TO_NEXT_LINE(str);
 		// Allocate the intervals
@@ -167,7 +199,7 @@ StreamGraph StreamGraph_from_string(const char* str) {
 	for (size_t link = 0; link < nb_links; link++) {
 		// Parse the edge
 		size_t nb_intervals;
-		nb_scanned = sscanf(str, "%zu\n", &nb_intervals);
+		nb_scanned = scan_size_t(&str, &nb_intervals);
 		EXPECTED_NB_SCANNED(1);
 		GO_TO_NEXT_LINE(str);
 		// Allocate the intervals
@@ -178,7 +210,7 @@ StreamGraph StreamGraph_from_string(const char* str) {
 	NEXT_HEADER([[[NumberOfSlices]]]);
 	size_t moments_in_slice;
 	for (size_t i = 0; i < nb_slices; i++) {
-		nb_scanned = sscanf(str, "%zu\n", &moments_in_slice);
+		nb_scanned = scan_size_t(&str, &moments_in_slice);
 		EXPECTED_NB_SCANNED(1);
 		KeyMomentsTable_alloc_slice(&sg.key_moments, i, moments_in_slice);
 		GO_TO_NEXT_LINE(str);
@@ -192,19 +224,18 @@ StreamGraph StreamGraph_from_string(const char* str) {
 		str = strchr(str, '(') + 1;
 		for (size_t j = 0; j < sg.nodes.nodes[node].nb_neighbours; j++) {
 			size_t link;
-			nb_scanned = sscanf(str, "%zu", &link);
+			nb_scanned = scan_size_t(&str, &link);
 			EXPECTED_NB_SCANNED(1);
 			sg.nodes.nodes[node].neighbours[j] = link;
-			while ((*str != '(') && (*str != ' ') && (*str != '\n')) {
-				str++;
-			}
 		}
 	}
 
 	NEXT_HEADER([[[LinksToNodes]]]);
 	for (size_t link = 0; link < nb_links; link++) {
 		size_t node1, node2;
-		sscanf(str, "(%zu %zu)", &node1, &node2);
+		str = strchr(str, '(') + 1;
+		nb_scanned = scan_size_t(&str, &node1) + scan_size_t(&str, &node2);
+		EXPECTED_NB_SCANNED(2);
 		sg.links.links[link].nodes[0] = node1;
 		sg.links.links[link].nodes[1] = node2;
 		GO_TO_NEXT_LINE(str);
@@ -223,14 +254,14 @@ StreamGraph StreamGraph_from_string(const char* str) {
 
 	for (size_t i = 0; i < nb_key_moments; i++) {
 		size_t key_moment;
-		nb_scanned = sscanf(str, "%zu=", &key_moment);
+		nb_scanned = scan_size_t(&str, &key_moment);
 		EXPECTED_NB_SCANNED(1);
 		str = strchr(str, '(') + 1;
 		KeyMomentsTable_push_in_order(&sg.key_moments, key_moment);
 		while (*str != '\n') {
 			char letter, sign;
 			size_t id;
-			nb_scanned = sscanf(str, "(%c %c %zu)", &sign, &letter, &id);
+			nb_scanned = scan_event_tuple(str, &sign, &letter, &id);
 			EXPECTED_NB_SCANNED(3);
 			// TODO : refactor this
 			if (letter == 'N') {
@@ -279,12 +310,19 @@ StreamGraph StreamGraph_from_string(const char* str) {
 	}
 
 	sg.events.nb_events = nb_key_moments;
+	// The events are only filled by init_events_table
+	sg.events.node_events.events = NULL;
+	sg.events.link_events.events = NULL;
 
 	// printf("nb_key_moments: %zu\n", nb_key_moments);
 	// printf("nb_events: %zu\n", sg.events.nb_events);
 
 	NEXT_HEADER([EndOfFile]);
 
+	sg.node_presences = PresenceStore_from_nodes(sg.nodes);
+	sg.link_presences = PresenceStore_from_links(sg.links);
+	sg.time_index = NULL;
+
 	free(key_moments);
 	free(nb_pushed_for_nodes);
 	free(nb_pushed_for_links);
@@ -393,7 +431,7 @@ NumberOfKeyMoments=13
 [[Nodes]]
 [[[NumberOfNeighbours]]]
 2
-2
+3
 2
 1
 [[[NumberOfIntervals]]]
@@ -418,7 +456,7 @@ NumberOfKeyMoments=13
 [[Neighbours]]
 [[[NodesToLinks]]]
 (0 2)
-(1 3)
+(0 1 3)
 (2 3)
 (1)
 [[[LinksToNodes]]]
@@ -1015,7 +1053,10 @@ void StreamGraph_destroy(StreamGraph sg) {
 		free(sg.links.links[i].presence.intervals);
 	}
 	free(sg.links.links);
+	PresenceStore_destroy(sg.node_presences);
+	PresenceStore_destroy(sg.link_presences);
 	KeyMomentsTable_destroy(sg.key_moments);
+	time_index_destroy(&sg);
 
 	// Free the events if they were initialized
 }
@@ -1149,7 +1190,7 @@ void init_events_table(StreamGraph* sg) {
 			size_t start = KeyMomentsTable_find_time_index(&sg->key_moments, interval.start);
 			size_t end = KeyMomentsTable_find_time_index(&sg->key_moments, interval.end);
 			if (end < sg->events.link_events.disappearance_index) {
-				BitArray_set_zero(sg->events.link_events.presence_mask, end);
+				BitArray_set_zero(sg->events.link_events.presence_mask, end - 1);
 			}
 			size_tVector_push(&link_events[start], i);
 			if (end > sg->events.link_events.disappearance_index) {
@@ -1172,16 +1213,16 @@ void init_events_table(StreamGraph* sg) {
 
 	for (size_t i = 1; i < sg->events.node_events.disappearance_index; i++) {
 		if (BitArray_is_zero(sg->events.node_events.presence_mask, i - 1)) {
-			for (int j = i - 2; j >= 0; j--) {
-				if ((j == 0) || (BitArray_is_one(sg->events.node_events.presence_mask, j - 1))) {
-					for (size_t k = 0; k < node_events[j].size; k++) {
-						if (IntervalsSet_contains(sg->nodes.nodes[node_events[j].array[k]].presence,
-												  KeyMomentsTable_nth_key_moment(&sg->key_moments, i))) {
-							size_tVector_push(&node_events[i], node_events[j].array[k]);
-						}
+			// The event just before and the previous ones hold what is present before i, down to the last one
+			// which has deletions, which holds everything present at its time
+			for (size_t j = i; j-- > 0;) {
+				for (size_t k = 0; k < node_events[j].size; k++) {
+					if (IntervalsSet_contains(sg->nodes.nodes[node_events[j].array[k]].presence,
+											  KeyMomentsTable_nth_key_moment(&sg->key_moments, i))) {
+						size_tVector_push(&node_events[i], node_events[j].array[k]);
 					}
 				}
-				else {
+				if (j == 0 || BitArray_is_zero(sg->events.node_events.presence_mask, j - 1)) {
 					break;
 				}
 			}
@@ -1204,16 +1245,16 @@ void init_events_table(StreamGraph* sg) {
 	// Do the same for links
 	for (size_t i = 1; i < sg->events.link_events.disappearance_index; i++) {
 		if (BitArray_is_zero(sg->events.link_events.presence_mask, i - 1)) {
-			for (int j = i - 2; j >= 0; j--) {
-				if ((j == 0) || (BitArray_is_one(sg->events.link_events.presence_mask, j - 1))) {
-					for (size_t k = 0; k < link_events[j].size; k++) {
-						if (IntervalsSet_contains(sg->links.links[link_events[j].array[k]].presence,
-												  KeyMomentsTable_nth_key_moment(&sg->key_moments, i))) {
-							size_tVector_push(&link_events[i], link_events[j].array[k]);
-						}
+			// The event just before and the previous ones hold what is present before i, down to the last one
+			// which has deletions, which holds everything present at its time
+			for (size_t j = i; j-- > 0;) {
+				for (size_t k = 0; k < link_events[j].size; k++) {
+					if (IntervalsSet_contains(sg->links.links[link_events[j].array[k]].presence,
+											  KeyMomentsTable_nth_key_moment(&sg->key_moments, i))) {
+						size_tVector_push(&link_events[i], link_events[j].array[k]);
 					}
 				}
-				else {
+				if (j == 0 || BitArray_is_zero(sg->events.link_events.presence_mask, j - 1)) {
 					break;
 				}
 			}
@@ -1256,4 +1297,23 @@ void events_destroy(StreamGraph* sg) {
 	free(sg->events.link_events.events);
 	BitArray_destroy(sg->events.node_events.presence_mask);
 	BitArray_destroy(sg->events.link_events.presence_mask);
+	sg->events.node_events.events = NULL;
+	sg->events.link_events.events = NULL;
+}
+
+void init_time_index(StreamGraph* sg) {
+	if (sg->time_index != NULL) {
+		return;
+	}
+	sg->time_index = MALLOC(sizeof(TimeIndex));
+	*sg->time_index = TimeIndex_from(&sg->key_moments, &sg->node_presences, &sg->link_presences);
+}
+
+void time_index_destroy(StreamGraph* sg) {
+	if (sg->time_index == NULL) {
+		return;
+	}
+	TimeIndex_destroy(*sg->time_index);
+	free(sg->time_index);
+	sg->time_index = NULL;
 }
\ No newline at end of file
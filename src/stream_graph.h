@@ -11,6 +11,8 @@
 #include "stream_graph/key_moments_table.h"
 #include "stream_graph/links_set.h"
 #include "stream_graph/nodes_set.h"
+#include "stream_graph/presence_store.h"
+#include "stream_graph/time_index.h"
 
 typedef struct {
 	KeyMomentsTable key_moments;
@@ -18,6 +20,9 @@ typedef struct {
 	LinksSet links;
 	EventsTable events;
 	size_t scaling;
+	PresenceStore node_presences; // The same intervals as in nodes, laid out for scans over all nodes
+	PresenceStore link_presences; // The same intervals as in links, laid out for scans over all links
+	TimeIndex* time_index;		  // The aggregates over ranges of time, NULL until built by init_time_index
 } StreamGraph;
 
 StreamGraph StreamGraph_from_string(const char* str);
@@ -28,6 +33,10 @@ size_t StreamGraph_lifespan_begin(StreamGraph* sg);
 size_t StreamGraph_lifespan_end(StreamGraph* sg);
 void init_events_table(StreamGraph* sg);
 void events_destroy(StreamGraph* sg);
+// Builds the TimeIndex of the StreamGraph, which the metrics of the Streams covering all of it then use.
+// It is not built on the fly, since the metrics of several Streams over the same StreamGraph can run concurrently.
+void init_time_index(StreamGraph* sg);
+void time_index_destroy(StreamGraph* sg);
 char* InternalFormat_from_External_str(const char* str);
 
 #endif // STREAM_GRAPH_H
\ No newline at end of file
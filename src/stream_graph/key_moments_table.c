@@ -55,7 +55,11 @@ size_t KeyMomentsTable_first_moment(KeyMomentsTable* kmt) {
 }
 
 size_t KeyMomentsTable_last_moment(KeyMomentsTable* kmt) {
+	// The parser can allocate more slices than needed, so the last ones may be empty
 	size_t last_slice_idx = kmt->nb_slices - 1;
+	while (last_slice_idx > 0 && kmt->slices[last_slice_idx].nb_moments == 0) {
+		last_slice_idx--;
+	}
 	size_t last_moment_idx = kmt->slices[last_slice_idx].nb_moments - 1;
 	size_t last_moment = kmt->slices[last_slice_idx].moments[last_moment_idx] + (last_slice_idx * SLICE_SIZE);
 	return last_moment;
@@ -104,4 +108,30 @@ size_t KeyMomentsTable_find_time_index(KeyMomentsTable* kmt, TimeId t) {
 
 	// return the index where the time should be inserted
 	return index + left;
+}
+
+// The number of key moments at or before t, so that the last of them is the one whose nodes and links are present at t
+size_t KeyMomentsTable_nb_moments_until(KeyMomentsTable* kmt, TimeId t) {
+	size_t slice = t / SLICE_SIZE;
+	size_t index = 0;
+	for (size_t i = 0; i < slice && i < kmt->nb_slices; i++) {
+		index += kmt->slices[i].nb_moments;
+	}
+	if (slice >= kmt->nb_slices) {
+		return index;
+	}
+	// The moments of the slice at or before the time are the ones before the first one after it
+	size_t relative_time = t % SLICE_SIZE;
+	size_t left = 0;
+	size_t right = kmt->slices[slice].nb_moments;
+	while (left < right) {
+		size_t mid = (left + right) / 2;
+		if (kmt->slices[slice].moments[mid] <= relative_time) {
+			left = mid + 1;
+		}
+		else {
+			right = mid;
+		}
+	}
+	return index + left;
 }
\ No newline at end of file
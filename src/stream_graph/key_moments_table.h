@@ -1,3 +1,6 @@
+#ifndef KEY_MOMENTS_TABLE_H
+#define KEY_MOMENTS_TABLE_H
+
 #include "../units.h"
 #include <stddef.h>
 #include <stdint.h>
@@ -29,4 +32,7 @@ void KeyMomentsTable_alloc_slice(KeyMomentsTable* kmt, size_t slice, size_t nb_m
 size_t KeyMomentsTable_first_moment(KeyMomentsTable* kmt);
 size_t KeyMomentsTable_last_moment(KeyMomentsTable* kmt);
 void KeyMomentsTable_destroy(KeyMomentsTable kmt);
-size_t KeyMomentsTable_find_time_index(KeyMomentsTable* kmt, TimeId t);
\ No newline at end of file
+size_t KeyMomentsTable_find_time_index(KeyMomentsTable* kmt, TimeId t);
+size_t KeyMomentsTable_nb_moments_until(KeyMomentsTable* kmt, TimeId t);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "presence_store.h"
+#include "../utils.h"
+#include <stddef.h>
+
+static PresenceStore PresenceStore_alloc(size_t nb_ids, size_t nb_intervals) {
+	size_t* block = MALLOC((nb_ids + 1 + 2 * nb_intervals) * sizeof(size_t));
+	PresenceStore store = {
+		.nb_ids = nb_ids,
+		.offsets = block,
+		.starts = block + nb_ids + 1,
+		.ends = block + nb_ids + 1 + nb_intervals,
+	};
+	return store;
+}
+
+static void PresenceStore_write(PresenceStore* store, size_t id, IntervalsSet presence) {
+	size_t offset = store->offsets[id];
+	for (size_t i = 0; i < presence.nb_intervals; i++) {
+		store->starts[offset + i] = presence.intervals[i].start;
+		store->ends[offset + i] = presence.intervals[i].end;
+	}
+	store->offsets[id + 1] = offset + presence.nb_intervals;
+}
+
+PresenceStore PresenceStore_from_nodes(TemporalNodesSet nodes) {
+	size_t nb_intervals = 0;
+	for (size_t i = 0; i < nodes.nb_nodes; i++) {
+		nb_intervals += nodes.nodes[i].presence.nb_intervals;
+	}
+	PresenceStore store = PresenceStore_alloc(nodes.nb_nodes, nb_intervals);
+	store.offsets[0] = 0;
+	for (size_t i = 0; i < nodes.nb_nodes; i++) {
+		PresenceStore_write(&store, i, nodes.nodes[i].presence);
+	}
+	return store;
+}
+
+PresenceStore PresenceStore_from_links(LinksSet links) {
+	size_t nb_intervals = 0;
+	for (size_t i = 0; i < links.nb_links; i++) {
+		nb_intervals += links.links[i].presence.nb_intervals;
+	}
+	PresenceStore store = PresenceStore_alloc(links.nb_links, nb_intervals);
+	store.offsets[0] = 0;
+	for (size_t i = 0; i < links.nb_links; i++) {
+		PresenceStore_write(&store, i, links.links[i].presence);
+	}
+	return store;
+}
+
+void PresenceStore_destroy(PresenceStore store) {
+	free(store.offsets);
+}
+
+// Sum of the ends minus sum of the starts, which wraps around the same way as the sum of the sizes.
+// Two plain reductions over contiguous arrays, which gcc vectorises.
+size_t PresenceStore_total_time(const PresenceStore* store) {
+	size_t nb_intervals = store->offsets[store->nb_ids];
+	size_t sum_ends = 0;
+	size_t sum_starts = 0;
+	for (size_t i = 0; i < nb_intervals; i++) {
+		sum_ends += store->ends[i];
+	}
+	for (size_t i = 0; i < nb_intervals; i++) {
+		sum_starts += store->starts[i];
+	}
+	return sum_ends - sum_starts;
+}
\ No newline at end of file
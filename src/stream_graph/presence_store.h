@@ -0,0 +1,49 @@
+#ifndef STREAM_GRAPH_PRESENCE_STORE_H
+#define STREAM_GRAPH_PRESENCE_STORE_H
+
+#include "../interval.h"
+#include "../units.h"
+#include "links_set.h"
+#include "nodes_set.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// The presence intervals of every node, or of every link, of a StreamGraph, stored as a structure of arrays.
+// The intervals of id are at [offsets[id], offsets[id + 1][ in starts and ends, in the same order as in its IntervalsSet.
+// Scanning them reads two contiguous arrays, instead of one small allocation per node or link.
+// The offsets, starts and ends share a single allocation, owned by offsets.
+typedef struct {
+	size_t nb_ids;
+	size_t* offsets;
+	TimeId* starts;
+	TimeId* ends;
+} PresenceStore;
+
+PresenceStore PresenceStore_from_nodes(TemporalNodesSet nodes);
+PresenceStore PresenceStore_from_links(LinksSet links);
+void PresenceStore_destroy(PresenceStore store);
+
+// Total time of all the intervals of the store, of all ids
+size_t PresenceStore_total_time(const PresenceStore* store);
+
+// Total time of the intervals of an id
+static inline size_t PresenceStore_time_of(const PresenceStore* store, size_t id) {
+	size_t sum = 0;
+	for (size_t i = store->offsets[id]; i < store->offsets[id + 1]; i++) {
+		sum += store->ends[i] - store->starts[i];
+	}
+	return sum;
+}
+
+// Total time of the intervals of an id inside clip, which must not be reversed
+static inline size_t PresenceStore_time_of_clipped(const PresenceStore* store, size_t id, Interval clip) {
+	size_t sum = 0;
+	for (size_t i = store->offsets[id]; i < store->offsets[id + 1]; i++) {
+		TimeId start = store->starts[i] < clip.start ? clip.start : store->starts[i];
+		TimeId end = store->ends[i] > clip.end ? clip.end : store->ends[i];
+		sum += end > start ? end - start : 0;
+	}
+	return sum;
+}
+
+#endif // STREAM_GRAPH_PRESENCE_STORE_H
\ No newline at end of file
@@ -0,0 +1,184 @@
+#include "time_index.h"
+#include "../utils.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+static TimeIndex TimeIndex_alloc(size_t nb_moments) {
+	size_t* block = MALLOC((9 * nb_moments + 1) * sizeof(size_t));
+	TimeIndex index = {
+		.nb_moments = nb_moments,
+		.moments = block,
+		.nb_nodes = block + nb_moments,
+		.nb_links = block + 2 * nb_moments,
+		.node_time = block + 3 * nb_moments,
+		.link_time = block + 4 * nb_moments,
+		.max_nodes = block + 5 * nb_moments,
+		.max_links = block + 7 * nb_moments,
+	};
+	return index;
+}
+
+// The position of a key moment, which must be one of them
+static size_t moment_index(const TimeIndex* index, TimeId instant) {
+	size_t low = 0;
+	size_t high = index->nb_moments;
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		if (index->moments[middle] < instant) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+// The number of intervals of the store present from each key moment to the next one, from the number of them starting
+// and ending at each key moment
+static void count_present(const TimeIndex* index, const PresenceStore* store, size_t* counts, size_t* nb_ends) {
+	for (size_t i = 0; i < index->nb_moments; i++) {
+		counts[i] = 0;
+		nb_ends[i] = 0;
+	}
+	size_t nb_intervals = store->offsets[store->nb_ids];
+	for (size_t i = 0; i < nb_intervals; i++) {
+		counts[moment_index(index, store->starts[i])]++;
+		nb_ends[moment_index(index, store->ends[i])]++;
+	}
+	size_t nb_present = 0;
+	for (size_t i = 0; i < index->nb_moments; i++) {
+		nb_present += counts[i] - nb_ends[i];
+		counts[i] = nb_present;
+	}
+}
+
+static void build_max_tree(size_t* tree, const size_t* values, size_t nb_values) {
+	memcpy(tree + nb_values, values, nb_values * sizeof(size_t));
+	for (size_t j = nb_values - 1; j > 0; j--) {
+		tree[j] = tree[2 * j] > tree[2 * j + 1] ? tree[2 * j] : tree[2 * j + 1];
+	}
+}
+
+TimeIndex TimeIndex_from(KeyMomentsTable* key_moments, const PresenceStore* node_presences,
+						 const PresenceStore* link_presences) {
+	size_t nb_moments = 0;
+	for (size_t i = 0; i < key_moments->nb_slices; i++) {
+		nb_moments += key_moments->slices[i].nb_moments;
+	}
+	TimeIndex index = TimeIndex_alloc(nb_moments);
+	if (nb_moments == 0) {
+		return index;
+	}
+	size_t n = 0;
+	for (size_t i = 0; i < key_moments->nb_slices; i++) {
+		for (size_t j = 0; j < key_moments->slices[i].nb_moments; j++) {
+			index.moments[n++] = i * SLICE_SIZE + key_moments->slices[i].moments[j];
+		}
+	}
+
+	// The segment trees are only built at the end, so their space holds the numbers of ends until then
+	count_present(&index, node_presences, index.nb_nodes, index.max_nodes);
+	count_present(&index, link_presences, index.nb_links, index.max_links);
+	index.node_time[0] = 0;
+	index.link_time[0] = 0;
+	for (size_t i = 1; i < nb_moments; i++) {
+		size_t duration = index.moments[i] - index.moments[i - 1];
+		index.node_time[i] = index.node_time[i - 1] + index.nb_nodes[i - 1] * duration;
+		index.link_time[i] = index.link_time[i - 1] + index.nb_links[i - 1] * duration;
+	}
+	build_max_tree(index.max_nodes, index.nb_nodes, nb_moments);
+	build_max_tree(index.max_links, index.nb_links, nb_moments);
+	return index;
+}
+
+void TimeIndex_destroy(TimeIndex index) {
+	free(index.moments);
+}
+
+// The number of key moments at or before the instant, so the segment containing it is the one just before
+static size_t moments_until(const TimeIndex* index, TimeId instant) {
+	size_t low = 0;
+	size_t high = index->nb_moments;
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		if (index->moments[middle] <= instant) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+static size_t count_at(const TimeIndex* index, const size_t* counts, TimeId instant) {
+	size_t nb_moments_until = moments_until(index, instant);
+	return nb_moments_until == 0 ? 0 : counts[nb_moments_until - 1];
+}
+
+size_t TimeIndex_nodes_at(const TimeIndex* index, TimeId instant) {
+	return count_at(index, index->nb_nodes, instant);
+}
+
+size_t TimeIndex_links_at(const TimeIndex* index, TimeId instant) {
+	return count_at(index, index->nb_links, instant);
+}
+
+// The total time before the instant, from the prefix sum of its segment and the part of the segment before it
+static size_t time_before(const TimeIndex* index, const size_t* counts, const size_t* times, TimeId instant) {
+	size_t nb_moments_until = moments_until(index, instant);
+	if (nb_moments_until == 0) {
+		return 0;
+	}
+	size_t segment = nb_moments_until - 1;
+	return times[segment] + counts[segment] * (instant - index->moments[segment]);
+}
+
+static size_t time_inside(const TimeIndex* index, const size_t* counts, const size_t* times, Interval range) {
+	if (range.start >= range.end) {
+		return 0;
+	}
+	return time_before(index, counts, times, range.end) - time_before(index, counts, times, range.start);
+}
+
+size_t TimeIndex_node_time(const TimeIndex* index, Interval range) {
+	return time_inside(index, index->nb_nodes, index->node_time, range);
+}
+
+size_t TimeIndex_link_time(const TimeIndex* index, Interval range) {
+	return time_inside(index, index->nb_links, index->link_time, range);
+}
+
+// The maximum of the segments overlapping the range, from the segment containing its start to the last one starting
+// before its end. Nothing is present before the first key moment, so that segment is left out.
+static size_t max_inside(const TimeIndex* index, const size_t* tree, Interval range) {
+	if (range.start >= range.end) {
+		return 0;
+	}
+	size_t first = moments_until(index, range.start);
+	first = first == 0 ? 0 : first - 1;
+	size_t last = moments_until(index, range.end - 1);
+	size_t max = 0;
+	// Bottom-up over the leaves [first, last[, moving up a level at each step
+	for (size_t low = first + index->nb_moments, high = last + index->nb_moments; low < high; low /= 2, high /= 2) {
+		if (low % 2 == 1) {
+			max = tree[low] > max ? tree[low] : max;
+			low++;
+		}
+		if (high % 2 == 1) {
+			high--;
+			max = tree[high] > max ? tree[high] : max;
+		}
+	}
+	return max;
+}
+
+size_t TimeIndex_max_nodes(const TimeIndex* index, Interval range) {
+	return max_inside(index, index->max_nodes, range);
+}
+
+size_t TimeIndex_max_links(const TimeIndex* index, Interval range) {
+	return max_inside(index, index->max_links, range);
+}
\ No newline at end of file
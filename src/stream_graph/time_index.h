@@ -0,0 +1,45 @@
+#ifndef STREAM_GRAPH_TIME_INDEX_H
+#define STREAM_GRAPH_TIME_INDEX_H
+
+#include "../interval.h"
+#include "../units.h"
+#include "key_moments_table.h"
+#include "presence_store.h"
+#include <stddef.h>
+
+// An index over the key moments of a StreamGraph, which answers aggregates of the nodes and links present over a range
+// of time in O(log K) for K key moments, instead of a scan of all their presence intervals.
+// The same nodes and links are present from a key moment to the next one, so the index stores, for each segment
+// [moments[i], moments[i + 1][, the number of nodes and links present, and the node-time and link-time before
+// moments[i]. The times over a range are the difference of two of these prefix sums, completed inside the segments of
+// its bounds, and the most nodes or links present at once over a range is read from a segment tree over the segments.
+// All the arrays share a single allocation, owned by moments.
+typedef struct {
+	size_t nb_moments;
+	TimeId* moments;   // The key moments, in increasing order
+	size_t* nb_nodes;  // The number of nodes present during the segment i, none after the last key moment
+	size_t* nb_links;  // The number of links present during the segment i, none after the last key moment
+	size_t* node_time; // The total time of the nodes before moments[i]
+	size_t* link_time; // The total time of the links before moments[i]
+	size_t* max_nodes; // Segment tree of nb_nodes, the node j with the children 2j and 2j + 1, leaves from nb_moments
+	size_t* max_links; // Segment tree of nb_links, laid out like max_nodes
+} TimeIndex;
+
+// The key moments must be those of the intervals of the stores
+TimeIndex TimeIndex_from(KeyMomentsTable* key_moments, const PresenceStore* node_presences,
+						 const PresenceStore* link_presences);
+void TimeIndex_destroy(TimeIndex index);
+
+// The number of nodes or links present at an instant
+size_t TimeIndex_nodes_at(const TimeIndex* index, TimeId instant);
+size_t TimeIndex_links_at(const TimeIndex* index, TimeId instant);
+
+// The total time of the nodes or links inside the range
+size_t TimeIndex_node_time(const TimeIndex* index, Interval range);
+size_t TimeIndex_link_time(const TimeIndex* index, Interval range);
+
+// The largest number of nodes or links present at the same instant of the range, 0 if it is empty
+size_t TimeIndex_max_nodes(const TimeIndex* index, Interval range);
+size_t TimeIndex_max_links(const TimeIndex* index, Interval range);
+
+#endif // STREAM_GRAPH_TIME_INDEX_H
\ No newline at end of file
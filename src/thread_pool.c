@@ -0,0 +1,301 @@
+#include "thread_pool.h"
+#include "instrumentation.h"
+#include "utils.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// The chunks a worker owns at the start of a loop. Other workers steal from it by moving the same cursor.
+// Aligned on a cache line so that workers moving their own cursor don't invalidate the others.
+typedef struct {
+	_Alignas(64) atomic_size_t next_chunk;
+	size_t end_chunk;
+} WorkRange;
+
+typedef struct {
+	ThreadPoolTask task;
+	void* context;
+	size_t nb_elements;
+	size_t chunk_size;
+	WorkRange* ranges;
+	size_t nb_ranges;
+#ifdef SGA_INSTRUMENTATION
+	StreamInstrumentation* instrumentation; // Of the caller, so that the iterations of the workers count for its Stream
+#endif
+} ThreadPoolJob;
+
+struct ThreadPool {
+	size_t nb_workers;
+	pthread_t* threads;
+	pthread_mutex_t lock;
+	pthread_cond_t job_available;
+	pthread_cond_t job_done;
+	pthread_mutex_t submit_lock; // Held by the thread whose loop is running on the pool
+	size_t generation;			 // Incremented for each new job so that the workers know when to wake up
+	size_t nb_busy;				 // Number of threads of the pool still working on the current job
+	bool shutting_down;
+	ThreadPoolJob* job;
+};
+
+typedef struct {
+	ThreadPool* pool;
+	size_t worker_index;
+} WorkerArgs;
+
+// Whether the current thread is running a chunk, to run nested loops sequentially instead of deadlocking
+static _Thread_local bool inside_parallel_loop = false;
+
+size_t ThreadPool_nb_chunks(size_t nb_elements, size_t chunk_size) {
+	if (chunk_size == 0) {
+		chunk_size = 1;
+	}
+	return (nb_elements + chunk_size - 1) / chunk_size;
+}
+
+static void run_chunk(ThreadPoolJob* job, size_t chunk) {
+	size_t from = chunk * job->chunk_size;
+	size_t to = from + job->chunk_size;
+	if (to > job->nb_elements) {
+		to = job->nb_elements;
+	}
+	job->task(job->context, chunk, from, to);
+}
+
+// Runs the chunks of the worker's own range, then steals the ones left in the ranges of the other workers
+static void run_job(ThreadPoolJob* job, size_t worker_index) {
+	bool was_inside = inside_parallel_loop;
+	inside_parallel_loop = true;
+#ifdef SGA_INSTRUMENTATION
+	StreamInstrumentation* previous_instrumentation = StreamInstrumentation_current();
+	StreamInstrumentation_set_current(job->instrumentation);
+#endif
+	for (size_t i = 0; i < job->nb_ranges; i++) {
+		WorkRange* range = &job->ranges[(worker_index + i) % job->nb_ranges];
+		size_t chunk;
+		while ((chunk = atomic_fetch_add(&range->next_chunk, 1)) < range->end_chunk) {
+			run_chunk(job, chunk);
+		}
+	}
+#ifdef SGA_INSTRUMENTATION
+	StreamInstrumentation_set_current(previous_instrumentation);
+#endif
+	inside_parallel_loop = was_inside;
+}
+
+static void* worker_main(void* arg) {
+	WorkerArgs args = *(WorkerArgs*)arg;
+	free(arg);
+	ThreadPool* pool = args.pool;
+	size_t seen_generation = 0;
+
+	pthread_mutex_lock(&pool->lock);
+	while (true) {
+		while (!pool->shutting_down && pool->generation == seen_generation) {
+			pthread_cond_wait(&pool->job_available, &pool->lock);
+		}
+		if (pool->shutting_down) {
+			break;
+		}
+		seen_generation = pool->generation;
+		ThreadPoolJob* job = pool->job;
+		pthread_mutex_unlock(&pool->lock);
+
+		run_job(job, args.worker_index);
+
+		pthread_mutex_lock(&pool->lock);
+		pool->nb_busy--;
+		if (pool->nb_busy == 0) {
+			pthread_cond_signal(&pool->job_done);
+		}
+	}
+	pthread_mutex_unlock(&pool->lock);
+	return NULL;
+}
+
+ThreadPool* ThreadPool_create(size_t nb_workers) {
+	if (nb_workers == 0) {
+		long nb_processors = sysconf(_SC_NPROCESSORS_ONLN);
+		nb_workers = nb_processors > 0 ? (size_t)nb_processors : 1;
+	}
+	ThreadPool* pool = MALLOC(sizeof(ThreadPool));
+	*pool = (ThreadPool){
+		.nb_workers = nb_workers,
+		.threads = MALLOC(nb_workers * sizeof(pthread_t)),
+		.generation = 0,
+		.nb_busy = 0,
+		.shutting_down = false,
+		.job = NULL,
+	};
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_mutex_init(&pool->submit_lock, NULL);
+	pthread_cond_init(&pool->job_available, NULL);
+	pthread_cond_init(&pool->job_done, NULL);
+
+	// Worker 0 is the thread calling the parallel loops
+	for (size_t i = 1; i < nb_workers; i++) {
+		WorkerArgs* args = MALLOC(sizeof(WorkerArgs));
+		*args = (WorkerArgs){.pool = pool, .worker_index = i};
+		if (pthread_create(&pool->threads[i], NULL, worker_main, args) != 0) {
+			fprintf(stderr, "Could not create thread %zu of the pool, using only %zu workers\n", i, i);
+			free(args);
+			pool->nb_workers = i;
+			break;
+		}
+	}
+	return pool;
+}
+
+void ThreadPool_destroy(ThreadPool* pool) {
+	if (pool == NULL) {
+		return;
+	}
+	pthread_mutex_lock(&pool->lock);
+	pool->shutting_down = true;
+	pthread_cond_broadcast(&pool->job_available);
+	pthread_mutex_unlock(&pool->lock);
+	for (size_t i = 1; i < pool->nb_workers; i++) {
+		pthread_join(pool->threads[i], NULL);
+	}
+	pthread_mutex_destroy(&pool->lock);
+	pthread_mutex_destroy(&pool->submit_lock);
+	pthread_cond_destroy(&pool->job_available);
+	pthread_cond_destroy(&pool->job_done);
+	free(pool->threads);
+	free(pool);
+}
+
+size_t ThreadPool_nb_workers(ThreadPool* pool) {
+	if (pool == NULL) {
+		return 1;
+	}
+	return pool->nb_workers;
+}
+
+static ThreadPool* global_pool = NULL;
+
+void ThreadPool_set_global_nb_workers(size_t nb_workers) {
+	ThreadPool_destroy(global_pool);
+	global_pool = NULL;
+	if (nb_workers != 1) {
+		global_pool = ThreadPool_create(nb_workers);
+	}
+}
+
+ThreadPool* ThreadPool_global(void) {
+	return global_pool;
+}
+
+void ThreadPool_parallel_for(ThreadPool* pool, size_t nb_elements, size_t chunk_size, ThreadPoolTask task,
+							 void* context) {
+	if (chunk_size == 0) {
+		chunk_size = 1;
+	}
+	size_t nb_chunks = ThreadPool_nb_chunks(nb_elements, chunk_size);
+	ThreadPoolJob job = {
+		.task = task,
+		.context = context,
+		.nb_elements = nb_elements,
+		.chunk_size = chunk_size,
+		.ranges = NULL,
+		.nb_ranges = 0,
+#ifdef SGA_INSTRUMENTATION
+		.instrumentation = StreamInstrumentation_current(),
+#endif
+	};
+
+	bool sequential = pool == NULL || pool->nb_workers <= 1 || nb_chunks <= 1 || inside_parallel_loop;
+	if (sequential || pthread_mutex_trylock(&pool->submit_lock) != 0) {
+		for (size_t chunk = 0; chunk < nb_chunks; chunk++) {
+			run_chunk(&job, chunk);
+		}
+		return;
+	}
+
+	// Give each worker a contiguous range of chunks
+	job.nb_ranges = pool->nb_workers;
+	job.ranges = aligned_alloc(_Alignof(WorkRange), job.nb_ranges * sizeof(WorkRange));
+	size_t chunks_per_range = nb_chunks / job.nb_ranges;
+	size_t remainder = nb_chunks % job.nb_ranges;
+	size_t first_chunk = 0;
+	for (size_t i = 0; i < job.nb_ranges; i++) {
+		size_t end_chunk = first_chunk + chunks_per_range + (i < remainder ? 1 : 0);
+		atomic_init(&job.ranges[i].next_chunk, first_chunk);
+		job.ranges[i].end_chunk = end_chunk;
+		first_chunk = end_chunk;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+	pool->job = &job;
+	pool->nb_busy = pool->nb_workers - 1;
+	pool->generation++;
+	pthread_cond_broadcast(&pool->job_available);
+	pthread_mutex_unlock(&pool->lock);
+
+	run_job(&job, 0);
+
+	pthread_mutex_lock(&pool->lock);
+	while (pool->nb_busy > 0) {
+		pthread_cond_wait(&pool->job_done, &pool->lock);
+	}
+	pool->job = NULL;
+	pthread_mutex_unlock(&pool->lock);
+	pthread_mutex_unlock(&pool->submit_lock);
+	free(job.ranges);
+}
+
+typedef struct {
+	void* context;
+	size_t (*sum_range)(void*, size_t, size_t);
+	double (*sum_range_double)(void*, size_t, size_t);
+	size_t* partial_sums;
+	double* partial_sums_double;
+} SumContext;
+
+static void sum_task(void* context, size_t chunk_index, size_t from, size_t to) {
+	SumContext* sum_context = (SumContext*)context;
+	sum_context->partial_sums[chunk_index] = sum_context->sum_range(sum_context->context, from, to);
+}
+
+static void sum_double_task(void* context, size_t chunk_index, size_t from, size_t to) {
+	SumContext* sum_context = (SumContext*)context;
+	sum_context->partial_sums_double[chunk_index] = sum_context->sum_range_double(sum_context->context, from, to);
+}
+
+size_t ThreadPool_sum(ThreadPool* pool, size_t nb_elements, size_t chunk_size,
+					  size_t (*sum_range)(void* context, size_t from, size_t to), void* context) {
+	size_t nb_chunks = ThreadPool_nb_chunks(nb_elements, chunk_size);
+	SumContext sum_context = {
+		.context = context,
+		.sum_range = sum_range,
+		.partial_sums = MALLOC((nb_chunks + 1) * sizeof(size_t)),
+	};
+	ThreadPool_parallel_for(pool, nb_elements, chunk_size, sum_task, &sum_context);
+	size_t sum = 0;
+	for (size_t i = 0; i < nb_chunks; i++) {
+		sum += sum_context.partial_sums[i];
+	}
+	free(sum_context.partial_sums);
+	return sum;
+}
+
+double ThreadPool_sum_double(ThreadPool* pool, size_t nb_elements, size_t chunk_size,
+							 double (*sum_range)(void* context, size_t from, size_t to), void* context) {
+	size_t nb_chunks = ThreadPool_nb_chunks(nb_elements, chunk_size);
+	SumContext sum_context = {
+		.context = context,
+		.sum_range_double = sum_range,
+		.partial_sums_double = MALLOC((nb_chunks + 1) * sizeof(double)),
+	};
+	ThreadPool_parallel_for(pool, nb_elements, chunk_size, sum_double_task, &sum_context);
+	double sum = 0;
+	for (size_t i = 0; i < nb_chunks; i++) {
+		sum += sum_context.partial_sums_double[i];
+	}
+	free(sum_context.partial_sums_double);
+	return sum;
+}
\ No newline at end of file
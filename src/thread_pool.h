@@ -0,0 +1,129 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+/**
+ * @file thread_pool.h
+ * @brief A pool of threads to split loops over node or link ids between several workers.
+ *
+ * Since the StreamGraph is read-only, the outer loop of most metrics can be cut into ranges of ids computed
+ * independently. A parallel loop cuts [0, nb_elements[ into chunks of a fixed size, and gives each worker a
+ * contiguous range of chunks. A worker that finishes its own range steals the remaining chunks of the others, so that
+ * uneven chunks (like nodes with many neighbours) don't leave workers idle.
+ * <br>
+ * The chunks only depend on the number of elements and the chunk size, not on the number of workers or on which
+ * worker ran them. Reductions keep one partial result per chunk and combine them in chunk order, so their result is
+ * the same whatever the number of workers, even for floating point sums.
+ * <br>
+ * The thread calling a parallel loop takes part in it as a worker. A parallel loop started from inside another one,
+ * or while the pool is busy with a loop of another thread, runs sequentially on the calling thread.
+ */
+
+#include <stddef.h>
+
+/**
+ * @brief A pool of worker threads. Its content is private to thread_pool.c.
+ */
+typedef struct ThreadPool ThreadPool;
+
+/**
+ * @brief A task run on a chunk of a parallel loop.
+ * @param[in] context The context given to the parallel loop.
+ * @param[in] chunk_index The index of the chunk, from 0 to the number of chunks.
+ * @param[in] from The first element of the chunk.
+ * @param[in] to The element after the last one of the chunk.
+ */
+typedef void (*ThreadPoolTask)(void* context, size_t chunk_index, size_t from, size_t to);
+
+/**
+ * @name Creation and destruction
+ * @{
+ */
+
+/**
+ * @brief Creates a pool of threads.
+ *
+ * Since the calling thread also works during a parallel loop, only nb_workers - 1 threads are created.
+ * Must be freed with ThreadPool_destroy.
+ * @param[in] nb_workers The number of workers. If it is 0, the number of processors online is used.
+ * @return The pool.
+ */
+ThreadPool* ThreadPool_create(size_t nb_workers);
+
+/**
+ * @brief Stops the threads of a pool and frees it. Must not be called during a parallel loop on the pool.
+ * @param[in] pool The pool.
+ */
+void ThreadPool_destroy(ThreadPool* pool);
+
+/**
+ * @brief Returns the number of workers of a pool, 1 if the pool is NULL.
+ * @param[in] pool The pool.
+ */
+size_t ThreadPool_nb_workers(ThreadPool* pool);
+/** @} */
+
+/**
+ * @name Library-level pool
+ * The pool used by the metrics. There is none by default, and the metrics run on a single thread.
+ * @{
+ */
+
+/**
+ * @brief Sets the number of workers of the pool used by the metrics.
+ *
+ * Replaces the previous pool, if any. 1 removes the pool, and 0 uses the number of processors online.
+ * Must not be called while metrics are being computed.
+ * @param[in] nb_workers The number of workers.
+ */
+void ThreadPool_set_global_nb_workers(size_t nb_workers);
+
+/**
+ * @brief Returns the pool used by the metrics, NULL if they run on a single thread.
+ */
+ThreadPool* ThreadPool_global(void);
+/** @} */
+
+/**
+ * @name Parallel loops
+ * All of them accept a NULL pool, in which case they run sequentially on the calling thread.
+ * @{
+ */
+
+/**
+ * @brief Returns the number of chunks a parallel loop cuts its elements into.
+ * @param[in] nb_elements The number of elements.
+ * @param[in] chunk_size The maximum number of elements per chunk.
+ */
+size_t ThreadPool_nb_chunks(size_t nb_elements, size_t chunk_size);
+
+/**
+ * @brief Runs the task on every chunk of [0, nb_elements[, and returns once all of them are done.
+ * @param[in] pool The pool.
+ * @param[in] nb_elements The number of elements.
+ * @param[in] chunk_size The maximum number of elements per chunk.
+ * @param[in] task The task to run on each chunk.
+ * @param[in] context Passed as is to the task.
+ */
+void ThreadPool_parallel_for(ThreadPool* pool, size_t nb_elements, size_t chunk_size, ThreadPoolTask task,
+							 void* context);
+
+/**
+ * @brief Sums the values returned by a function on every chunk of [0, nb_elements[.
+ * @param[in] pool The pool.
+ * @param[in] nb_elements The number of elements.
+ * @param[in] chunk_size The maximum number of elements per chunk.
+ * @param[in] sum_range Returns the sum over the elements [from, to[.
+ * @param[in] context Passed as is to sum_range.
+ * @return The sum over all the elements.
+ */
+size_t ThreadPool_sum(ThreadPool* pool, size_t nb_elements, size_t chunk_size,
+					  size_t (*sum_range)(void* context, size_t from, size_t to), void* context);
+
+/**
+ * @brief Like ThreadPool_sum, but for floating point values. The partial sums are added in the order of the chunks.
+ */
+double ThreadPool_sum_double(ThreadPool* pool, size_t nb_elements, size_t chunk_size,
+							 double (*sum_range)(void* context, size_t from, size_t to), void* context);
+/** @} */
+
+#endif // THREAD_POOL_H
\ No newline at end of file
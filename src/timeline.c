@@ -0,0 +1,84 @@
+#include "timeline.h"
+#include "iterators.h"
+#include "stream/chunk_stream.h"
+#include "stream/chunk_stream_small.h"
+#include "stream/full_stream_graph.h"
+#include "stream/link_stream.h"
+#include "stream_functions.h"
+#include "utils.h"
+#include "vector.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+char* TimelineEvent_to_string(const TimelineEvent* event) {
+	char* str = MALLOC(64);
+	const char* kinds[] = {"- L", "- N", "+ N", "+ L"};
+	snprintf(str, 64, "%zu=(%s %zu)", event->instant, kinds[event->kind], event->id);
+	return str;
+}
+
+bool TimelineEvent_equals(TimelineEvent a, TimelineEvent b) {
+	return a.instant == b.instant && a.kind == b.kind && a.id == b.id;
+}
+
+DefVector(TimelineEvent, NO_FREE(TimelineEvent));
+
+static void push_presence(TimelineEventVector* events, TimesIterator times, size_t id, TimelineEventKind appearance,
+						  TimelineEventKind disappearance) {
+	FOR_EACH_TIME(interval, times) {
+		if (Interval_size(interval) == 0) {
+			continue;
+		}
+		TimelineEventVector_push(events, (TimelineEvent){.instant = interval.start, .kind = appearance, .id = id});
+		TimelineEventVector_push(events, (TimelineEvent){.instant = interval.end, .kind = disappearance, .id = id});
+	}
+}
+
+static int TimelineEvent_compare(const void* a, const void* b) {
+	const TimelineEvent* event_a = (const TimelineEvent*)a;
+	const TimelineEvent* event_b = (const TimelineEvent*)b;
+	if (event_a->instant != event_b->instant) {
+		return event_a->instant < event_b->instant ? -1 : 1;
+	}
+	if (event_a->kind != event_b->kind) {
+		return event_a->kind < event_b->kind ? -1 : 1;
+	}
+	return (event_a->id > event_b->id) - (event_a->id < event_b->id);
+}
+
+Timeline Timeline_from(Stream* stream) {
+	const StreamFunctions* stream_functions = stream->stream_functions;
+	TimelineEventVector events = TimelineEventVector_new();
+
+	NodesIterator nodes = stream_functions->nodes_set(stream->stream);
+	FOR_EACH_NODE(node_id, nodes) {
+		TimesIterator times = stream_functions->times_node_present(stream->stream, node_id);
+		push_presence(&events, times, node_id, NODE_APPEARANCE, NODE_DISAPPEARANCE);
+	}
+
+	LinksIterator links = stream_functions->links_set(stream->stream);
+	FOR_EACH_LINK(link_id, links) {
+		TimesIterator times = stream_functions->times_link_present(stream->stream, link_id);
+		push_presence(&events, times, link_id, LINK_APPEARANCE, LINK_DISAPPEARANCE);
+	}
+
+	qsort(events.array, events.size, sizeof(TimelineEvent), TimelineEvent_compare);
+	return (Timeline){
+		.nb_events = events.size,
+		.events = events.array,
+		.lifespan = stream_functions->lifespan(stream->stream),
+	};
+}
+
+void Timeline_destroy(Timeline timeline) {
+	free(timeline.events);
+}
+
+bool TimelineEvent_is_node(TimelineEvent event) {
+	return event.kind == NODE_APPEARANCE || event.kind == NODE_DISAPPEARANCE;
+}
+
+bool TimelineEvent_is_appearance(TimelineEvent event) {
+	return event.kind == NODE_APPEARANCE || event.kind == LINK_APPEARANCE;
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+/**
+ * @file timeline.h
+ * @brief The appearances and disappearances of the nodes and links of a Stream, sorted by time.
+ *
+ * A Timeline is built once from the presence intervals of a Stream, through its StreamFunctions, so it works on any
+ * type of Stream. It is then meant to be swept forward, applying each event to some state, to compute quantities at
+ * every key moment in a single pass instead of rebuilding the set of nodes and links present at each instant.
+ */
+
+#include "interval.h"
+#include "stream.h"
+#include "units.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief The kind of an event.
+ *
+ * The kinds are ordered in the order in which events happening at the same instant are sorted : removals before
+ * additions since the intervals are open on the right, links removed before their nodes and nodes added before their
+ * links, so that after any event, every link present has its two nodes present.
+ */
+typedef enum {
+	LINK_DISAPPEARANCE,
+	NODE_DISAPPEARANCE,
+	NODE_APPEARANCE,
+	LINK_APPEARANCE,
+} TimelineEventKind;
+
+/**
+ * @brief A node or link appearing or disappearing at an instant.
+ */
+typedef struct {
+	TimeId instant;			/**< When the event happens. */
+	TimelineEventKind kind; /**< Whether it is a node or a link, and whether it appears or disappears. */
+	size_t id;				/**< The id of the node or link. */
+} TimelineEvent;
+
+/**
+ * @brief Every event of a Stream, sorted by instant, then by kind.
+ */
+typedef struct {
+	size_t nb_events;		/**< The number of events. */
+	TimelineEvent* events;	/**< The events. */
+	Interval lifespan;		/**< The lifespan of the Stream the Timeline was built from. */
+} Timeline;
+
+/**
+ * @brief Builds the Timeline of a Stream.
+ *
+ * Costs one pass over the presence intervals of the nodes and links of the Stream, and a sort of the events.
+ * Must be freed with Timeline_destroy.
+ * @param[in] stream The Stream.
+ * @return The Timeline of the Stream.
+ */
+Timeline Timeline_from(Stream* stream);
+
+/**
+ * @brief Frees the memory of a Timeline.
+ * @param[in] timeline The Timeline.
+ */
+void Timeline_destroy(Timeline timeline);
+
+/**
+ * @brief Returns whether the event is about a node.
+ * @param[in] event The event.
+ */
+bool TimelineEvent_is_node(TimelineEvent event);
+
+/**
+ * @brief Returns whether the event is an appearance.
+ * @param[in] event The event.
+ */
+bool TimelineEvent_is_appearance(TimelineEvent event);
+
+#endif // TIMELINE_H
\ No newline at end of file
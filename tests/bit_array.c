@@ -136,6 +136,93 @@ bool test_leading_zeros_big_1() {
 	return true;
 }
 
+// Ones on both sides of word boundaries
+static BitArray sparse_array(size_t nb_bits) {
+	BitArray bit_array = BitArray_n_zeros(nb_bits);
+	size_t ones[] = {0, 63, 64, 127, 200};
+	for (size_t i = 0; i < sizeof(ones) / sizeof(ones[0]); i++) {
+		if (ones[i] < nb_bits) {
+			BitArray_set_one(bit_array, ones[i]);
+		}
+	}
+	return bit_array;
+}
+
+bool test_next_one() {
+	BitArray bit_array = sparse_array(210);
+	bool result = EXPECT_EQ(BitArray_next_one(bit_array, 0), 0);
+	result &= EXPECT_EQ(BitArray_next_one(bit_array, 1), 63);
+	result &= EXPECT_EQ(BitArray_next_one(bit_array, 64), 64);
+	result &= EXPECT_EQ(BitArray_next_one(bit_array, 65), 127);
+	result &= EXPECT_EQ(BitArray_next_one(bit_array, 128), 200);
+	result &= EXPECT_EQ(BitArray_next_one(bit_array, 201), 210);
+	result &= EXPECT_EQ(BitArray_next_one(bit_array, 500), 210);
+	BitArray_destroy(bit_array);
+	return result;
+}
+
+bool test_for_each_one() {
+	BitArray bit_array = sparse_array(210);
+	size_t expected[] = {0, 63, 64, 127, 200};
+	size_t nb_found = 0;
+	bool result = true;
+	BIT_ARRAY_FOR_EACH_ONE(index, bit_array) {
+		result &= EXPECT_EQ(index, expected[nb_found]);
+		nb_found++;
+	}
+	result &= EXPECT_EQ(nb_found, 5);
+	BitArray_destroy(bit_array);
+	return result;
+}
+
+bool test_count_ones_and_rank() {
+	BitArray bit_array = sparse_array(210);
+	bool result = EXPECT_EQ(BitArray_count_ones(bit_array), 5);
+	result &= EXPECT_EQ(BitArray_rank(bit_array, 0), 0);
+	result &= EXPECT_EQ(BitArray_rank(bit_array, 1), 1);
+	result &= EXPECT_EQ(BitArray_rank(bit_array, 64), 2);
+	result &= EXPECT_EQ(BitArray_rank(bit_array, 65), 3);
+	result &= EXPECT_EQ(BitArray_rank(bit_array, 210), 5);
+	BitArray_destroy(bit_array);
+
+	// The bits after nb_bits in the last word are not counted
+	BitArray ones = BitArray_n_ones(90);
+	result &= EXPECT_EQ(BitArray_count_ones(ones), 90);
+	BitArray_destroy(ones);
+	return result;
+}
+
+bool test_bulk_operations() {
+	BitArray a = sparse_array(210);
+	BitArray b = BitArray_n_zeros(210);
+	BitArray_set_one(b, 63);
+	BitArray_set_one(b, 100);
+	BitArray_set_one(b, 200);
+
+	BitArray and_ab = BitArray_and_array(a, b);
+	BitArray or_ab = BitArray_or_array(a, b);
+	BitArray andnot_ab = BitArray_andnot_array(a, b);
+	bool result = EXPECT_EQ(BitArray_count_ones(and_ab), 2);
+	result &= EXPECT(BitArray_is_one(and_ab, 63) && BitArray_is_one(and_ab, 200));
+	result &= EXPECT_EQ(BitArray_count_ones(or_ab), 6);
+	result &= EXPECT_EQ(BitArray_count_ones(andnot_ab), 3);
+	result &= EXPECT(BitArray_is_zero(andnot_ab, 63) && BitArray_is_one(andnot_ab, 127));
+
+	BitArray_andnot_in_place(a, b);
+	result &= EXPECT_EQ(BitArray_count_ones(a), 3);
+	BitArray_or_in_place(a, b);
+	result &= EXPECT_EQ(BitArray_count_ones(a), 6);
+	BitArray_and_in_place(a, b);
+	result &= EXPECT_EQ(BitArray_count_ones(a), 3);
+
+	BitArray_destroy(a);
+	BitArray_destroy(b);
+	BitArray_destroy(and_ab);
+	BitArray_destroy(or_ab);
+	BitArray_destroy(andnot_ab);
+	return result;
+}
+
 int main() {
 	Test* tests[] = {
 		&(Test){"create",					  test_create					 },
@@ -153,6 +240,10 @@ int main() {
 		&(Test){"leading_zeros_big_zeros",   test_leading_zeros_big_zeros  },
 		&(Test){"leading_zeros_big_ones",	  test_leading_zeros_big_ones	 },
 		&(Test){"leading_zeros_big_1",	   test_leading_zeros_big_1	   },
+		&(Test){"next_one",				   test_next_one				   },
+		&(Test){"for_each_one",			   test_for_each_one			   },
+		&(Test){"count_ones_and_rank",	   test_count_ones_and_rank	   },
+		&(Test){"bulk_operations",		   test_bulk_operations		   },
 
 		NULL
 	};
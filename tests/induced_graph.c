@@ -163,6 +163,117 @@ bool test_links_at_time_90() {
 	return true;
 }
 
+// Compares the nodes and links read from the EventsTable at each key moment to their presence intervals
+// The nodes and links iterated are exactly the ones present at t
+static bool expect_present_at(StreamGraph* sg, TimeId t, NodesIterator nodes, LinksIterator links) {
+	bool result = true;
+	size_t nb_nodes = 0;
+	FOR_EACH_NODE(node, nodes) {
+		result &= EXPECT(IntervalsSet_contains(sg->nodes.nodes[node].presence, t));
+		nb_nodes++;
+	}
+	size_t nb_links = 0;
+	FOR_EACH_LINK(link, links) {
+		result &= EXPECT(IntervalsSet_contains(sg->links.links[link].presence, t));
+		nb_links++;
+	}
+	size_t nb_expected_nodes = 0;
+	for (size_t i = 0; i < sg->nodes.nb_nodes; i++) {
+		nb_expected_nodes += IntervalsSet_contains(sg->nodes.nodes[i].presence, t);
+	}
+	size_t nb_expected_links = 0;
+	for (size_t i = 0; i < sg->links.nb_links; i++) {
+		nb_expected_links += IntervalsSet_contains(sg->links.links[i].presence, t);
+	}
+	result &= EXPECT_EQ(nb_nodes, nb_expected_nodes);
+	result &= EXPECT_EQ(nb_links, nb_expected_links);
+	return result;
+}
+
+// At each key moment, and at every instant of the lifespan, most of which are between two key moments
+static bool expect_present_at_every_instant(StreamGraph* sg) {
+	init_events_table(sg);
+	bool result = true;
+	for (size_t n = 0; n < sg->events.nb_events; n++) {
+		TimeId t = KeyMomentsTable_nth_key_moment(&sg->key_moments, n);
+		result &= expect_present_at(sg, t, get_nodes_present_at_nth_key_moment(sg, n),
+									get_links_present_at_nth_key_moment(sg, n));
+	}
+	for (TimeId t = StreamGraph_lifespan_begin(sg); t <= StreamGraph_lifespan_end(sg); t++) {
+		result &= expect_present_at(sg, t, get_nodes_present_at_t(sg, t), get_links_present_at_t(sg, t));
+	}
+	events_destroy(sg);
+	return result;
+}
+
+bool test_present_at_every_instant() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	bool result = expect_present_at_every_instant(&sg);
+	StreamGraph_destroy(sg);
+	sg = StreamGraph_from_file("tests/test_data/S_multiple_slices.txt");
+	result &= expect_present_at_every_instant(&sg);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+// All the nodes appear at 0, and the key moments of the links only leave gaps between their disappearances
+bool test_present_after_last_appearance() {
+	const char* str = "SGA Internal version 1.0.0\n"
+					  "\n"
+					  "[General]\n"
+					  "Lifespan=(0 100)\n"
+					  "Scaling=10\n"
+					  "\n"
+					  "[Memory]\n"
+					  "NumberOfNodes=3\n"
+					  "NumberOfLinks=2\n"
+					  "NumberOfKeyMoments=7\n"
+					  "\n"
+					  "[[Nodes]]\n"
+					  "[[[NumberOfNeighbours]]]\n"
+					  "2\n"
+					  "1\n"
+					  "1\n"
+					  "[[[NumberOfIntervals]]]\n"
+					  "1\n"
+					  "1\n"
+					  "1\n"
+					  "\n"
+					  "[[Links]]\n"
+					  "[[[NumberOfIntervals]]]\n"
+					  "1\n"
+					  "1\n"
+					  "\n"
+					  "[[[NumberOfSlices]]]\n"
+					  "7\n"
+					  "\n"
+					  "[Data]\n"
+					  "\n"
+					  "[[Neighbours]]\n"
+					  "[[[NodesToLinks]]]\n"
+					  "(0 1)\n"
+					  "(0)\n"
+					  "(1)\n"
+					  "[[[LinksToNodes]]]\n"
+					  "(0 1)\n"
+					  "(0 2)\n"
+					  "\n"
+					  "[[Events]]\n"
+					  "0=((+ N 0) (+ N 1) (+ N 2))\n"
+					  "10=((+ L 0))\n"
+					  "20=((- N 1) (- L 0))\n"
+					  "30=((+ L 1))\n"
+					  "40=((- L 1))\n"
+					  "50=((- N 2))\n"
+					  "100=((- N 0))\n"
+					  "\n"
+					  "[EndOfFile]\n";
+	StreamGraph sg = StreamGraph_from_string(str);
+	bool result = expect_present_at_every_instant(&sg);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
 int main() {
 	Test* tests[] = {
 		&(Test){"nodes_at_time_40",	test_nodes_at_time_40 },
@@ -178,6 +289,8 @@ int main() {
 		&(Test){"links_at_time_80",	test_links_at_time_80 },
 		&(Test){"links_at_time_90",	test_links_at_time_90 },
 		&(Test){"links_at_time_100", test_links_at_time_100},
+		&(Test){"present_at_every_instant", test_present_at_every_instant},
+		&(Test){"present_after_last_appearance", test_present_after_last_appearance},
 
 		NULL
 	};
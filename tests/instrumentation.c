@@ -0,0 +1,107 @@
+#include "../src/instrumentation.h"
+#include "test.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+bool test_counters_start_at_zero() {
+	StreamInstrumentation* instrumentation = StreamInstrumentation_new();
+	StreamCounters counters = StreamInstrumentation_snapshot(instrumentation);
+	bool result = EXPECT_EQ(counters.cache_hits, 0);
+	result &= EXPECT_EQ(counters.cache_misses, 0);
+	result &= EXPECT_EQ(counters.iterators_created, 0);
+	result &= EXPECT_EQ(counters.elements_iterated, 0);
+	for (size_t i = 0; i < NB_INSTRUMENTED_METRICS; i++) {
+		result &= EXPECT_EQ(counters.metric_calls[i], 0);
+	}
+	StreamInstrumentation_destroy(instrumentation);
+	return result;
+}
+
+bool test_null_instrumentation() {
+	// What the Streams have when the library is compiled without SGA_INSTRUMENTATION
+	StreamInstrumentation_count_cache_access(NULL, true);
+	StreamInstrumentation_reset(NULL);
+	MetricTimer timer = MetricTimer_start(NULL, METRIC_density);
+	StreamInstrumentation_count_iterator();
+	MetricTimer_stop(&timer);
+	StreamCounters counters = StreamInstrumentation_snapshot(NULL);
+	bool result = EXPECT_EQ(counters.cache_hits, 0);
+	result &= EXPECT_EQ(counters.iterators_created, 0);
+	result &= EXPECT(StreamInstrumentation_current() == NULL);
+	return result;
+}
+
+bool test_cache_accesses() {
+	StreamInstrumentation* instrumentation = StreamInstrumentation_new();
+	StreamInstrumentation_count_cache_access(instrumentation, false);
+	StreamInstrumentation_count_cache_access(instrumentation, true);
+	StreamInstrumentation_count_cache_access(instrumentation, true);
+	StreamCounters counters = StreamInstrumentation_snapshot(instrumentation);
+	bool result = EXPECT_EQ(counters.cache_hits, 2);
+	result &= EXPECT_EQ(counters.cache_misses, 1);
+
+	StreamInstrumentation_reset(instrumentation);
+	counters = StreamInstrumentation_snapshot(instrumentation);
+	result &= EXPECT_EQ(counters.cache_hits, 0);
+	result &= EXPECT_EQ(counters.cache_misses, 0);
+	StreamInstrumentation_destroy(instrumentation);
+	return result;
+}
+
+bool test_iterations_go_to_current_metric() {
+	StreamInstrumentation* outer = StreamInstrumentation_new();
+	StreamInstrumentation* inner = StreamInstrumentation_new();
+
+	MetricTimer outer_timer = MetricTimer_start(outer, METRIC_coverage);
+	StreamInstrumentation_count_iterator();
+	StreamInstrumentation_count_element();
+	MetricTimer inner_timer = MetricTimer_start(inner, METRIC_cardinalOfW);
+	StreamInstrumentation_count_iterator();
+	StreamInstrumentation_count_element();
+	StreamInstrumentation_count_element();
+	MetricTimer_stop(&inner_timer);
+	StreamInstrumentation_count_element();
+	MetricTimer_stop(&outer_timer);
+
+	// Not inside any metric anymore
+	StreamInstrumentation_count_iterator();
+
+	StreamCounters outer_counters = StreamInstrumentation_snapshot(outer);
+	StreamCounters inner_counters = StreamInstrumentation_snapshot(inner);
+	bool result = EXPECT_EQ(outer_counters.iterators_created, 1);
+	result &= EXPECT_EQ(outer_counters.elements_iterated, 2);
+	result &= EXPECT_EQ(outer_counters.metric_calls[METRIC_coverage], 1);
+	result &= EXPECT_EQ(outer_counters.metric_calls[METRIC_cardinalOfW], 0);
+	result &= EXPECT_EQ(inner_counters.iterators_created, 1);
+	result &= EXPECT_EQ(inner_counters.elements_iterated, 2);
+	result &= EXPECT_EQ(inner_counters.metric_calls[METRIC_cardinalOfW], 1);
+	result &= EXPECT(outer_counters.metric_nanoseconds[METRIC_coverage] >=
+					 inner_counters.metric_nanoseconds[METRIC_cardinalOfW]);
+	result &= EXPECT(StreamInstrumentation_current() == NULL);
+
+	StreamInstrumentation_destroy(outer);
+	StreamInstrumentation_destroy(inner);
+	return result;
+}
+
+bool test_metric_names() {
+	bool result = EXPECT(strcmp(InstrumentedMetric_name(METRIC_cardinalOfT), "cardinalOfT") == 0);
+	result &= EXPECT(strcmp(InstrumentedMetric_name(METRIC_density_of_node), "density_of_node") == 0);
+	result &= EXPECT(strcmp(InstrumentedMetric_name(NB_INSTRUMENTED_METRICS), "unknown") == 0);
+	return result;
+}
+
+int main() {
+	Test* tests[] = {
+		&(Test){"counters_start_at_zero",		  test_counters_start_at_zero		 },
+		&(Test){"null_instrumentation",		   test_null_instrumentation			},
+		&(Test){"cache_accesses",				  test_cache_accesses				 },
+		&(Test){"iterations_go_to_current_metric", test_iterations_go_to_current_metric},
+		&(Test){"metric_names",					  test_metric_names					 },
+		NULL,
+	};
+
+	return test("Instrumentation", tests);
+}
\ No newline at end of file
@@ -108,6 +108,91 @@ bool test_intervals_set_union_overlap() {
 		   EXPECT_EQ(union_ab.intervals[0].end, 10);
 }
 
+// Enough intervals to go through the SIMD loop and its scalar tail
+bool test_intervals_set_size_many() {
+	IntervalsSet set = IntervalsSet_alloc(7);
+	size_t expected = 0;
+	for (size_t i = 0; i < set.nb_intervals; i++) {
+		set.intervals[i] = (Interval){.start = 10 * i, .end = 10 * i + i + 1};
+		expected += i + 1;
+	}
+	bool result = EXPECT_EQ(IntervalsSet_size(set), expected);
+	IntervalsSet_destroy(set);
+	return result;
+}
+
+bool test_intervals_set_size_clipped() {
+	IntervalsSet set = IntervalsSet_alloc(9);
+	for (size_t i = 0; i < set.nb_intervals; i++) {
+		set.intervals[i] = (Interval){.start = 10 * i, .end = 10 * i + 5};
+	}
+	bool result = true;
+	Interval clips[] = {{0, 100}, {12, 63}, {3, 4}, {40, 45}, {200, 300}, {7, 7}, {0, 0}};
+	for (size_t c = 0; c < sizeof(clips) / sizeof(clips[0]); c++) {
+		size_t expected = 0;
+		for (size_t i = 0; i < set.nb_intervals; i++) {
+			expected += Interval_size(Interval_intersection(set.intervals[i], clips[c]));
+		}
+		result &= EXPECT_EQ(IntervalsSet_size_clipped(set, clips[c]), expected);
+	}
+	IntervalsSet_destroy(set);
+	return result;
+}
+
+bool test_intervals_set_span_clipped() {
+	IntervalsSet set = IntervalsSet_alloc(9);
+	for (size_t i = 0; i < set.nb_intervals; i++) {
+		set.intervals[i] = (Interval){.start = 10 * i, .end = 10 * i + 5};
+	}
+	bool result = true;
+	Interval clips[] = {{0, 100}, {12, 63}, {3, 4}, {5, 10}, {200, 300}, {7, 7}, {43, 81}};
+	for (size_t c = 0; c < sizeof(clips) / sizeof(clips[0]); c++) {
+		Interval expected = {SIZE_MAX, 0};
+		for (size_t i = 0; i < set.nb_intervals; i++) {
+			Interval part = Interval_intersection(set.intervals[i], clips[c]);
+			if (part.start < part.end) {
+				expected.start = part.start < expected.start ? part.start : expected.start;
+				expected.end = part.end;
+			}
+		}
+		Interval span = IntervalsSet_span_clipped(set, clips[c]);
+		if (expected.start == SIZE_MAX) {
+			result &= EXPECT(span.start >= span.end);
+		}
+		else {
+			result &= EXPECT_EQ(span.start, expected.start);
+			result &= EXPECT_EQ(span.end, expected.end);
+		}
+	}
+	IntervalsSet_destroy(set);
+	return result;
+}
+
+bool test_intersection_size_of_three() {
+	IntervalsSet a = IntervalsSet_alloc(3);
+	a.intervals[0] = (Interval){.start = 0, .end = 10};
+	a.intervals[1] = (Interval){.start = 20, .end = 40};
+	a.intervals[2] = (Interval){.start = 50, .end = 90};
+	IntervalsSet b = IntervalsSet_alloc(2);
+	b.intervals[0] = (Interval){.start = 5, .end = 25};
+	b.intervals[1] = (Interval){.start = 30, .end = 70};
+	IntervalsSet c = IntervalsSet_alloc(3);
+	c.intervals[0] = (Interval){.start = 0, .end = 8};
+	c.intervals[1] = (Interval){.start = 22, .end = 35};
+	c.intervals[2] = (Interval){.start = 60, .end = 100};
+	// [5, 8[, [22, 25[, [30, 35[ and [60, 70[
+	bool result = EXPECT_EQ(IntervalsSet_intersection_size_of_three(a, b, c), 21);
+	result &= EXPECT_EQ(IntervalsSet_intersection_size_of_three(c, a, b), 21);
+	result &= EXPECT_EQ(IntervalsSet_intersection_size_of_three(b, c, a), 21);
+	IntervalsSet empty = {.nb_intervals = 0, .intervals = NULL};
+	result &= EXPECT_EQ(IntervalsSet_intersection_size_of_three(a, empty, c), 0);
+	IntervalsSet_destroy(a);
+	IntervalsSet_destroy(b);
+	IntervalsSet_destroy(c);
+	IntervalsSet_destroy(empty);
+	return result;
+}
+
 int main() {
 	Test* tests[] = {
 		&(Test){"size_1",						  test_size_1						 },
@@ -125,6 +210,10 @@ int main() {
 		&(Test){"intervals_set_merge_contiguous",  test_intervals_set_merge_contiguous },
 		&(Test){"intervals_set_merge_independent", test_intervals_set_merge_independent},
 		&(Test){"intervals_set_union_overlap",	   test_intervals_set_union_overlap	   },
+		&(Test){"intervals_set_size_many",		   test_intervals_set_size_many		   },
+		&(Test){"intervals_set_size_clipped",	   test_intervals_set_size_clipped	   },
+		&(Test){"intervals_set_span_clipped",	   test_intervals_set_span_clipped	   },
+		&(Test){"intersection_size_of_three",	   test_intersection_size_of_three	   },
 		NULL
 	};
 
@@ -1,10 +1,20 @@
+#include "../src/cliques.h"
+#include "../src/components.h"
 #include "../src/metrics.h"
+#include "../src/paths.h"
+#include "../src/point_queries.h"
+#include "../src/sampling.h"
 #include "../src/stream/chunk_stream.h"
 #include "../src/stream/chunk_stream_small.h"
 #include "../src/stream/full_stream_graph.h"
 #include "../src/stream/link_stream.h"
+#include "../src/stream/substream.h"
+#include "../src/stream/window_stream.h"
 #include "../src/stream_graph.h"
+#include "../src/thread_pool.h"
 #include "test.h"
+#include <math.h>
+#include <pthread.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -110,7 +120,12 @@ bool test_coverage_S() {
 bool test_coverage_L() {
 	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
 	LinkStream ls = LinkStream_from(&sg);
-	Stream st = (Stream){.type = LINK_STREAM, .stream = &ls};
+	Stream st = (Stream){
+		.type = LINK_STREAM,
+		.stream = &ls,
+		.stream_functions = &LinkStream_stream_functions,
+		.metrics_functions = &LinkStream_metrics_functions,
+	};
 	double coverage = Stream_coverage(&st);
 	StreamGraph_destroy(sg);
 	return EXPECT_F_APPROX_EQ(coverage, 1.0, 1e-6);
@@ -178,6 +193,7 @@ bool test_contributions_of_links() {
 }
 
 TEST_METRIC_F(uniformity, 22.0 / 56.0, S, FullStreamGraph)
+TEST_METRIC_F(compactness, 26.0 / 40.0, S, FullStreamGraph)
 TEST_METRIC_F(density, 10.0 / 22.0, S, FullStreamGraph)
 
 bool test_density_of_link() {
@@ -420,6 +436,56 @@ bool test_degree_of_node() {
 	return EXPECT_F_APPROX_EQ(degree_a, 0.6, 1e-2);
 }
 
+// The only triangle is the one of the nodes 0, 1 and 2, whose links are all present during [70, 75[
+bool test_clustering_coeff_of_node() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	Stream st = FullStreamGraph_from(&sg);
+	double expected[] = {1.0, 5.0 / 20.0, 5.0 / 15.0, 0.0};
+	bool result = true;
+	for (size_t i = 0; i < 4; i++) {
+		result &= EXPECT_F_APPROX_EQ(Stream_clustering_coeff_of_node(&st, i), expected[i], 1e-9);
+	}
+	FullStreamGraph_destroy(st);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+TEST_METRIC_F(clustering_coeff, (100.0 + 22.5 + 50.0 / 3.0) / 260.0, S, FullStreamGraph)
+TEST_METRIC_F(transitivity, 15.0 / 40.0, S, FullStreamGraph)
+
+// Without the node 3 and before 60, the node 1 only keeps its pair of links present during [70, 80[
+bool test_clustering_coeff_chunk_stream() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	NodeIdVector nodes = NodeIdVector_with_capacity(3);
+	NodeIdVector_push(&nodes, 0);
+	NodeIdVector_push(&nodes, 1);
+	NodeIdVector_push(&nodes, 2);
+	LinkIdVector links = LinkIdVector_with_capacity(4);
+	for (size_t i = 0; i < 4; i++) {
+		LinkIdVector_push(&links, i);
+	}
+	Stream st = CS_from(&sg, &nodes, &links, 60, 100);
+
+	double expected[] = {1.0, 5.0 / 10.0, 5.0 / 15.0};
+	bool result = true;
+	for (size_t i = 0; i < 3; i++) {
+		result &= EXPECT_F_APPROX_EQ(Stream_clustering_coeff_of_node(&st, i), expected[i], 1e-9);
+	}
+	MetricValues values = Stream_clustering_coeff_of_all_nodes(&st);
+	result &= EXPECT_EQ(values.nb_elements, 3);
+	for (size_t i = 0; i < values.nb_elements; i++) {
+		result &= EXPECT_F_APPROX_EQ(values.values[i], expected[values.ids[i]], 1e-9);
+	}
+	MetricValues_destroy(values);
+	result &= EXPECT_F_APPROX_EQ(Stream_transitivity(&st), 15.0 / 30.0, 1e-9);
+
+	CS_destroy(st);
+	StreamGraph_destroy(sg);
+	NodeIdVector_destroy(nodes);
+	LinkIdVector_destroy(links);
+	return result;
+}
+
 bool test_cache() {
 	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
 	Stream st = FullStreamGraph_from(&sg);
@@ -433,6 +499,275 @@ bool test_cache() {
 	return true;
 }
 
+static void* compute_cardinals(void* arg) {
+	Stream* st = (Stream*)arg;
+	size_t* cardinals = malloc(3 * sizeof(size_t));
+	cardinals[0] = cardinalOfW(st);
+	cardinals[1] = cardinalOfE(st);
+	cardinals[2] = cardinalOfT(st);
+	return cardinals;
+}
+
+// Several threads computing the cardinals of the same Stream must all get the value published in the cache
+bool test_concurrent_cache() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	Stream st = FullStreamGraph_from(&sg);
+	pthread_t threads[4];
+	for (size_t i = 0; i < 4; i++) {
+		pthread_create(&threads[i], NULL, compute_cardinals, &st);
+	}
+	bool result = true;
+	for (size_t i = 0; i < 4; i++) {
+		size_t* cardinals;
+		pthread_join(threads[i], (void**)&cardinals);
+		result &= EXPECT_EQ(cardinals[0], 260);
+		result &= EXPECT_EQ(cardinals[1], 100);
+		result &= EXPECT_EQ(cardinals[2], 100);
+		free(cardinals);
+	}
+	result &= EXPECT_EQ(atomic_load(&st.cache.cardinalOfW.state), CACHE_READY);
+	result &= EXPECT_EQ(st.cache.cardinalOfW.data, 260);
+	FullStreamGraph_destroy(st);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+bool test_memo_table() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	Stream st = FullStreamGraph_from(&sg);
+	bool result = EXPECT_EQ(Stream_memo_usage(&st), 0);
+	MemoValue degree_sums;
+	result &= EXPECT(!Stream_memo_fetch(&st, MEMO_DEGREE_SUMS, &degree_sums));
+
+	// Filled by the first metric which needs it, then shared with the others
+	double average_node_degree = Stream_average_node_degree(&st);
+	result &= EXPECT(Stream_memo_fetch(&st, MEMO_DEGREE_SUMS, &degree_sums));
+	result &= EXPECT_EQ(degree_sums.nb_values, 4);
+	Stream_memo_release(&st, MEMO_DEGREE_SUMS, degree_sums);
+	result &= EXPECT(Stream_memo_usage(&st) > 0);
+
+	// The metrics give the same values without the memo table
+	double uniformity = Stream_uniformity(&st);
+	double density = Stream_density(&st);
+	double degree = Stream_degree_of_node(&st, 1);
+	Stream_set_memo_budget(&st, 0);
+	result &= EXPECT_EQ(Stream_memo_usage(&st), 0);
+	result &= EXPECT(!Stream_memo_fetch(&st, MEMO_DEGREE_SUMS, &degree_sums));
+	result &= EXPECT_F_APPROX_EQ(Stream_average_node_degree(&st), average_node_degree, 1e-9);
+	result &= EXPECT_F_APPROX_EQ(Stream_uniformity(&st), uniformity, 1e-9);
+	result &= EXPECT_F_APPROX_EQ(Stream_density(&st), density, 1e-9);
+	result &= EXPECT_F_APPROX_EQ(Stream_degree_of_node(&st, 1), degree, 1e-9);
+	result &= EXPECT_EQ(Stream_memo_usage(&st), 0);
+
+	FullStreamGraph_destroy(st);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+// With room for a single array, acquiring a second one evicts the least recently used
+bool test_memo_table_eviction() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	Stream st = FullStreamGraph_from(&sg);
+	Stream_set_memo_budget(&st, 4 * sizeof(size_t));
+	MetricValues nodes = Stream_contribution_of_all_nodes(&st);
+	MemoValue times;
+	bool result = EXPECT(Stream_memo_fetch(&st, MEMO_TIMES_NODE_PRESENT, &times));
+	Stream_memo_release(&st, MEMO_TIMES_NODE_PRESENT, times);
+
+	MetricValues links = Stream_contribution_of_all_links(&st);
+	result &= EXPECT(!Stream_memo_fetch(&st, MEMO_TIMES_NODE_PRESENT, &times));
+	result &= EXPECT(Stream_memo_fetch(&st, MEMO_TIMES_LINK_PRESENT, &times));
+	Stream_memo_release(&st, MEMO_TIMES_LINK_PRESENT, times);
+	result &= EXPECT_EQ(Stream_memo_usage(&st), 4 * sizeof(size_t));
+	for (size_t i = 0; i < links.nb_elements; i++) {
+		result &= EXPECT_F_APPROX_EQ(links.values[i], Stream_contribution_of_link(&st, links.ids[i]), 1e-9);
+	}
+
+	MetricValues_destroy(nodes);
+	MetricValues_destroy(links);
+	FullStreamGraph_destroy(st);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+// Computes the metrics a second time through the generic path, with no specialised implementation and an empty cache
+static bool specialised_matches_generic(Stream* st, bool with_neighbours) {
+	static const MetricsFunctions no_specialisation = {0};
+	Stream generic = {
+		.type = st->type,
+		.stream = st->stream,
+		.stream_functions = st->stream_functions,
+		.metrics_functions = &no_specialisation,
+	};
+	init_cache(&generic);
+	bool result = EXPECT_EQ(cardinalOfV(st), cardinalOfV(&generic));
+	result &= EXPECT_EQ(cardinalOfW(st), cardinalOfW(&generic));
+	result &= EXPECT_EQ(cardinalOfE(st), cardinalOfE(&generic));
+	result &= EXPECT_F_APPROX_EQ(Stream_compactness(st), Stream_compactness(&generic), 1e-9);
+
+	MetricValues (*bulk_metrics[])(Stream*) = {
+		Stream_contribution_of_all_nodes,
+		Stream_contribution_of_all_links,
+		Stream_density_of_all_links,
+		Stream_degree_of_all_nodes,
+	};
+	size_t nb_bulk_metrics = with_neighbours ? 4 : 3;
+	for (size_t m = 0; m < nb_bulk_metrics; m++) {
+		MetricValues specialised = bulk_metrics[m](st);
+		MetricValues expected = bulk_metrics[m](&generic);
+		result &= EXPECT_EQ(specialised.nb_elements, expected.nb_elements);
+		for (size_t i = 0; i < specialised.nb_elements && i < expected.nb_elements; i++) {
+			result &= EXPECT_EQ(specialised.ids[i], expected.ids[i]);
+			result &= EXPECT_F_APPROX_EQ(specialised.values[i], expected.values[i], 1e-9);
+		}
+		MetricValues_destroy(specialised);
+		MetricValues_destroy(expected);
+	}
+	destroy_cache(generic);
+	return result;
+}
+
+bool test_specialised_kernels() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	Stream full = FullStreamGraph_from(&sg);
+	bool result = specialised_matches_generic(&full, true);
+	FullStreamGraph_destroy(full);
+
+	// The LinkStream has no neighbours_of_node to compute the degrees through the generic path
+	Stream link_stream = LS_from(&sg);
+	result &= specialised_matches_generic(&link_stream, false);
+	LS_destroy(link_stream);
+
+	NodeIdVector nodes = NodeIdVector_with_capacity(3);
+	NodeIdVector_push(&nodes, 0);
+	NodeIdVector_push(&nodes, 1);
+	NodeIdVector_push(&nodes, 3);
+	LinkIdVector links = LinkIdVector_with_capacity(4);
+	LinkIdVector_push(&links, 0);
+	LinkIdVector_push(&links, 1);
+	LinkIdVector_push(&links, 2);
+	LinkIdVector_push(&links, 3);
+	Stream chunk_stream = CS_from(&sg, &nodes, &links, 20, 80);
+	result &= specialised_matches_generic(&chunk_stream, true);
+	CS_destroy(chunk_stream);
+
+	// Takes ownership of the arrays
+	Stream chunk_stream_small = CSS_from(&sg, nodes.array, links.array, Interval_from(20, 80), nodes.size, links.size);
+	result &= specialised_matches_generic(&chunk_stream_small, true);
+	ChunkStreamSmall_destroy(chunk_stream_small);
+
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+bool test_counters() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	Stream st = FullStreamGraph_from(&sg);
+	Stream_density(&st);
+	Stream_density(&st);
+	StreamCounters counters = Stream_counters(&st);
+	bool result = true;
+	if (Instrumentation_enabled()) {
+		result &= EXPECT_EQ(counters.metric_calls[METRIC_density], 2);
+		result &= EXPECT(counters.metric_calls[METRIC_cardinalOfE] >= 2);
+		result &= EXPECT(counters.cache_hits > 0);
+		result &= EXPECT(counters.cache_misses > 0);
+		result &= EXPECT(counters.iterators_created > 0);
+		result &= EXPECT(counters.elements_iterated > 0);
+		Stream_reset_counters(&st);
+		counters = Stream_counters(&st);
+	}
+	// Always 0 when compiled without the instrumentation
+	result &= EXPECT_EQ(counters.metric_calls[METRIC_density], 0);
+	result &= EXPECT_EQ(counters.cache_hits, 0);
+	result &= EXPECT_EQ(counters.iterators_created, 0);
+	FullStreamGraph_destroy(st);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+// Whether two iterators return the same ids in the same order. Destroys them.
+#define SAME_IDS(iterator1, iterator2)                                                                                 \
+	({                                                                                                                 \
+		bool same = true;                                                                                              \
+		size_t id1;                                                                                                    \
+		size_t id2;                                                                                                    \
+		do {                                                                                                           \
+			id1 = (iterator1).next(&(iterator1));                                                                      \
+			id2 = (iterator2).next(&(iterator2));                                                                      \
+			same &= EXPECT_EQ(id1, id2);                                                                               \
+		} while (same && id1 != SIZE_MAX);                                                                             \
+		(iterator1).destroy(&(iterator1));                                                                             \
+		(iterator2).destroy(&(iterator2));                                                                             \
+		same;                                                                                                          \
+	})
+
+static bool same_nodes(NodesIterator iterator1, NodesIterator iterator2) {
+	return SAME_IDS(iterator1, iterator2);
+}
+
+static bool same_links(LinksIterator iterator1, LinksIterator iterator2) {
+	return SAME_IDS(iterator1, iterator2);
+}
+
+// The ChunkStreamSmall sorts the ids it is given, and its lookups must give the same ids as the ChunkStream
+bool test_chunk_stream_small_lookups() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	NodeIdVector nodes = NodeIdVector_with_capacity(4);
+	NodeIdVector_push(&nodes, 3);
+	NodeIdVector_push(&nodes, 1);
+	NodeIdVector_push(&nodes, 0);
+	NodeIdVector_push(&nodes, 2);
+	LinkIdVector links = LinkIdVector_with_capacity(2);
+	LinkIdVector_push(&links, 3);
+	LinkIdVector_push(&links, 1);
+
+	Stream chunk_stream = CS_from(&sg, &nodes, &links, 20, 80);
+	NodeId* small_nodes = MALLOC(nodes.size * sizeof(NodeId));
+	LinkId* small_links = MALLOC(links.size * sizeof(LinkId));
+	memcpy(small_nodes, nodes.array, nodes.size * sizeof(NodeId));
+	memcpy(small_links, links.array, links.size * sizeof(LinkId));
+	Stream chunk_stream_small = CSS_from(&sg, small_nodes, small_links, Interval_from(20, 80), nodes.size, links.size);
+
+	StreamFunctions cs_funcs = STREAM_FUNCS(cs_funcs, &chunk_stream);
+	StreamFunctions css_funcs = STREAM_FUNCS(css_funcs, &chunk_stream_small);
+	bool result = same_nodes(cs_funcs.nodes_set(chunk_stream.stream), css_funcs.nodes_set(chunk_stream_small.stream));
+	result &= same_links(cs_funcs.links_set(chunk_stream.stream), css_funcs.links_set(chunk_stream_small.stream));
+	for (NodeId node = 0; node < sg.nodes.nb_nodes; node++) {
+		result &= same_links(cs_funcs.neighbours_of_node(chunk_stream.stream, node),
+							 css_funcs.neighbours_of_node(chunk_stream_small.stream, node));
+	}
+	init_events_table(&sg);
+	TimeId instants[] = {25, 30, 40, 60, 74, 75};
+	for (size_t i = 0; i < sizeof(instants) / sizeof(instants[0]); i++) {
+		result &= same_nodes(cs_funcs.nodes_present_at_t(chunk_stream.stream, instants[i]),
+							 css_funcs.nodes_present_at_t(chunk_stream_small.stream, instants[i]));
+		result &= same_links(cs_funcs.links_present_at_t(chunk_stream.stream, instants[i]),
+							 css_funcs.links_present_at_t(chunk_stream_small.stream, instants[i]));
+	}
+	events_destroy(&sg);
+	CS_destroy(chunk_stream);
+	ChunkStreamSmall_destroy(chunk_stream_small);
+
+	// A chunk keeping most of the StreamGraph is a ChunkStream, an almost empty one a ChunkStreamSmall
+	Stream chunk = ChunkStream_auto_from(&sg, &nodes, &links, Interval_from(20, 80));
+	result &= EXPECT(chunk.type == CHUNK_STREAM);
+	ChunkStream_auto_destroy(chunk);
+	NodeIdVector no_nodes = NodeIdVector_with_capacity(1);
+	LinkIdVector no_links = LinkIdVector_with_capacity(1);
+	chunk = ChunkStream_auto_from(&sg, &no_nodes, &no_links, Interval_from(20, 80));
+	result &= EXPECT(chunk.type == CHUNK_STREAM_SMALL);
+	result &= EXPECT(Stream_number_of_nodes(&chunk) == 0.0);
+	ChunkStream_auto_destroy(chunk);
+
+	NodeIdVector_destroy(nodes);
+	LinkIdVector_destroy(links);
+	NodeIdVector_destroy(no_nodes);
+	LinkIdVector_destroy(no_links);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
 bool test_chunk_stream_small_nodes_set() {
 	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
 	NodeIdVector nodes = NodeIdVector_with_capacity(2);
@@ -532,7 +867,848 @@ bool test_chunk_stream_small_times_node_present() {
 	return true;
 }
 
-// TEST_METRIC_F(compactness, 26.0 / 40.0, S)
+// Two SubStreams of the same nodes and links, cut into adjacent windows and into windows separated by a gap
+bool test_substream() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	NodeIdVector nodes = NodeIdVector_with_capacity(3);
+	NodeIdVector_push(&nodes, 0);
+	NodeIdVector_push(&nodes, 1);
+	NodeIdVector_push(&nodes, 3);
+	LinkIdVector links = LinkIdVector_with_capacity(4);
+	LinkIdVector_push(&links, 0);
+	LinkIdVector_push(&links, 1);
+	LinkIdVector_push(&links, 2);
+	LinkIdVector_push(&links, 3);
+
+	// Given out of order, the SubStream sorts them by window
+	SubStreamPiece adjacent_pieces[] = {
+		{.nodes = &nodes, .links = &links, .window = Interval_from(50, 80)},
+		{.nodes = &nodes, .links = &links, .window = Interval_from(20, 50)},
+	};
+	Stream sub_stream = SubStream_from(&sg, 2, adjacent_pieces);
+	Stream chunk_stream = CS_from(&sg, &nodes, &links, 20, 80);
+	bool result = EXPECT_EQ(cardinalOfT(&sub_stream), cardinalOfT(&chunk_stream));
+	result &= EXPECT_EQ(cardinalOfV(&sub_stream), cardinalOfV(&chunk_stream));
+	result &= EXPECT_EQ(cardinalOfW(&sub_stream), cardinalOfW(&chunk_stream));
+	result &= EXPECT_EQ(cardinalOfE(&sub_stream), cardinalOfE(&chunk_stream));
+	result &= EXPECT_F_APPROX_EQ(Stream_coverage(&sub_stream), Stream_coverage(&chunk_stream), 1e-9);
+	result &= EXPECT_F_APPROX_EQ(Stream_density(&sub_stream), Stream_density(&chunk_stream), 1e-9);
+	for (NodeId node = 0; node < sg.nodes.nb_nodes; node++) {
+		result &= EXPECT_F_APPROX_EQ(Stream_degree_of_node(&sub_stream, node),
+									 Stream_degree_of_node(&chunk_stream, node), 1e-9);
+	}
+	result &= specialised_matches_generic(&sub_stream, true);
+
+	StreamFunctions ss_funcs = STREAM_FUNCS(ss_funcs, &sub_stream);
+	StreamFunctions cs_funcs = STREAM_FUNCS(cs_funcs, &chunk_stream);
+	result &= same_nodes(ss_funcs.nodes_set(sub_stream.stream), cs_funcs.nodes_set(chunk_stream.stream));
+	result &= same_links(ss_funcs.links_set(sub_stream.stream), cs_funcs.links_set(chunk_stream.stream));
+	init_events_table(&sg);
+	TimeId instants[] = {25, 49, 50, 60, 79};
+	for (size_t i = 0; i < sizeof(instants) / sizeof(instants[0]); i++) {
+		result &= same_nodes(ss_funcs.nodes_present_at_t(sub_stream.stream, instants[i]),
+							 cs_funcs.nodes_present_at_t(chunk_stream.stream, instants[i]));
+		result &= same_links(ss_funcs.links_present_at_t(sub_stream.stream, instants[i]),
+							 cs_funcs.links_present_at_t(chunk_stream.stream, instants[i]));
+	}
+	SubStream_destroy(sub_stream);
+	CS_destroy(chunk_stream);
+
+	// Nothing is present in the gap, and it doesn't count in the time of the SubStream
+	SubStreamPiece gapped_pieces[] = {
+		{.nodes = &nodes, .links = &links, .window = Interval_from(20, 40)},
+		{.nodes = &nodes, .links = &links, .window = Interval_from(60, 80)},
+	};
+	sub_stream = SubStream_from(&sg, 2, gapped_pieces);
+	Stream first_chunk = CS_from(&sg, &nodes, &links, 20, 40);
+	Stream last_chunk = CS_from(&sg, &nodes, &links, 60, 80);
+	result &= EXPECT_EQ(cardinalOfT(&sub_stream), 40);
+	result &= EXPECT_EQ(cardinalOfW(&sub_stream), cardinalOfW(&first_chunk) + cardinalOfW(&last_chunk));
+	result &= EXPECT_EQ(cardinalOfE(&sub_stream), cardinalOfE(&first_chunk) + cardinalOfE(&last_chunk));
+	for (size_t i = 0; i < nodes.size; i++) {
+		NodeId node = nodes.array[i];
+		size_t time = total_time_of(ss_funcs.times_node_present(sub_stream.stream, node));
+		result &= EXPECT_EQ(time, total_time_of(cs_funcs.times_node_present(first_chunk.stream, node)) +
+									  total_time_of(cs_funcs.times_node_present(last_chunk.stream, node)));
+	}
+	NodesIterator nodes_in_gap = ss_funcs.nodes_present_at_t(sub_stream.stream, 50);
+	result &= EXPECT_EQ(COUNT_ITERATOR(nodes_in_gap), 0);
+	events_destroy(&sg);
+
+	// The degrees are over the time of the SubStream too, whether they are computed one by one or all at once
+	double* degrees = MALLOC(nodes.size * sizeof(double));
+	for (size_t i = 0; i < nodes.size; i++) {
+		degrees[i] = Stream_degree_of_node(&sub_stream, nodes.array[i]);
+	}
+	MetricValues all_degrees = Stream_degree_of_all_nodes(&sub_stream);
+	result &= EXPECT_EQ(all_degrees.nb_elements, nodes.size);
+	double weighted_degrees = 0;
+	for (size_t i = 0; i < all_degrees.nb_elements; i++) {
+		for (size_t j = 0; j < nodes.size; j++) {
+			if (nodes.array[j] == all_degrees.ids[i]) {
+				result &= EXPECT_F_APPROX_EQ(degrees[j], all_degrees.values[i], 1e-9);
+			}
+		}
+		size_t time = total_time_of(ss_funcs.times_node_present(sub_stream.stream, all_degrees.ids[i]));
+		weighted_degrees += all_degrees.values[i] * (double)time;
+	}
+	result &= EXPECT_F_APPROX_EQ(Stream_average_node_degree(&sub_stream),
+								 weighted_degrees / (double)cardinalOfW(&sub_stream), 1e-9);
+	MetricValues_destroy(all_degrees);
+	free(degrees);
+
+	SubStream_destroy(sub_stream);
+	CS_destroy(first_chunk);
+	CS_destroy(last_chunk);
+	NodeIdVector_destroy(nodes);
+	LinkIdVector_destroy(links);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+// The nodes of a link meet in the pieces that do not select it too, which count in the density of the link
+bool test_substream_links_of_pieces() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	NodeIdVector nodes = NodeIdVector_with_capacity(2);
+	NodeIdVector_push(&nodes, 0);
+	NodeIdVector_push(&nodes, 1);
+	LinkIdVector with_link = LinkIdVector_with_capacity(1);
+	LinkIdVector_push(&with_link, 0);
+	LinkIdVector without_link = LinkIdVector_with_capacity(1);
+	SubStreamPiece pieces[] = {
+		{.nodes = &nodes, .links = &with_link, .window = Interval_from(0, 50)},
+		{.nodes = &nodes, .links = &without_link, .window = Interval_from(50, 100)},
+	};
+	Stream sub_stream = SubStream_from(&sg, 2, pieces);
+	double density = Stream_density_of_link(&sub_stream, 0);
+	bool result = EXPECT_F_APPROX_EQ(density, 2.0 / 9.0, 1e-9);
+	MetricValues densities = Stream_density_of_all_links(&sub_stream);
+	result &= EXPECT_EQ(densities.nb_elements, 1);
+	result &= EXPECT_F_APPROX_EQ(densities.values[0], density, 1e-9);
+	result &= EXPECT_F_APPROX_EQ(Stream_density_of_link(&sub_stream, 0), density, 1e-9);
+	MetricValues_destroy(densities);
+	SubStream_destroy(sub_stream);
+	NodeIdVector_destroy(nodes);
+	LinkIdVector_destroy(with_link);
+	LinkIdVector_destroy(without_link);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+// At each step of the slide, the incremental metrics must match the ones of a ChunkStream built on the window
+bool test_window_stream() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	NodeIdVector nodes = NodeIdVector_with_capacity(sg.nodes.nb_nodes);
+	for (NodeId node = 0; node < sg.nodes.nb_nodes; node++) {
+		NodeIdVector_push(&nodes, node);
+	}
+	LinkIdVector links = LinkIdVector_with_capacity(sg.links.nb_links);
+	for (LinkId link = 0; link < sg.links.nb_links; link++) {
+		LinkIdVector_push(&links, link);
+	}
+
+	init_events_table(&sg);
+	Stream window = WindowStream_from(&sg, Interval_from(0, 30));
+	bool result = true;
+	for (size_t start = 0; start <= 80; start += 7) {
+		Interval interval = WindowStream_window(&window);
+		result &= EXPECT_EQ(interval.start, start);
+		Stream chunk_stream = CS_from(&sg, &nodes, &links, interval.start, interval.end);
+		size_t nb_nodes_present = 0;
+		for (NodeId node = 0; node < sg.nodes.nb_nodes; node++) {
+			TimesIterator times = chunk_stream.stream_functions->times_node_present(chunk_stream.stream, node);
+			nb_nodes_present += total_time_of(times) > 0;
+		}
+		result &= EXPECT_EQ(cardinalOfT(&window), 30);
+		result &= EXPECT_EQ(cardinalOfV(&window), nb_nodes_present);
+		result &= EXPECT_EQ(cardinalOfW(&window), cardinalOfW(&chunk_stream));
+		result &= EXPECT_EQ(cardinalOfE(&window), cardinalOfE(&chunk_stream));
+		if (cardinalOfE(&chunk_stream) > 0) {
+			result &= EXPECT_F_APPROX_EQ(Stream_density(&window), Stream_density(&chunk_stream), 1e-9);
+		}
+		for (NodeId node = 0; node < sg.nodes.nb_nodes; node++) {
+			double expected = Stream_degree_of_node(&chunk_stream, node);
+			result &= EXPECT_F_APPROX_EQ(Stream_degree_of_node(&window, node), expected, 1e-9);
+		}
+		// Most instants of the window are between two key moments, and nothing is present outside of it
+		for (TimeId t = interval.start; t <= interval.end; t++) {
+			bool in_window = Interval_contains(interval, t);
+			NodesIterator nodes_present = window.stream_functions->nodes_present_at_t(window.stream, t);
+			size_t nb_nodes_at_t = 0;
+			FOR_EACH_NODE(node, nodes_present) {
+				result &= EXPECT(in_window && IntervalsSet_contains(sg.nodes.nodes[node].presence, t));
+				nb_nodes_at_t++;
+			}
+			size_t nb_nodes_expected = 0;
+			for (NodeId node = 0; node < sg.nodes.nb_nodes && in_window; node++) {
+				nb_nodes_expected += IntervalsSet_contains(sg.nodes.nodes[node].presence, t);
+			}
+			result &= EXPECT_EQ(nb_nodes_at_t, nb_nodes_expected);
+			LinksIterator links_present = window.stream_functions->links_present_at_t(window.stream, t);
+			size_t nb_links_present = 0;
+			FOR_EACH_LINK(link, links_present) {
+				result &= EXPECT(in_window && IntervalsSet_contains(sg.links.links[link].presence, t));
+				nb_links_present++;
+			}
+			size_t nb_links_expected = 0;
+			for (LinkId link = 0; link < sg.links.nb_links && in_window; link++) {
+				nb_links_expected += IntervalsSet_contains(sg.links.links[link].presence, t);
+			}
+			result &= EXPECT_EQ(nb_links_present, nb_links_expected);
+		}
+		CS_destroy(chunk_stream);
+		WindowStream_slide(&window, 7);
+	}
+	WindowStream_destroy(window);
+	events_destroy(&sg);
+
+	NodeIdVector_destroy(nodes);
+	LinkIdVector_destroy(links);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+// Checks that a bulk metric gives the same values as its per-element version, sequentially and with a thread pool
+#define TEST_BULK_METRIC(bulk_name, single_name)                                                                     \
+	bool test_##bulk_name() {                                                                                          \
+		StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");                                               \
+		Stream st = FullStreamGraph_from(&sg);                                                                         \
+		bool result = true;                                                                                            \
+		for (size_t nb_workers = 1; nb_workers <= 3; nb_workers++) {                                                   \
+			ThreadPool_set_global_nb_workers(nb_workers);                                                              \
+			MetricValues values = Stream_##bulk_name(&st);                                                             \
+			result &= EXPECT_EQ(values.nb_elements, 4);                                                                \
+			for (size_t i = 0; i < values.nb_elements; i++) {                                                          \
+				result &= EXPECT_EQ(values.ids[i], i);                                                                 \
+				result &= EXPECT_F_APPROX_EQ(values.values[i], Stream_##single_name(&st, values.ids[i]), 1e-9);        \
+			}                                                                                                          \
+			MetricValues_destroy(values);                                                                              \
+		}                                                                                                              \
+		ThreadPool_set_global_nb_workers(1);                                                                           \
+		FullStreamGraph_destroy(st);                                                                                   \
+		StreamGraph_destroy(sg);                                                                                       \
+		return result;                                                                                                 \
+	}
+
+TEST_BULK_METRIC(contribution_of_all_nodes, contribution_of_node)
+TEST_BULK_METRIC(contribution_of_all_links, contribution_of_link)
+TEST_BULK_METRIC(degree_of_all_nodes, degree_of_node)
+TEST_BULK_METRIC(density_of_all_links, density_of_link)
+TEST_BULK_METRIC(density_of_all_nodes, density_of_node)
+TEST_BULK_METRIC(clustering_coeff_of_all_nodes, clustering_coeff_of_node)
+
+bool test_bulk_metric_chunk_stream() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	NodeIdVector nodes = NodeIdVector_with_capacity(3);
+	NodeIdVector_push(&nodes, 0);
+	NodeIdVector_push(&nodes, 1);
+	NodeIdVector_push(&nodes, 3);
+
+	LinkIdVector links = LinkIdVector_with_capacity(4);
+	LinkIdVector_push(&links, 0);
+	LinkIdVector_push(&links, 1);
+	LinkIdVector_push(&links, 2);
+	LinkIdVector_push(&links, 3);
+
+	Stream st = CS_from(&sg, &nodes, &links, 20, 80);
+	MetricValues degrees = Stream_degree_of_all_nodes(&st);
+	bool result = EXPECT_EQ(degrees.nb_elements, 3);
+	for (size_t i = 0; i < degrees.nb_elements; i++) {
+		result &= EXPECT_EQ(degrees.ids[i], nodes.array[i]);
+		result &= EXPECT_F_APPROX_EQ(degrees.values[i], Stream_degree_of_node(&st, degrees.ids[i]), 1e-9);
+	}
+	MetricValues_destroy(degrees);
+
+	CS_destroy(st);
+	StreamGraph_destroy(sg);
+	NodeIdVector_destroy(nodes);
+	LinkIdVector_destroy(links);
+	return result;
+}
+
+// The reductions are done in the same order whatever the number of workers, so the results must be exactly the same
+bool test_metrics_with_thread_pool() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	Stream st = FullStreamGraph_from(&sg);
+	size_t w = cardinalOfW(&st);
+	size_t e = cardinalOfE(&st);
+	double uniformity = Stream_uniformity(&st);
+	double density = Stream_density(&st);
+	double average_node_degree = Stream_average_node_degree(&st);
+	double clustering_coeff = Stream_clustering_coeff(&st);
+	double transitivity = Stream_transitivity(&st);
+	FullStreamGraph_destroy(st);
+
+	bool result = true;
+	ThreadPool_set_global_nb_workers(3);
+	st = FullStreamGraph_from(&sg);
+	result &= EXPECT_EQ(cardinalOfW(&st), w);
+	result &= EXPECT_EQ(cardinalOfE(&st), e);
+	result &= EXPECT(Stream_uniformity(&st) == uniformity);
+	result &= EXPECT(Stream_density(&st) == density);
+	result &= EXPECT(Stream_average_node_degree(&st) == average_node_degree);
+	result &= EXPECT(Stream_clustering_coeff(&st) == clustering_coeff);
+	result &= EXPECT(Stream_transitivity(&st) == transitivity);
+	ThreadPool_set_global_nb_workers(1);
+
+	FullStreamGraph_destroy(st);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+bool test_key_moments_time_series() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	Stream st = FullStreamGraph_from(&sg);
+	size_t nb_key_moments;
+	InstantMetrics* series = Stream_key_moments_time_series(&st, &nb_key_moments);
+	TimeId instants[] = {0, 10, 20, 30, 40, 45, 50, 60, 70, 75, 80, 90, 100};
+	size_t nb_nodes[] = {2, 3, 3, 2, 2, 2, 3, 3, 3, 3, 3, 2, 0};
+	size_t nb_links[] = {0, 1, 2, 0, 0, 1, 1, 2, 3, 2, 1, 0, 0};
+	bool result = EXPECT_EQ(nb_key_moments, 13);
+	for (size_t i = 0; i < nb_key_moments && i < 13; i++) {
+		result &= EXPECT_EQ(series[i].instant, instants[i]);
+		result &= EXPECT_EQ(series[i].nb_nodes, nb_nodes[i]);
+		result &= EXPECT_EQ(series[i].nb_links, nb_links[i]);
+	}
+	result &= EXPECT_F_APPROX_EQ(series[2].density, 2.0 / 3.0, 1e-9);
+	free(series);
+	FullStreamGraph_destroy(st);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+bool test_instants_time_series() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	Stream st = FullStreamGraph_from(&sg);
+	TimeId instants[] = {5, 20, 25, 44, 45, 74, 75, 99};
+	InstantMetrics series[8];
+	Stream_instants_time_series(&st, instants, 8, series);
+	bool result = true;
+	for (size_t i = 0; i < 8; i++) {
+		size_t nb_nodes = 0;
+		for (size_t node = 0; node < sg.nodes.nb_nodes; node++) {
+			nb_nodes += IntervalsSet_contains(sg.nodes.nodes[node].presence, instants[i]);
+		}
+		size_t nb_links = 0;
+		for (size_t link = 0; link < sg.links.nb_links; link++) {
+			nb_links += IntervalsSet_contains(sg.links.links[link].presence, instants[i]);
+		}
+		result &= EXPECT_EQ(series[i].instant, instants[i]);
+		result &= EXPECT_EQ(series[i].nb_nodes, nb_nodes);
+		result &= EXPECT_EQ(series[i].nb_links, nb_links);
+	}
+	FullStreamGraph_destroy(st);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+bool test_degree_histogram() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	Stream st = FullStreamGraph_from(&sg);
+	DegreeHistogram histogram = Stream_degree_histogram(&st);
+	// Node 0 has 2 neighbours from 70 to 75, node 1 from 20 to 30 and from 70 to 80, and node 2 from 60 to 75
+	bool result = EXPECT_EQ(histogram.nb_degrees, 3);
+	result &= EXPECT_EQ(histogram.node_times[0], 100);
+	result &= EXPECT_EQ(histogram.node_times[1], 120);
+	result &= EXPECT_EQ(histogram.node_times[2], 40);
+	result &= EXPECT_EQ(histogram.degrees.nb_elements, 4);
+	for (size_t i = 0; i < histogram.degrees.nb_elements; i++) {
+		result &= EXPECT_F_APPROX_EQ(histogram.degrees.values[i],
+									 Stream_degree_of_node(&st, histogram.degrees.ids[i]), 1e-9);
+	}
+	DegreeHistogram_destroy(histogram);
+
+	// The gap between the windows of a SubStream doesn't count in the time the degrees are over
+	NodeIdVector nodes = NodeIdVector_with_capacity(4);
+	LinkIdVector links = LinkIdVector_with_capacity(4);
+	for (size_t i = 0; i < 4; i++) {
+		NodeIdVector_push(&nodes, i);
+		LinkIdVector_push(&links, i);
+	}
+	SubStreamPiece pieces[] = {
+		{.nodes = &nodes, .links = &links, .window = Interval_from(0, 30)},
+		{.nodes = &nodes, .links = &links, .window = Interval_from(60, 100)},
+	};
+	Stream sub_stream = SubStream_from(&sg, 2, pieces);
+	histogram = Stream_degree_histogram(&sub_stream);
+	MetricValues degrees = Stream_degree_of_all_nodes(&sub_stream);
+	result &= EXPECT_EQ(histogram.degrees.nb_elements, degrees.nb_elements);
+	for (size_t i = 0; i < histogram.degrees.nb_elements; i++) {
+		result &= EXPECT_EQ(histogram.degrees.ids[i], degrees.ids[i]);
+		result &= EXPECT_F_APPROX_EQ(histogram.degrees.values[i], degrees.values[i], 1e-9);
+	}
+	MetricValues_destroy(degrees);
+	DegreeHistogram_destroy(histogram);
+	SubStream_destroy(sub_stream);
+	NodeIdVector_destroy(nodes);
+	LinkIdVector_destroy(links);
+	FullStreamGraph_destroy(st);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+static bool expect_paths(const size_t* got, const size_t* expected, size_t nb_values) {
+	bool result = true;
+	for (size_t i = 0; i < nb_values; i++) {
+		result &= EXPECT_EQ(got[i], expected[i]);
+	}
+	return result;
+}
+
+bool test_temporal_paths_from() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	Stream st = FullStreamGraph_from(&sg);
+
+	TemporalPaths paths = Stream_temporal_paths_from(&st, 0, 0);
+	bool result = EXPECT_EQ(paths.nb_node_ids, 4);
+	result &= expect_paths(paths.earliest_arrivals, (size_t[]){0, 10, 45, 20}, 4);
+	result &= expect_paths(paths.shortest_lengths, (size_t[]){0, 1, 1, 2}, 4);
+	result &= expect_paths(paths.fastest_durations, (size_t[]){0, 0, 0, 0}, 4);
+	TemporalPaths_destroy(paths);
+
+	// Node 1 is left at 40 and reached again at 60 through node 2, with more links than at 20
+	paths = Stream_temporal_paths_from(&st, 3, 10);
+	result &= expect_paths(paths.earliest_arrivals, (size_t[]){20, 20, 45, 10}, 4);
+	result &= expect_paths(paths.shortest_lengths, (size_t[]){2, 1, 3, 0}, 4);
+	result &= expect_paths(paths.fastest_durations, (size_t[]){0, 0, 15, 0}, 4);
+	TemporalPaths_destroy(paths);
+
+	// Node 3 is absent at 0, so no path starts from it then, but the fastest paths can leave it once it appears
+	paths = Stream_temporal_paths_from(&st, 3, 0);
+	size_t unreachable[] = {PATHS_UNREACHABLE, PATHS_UNREACHABLE, PATHS_UNREACHABLE, PATHS_UNREACHABLE};
+	result &= expect_paths(paths.earliest_arrivals, unreachable, 4);
+	result &= expect_paths(paths.shortest_lengths, unreachable, 4);
+	result &= expect_paths(paths.fastest_durations, (size_t[]){0, 0, 15, 0}, 4);
+	TemporalPaths_destroy(paths);
+
+	FullStreamGraph_destroy(st);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+bool test_latest_departures_to() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	Stream st = FullStreamGraph_from(&sg);
+
+	// Nodes 1 and 3 only reach node 0, which waits for node 2, through links which end at 30
+	LatestDepartures departures = Stream_latest_departures_to(&st, 2, 50);
+	bool result = expect_paths(departures.latest_departures, (size_t[]){50, 30, 50, 30}, 4);
+	LatestDepartures_destroy(departures);
+
+	departures = Stream_latest_departures_to(&st, 3, 50);
+	size_t unreachable[] = {PATHS_UNREACHABLE, PATHS_UNREACHABLE, PATHS_UNREACHABLE, PATHS_UNREACHABLE};
+	result &= expect_paths(departures.latest_departures, unreachable, 4);
+	LatestDepartures_destroy(departures);
+
+	FullStreamGraph_destroy(st);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+typedef struct {
+	Stream* stream;
+	pthread_mutex_t mutex;
+	size_t nb_sources;
+	bool result;
+} AllSourcesCheck;
+
+static void check_paths_of_source(const TemporalPaths* paths, void* data) {
+	AllSourcesCheck* check = (AllSourcesCheck*)data;
+	TemporalPaths expected = Stream_temporal_paths_from(check->stream, paths->source, paths->start);
+	bool result = expect_paths(paths->earliest_arrivals, expected.earliest_arrivals, expected.nb_node_ids);
+	result &= expect_paths(paths->shortest_lengths, expected.shortest_lengths, expected.nb_node_ids);
+	result &= expect_paths(paths->fastest_durations, expected.fastest_durations, expected.nb_node_ids);
+	TemporalPaths_destroy(expected);
+	pthread_mutex_lock(&check->mutex);
+	check->nb_sources++;
+	check->result &= result;
+	pthread_mutex_unlock(&check->mutex);
+}
+
+bool test_temporal_paths_from_all_nodes() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	Stream st = FullStreamGraph_from(&sg);
+	AllSourcesCheck check = {.stream = &st, .mutex = PTHREAD_MUTEX_INITIALIZER, .result = true};
+	ThreadPool_set_global_nb_workers(3);
+	Stream_temporal_paths_from_all_nodes(&st, 5, check_paths_of_source, &check);
+	ThreadPool_set_global_nb_workers(1);
+	bool result = EXPECT_EQ(check.nb_sources, 4);
+	result &= check.result;
+	FullStreamGraph_destroy(st);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+typedef struct {
+	pthread_mutex_t mutex;
+	size_t nb_cliques;
+	size_t nodes_masks[8]; // The nodes of each clique, as bits
+	Interval intervals[8];
+} CliquesCollector;
+
+static void collect_clique(const TemporalClique* clique, void* data) {
+	CliquesCollector* collector = (CliquesCollector*)data;
+	size_t mask = 0;
+	for (size_t i = 0; i < clique->nb_nodes; i++) {
+		mask |= (size_t)1 << clique->nodes[i];
+	}
+	pthread_mutex_lock(&collector->mutex);
+	if (collector->nb_cliques < 8) {
+		collector->nodes_masks[collector->nb_cliques] = mask;
+		collector->intervals[collector->nb_cliques] = clique->interval;
+	}
+	collector->nb_cliques++;
+	pthread_mutex_unlock(&collector->mutex);
+}
+
+static bool expect_clique(const CliquesCollector* collector, size_t mask, Interval interval) {
+	for (size_t i = 0; i < collector->nb_cliques && i < 8; i++) {
+		if (collector->nodes_masks[i] == mask && Interval_equals(collector->intervals[i], interval)) {
+			return true;
+		}
+	}
+	printf("Clique %zx during [%zu, %zu[ not found\n", mask, interval.start, interval.end);
+	return false;
+}
+
+bool test_maximal_cliques() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	Stream st = FullStreamGraph_from(&sg);
+	bool result = true;
+	size_t nb_workers[] = {1, 3};
+	for (size_t w = 0; w < 2; w++) {
+		CliquesCollector collector = {.mutex = PTHREAD_MUTEX_INITIALIZER};
+		ThreadPool_set_global_nb_workers(nb_workers[w]);
+		Stream_maximal_cliques(&st, collect_clique, &collector);
+		ThreadPool_set_global_nb_workers(1);
+		result &= EXPECT_EQ(collector.nb_cliques, 6);
+		// The triangle 0, 1, 2 only lasts from 70 to 75, and node 2 doesn't extend the other times of 0 and 1
+		result &= expect_clique(&collector, 0b0111, Interval_from(70, 75));
+		result &= expect_clique(&collector, 0b0011, Interval_from(10, 30));
+		result &= expect_clique(&collector, 0b0011, Interval_from(70, 80));
+		result &= expect_clique(&collector, 0b0101, Interval_from(45, 75));
+		result &= expect_clique(&collector, 0b0110, Interval_from(60, 90));
+		result &= expect_clique(&collector, 0b1010, Interval_from(20, 30));
+	}
+	FullStreamGraph_destroy(st);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+bool test_components_time_series() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	Stream st = FullStreamGraph_from(&sg);
+	size_t nb_key_moments;
+	ComponentsCount* counts = Stream_components_time_series(&st, &nb_key_moments);
+	bool result = EXPECT_EQ(nb_key_moments, 13);
+	size_t instants[] = {0, 10, 20, 30, 40, 45, 50, 60, 70, 75, 80, 90, 100};
+	size_t nb_components[] = {2, 2, 1, 2, 2, 1, 2, 1, 1, 1, 2, 2, 0};
+	size_t largest[] = {1, 2, 3, 1, 1, 2, 2, 3, 3, 3, 2, 1, 0};
+	for (size_t i = 0; i < nb_key_moments && i < 13; i++) {
+		result &= EXPECT_EQ(counts[i].instant, instants[i]);
+		result &= EXPECT_EQ(counts[i].nb_components, nb_components[i]);
+		result &= EXPECT_EQ(counts[i].largest_component, largest[i]);
+	}
+	free(counts);
+	FullStreamGraph_destroy(st);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+bool test_components_at_instants() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	Stream st = FullStreamGraph_from(&sg);
+	TimeId instants[] = {5, 25, 55, 85, 100};
+	NodesComponents components = Stream_components_at_instants(&st, instants, 5);
+	bool result = EXPECT_EQ(components.nb_node_ids, 4);
+	// Nodes 0 and 1 are only linked from 10 to 30 and from 70 to 80, and node 2 is linked to 0 at 55 and to 1 at 85
+	NodeId expected[] = {
+		0, 1, NO_COMPONENT, NO_COMPONENT, 0, 0, NO_COMPONENT, 0, 0, 1, 0, NO_COMPONENT, 0, 1, 1, NO_COMPONENT,
+		NO_COMPONENT, NO_COMPONENT, NO_COMPONENT, NO_COMPONENT,
+	};
+	for (size_t i = 0; i < 20; i++) {
+		result &= EXPECT_EQ(components.components[i], expected[i]);
+	}
+	NodesComponents_destroy(components);
+
+	// Out of order and repeated, each row is still at the position of its instant
+	TimeId shuffled[] = {85, 5, 100, 25, 55, 25};
+	size_t rows[] = {3, 0, 4, 1, 2, 1};
+	components = Stream_components_at_instants(&st, shuffled, 6);
+	for (size_t i = 0; i < 6; i++) {
+		for (size_t node = 0; node < 4; node++) {
+			result &= EXPECT_EQ(components.components[i * 4 + node], expected[rows[i] * 4 + node]);
+		}
+	}
+	NodesComponents_destroy(components);
+	FullStreamGraph_destroy(st);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+static bool expect_estimate(MetricEstimate estimate, double exact) {
+	bool result = EXPECT(estimate.lower <= exact && exact <= estimate.upper);
+	result &= EXPECT(estimate.lower <= estimate.value && estimate.value <= estimate.upper);
+	return result;
+}
+
+bool test_sampling_estimates() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	Stream st = FullStreamGraph_from(&sg);
+	SamplingBudget budget = {.max_samples = 20000, .confidence = 0.999, .seed = 42};
+	MetricEstimate uniformity = Stream_uniformity_estimate(&st, budget);
+	bool result = EXPECT_EQ(uniformity.nb_samples, 20000);
+	result &= expect_estimate(uniformity, Stream_uniformity(&st));
+	result &= expect_estimate(Stream_density_estimate(&st, budget), Stream_density(&st));
+	result &= expect_estimate(Stream_clustering_coeff_estimate(&st, budget), Stream_clustering_coeff(&st));
+	for (NodeId node_id = 0; node_id < 4; node_id++) {
+		result &= expect_estimate(Stream_density_of_node_estimate(&st, node_id, budget),
+								  Stream_density_of_node(&st, node_id));
+	}
+
+	// The sampling stops once the interval is narrow enough, long before the cap on the samples
+	SamplingBudget precision = {.max_samples = 1000000, .relative_error = 0.05, .seed = 1};
+	MetricEstimate density = Stream_density_estimate(&st, precision);
+	result &= EXPECT(density.nb_samples < 1000000);
+	result &= EXPECT(density.upper - density.value <= 0.05 * density.value);
+
+	// Nodes 2 and 3 are never present together, so every denominator is 0 and the estimates stop on NaN
+	NodeIdVector nodes = NodeIdVector_with_capacity(2);
+	NodeIdVector_push(&nodes, 2);
+	NodeIdVector_push(&nodes, 3);
+	LinkIdVector links = LinkIdVector_with_capacity(1);
+	Stream disjoint = CS_from(&sg, &nodes, &links, 0, 100);
+	MetricEstimate disjoint_density = Stream_density_estimate(&disjoint, precision);
+	result &= EXPECT(isnan(disjoint_density.value));
+	result &= EXPECT(disjoint_density.nb_samples < 1000000);
+	MetricEstimate disjoint_node_density = Stream_density_of_node_estimate(&disjoint, 3, precision);
+	result &= EXPECT(isnan(disjoint_node_density.value));
+	result &= EXPECT(disjoint_node_density.nb_samples < 1000000);
+	CS_destroy(disjoint);
+	NodeIdVector_destroy(nodes);
+	LinkIdVector_destroy(links);
+	FullStreamGraph_destroy(st);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+// Checks that the top k are sorted, have the values of the per-element metric, and that no other element beats them.
+// The elements whose metric is undefined are not ranked.
+static bool expect_top_k(MetricValues top, MetricValues all, size_t k) {
+	size_t nb_defined = 0;
+	for (size_t j = 0; j < all.nb_elements; j++) {
+		nb_defined += !isnan(all.values[j]);
+	}
+	bool result = EXPECT_EQ(top.nb_elements, k < nb_defined ? k : nb_defined);
+	for (size_t i = 0; i < top.nb_elements; i++) {
+		bool found = false;
+		for (size_t j = 0; j < all.nb_elements; j++) {
+			if (all.ids[j] == top.ids[i]) {
+				found = true;
+				result &= EXPECT_F_APPROX_EQ(top.values[i], all.values[j], 1e-9);
+			}
+		}
+		result &= EXPECT(found);
+		if (i > 0) {
+			result &= EXPECT(top.values[i - 1] > top.values[i] ||
+							 (top.values[i - 1] == top.values[i] && top.ids[i - 1] < top.ids[i]));
+		}
+	}
+	size_t nb_better = 0;
+	for (size_t j = 0; j < all.nb_elements && top.nb_elements > 0; j++) {
+		nb_better += all.values[j] > top.values[top.nb_elements - 1];
+	}
+	result &= EXPECT(nb_better < top.nb_elements || nb_better == 0);
+	return result;
+}
+
+bool test_top_k() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	Stream st = FullStreamGraph_from(&sg);
+	MetricValues presences = Stream_contribution_of_all_nodes(&st);
+	MetricValues densities = Stream_density_of_all_links(&st);
+	bool result = true;
+	for (size_t nb_workers = 1; nb_workers <= 3; nb_workers += 2) {
+		ThreadPool_set_global_nb_workers(nb_workers);
+		for (size_t k = 0; k <= 5; k++) {
+			MetricValues nodes = Stream_most_present_nodes(&st, k);
+			result &= expect_top_k(nodes, presences, k);
+			MetricValues_destroy(nodes);
+			MetricValues links = Stream_densest_links(&st, k);
+			result &= expect_top_k(links, densities, k);
+			MetricValues_destroy(links);
+		}
+	}
+	ThreadPool_set_global_nb_workers(1);
+
+	// Node 0 is present during the whole lifespan, and links are present together at most at 70
+	MetricValues nodes = Stream_most_present_nodes(&st, 1);
+	result &= EXPECT_EQ(nodes.ids[0], 0);
+	result &= EXPECT_F_APPROX_EQ(nodes.values[0], 1.0, 1e-9);
+	MetricValues_destroy(nodes);
+	MetricValues_destroy(densities);
+	MetricValues_destroy(presences);
+
+	// During [0, 10[, only the nodes of link 0 are present together, so the other links have no density
+	NodeIdVector chunk_nodes = NodeIdVector_with_capacity(4);
+	LinkIdVector chunk_links = LinkIdVector_with_capacity(4);
+	for (size_t i = 0; i < 4; i++) {
+		NodeIdVector_push(&chunk_nodes, i);
+		LinkIdVector_push(&chunk_links, i);
+	}
+	Stream chunk = CS_from(&sg, &chunk_nodes, &chunk_links, 0, 10);
+	MetricValues chunk_densities = Stream_density_of_all_links(&chunk);
+	MetricValues chunk_best = Stream_densest_links(&chunk, 4);
+	result &= expect_top_k(chunk_best, chunk_densities, 4);
+	result &= EXPECT_EQ(chunk_best.nb_elements, 1);
+	result &= EXPECT_EQ(chunk_best.ids[0], 0);
+	result &= EXPECT_F_APPROX_EQ(chunk_best.values[0], 0.0, 1e-9);
+	MetricValues_destroy(chunk_best);
+	MetricValues_destroy(chunk_densities);
+	CS_destroy(chunk);
+	NodeIdVector_destroy(chunk_nodes);
+	LinkIdVector_destroy(chunk_links);
+
+	size_t nb_key_moments;
+	InstantMetrics* key_moments = Stream_key_moments_time_series(&st, &nb_key_moments);
+	size_t nb_instants;
+	InstantMetrics* busiest = Stream_busiest_instants(&st, 3, &nb_instants);
+	result &= EXPECT_EQ(nb_instants, 3);
+	result &= EXPECT_EQ(busiest[0].instant, 70);
+	result &= EXPECT_EQ(busiest[0].nb_links, 3);
+	for (size_t i = 0; i < nb_instants; i++) {
+		size_t nb_better = 0;
+		for (size_t j = 0; j < nb_key_moments; j++) {
+			nb_better += key_moments[j].nb_links > busiest[i].nb_links;
+			if (key_moments[j].instant == busiest[i].instant) {
+				result &= EXPECT_EQ(key_moments[j].nb_nodes, busiest[i].nb_nodes);
+				result &= EXPECT_EQ(key_moments[j].nb_links, busiest[i].nb_links);
+			}
+		}
+		result &= EXPECT(nb_better <= i);
+	}
+	free(busiest);
+	free(key_moments);
+	FullStreamGraph_destroy(st);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+// The links present at each instant are the ones whose presence contains it, in increasing order
+static bool expect_links_at_instants(StreamGraph* sg, Stream* st, const TimeId* instants, size_t nb_instants) {
+	LinksAtInstants links = Stream_links_present_at_instants(st, instants, nb_instants);
+	bool result = EXPECT_EQ(links.nb_instants, nb_instants);
+	for (size_t i = 0; i < nb_instants; i++) {
+		size_t j = links.offsets[i];
+		for (size_t link_id = 0; link_id < sg->links.nb_links; link_id++) {
+			if (IntervalsSet_contains(sg->links.links[link_id].presence, instants[i])) {
+				result &= EXPECT(j < links.offsets[i + 1] && links.links[j] == link_id);
+				j++;
+			}
+		}
+		result &= EXPECT_EQ(j, links.offsets[i + 1]);
+		// Once the EventsTable is built, the links present at a single instant are read from it too
+		if (sg->events.link_events.events != NULL) {
+			StreamFunctions funcs = STREAM_FUNCS(funcs, st);
+			LinksIterator present = funcs.links_present_at_t(st->stream, instants[i]);
+			result &= EXPECT_EQ(COUNT_ITERATOR(present), links.offsets[i + 1] - links.offsets[i]);
+		}
+	}
+	LinksAtInstants_destroy(links);
+	return result;
+}
+
+bool test_point_queries() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	Stream st = FullStreamGraph_from(&sg);
+	// Every node and link at every instant of the lifespan and around it, the instants going down and the ids
+	// alternating so that the queries are not sorted
+	PresenceQuery node_queries[4 * 112];
+	PresenceQuery link_queries[4 * 112];
+	for (size_t i = 0; i < 4 * 112; i++) {
+		node_queries[i] = (PresenceQuery){.id = (i * 3) % 4, .instant = 111 - i / 4};
+		link_queries[i] = (PresenceQuery){.id = i % 4, .instant = 111 - i / 4};
+	}
+	bool answers[4 * 112];
+	Stream_are_nodes_present(&st, node_queries, 4 * 112, answers);
+	bool result = true;
+	for (size_t i = 0; i < 4 * 112; i++) {
+		bool expected = IntervalsSet_contains(sg.nodes.nodes[node_queries[i].id].presence, node_queries[i].instant);
+		result &= EXPECT(answers[i] == expected);
+	}
+	Stream_are_links_present(&st, link_queries, 4 * 112, answers);
+	for (size_t i = 0; i < 4 * 112; i++) {
+		bool expected = IntervalsSet_contains(sg.links.links[link_queries[i].id].presence, link_queries[i].instant);
+		result &= EXPECT(answers[i] == expected);
+	}
+
+	// Without the EventsTable, the presences of the links are scanned, and with it, it is walked along the instants
+	TimeId instants[] = {75, 0, 25, 100, 70, 25, 29, 30, 111, 74};
+	result &= expect_links_at_instants(&sg, &st, instants, 10);
+	init_events_table(&sg);
+	result &= expect_links_at_instants(&sg, &st, instants, 10);
+	Stream link_stream = LS_from(&sg);
+	result &= expect_links_at_instants(&sg, &link_stream, instants, 10);
+	LS_destroy(link_stream);
+	events_destroy(&sg);
+	FullStreamGraph_destroy(st);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+// The cardinals read from the TimeIndex are the ones summed over the presence intervals
+bool test_time_index_cardinals() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	NodeIdVector nodes = NodeIdVector_with_capacity(4);
+	LinkIdVector links = LinkIdVector_with_capacity(4);
+	for (size_t i = 0; i < 4; i++) {
+		NodeIdVector_push(&nodes, i);
+		LinkIdVector_push(&links, i);
+	}
+	Interval snapshots[] = {Interval_from(0, 100), Interval_from(20, 80), Interval_from(42, 43), Interval_from(75, 75)};
+	size_t expected_w[4];
+	size_t expected_e[4];
+	for (size_t i = 0; i < 4; i++) {
+		Stream st = CS_from(&sg, &nodes, &links, snapshots[i].start, snapshots[i].end);
+		expected_w[i] = cardinalOfW(&st);
+		expected_e[i] = cardinalOfE(&st);
+		CS_destroy(st);
+	}
+	Stream full = FullStreamGraph_from(&sg);
+	size_t full_w = cardinalOfW(&full);
+	size_t full_e = cardinalOfE(&full);
+	FullStreamGraph_destroy(full);
+
+	init_time_index(&sg);
+	bool result = true;
+	for (size_t i = 0; i < 4; i++) {
+		Stream st = CS_from(&sg, &nodes, &links, snapshots[i].start, snapshots[i].end);
+		result &= EXPECT(((ChunkStream*)st.stream)->has_every_id);
+		result &= EXPECT_EQ(cardinalOfW(&st), expected_w[i]);
+		result &= EXPECT_EQ(cardinalOfE(&st), expected_e[i]);
+		CS_destroy(st);
+	}
+	full = FullStreamGraph_from(&sg);
+	result &= EXPECT_EQ(cardinalOfW(&full), full_w);
+	result &= EXPECT_EQ(cardinalOfE(&full), full_e);
+	FullStreamGraph_destroy(full);
+
+	// Without one of the nodes, its links are left out too, so the index can't be used
+	NodeIdVector_destroy(nodes);
+	nodes = NodeIdVector_with_capacity(3);
+	NodeIdVector_push(&nodes, 0);
+	NodeIdVector_push(&nodes, 1);
+	NodeIdVector_push(&nodes, 3);
+	Stream st = CS_from(&sg, &nodes, &links, 20, 80);
+	result &= EXPECT(!((ChunkStream*)st.stream)->has_every_id);
+	result &= EXPECT_EQ(cardinalOfW(&st), 120);
+	CS_destroy(st);
+
+	StreamGraph_destroy(sg);
+	NodeIdVector_destroy(nodes);
+	LinkIdVector_destroy(links);
+	return result;
+}
 
 int main() {
 	/*Test* tests[] = {
@@ -562,6 +1738,7 @@ int main() {
 		&(Test){"contribution_of_nodes",					 test_contribution_of_nodes					   },
 		&(Test){"contributions_of_links",					  test_contributions_of_links					 },
 		&(Test){"uniformity",								test_uniformity								 },
+		&(Test){"compactness",								test_compactness							 },
 
 		&(Test){"density",								   test_density								   },
 		&(Test){"density_of_link",						   test_density_of_link						   },
@@ -575,11 +1752,46 @@ int main() {
 		&(Test){"link_presence_chunk_stream",				  test_link_presence_chunk_stream				 },
 		&(Test){"nodes_and_links_present_at_t_chunk_stream", test_nodes_and_links_present_at_t_chunk_stream},
 		&(Test){"degree_of_node",							  test_degree_of_node							 },
+		&(Test){"clustering_coeff_of_node",					  test_clustering_coeff_of_node					 },
+		&(Test){"clustering_coeff",							  test_clustering_coeff							 },
+		&(Test){"transitivity",								  test_transitivity								 },
+		&(Test){"clustering_coeff_chunk_stream",			  test_clustering_coeff_chunk_stream			 },
 		&(Test){"cache",									 test_cache									},
+		&(Test){"concurrent_cache",						  test_concurrent_cache						  },
+		&(Test){"memo_table",								test_memo_table								 },
+		&(Test){"memo_table_eviction",					   test_memo_table_eviction					   },
+		&(Test){"counters",								   test_counters								   },
+		&(Test){"specialised_kernels",					   test_specialised_kernels					   },
 
 		&(Test){"chunk_stream_small_nodes_set",				test_chunk_stream_small_nodes_set			 },
+		&(Test){"chunk_stream_small_lookups",				 test_chunk_stream_small_lookups			   },
 		&(Test){"chunk_stream_small_neighbours_of_node",	 test_chunk_stream_small_neighbours_of_node	   },
 		&(Test){"chunk_stream_small_times_node_present",	 test_chunk_stream_small_times_node_present	   },
+		&(Test){"substream",								 test_substream								   },
+		&(Test){"substream_links_of_pieces",				 test_substream_links_of_pieces				   },
+		&(Test){"window_stream",							 test_window_stream							   },
+
+		&(Test){"contribution_of_all_nodes",				 test_contribution_of_all_nodes				   },
+		&(Test){"contribution_of_all_links",				 test_contribution_of_all_links				   },
+		&(Test){"degree_of_all_nodes",					   test_degree_of_all_nodes					   },
+		&(Test){"density_of_all_links",					  test_density_of_all_links					   },
+		&(Test){"density_of_all_nodes",					  test_density_of_all_nodes					   },
+		&(Test){"clustering_coeff_of_all_nodes",		  test_clustering_coeff_of_all_nodes		   },
+		&(Test){"bulk_metric_chunk_stream",				  test_bulk_metric_chunk_stream				   },
+		&(Test){"metrics_with_thread_pool",				  test_metrics_with_thread_pool				   },
+		&(Test){"key_moments_time_series",				   test_key_moments_time_series				   },
+		&(Test){"instants_time_series",					  test_instants_time_series					   },
+		&(Test){"degree_histogram",						  test_degree_histogram						   },
+		&(Test){"temporal_paths_from",					  test_temporal_paths_from					   },
+		&(Test){"latest_departures_to",					  test_latest_departures_to					   },
+		&(Test){"temporal_paths_from_all_nodes",		  test_temporal_paths_from_all_nodes		   },
+		&(Test){"maximal_cliques",						  test_maximal_cliques						   },
+		&(Test){"components_time_series",				  test_components_time_series				   },
+		&(Test){"components_at_instants",				  test_components_at_instants				   },
+		&(Test){"sampling_estimates",					  test_sampling_estimates					   },
+		&(Test){"top_k",								  test_top_k								   },
+		&(Test){"point_queries",						  test_point_queries						   },
+		&(Test){"time_index_cardinals",					  test_time_index_cardinals					   },
 
 		NULL,
 	};
@@ -0,0 +1,212 @@
+#include "../src/roaring_bitmap.h"
+#include "../src/utils.h"
+#include "test.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// Checks that a RoaringBitmap contains exactly the values set to true in expected
+static bool same_values(const RoaringBitmap* bitmap, const bool* expected, size_t nb_expected) {
+	size_t value = 0;
+	RoaringIterator iterator = RoaringIterator_from(bitmap);
+	for (size_t i = 0; i < nb_expected; i++) {
+		if (expected[i]) {
+			value = RoaringIterator_next(&iterator);
+			if (!EXPECT_EQ(value, i) || !EXPECT(RoaringBitmap_contains(bitmap, i))) {
+				return false;
+			}
+		}
+		else if (!EXPECT(!RoaringBitmap_contains(bitmap, i))) {
+			return false;
+		}
+	}
+	return EXPECT_EQ(RoaringIterator_next(&iterator), SIZE_MAX);
+}
+
+bool test_empty() {
+	RoaringBitmap bitmap = RoaringBitmap_empty();
+	bool result = EXPECT_EQ(RoaringBitmap_cardinality(&bitmap), 0);
+	result &= EXPECT(!RoaringBitmap_contains(&bitmap, 0));
+	result &= EXPECT_EQ(RoaringBitmap_next(&bitmap, 0), SIZE_MAX);
+	RoaringIterator iterator = RoaringIterator_from(&bitmap);
+	result &= EXPECT_EQ(RoaringIterator_next(&iterator), SIZE_MAX);
+	RoaringBitmap_destroy(bitmap);
+	return result;
+}
+
+bool test_add_and_contains() {
+	RoaringBitmap bitmap = RoaringBitmap_empty();
+	size_t values[] = {70000, 3, 1 << 20, 3, 65535, 65536, 0};
+	for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+		RoaringBitmap_add(&bitmap, values[i]);
+	}
+	bool result = EXPECT_EQ(RoaringBitmap_cardinality(&bitmap), 6);
+	result &= EXPECT_EQ(bitmap.nb_containers, 3);
+	for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+		result &= EXPECT(RoaringBitmap_contains(&bitmap, values[i]));
+	}
+	result &= EXPECT(!RoaringBitmap_contains(&bitmap, 4));
+	result &= EXPECT(!RoaringBitmap_contains(&bitmap, 70001));
+	result &= EXPECT(!RoaringBitmap_contains(&bitmap, 1 << 30));
+	result &= EXPECT_EQ(RoaringBitmap_next(&bitmap, 4), 65535);
+	result &= EXPECT_EQ(RoaringBitmap_next(&bitmap, 70001), 1 << 20);
+	result &= EXPECT_EQ(RoaringBitmap_next(&bitmap, (1 << 20) + 1), SIZE_MAX);
+	RoaringBitmap_destroy(bitmap);
+	return result;
+}
+
+// An array container becomes a bitmap once it holds more than ROARING_ARRAY_MAX_CARDINALITY values
+bool test_array_to_bitmap() {
+	RoaringBitmap bitmap = RoaringBitmap_empty();
+	bool* expected = calloc(ROARING_BLOCK_SIZE, sizeof(bool));
+	for (size_t i = 0; i < 2 * ROARING_ARRAY_MAX_CARDINALITY; i++) {
+		size_t value = (i * 7919) % ROARING_BLOCK_SIZE;
+		RoaringBitmap_add(&bitmap, value);
+		expected[value] = true;
+	}
+	bool result = EXPECT(bitmap.containers[0].kind == ROARING_BITMAP);
+	result &= EXPECT_EQ(RoaringBitmap_cardinality(&bitmap), 2 * ROARING_ARRAY_MAX_CARDINALITY);
+	result &= same_values(&bitmap, expected, ROARING_BLOCK_SIZE);
+	RoaringBitmap_destroy(bitmap);
+	free(expected);
+	return result;
+}
+
+bool test_from_values_and_optimize() {
+	size_t nb_expected = 3 * ROARING_BLOCK_SIZE;
+	size_t* values = MALLOC(nb_expected * sizeof(size_t));
+	bool* expected = calloc(nb_expected, sizeof(bool));
+	size_t nb_values = 0;
+	// A long run in the first block, sparse values in the second, a dense random block in the third
+	for (size_t i = 100; i < 50000; i++) {
+		values[nb_values++] = i;
+	}
+	for (size_t i = 0; i < 100; i++) {
+		values[nb_values++] = ROARING_BLOCK_SIZE + i * 37;
+		values[nb_values++] = ROARING_BLOCK_SIZE + i * 37; // Duplicates are ignored
+	}
+	srand(42);
+	for (size_t i = 0; i < 20000; i++) {
+		values[nb_values++] = 2 * ROARING_BLOCK_SIZE + (size_t)rand() % ROARING_BLOCK_SIZE;
+	}
+	for (size_t i = 0; i < nb_values; i++) {
+		expected[values[i]] = true;
+	}
+
+	RoaringBitmap bitmap = RoaringBitmap_from_values(values, nb_values);
+	bool result = EXPECT_EQ(bitmap.nb_containers, 3);
+	result &= EXPECT(bitmap.containers[0].kind == ROARING_RUN);
+	result &= EXPECT(bitmap.containers[1].kind == ROARING_ARRAY);
+	result &= EXPECT(bitmap.containers[2].kind == ROARING_BITMAP);
+	result &= same_values(&bitmap, expected, nb_expected);
+	result &= EXPECT(RoaringBitmap_memory_usage(&bitmap) < 2 * ROARING_BITMAP_WORDS * sizeof(uint64_t));
+
+	// Adding to a run container goes back to a bitmap, and optimizing brings back the run
+	RoaringBitmap_add(&bitmap, 50000);
+	expected[50000] = true;
+	result &= EXPECT(bitmap.containers[0].kind == ROARING_BITMAP);
+	RoaringBitmap_optimize(&bitmap);
+	result &= EXPECT(bitmap.containers[0].kind == ROARING_RUN);
+	result &= EXPECT(bitmap.containers[0].size == 1);
+	result &= same_values(&bitmap, expected, nb_expected);
+
+	RoaringBitmap_destroy(bitmap);
+	free(expected);
+	free(values);
+	return result;
+}
+
+// Compares the set operations to the ones on arrays of booleans, on pairs of containers of every kind
+bool test_set_operations() {
+	size_t nb_expected = 5 * ROARING_BLOCK_SIZE;
+	bool* in1 = calloc(nb_expected, sizeof(bool));
+	bool* in2 = calloc(nb_expected, sizeof(bool));
+	srand(7);
+	// Block 0 : sparse in both, 1 : dense in both, 2 : dense and sparse, 3 : a run and sparse, 4 : only in the first
+	for (size_t block = 0; block < 5; block++) {
+		size_t offset = block * ROARING_BLOCK_SIZE;
+		size_t nb1 = block == 1 || block == 2 ? 30000 : 1000;
+		size_t nb2 = block == 1 ? 30000 : block == 4 ? 0 : 1000;
+		for (size_t i = 0; i < nb1; i++) {
+			in1[offset + (block == 3 ? i + 500 : (size_t)rand() % ROARING_BLOCK_SIZE)] = true;
+		}
+		for (size_t i = 0; i < nb2; i++) {
+			in2[offset + (size_t)rand() % ROARING_BLOCK_SIZE] = true;
+		}
+	}
+	RoaringBitmap bitmap1 = RoaringBitmap_empty();
+	RoaringBitmap bitmap2 = RoaringBitmap_empty();
+	for (size_t i = 0; i < nb_expected; i++) {
+		if (in1[i]) {
+			RoaringBitmap_add(&bitmap1, i);
+		}
+		if (in2[i]) {
+			RoaringBitmap_add(&bitmap2, i);
+		}
+	}
+	RoaringBitmap_optimize(&bitmap1);
+	bool result = EXPECT(bitmap1.containers[3].kind == ROARING_RUN);
+
+	RoaringBitmap and12 = RoaringBitmap_and(&bitmap1, &bitmap2);
+	RoaringBitmap or12 = RoaringBitmap_or(&bitmap1, &bitmap2);
+	RoaringBitmap andnot12 = RoaringBitmap_andnot(&bitmap1, &bitmap2);
+	RoaringBitmap andnot21 = RoaringBitmap_andnot(&bitmap2, &bitmap1);
+	bool* expected_and = MALLOC(nb_expected * sizeof(bool));
+	bool* expected_or = MALLOC(nb_expected * sizeof(bool));
+	bool* expected_andnot12 = MALLOC(nb_expected * sizeof(bool));
+	bool* expected_andnot21 = MALLOC(nb_expected * sizeof(bool));
+	for (size_t i = 0; i < nb_expected; i++) {
+		expected_and[i] = in1[i] && in2[i];
+		expected_or[i] = in1[i] || in2[i];
+		expected_andnot12[i] = in1[i] && !in2[i];
+		expected_andnot21[i] = in2[i] && !in1[i];
+	}
+
+	result &= same_values(&and12, expected_and, nb_expected);
+	result &= same_values(&or12, expected_or, nb_expected);
+	result &= same_values(&andnot12, expected_andnot12, nb_expected);
+	result &= same_values(&andnot21, expected_andnot21, nb_expected);
+	result &= EXPECT_EQ(and12.nb_containers, 4);
+
+	RoaringBitmap_destroy(bitmap1);
+	RoaringBitmap_destroy(bitmap2);
+	RoaringBitmap_destroy(and12);
+	RoaringBitmap_destroy(or12);
+	RoaringBitmap_destroy(andnot12);
+	RoaringBitmap_destroy(andnot21);
+	free(in1);
+	free(in2);
+	free(expected_and);
+	free(expected_or);
+	free(expected_andnot12);
+	free(expected_andnot21);
+	return result;
+}
+
+// A few sparse ids out of millions must not cost a bit per possible id
+bool test_memory_scales_with_content() {
+	size_t values[1000];
+	for (size_t i = 0; i < 1000; i++) {
+		values[i] = 100000000 + i * 3;
+	}
+	RoaringBitmap bitmap = RoaringBitmap_from_values(values, 1000);
+	bool result = EXPECT(RoaringBitmap_memory_usage(&bitmap) < 4096);
+	result &= EXPECT_EQ(RoaringBitmap_next(&bitmap, 0), 100000000);
+	RoaringBitmap_destroy(bitmap);
+	return result;
+}
+
+int main() {
+	Test* tests[] = {
+		&(Test){"empty",					  test_empty					 },
+		&(Test){"add_and_contains",			  test_add_and_contains			 },
+		&(Test){"array_to_bitmap",			  test_array_to_bitmap			 },
+		&(Test){"from_values_and_optimize",	  test_from_values_and_optimize	 },
+		&(Test){"set_operations",			  test_set_operations			 },
+		&(Test){"memory_scales_with_content", test_memory_scales_with_content},
+
+		NULL
+	};
+
+	return test("RoaringBitmap", tests);
+}
\ No newline at end of file
@@ -87,6 +87,87 @@ bool test_external_format() {
 	return true;
 }
 
+// The PresenceStores hold the same intervals as the nodes and links, in the same order
+bool test_presence_stores() {
+	StreamGraph sg = StreamGraph_from_file("tests/test_data/S.txt");
+	bool result = EXPECT_EQ(sg.node_presences.nb_ids, sg.nodes.nb_nodes);
+	size_t total_time = 0;
+	for (size_t node = 0; node < sg.nodes.nb_nodes; node++) {
+		IntervalsSet presence = sg.nodes.nodes[node].presence;
+		size_t offset = sg.node_presences.offsets[node];
+		result &= EXPECT_EQ(sg.node_presences.offsets[node + 1] - offset, presence.nb_intervals);
+		for (size_t i = 0; i < presence.nb_intervals; i++) {
+			result &= EXPECT_EQ(sg.node_presences.starts[offset + i], presence.intervals[i].start);
+			result &= EXPECT_EQ(sg.node_presences.ends[offset + i], presence.intervals[i].end);
+		}
+		result &= EXPECT_EQ(PresenceStore_time_of(&sg.node_presences, node), IntervalsSet_size(presence));
+		result &= EXPECT_EQ(PresenceStore_time_of_clipped(&sg.node_presences, node, Interval_from(20, 60)),
+							IntervalsSet_size_clipped(presence, Interval_from(20, 60)));
+		total_time += IntervalsSet_size(presence);
+	}
+	result &= EXPECT_EQ(PresenceStore_total_time(&sg.node_presences), total_time);
+
+	result &= EXPECT_EQ(sg.link_presences.nb_ids, sg.links.nb_links);
+	total_time = 0;
+	for (size_t link = 0; link < sg.links.nb_links; link++) {
+		IntervalsSet presence = sg.links.links[link].presence;
+		result &= EXPECT_EQ(PresenceStore_time_of(&sg.link_presences, link), IntervalsSet_size(presence));
+		total_time += IntervalsSet_size(presence);
+	}
+	result &= EXPECT_EQ(PresenceStore_total_time(&sg.link_presences), total_time);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+// Checks the aggregates of the TimeIndex against the intervals, over ranges from before to after the lifespan
+static bool expect_time_index(const char* filename, size_t step) {
+	StreamGraph sg = StreamGraph_from_file(filename);
+	init_time_index(&sg);
+	size_t end = StreamGraph_lifespan_end(&sg) + 2;
+	size_t* nodes_at = calloc(end, sizeof(size_t));
+	size_t* links_at = calloc(end, sizeof(size_t));
+	bool result = true;
+	for (size_t t = 0; t < end; t++) {
+		for (size_t node = 0; node < sg.nodes.nb_nodes; node++) {
+			nodes_at[t] += IntervalsSet_contains(sg.nodes.nodes[node].presence, t);
+		}
+		for (size_t link = 0; link < sg.links.nb_links; link++) {
+			links_at[t] += IntervalsSet_contains(sg.links.links[link].presence, t);
+		}
+		result &= EXPECT_EQ(TimeIndex_nodes_at(sg.time_index, t), nodes_at[t]);
+		result &= EXPECT_EQ(TimeIndex_links_at(sg.time_index, t), links_at[t]);
+	}
+	for (size_t a = 0; a < end; a += step) {
+		for (size_t b = a; b <= end; b += step) {
+			Interval range = Interval_from(a, b);
+			size_t node_time = 0;
+			size_t link_time = 0;
+			size_t max_nodes = 0;
+			size_t max_links = 0;
+			for (size_t t = a; t < b; t++) {
+				node_time += nodes_at[t];
+				link_time += links_at[t];
+				max_nodes = nodes_at[t] > max_nodes ? nodes_at[t] : max_nodes;
+				max_links = links_at[t] > max_links ? links_at[t] : max_links;
+			}
+			result &= EXPECT_EQ(TimeIndex_node_time(sg.time_index, range), node_time);
+			result &= EXPECT_EQ(TimeIndex_link_time(sg.time_index, range), link_time);
+			result &= EXPECT_EQ(TimeIndex_max_nodes(sg.time_index, range), max_nodes);
+			result &= EXPECT_EQ(TimeIndex_max_links(sg.time_index, range), max_links);
+		}
+	}
+	free(nodes_at);
+	free(links_at);
+	StreamGraph_destroy(sg);
+	return result;
+}
+
+bool test_time_index() {
+	bool result = expect_time_index("tests/test_data/S.txt", 1);
+	result &= expect_time_index("tests/test_data/S_multiple_slices.txt", 9);
+	return result;
+}
+
 int main() {
 	Test* tests[] = {
 		&(Test){"load",						 test_load						 },
@@ -96,6 +177,8 @@ int main() {
 		&(Test){"find_index_of_time_not_found", test_find_index_of_time_not_found},
 		&(Test){"init_events_table",			 test_init_events_table		   },
 		&(Test){"external_format",			   test_external_format			   },
+		&(Test){"presence_stores",			   test_presence_stores			   },
+		&(Test){"time_index",				   test_time_index				   },
 
 		NULL
 	};
@@ -0,0 +1,120 @@
+#include "../src/thread_pool.h"
+#include "../src/utils.h"
+#include "test.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+static void count_visits(void* context, size_t chunk_index, size_t from, size_t to) {
+	(void)chunk_index;
+	atomic_int* visits = (atomic_int*)context;
+	for (size_t i = from; i < to; i++) {
+		atomic_fetch_add(&visits[i], 1);
+	}
+}
+
+bool test_every_element_visited_once() {
+	ThreadPool* pool = ThreadPool_create(4);
+	bool result = EXPECT_EQ(ThreadPool_nb_workers(pool), 4);
+	size_t nb_elements = 10007;
+	atomic_int* visits = MALLOC(nb_elements * sizeof(atomic_int));
+	for (size_t i = 0; i < nb_elements; i++) {
+		atomic_init(&visits[i], 0);
+	}
+	ThreadPool_parallel_for(pool, nb_elements, 3, count_visits, visits);
+	for (size_t i = 0; i < nb_elements; i++) {
+		result &= EXPECT_EQ(atomic_load(&visits[i]), 1);
+	}
+	free(visits);
+	ThreadPool_destroy(pool);
+	return result;
+}
+
+static size_t sum_of_ids(void* context, size_t from, size_t to) {
+	(void)context;
+	size_t sum = 0;
+	for (size_t i = from; i < to; i++) {
+		sum += i;
+	}
+	return sum;
+}
+
+bool test_sum() {
+	ThreadPool* pool = ThreadPool_create(3);
+	bool result = EXPECT_EQ(ThreadPool_sum(pool, 1000, 7, sum_of_ids, NULL), 1000 * 999 / 2);
+	result &= EXPECT_EQ(ThreadPool_sum(NULL, 1000, 7, sum_of_ids, NULL), 1000 * 999 / 2);
+	result &= EXPECT_EQ(ThreadPool_sum(pool, 0, 7, sum_of_ids, NULL), 0);
+	ThreadPool_destroy(pool);
+	return result;
+}
+
+static double sum_of_inverses(void* context, size_t from, size_t to) {
+	(void)context;
+	double sum = 0;
+	for (size_t i = from; i < to; i++) {
+		sum += 1.0 / (double)(i + 1);
+	}
+	return sum;
+}
+
+// The floating point sums must be exactly the same whatever the number of workers
+bool test_sum_double_is_deterministic() {
+	double expected = ThreadPool_sum_double(NULL, 100000, 64, sum_of_inverses, NULL);
+	bool result = true;
+	for (size_t nb_workers = 2; nb_workers <= 5; nb_workers++) {
+		ThreadPool* pool = ThreadPool_create(nb_workers);
+		for (size_t run = 0; run < 5; run++) {
+			result &= EXPECT(ThreadPool_sum_double(pool, 100000, 64, sum_of_inverses, NULL) == expected);
+		}
+		ThreadPool_destroy(pool);
+	}
+	return result;
+}
+
+typedef struct {
+	ThreadPool* pool;
+	atomic_size_t total;
+} NestedContext;
+
+static void nested_loop(void* context, size_t chunk_index, size_t from, size_t to) {
+	(void)chunk_index;
+	NestedContext* nested = (NestedContext*)context;
+	for (size_t i = from; i < to; i++) {
+		atomic_fetch_add(&nested->total, ThreadPool_sum(nested->pool, 100, 10, sum_of_ids, NULL));
+	}
+}
+
+// A parallel loop inside another one must not deadlock
+bool test_nested_loops() {
+	NestedContext nested = {.pool = ThreadPool_create(3)};
+	atomic_init(&nested.total, 0);
+	ThreadPool_parallel_for(nested.pool, 20, 1, nested_loop, &nested);
+	bool result = EXPECT_EQ(atomic_load(&nested.total), 20 * (100 * 99 / 2));
+	ThreadPool_destroy(nested.pool);
+	return result;
+}
+
+bool test_global_pool() {
+	bool result = EXPECT(ThreadPool_global() == NULL);
+	ThreadPool_set_global_nb_workers(2);
+	result &= EXPECT_EQ(ThreadPool_nb_workers(ThreadPool_global()), 2);
+	result &= EXPECT_EQ(ThreadPool_sum(ThreadPool_global(), 50, 4, sum_of_ids, NULL), 50 * 49 / 2);
+	ThreadPool_set_global_nb_workers(1);
+	result &= EXPECT(ThreadPool_global() == NULL);
+	return result;
+}
+
+int main() {
+	Test* tests[] = {
+		&(Test){"every_element_visited_once", test_every_element_visited_once},
+		&(Test){"sum",						  test_sum						 },
+		&(Test){"sum_double_is_deterministic", test_sum_double_is_deterministic},
+		&(Test){"nested_loops",				  test_nested_loops				 },
+		&(Test){"global_pool",				  test_global_pool				 },
+		NULL,
+	};
+
+	return test("ThreadPool", tests);
+}
\ No newline at end of file